@@ -0,0 +1,105 @@
+/*
+ * builtinBench.cpp
+ *
+ *  Created on: 16.10.2026
+ *
+ * Startup and compile time of the glslang front end. The first compile with
+ * a set of resource limits parses the built-in level for them, later ones
+ * reuse it from the cache; both are printed per language.
+ *
+ * Usage: builtinBench [number of compiles]
+ */
+
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "glsldb/utils/benchtime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* vertexShader =
+		"uniform float u;\n"
+		"void main()\n"
+		"{\n"
+		"  gl_TexCoord[0] = gl_MultiTexCoord0 * u;\n"
+		"  gl_Position = ftransform();\n"
+		"}\n";
+
+static const char* fragmentShader =
+		"uniform sampler2D tex;\n"
+		"void main()\n"
+		"{\n"
+		"  gl_FragColor = texture2D(tex, gl_TexCoord[0].xy);\n"
+		"}\n";
+
+/* seconds for one compile, -1 on failure */
+static double compile(EShLanguage language, const char* source,
+		const TBuiltInResource* resources)
+{
+	ShVariableList vl;
+	double start = now();
+
+	ShHandle compiler = ShConstructCompiler(language, 0);
+	if (!compiler)
+		return -1.0;
+	int success = ShCompile(compiler, &source, 1, EShOptNone, resources, 0,
+			&vl);
+	freeShVariableList(&vl);
+	ShDestruct(compiler);
+
+	return success ? now() - start : -1.0;
+}
+
+int main(int argc, char** argv)
+{
+	int compiles = argc > 1 ? atoi(argv[1]) : 100;
+	if (compiles < 1)
+		compiles = 1;
+
+	double start = now();
+	if (!ShInitialize()) {
+		fprintf(stderr, "ShInitialize failed\n");
+		return 1;
+	}
+	printf("ShInitialize: %.2f ms\n\n", (now() - start) * 1e3);
+
+	static const struct {
+		const char* name;
+		EShLanguage language;
+		const char* source;
+	} shaders[] = {
+		{ "vertex", EShLangVertex, vertexShader },
+		{ "fragment", EShLangFragment, fragmentShader }
+	};
+
+	printf("%10s %14s %14s %14s\n", "shader", "resources", "first ms",
+			"cached ms");
+	for (int s = 0; s < 2; ++s) {
+		/* two limit sets, the second one must not reuse the first level */
+		for (int drawBuffers = 4; drawBuffers <= 8; drawBuffers += 4) {
+			TBuiltInResource resources;
+			setTestResources(&resources, drawBuffers);
+
+			double first = compile(shaders[s].language, shaders[s].source,
+					&resources);
+			double total = 0.0;
+			for (int i = 0; i < compiles && total >= 0.0; ++i) {
+				double elapsed = compile(shaders[s].language, shaders[s].source,
+						&resources);
+				total = elapsed < 0.0 ? -1.0 : total + elapsed;
+			}
+
+			if (first < 0.0 || total < 0.0)
+				printf("%10s %11s %2d %14s %14s\n", shaders[s].name,
+						"drawbuffers", drawBuffers, "failed", "-");
+			else
+				printf("%10s %11s %2d %14.3f %14.3f\n", shaders[s].name,
+						"drawbuffers", drawBuffers, first * 1e3,
+						total / compiles * 1e3);
+		}
+	}
+
+	ShFinalize();
+	return 0;
+}
@@ -71,10 +71,14 @@ public:
 	bool finishedDbgFunction;
 };
 
-static struct {
+/* Kept per compiler handle; the traverser holds the stack of the step */
+struct TDebugJumpState {
 	TOutputDebugJumpTraverser *it;
 	DbgResult result;
-} g;
+};
+
+/* state of the handle being traversed */
+static TDebugJumpState *g;
 
 //
 // This function must be provided to create the actual
@@ -98,40 +102,18 @@ void DeleteTraverseDebugJump(TCompiler* compiler)
 //
 // Some helper functions for easier scope handling
 //
-static void initGlobalScope(void)
-{
-	static int initialized = 0;
-
-	if (!initialized) {
-		g.result.scope.numIds = 0;
-		g.result.scope.ids = NULL;
-		initialized = 1;
-	}
-}
-
-static void initGlobalScopeStack(void)
-{
-	static int initialized = 0;
-
-	if (!initialized) {
-		g.result.scopeStack.numIds = 0;
-		g.result.scopeStack.ids = NULL;
-		initialized = 1;
-	}
-}
-
 static void clearGlobalScope(void)
 {
-	g.result.scope.numIds = 0;
-	free(g.result.scope.ids);
-	g.result.scope.ids = NULL;
+	g->result.scope.numIds = 0;
+	free(g->result.scope.ids);
+	g->result.scope.ids = NULL;
 }
 
 static void clearGlobalScopeStack(void)
 {
-	g.result.scopeStack.numIds = 0;
-	free(g.result.scopeStack.ids);
-	g.result.scopeStack.ids = NULL;
+	g->result.scopeStack.numIds = 0;
+	free(g->result.scopeStack.ids);
+	g->result.scopeStack.ids = NULL;
 }
 
 static void addScopeToScopeStack(scopeList *s)
@@ -145,17 +127,17 @@ static void addScopeToScopeStack(scopeList *s)
 	scopeList::iterator si = s->begin();
 
 	while (si != s->end()) {
-		for (i = 0; i < g.result.scopeStack.numIds; i++) {
-			if (*si == g.result.scopeStack.ids[i]) {
+		for (i = 0; i < g->result.scopeStack.numIds; i++) {
+			if (*si == g->result.scopeStack.ids[i]) {
 				goto NEXTINSCOPE;
 			}
 		}
 
-		g.result.scopeStack.numIds++;
+		g->result.scopeStack.numIds++;
 
-		g.result.scopeStack.ids = (int*) realloc(g.result.scopeStack.ids,
-				g.result.scopeStack.numIds * sizeof(int));
-		g.result.scopeStack.ids[g.result.scopeStack.numIds - 1] = *si;
+		g->result.scopeStack.ids = (int*) realloc(g->result.scopeStack.ids,
+				g->result.scopeStack.numIds * sizeof(int));
+		g->result.scopeStack.ids[g->result.scopeStack.numIds - 1] = *si;
 
 		NEXTINSCOPE: si++;
 	}
@@ -174,10 +156,10 @@ static void setGobalScope(scopeList *s)
 	VPRINT(3, "SET GLOBAL SCOPE LIST:");
 
 	while (si != s->end()) {
-		g.result.scope.numIds++;
-		g.result.scope.ids = (int*) realloc(g.result.scope.ids,
-				g.result.scope.numIds * sizeof(int));
-		g.result.scope.ids[g.result.scope.numIds - 1] = *si;
+		g->result.scope.numIds++;
+		g->result.scope.ids = (int*) realloc(g->result.scope.ids,
+				g->result.scope.numIds * sizeof(int));
+		g->result.scope.ids[g->result.scope.numIds - 1] = *si;
 
 		VPRINT(3, " %i", *si);
 		si++;
@@ -191,24 +173,13 @@ static void setGobalScope(scopeList *s)
 //
 // Functions for keeping track of changes variables
 //
-static void initGlobalChangeables(void)
-{
-	static int initialized = 0;
-
-	if (!initialized) {
-		g.result.cgbls.numChangeables = 0;
-		g.result.cgbls.changeables = NULL;
-		initialized = 1;
-	}
-}
-
 static void clearGlobalChangeables(void)
 {
 	int i, j;
 
-	for (i = 0; i < g.result.cgbls.numChangeables; i++) {
+	for (i = 0; i < g->result.cgbls.numChangeables; i++) {
 		ShChangeable *c;
-		if ((c = g.result.cgbls.changeables[i])) {
+		if ((c = g->result.cgbls.changeables[i])) {
 			for (j = 0; j < c->numIndices; j++) {
 				free(c->indices[j]);
 			}
@@ -216,10 +187,10 @@ static void clearGlobalChangeables(void)
 			free(c);
 		}
 	}
-	free(g.result.cgbls.changeables);
+	free(g->result.cgbls.changeables);
 
-	g.result.cgbls.numChangeables = 0;
-	g.result.cgbls.changeables = NULL;
+	g->result.cgbls.numChangeables = 0;
+	g->result.cgbls.changeables = NULL;
 }
 
 static TIntermNode* getFunctionBySignature(const char *sig, TIntermNode* root)
@@ -294,7 +265,7 @@ static void processDebugable(TIntermNode *node, OTOperation *op)
 			node->setDebugState(DbgStNone);
 			*op = OTOpTargetSet;
 			VPRINT(3, "\t ------- unset target --------\n");
-			g.result.position = DBG_RS_POSITION_UNSET;
+			g->result.position = DBG_RS_POSITION_UNSET;
 			break;
 		default:
 			break;
@@ -311,20 +282,20 @@ static void processDebugable(TIntermNode *node, OTOperation *op)
 			*op = OTOpDone;
 			VPRINT(3, "\t -------- set target ---------\n");
 			if (node->getAsBinaryNode()) {
-				g.result.position = DBG_RS_POSITION_ASSIGMENT;
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.position = DBG_RS_POSITION_ASSIGMENT;
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 			} else if (node->getAsBranchNode()) {
-				g.result.position = DBG_RS_POSITION_BRANCH;
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.position = DBG_RS_POSITION_BRANCH;
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 			} else if (node->getAsUnaryNode()) {
-				g.result.position = DBG_RS_POSITION_UNARY;
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.position = DBG_RS_POSITION_UNARY;
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 			} else if (node->getAsDummy()) {
-				g.result.position = DBG_RS_POSITION_DUMMY;
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.position = DBG_RS_POSITION_DUMMY;
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 			}
 			break;
@@ -478,7 +449,7 @@ static bool TraverseAggregate(bool /* preVisit */, TIntermAggregate* node,
 					oit->operation = OTOpTargetSet;
 
 					// add local parameters of called function first
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							funcDec->getAsAggregate()->getCgbParameterList());
 
 					funcDec->traverse(oit);
@@ -487,33 +458,33 @@ static bool TraverseAggregate(bool /* preVisit */, TIntermAggregate* node,
 					// searched, a wierd function was called, but anyway,
 					// let's copy the appropriate changeables
 					if (oit->operation == OTOpTargetSet) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getCgbList());
 					}
 				} else {
 					node->setDebugState(DbgStNone);
 					oit->operation = OTOpTargetSet;
 					VPRINT(3, "\t ------- unset target --------\n");
-					g.result.position = DBG_RS_POSITION_UNSET;
+					g->result.position = DBG_RS_POSITION_UNSET;
 
 					// if parsing of the subfunction finished right now
 					// -> copy only changed parameters to changeables
 					// else
 					// -> copy all, since user wants to jump over this func
 					if (oit->finishedDbgFunction == true) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getCgbParameterList());
 						oit->finishedDbgFunction = false;
 					} else {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getCgbList());
 						// Check if this function call would have emitted a vertex
 						if (node->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -533,17 +504,17 @@ static bool TraverseAggregate(bool /* preVisit */, TIntermAggregate* node,
 				if (node->isUserDefined()) {
 					node->setDebugState(DbgStTarget);
 					VPRINT(3, "\t -------- set target ---------\n");
-					g.result.position = DBG_RS_POSITION_FUNCTION_CALL;
-					g.result.range = setDbgResultRange(node->getRange());
+					g->result.position = DBG_RS_POSITION_FUNCTION_CALL;
+					g->result.range = setDbgResultRange(node->getRange());
 					setGobalScope(node->getScope());
 					oit->operation = OTOpDone;
 				} else {
 					if (node->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 				}
@@ -602,15 +573,15 @@ static bool TraverseBinary(bool /* preVisit */, TIntermBinary* node,
 			if (!(oit->dbgBehaviour & DBG_BH_JUMPINTO)) {
 				// do not visit children
 				// add all changeables of this node to the list
-				copyShChangeableList(&(g.result.cgbls), node->getCgbList());
+				copyShChangeableList(&(g->result.cgbls), node->getCgbList());
 
 				// Check if this operation would have emitted a vertex
 				if (node->containsEmitVertex()) {
-					g.result.passedEmitVertex = true;
+					g->result.passedEmitVertex = true;
 					VPRINT(6, "passed Emit %i\n", __LINE__);
 				}
 				if (node->containsDiscard()) {
-					g.result.passedDiscard = true;
+					g->result.passedDiscard = true;
 					VPRINT(6, "passed Discard %i\n", __LINE__);
 				}
 				return false;
@@ -630,14 +601,14 @@ static bool TraverseBinary(bool /* preVisit */, TIntermBinary* node,
 				// if no target was found so far
 				// all changeables need to be added to the list
 				if (oit->operation == OTOpTargetSet) {
-					copyShChangeableList(&(g.result.cgbls), node->getCgbList());
+					copyShChangeableList(&(g->result.cgbls), node->getCgbList());
 					// Check if this operation would have emitted a vertex
 					if (node->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 				}
@@ -661,15 +632,15 @@ static bool TraverseBinary(bool /* preVisit */, TIntermBinary* node,
 			// -> add only changed variables of this assigment, i.e.
 			//    changeables of the left branch
 			if (oit->operation == OTOpTargetSet) {
-				copyShChangeableList(&(g.result.cgbls),
+				copyShChangeableList(&(g->result.cgbls),
 						node->getLeft()->getCgbList());
 				// Check if this operation would have emitted a vertex
 				if (node->getLeft()->containsEmitVertex()) {
-					g.result.passedEmitVertex = true;
+					g->result.passedEmitVertex = true;
 					VPRINT(6, "passed Emit %i\n", __LINE__);
 				}
 				if (node->getLeft()->containsDiscard()) {
-					g.result.passedDiscard = true;
+					g->result.passedDiscard = true;
 					VPRINT(6, "passed Discard %i\n", __LINE__);
 				}
 			}
@@ -740,7 +711,7 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 				sn->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
 				sn->setDbgInternalState(DBG_STATE_SELECTION_CONDITION);
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 				if (oit->dbgBehaviour & DBG_BH_JUMPINTO) {
 					// visit condition
 					node->getCondition()->traverse(it);
@@ -750,16 +721,16 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 						// changeables; it's unlikely that there is a
 						// changeable and no target, but anyway be on the
 						// safe side
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getCondition()->getCgbList());
 
 						// Check if condition emitted a vertex
 						if (node->getCondition()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getCondition()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -768,47 +739,47 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 #if 0    /* Jump only over condition */
 					// user did not want to check condition, so just
 					// copy all changeables to result
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getCondition()->getCgbList());
 #else    /* Jump over whole condition */
 					/* Finish debugging this selection */
 					sn->setDbgInternalState(DBG_STATE_SELECTION_UNSET);
 					/* copy changeables */
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getCondition()->getCgbList());
 					// Check if condition emitted a vertex
 					if (node->getCondition()->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->getCondition()->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 
 					if (node->getTrueBlock()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getTrueBlock()->getCgbList());
 						// Check if true block emitted a vertex
 						if (node->getTrueBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTrueBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (node->getFalseBlock()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getFalseBlock()->getCgbList());
 						// Check if false block emitted a vertex
 						if (node->getFalseBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getFalseBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -821,7 +792,7 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 				VPRINT(3, "\t ------- unset target again --------\n");
 				sn->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 
 				if (node->getFalseBlock()) {
 					/* IF ELSE construct */
@@ -829,25 +800,25 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 						/* Finish debugging this selection */
 						sn->setDbgInternalState(DBG_STATE_SELECTION_UNSET);
 						/* copy changeables */
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getTrueBlock()->getCgbList());
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getFalseBlock()->getCgbList());
 						/* Check if condition emitted a vertex */
 						if (node->getTrueBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTrueBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 						if (node->getFalseBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getFalseBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 						return false;
@@ -856,7 +827,7 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 						// check other branch for discards
 						if (node->getTrueBlock()
 								&& node->getTrueBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					} else {
@@ -864,7 +835,7 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 						// check other branch for discards
 						if (node->getFalseBlock()
 								&& node->getFalseBlock()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -875,15 +846,15 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 						sn->setDbgInternalState(DBG_STATE_SELECTION_UNSET);
 						/* copy changeables */
 						if (node->getTrueBlock()) {
-							copyShChangeableList(&(g.result.cgbls),
+							copyShChangeableList(&(g->result.cgbls),
 									node->getTrueBlock()->getCgbList());
 							/* Check if condition emitted a vertex */
 							if (node->getTrueBlock()->containsEmitVertex()) {
-								g.result.passedEmitVertex = true;
+								g->result.passedEmitVertex = true;
 								VPRINT(6, "passed Emit %i\n", __LINE__);
 							}
 							if (node->getTrueBlock()->containsDiscard()) {
-								g.result.passedDiscard = true;
+								g->result.passedDiscard = true;
 								VPRINT(6, "passed Discard %i\n", __LINE__);
 							}
 						}
@@ -911,12 +882,12 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 				oit->operation = OTOpDone;
 				sn->setDbgInternalState(DBG_STATE_SELECTION_INIT);
 				if (node->getAsSelectionNode()->getFalseBlock()) {
-					g.result.position = DBG_RS_POSITION_SELECTION_IF_ELSE;
-					g.result.range = setDbgResultRange(node->getRange());
+					g->result.position = DBG_RS_POSITION_SELECTION_IF_ELSE;
+					g->result.range = setDbgResultRange(node->getRange());
 					setGobalScope(node->getScope());
 				} else {
-					g.result.position = DBG_RS_POSITION_SELECTION_IF;
-					g.result.range = setDbgResultRange(node->getRange());
+					g->result.position = DBG_RS_POSITION_SELECTION_IF;
+					g->result.range = setDbgResultRange(node->getRange());
 					setGobalScope(node->getScope());
 				}
 				return false;
@@ -926,12 +897,12 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 				oit->operation = OTOpDone;
 				sn->setDbgInternalState(DBG_STATE_SELECTION_CONDITION_PASSED);
 				if (node->getAsSelectionNode()->getFalseBlock()) {
-					g.result.position =
+					g->result.position =
 							DBG_RS_POSITION_SELECTION_IF_ELSE_CHOOSE;
 				} else {
-					g.result.position = DBG_RS_POSITION_SELECTION_IF_CHOOSE;
+					g->result.position = DBG_RS_POSITION_SELECTION_IF_CHOOSE;
 				}
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 				return false;
 			case DBG_STATE_SELECTION_IF:
@@ -942,22 +913,22 @@ static bool TraverseSelection(bool /* preVisit */, TIntermSelection* node,
 				// it's changeables!
 				if (sn->getDbgInternalState() == DBG_STATE_SELECTION_IF) {
 					if (node->getAsSelectionNode()->getFalseBlock()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getFalseBlock()->getCgbList());
 						/* Check if false block emitted a vertex */
 						if (node->getFalseBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 					}
 				} else {
 					if (node->getAsSelectionNode()->getTrueBlock()) {
 
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getTrueBlock()->getCgbList());
 						/* Check if true block emitted a vertex */
 						if (node->getTrueBlock()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 					}
@@ -1060,7 +1031,7 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				ln->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
 				ln->setDbgInternalState(DBG_STATE_LOOP_WRK_INIT);
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 				if (oit->dbgBehaviour & DBG_BH_JUMPINTO) {
 					// visit initialization
 					node->getInit()->traverse(it);
@@ -1070,15 +1041,15 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 						// changeables; it's unlikely that there is a
 						// changeable and no target, but anyway be on the
 						// safe side
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getInit()->getCgbList());
 						/* Check if init emitted a vertex */
 						if (node->getInit()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getInit()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -1086,7 +1057,7 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 #if 0    /* Jump only over loop */
 					// user did not want to check initialization, so just
 					// copy all changeables to result
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getInit()->getCgbList());
 #else    /* Jump over whole loop */
 					/* Finish debugging this loop */
@@ -1094,53 +1065,53 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 					ln->setDbgIter(0);
 
 					/* Copy all changeables from condition, test, body, terminal */
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getInit()->getCgbList());
 					/* Check if init emitted a vertex */
 					if (node->getInit()->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->getInit()->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 					if (ln->getTest()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTest()->getCgbList());
 						/* Check if test emitted a vertex */
 						if (ln->getTest()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTest()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getBody()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getBody()->getCgbList());
 						/* Check if body emitted a vertex */
 						if (ln->getBody()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getBody()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getTerminal()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTerminal()->getCgbList());
 						/* Check if terminal emitted a vertex */
 						if (ln->getTerminal()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTerminal()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -1153,28 +1124,28 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				ln->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
 				ln->setDbgInternalState(DBG_STATE_LOOP_WRK_TEST);
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 				if (oit->dbgBehaviour & DBG_BH_JUMPINTO) {
 					// visit test
 					node->getTest()->traverse(it);
 
 					if (oit->operation == OTOpTargetSet) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getTest()->getCgbList());
 						/* Check if condition emitted a vertex */
 						if (node->getTest()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTest()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 				} else {
 #if 0    /* Jump only over test */
 					// do not visit test
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getTest()->getCgbList());
 #else    /* Jump over whole loop */
 					/* Finish debugging this loop */
@@ -1183,41 +1154,41 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 
 					/* Copy all changeables from test, body, terminal */
 					if (ln->getTest()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTest()->getCgbList());
 						/* Check if test emitted a vertex */
 						if (ln->getTest()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTest()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getBody()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getBody()->getCgbList());
 						/* Check if body emitted a vertex */
 						if (ln->getBody()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getBody()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getTerminal()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTerminal()->getCgbList());
 						/* Check if terminal emitted a vertex */
 						if (ln->getTerminal()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTerminal()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -1228,7 +1199,7 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				VPRINT(3, "\t ------- unset target again --------\n");
 				ln->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 
 				if (oit->dbgBehaviour & DBG_BH_SELECTION_JUMP_OVER) {
 					/* Finish debugging this loop */
@@ -1238,41 +1209,41 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 					/* Copy all changeables from
 					 * test, body, terminal */
 					if (ln->getTest()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTest()->getCgbList());
 						/* Check if test emitted a vertex */
 						if (ln->getTest()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTest()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getBody()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getBody()->getCgbList());
 						/* Check if body emitted a vertex */
 						if (ln->getBody()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getBody()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getTerminal()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTerminal()->getCgbList());
 						/* Check if terminal emitted a vertex */
 						if (ln->getTerminal()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTerminal()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -1296,53 +1267,53 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 					oit->operation = OTOpDone;
 
 					/* Build result struct */
-					g.result.position = DBG_RS_POSITION_LOOP_CHOOSE;
+					g->result.position = DBG_RS_POSITION_LOOP_CHOOSE;
 					switch (ln->getLoopType()) {
 					case LOOP_FOR:
 					case LOOP_WHILE:
-						g.result.loopIteration = ln->getDbgIter();
+						g->result.loopIteration = ln->getDbgIter();
 						break;
 					case LOOP_DO:
-						g.result.loopIteration = ln->getDbgIter() - 1;
+						g->result.loopIteration = ln->getDbgIter() - 1;
 						break;
 					}
-					g.result.range = setDbgResultRange(node->getRange());
+					g->result.range = setDbgResultRange(node->getRange());
 					if (ln->getTest()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTest()->getCgbList());
 						/* Check if test emitted a vertex */
 						if (ln->getTest()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTest()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getBody()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getBody()->getCgbList());
 						/* Check if body emitted a vertex */
 						if (ln->getBody()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getBody()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 					if (ln->getTerminal()) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								ln->getTerminal()->getCgbList());
 						/* Check if terminal emitted a vertex */
 						if (ln->getTerminal()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTerminal()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
@@ -1357,35 +1328,35 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				ln->setDebugState(DbgStNone);
 				oit->operation = OTOpTargetSet;
 				ln->setDbgInternalState(DBG_STATE_LOOP_WRK_TERMINAL);
-				g.result.position = DBG_RS_POSITION_UNSET;
+				g->result.position = DBG_RS_POSITION_UNSET;
 				if (oit->dbgBehaviour & DBG_BH_JUMPINTO) {
 					// visit terminal
 					node->getTerminal()->traverse(it);
 
 					if (oit->operation == OTOpTargetSet) {
-						copyShChangeableList(&(g.result.cgbls),
+						copyShChangeableList(&(g->result.cgbls),
 								node->getTerminal()->getCgbList());
 						/* Check if terminal emitted a vertex */
 						if (node->getTerminal()->containsEmitVertex()) {
-							g.result.passedEmitVertex = true;
+							g->result.passedEmitVertex = true;
 							VPRINT(6, "passed Emit %i\n", __LINE__);
 						}
 						if (node->getTerminal()->containsDiscard()) {
-							g.result.passedDiscard = true;
+							g->result.passedDiscard = true;
 							VPRINT(6, "passed Discard %i\n", __LINE__);
 						}
 					}
 				} else {
 					// do not visit terminal
-					copyShChangeableList(&(g.result.cgbls),
+					copyShChangeableList(&(g->result.cgbls),
 							node->getTerminal()->getCgbList());
 					/* Check if test emitted a vertex */
 					if (node->getTerminal()->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->getTerminal()->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 				}
@@ -1410,16 +1381,16 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 					oit->operation = OTOpDone;
 					if (ln->getInit()) {
 						ln->setDbgInternalState(DBG_STATE_LOOP_QYR_INIT);
-						g.result.position = setPositionLoop(ln->getLoopType());
+						g->result.position = setPositionLoop(ln->getLoopType());
 					} else if (ln->getTest()) {
 						ln->setDbgInternalState(DBG_STATE_LOOP_QYR_TEST);
-						g.result.position = setPositionLoop(ln->getLoopType());
+						g->result.position = setPositionLoop(ln->getLoopType());
 					} else {
 						ln->setDbgInternalState(DBG_STATE_LOOP_SELECT_FLOW);
-						g.result.position = DBG_RS_POSITION_LOOP_CHOOSE;
-						g.result.loopIteration = ln->getDbgIter();
+						g->result.position = DBG_RS_POSITION_LOOP_CHOOSE;
+						g->result.loopIteration = ln->getDbgIter();
 					}
-					g.result.range = setDbgResultRange(node->getRange());
+					g->result.range = setDbgResultRange(node->getRange());
 					setGobalScope(node->getScope());
 					return false;
 				case LOOP_DO:
@@ -1437,8 +1408,8 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				} else {
 					ln->setDbgInternalState(DBG_STATE_LOOP_SELECT_FLOW);
 				}
-				g.result.position = DBG_RS_POSITION_LOOP_FOR;
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.position = DBG_RS_POSITION_LOOP_FOR;
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 				return false;
 			case DBG_STATE_LOOP_WRK_TEST:
@@ -1446,17 +1417,17 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				node->setDebugState(DbgStTarget);
 				oit->operation = OTOpDone;
 				ln->setDbgInternalState(DBG_STATE_LOOP_SELECT_FLOW);
-				g.result.position = DBG_RS_POSITION_LOOP_CHOOSE;
+				g->result.position = DBG_RS_POSITION_LOOP_CHOOSE;
 				switch (ln->getLoopType()) {
 				case LOOP_FOR:
 				case LOOP_WHILE:
-					g.result.loopIteration = ln->getDbgIter();
+					g->result.loopIteration = ln->getDbgIter();
 					break;
 				case LOOP_DO:
-					g.result.loopIteration = ln->getDbgIter() - 1;
+					g->result.loopIteration = ln->getDbgIter() - 1;
 					break;
 				}
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 				return false;
 			case DBG_STATE_LOOP_WRK_BODY:
@@ -1465,28 +1436,28 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				oit->operation = OTOpDone;
 				if (ln->getTerminal()) {
 					ln->setDbgInternalState(DBG_STATE_LOOP_QYR_TERMINAL);
-					g.result.position = setPositionLoop(ln->getLoopType());
+					g->result.position = setPositionLoop(ln->getLoopType());
 				} else if (ln->getTest()) {
 					ln->setDbgInternalState(DBG_STATE_LOOP_QYR_TEST);
-					g.result.position = setPositionLoop(ln->getLoopType());
+					g->result.position = setPositionLoop(ln->getLoopType());
 					/* Increase the loop counter */
 					ln->addDbgIter(1);
 				} else {
 					ln->setDbgInternalState(DBG_STATE_LOOP_SELECT_FLOW);
-					g.result.position = DBG_RS_POSITION_LOOP_CHOOSE;
+					g->result.position = DBG_RS_POSITION_LOOP_CHOOSE;
 					switch (ln->getLoopType()) {
 					case LOOP_FOR:
 					case LOOP_WHILE:
-						g.result.loopIteration = ln->getDbgIter();
+						g->result.loopIteration = ln->getDbgIter();
 						break;
 					case LOOP_DO:
-						g.result.loopIteration = ln->getDbgIter() - 1;
+						g->result.loopIteration = ln->getDbgIter() - 1;
 						break;
 					}
 					/* Increase the loop counter */
 					ln->addDbgIter(1);
 				}
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 				return false;
 			case DBG_STATE_LOOP_WRK_TERMINAL:
@@ -1495,16 +1466,16 @@ static bool TraverseLoop(bool, TIntermLoop* node, TIntermTraverser* it)
 				oit->operation = OTOpDone;
 				if (ln->getTest()) {
 					ln->setDbgInternalState(DBG_STATE_LOOP_QYR_TEST);
-					g.result.position = setPositionLoop(ln->getLoopType());
+					g->result.position = setPositionLoop(ln->getLoopType());
 				} else {
 					ln->setDbgInternalState(DBG_STATE_LOOP_SELECT_FLOW);
-					g.result.position = DBG_RS_POSITION_LOOP_CHOOSE;
-					g.result.loopIteration = ln->getDbgIter();
+					g->result.position = DBG_RS_POSITION_LOOP_CHOOSE;
+					g->result.loopIteration = ln->getDbgIter();
 				}
 				/* Increase the loop counter */
 				ln->addDbgIter(1);
 
-				g.result.range = setDbgResultRange(node->getRange());
+				g->result.range = setDbgResultRange(node->getRange());
 				setGobalScope(node->getScope());
 				return false;
 			default:
@@ -1579,14 +1550,14 @@ static bool TraverseUnary(bool, TIntermUnary* node, TIntermTraverser* it)
 				// user didn't want to debug further
 				// copy all changeables
 				VPRINT(2, "----> copy changeables\n");
-				copyShChangeableList(&(g.result.cgbls), node->getCgbList());
+				copyShChangeableList(&(g->result.cgbls), node->getCgbList());
 				/* Check if node emitted a vertex */
 				if (node->containsEmitVertex()) {
-					g.result.passedEmitVertex = true;
+					g->result.passedEmitVertex = true;
 					VPRINT(6, "passed Emit %i\n", __LINE__);
 				}
 				if (node->containsDiscard()) {
-					g.result.passedDiscard = true;
+					g->result.passedDiscard = true;
 					VPRINT(6, "passed Discard %i\n", __LINE__);
 				}
 			} else {
@@ -1597,14 +1568,14 @@ static bool TraverseUnary(bool, TIntermUnary* node, TIntermTraverser* it)
 				// if the target was not inside operand, all changeables
 				// need to be copied
 				if (oit->operation == OTOpTargetSet) {
-					copyShChangeableList(&(g.result.cgbls), node->getCgbList());
+					copyShChangeableList(&(g->result.cgbls), node->getCgbList());
 					/* Check if node emitted a vertex */
 					if (node->containsEmitVertex()) {
-						g.result.passedEmitVertex = true;
+						g->result.passedEmitVertex = true;
 						VPRINT(6, "passed Emit %i\n", __LINE__);
 					}
 					if (node->containsDiscard()) {
-						g.result.passedDiscard = true;
+						g->result.passedDiscard = true;
 						VPRINT(6, "passed Discard %i\n", __LINE__);
 					}
 				}
@@ -1620,14 +1591,14 @@ static bool TraverseUnary(bool, TIntermUnary* node, TIntermTraverser* it)
 			// if the old target was inside operand but not the new one, add
 			// changeables to global list
 			if (oit->operation == OTOpTargetSet) {
-				copyShChangeableList(&(g.result.cgbls), node->getCgbList());
+				copyShChangeableList(&(g->result.cgbls), node->getCgbList());
 				/* Check if node emitted a vertex */
 				if (node->containsEmitVertex()) {
-					g.result.passedEmitVertex = true;
+					g->result.passedEmitVertex = true;
 					VPRINT(6, "passed Emit %i\n", __LINE__);
 				}
 				if (node->containsDiscard()) {
-					g.result.passedDiscard = true;
+					g->result.passedDiscard = true;
 					VPRINT(6, "passed Discard %i\n", __LINE__);
 				}
 			}
@@ -1677,10 +1648,33 @@ static void TraverseDummy(TIntermDummy* node, TIntermTraverser* it)
 	processDebugable(node, &oit->operation);
 }
 
-void clearTraverseDebugJump(void)
+TDebugJumpState* newDebugJumpState(void)
+{
+	/* value-initialized, i.e. empty scopes and changeables */
+	return new TDebugJumpState();
+}
+
+void deleteDebugJumpState(TDebugJumpState* state)
 {
-	delete g.it;
-	g.it = NULL;
+	if (!state)
+		return;
+
+	clearTraverseDebugJump(state);
+	g = state;
+	clearGlobalScope();
+	clearGlobalScopeStack();
+	clearGlobalChangeables();
+	g = NULL;
+	delete state;
+}
+
+void clearTraverseDebugJump(TDebugJumpState* state)
+{
+	if (!state)
+		return;
+
+	delete state->it;
+	state->it = NULL;
 }
 
 class TScopeStackTraverser: public TIntermTraverser {
@@ -1966,67 +1960,65 @@ static void ScopeStackTraverseDummy(TIntermDummy* node, TIntermTraverser* it)
 //
 //  Generate code from the given parse tree
 //
-DbgResult* TTraverseDebugJump::process(TIntermNode *root)
+DbgResult* TTraverseDebugJump::process(TIntermNode *root,
+		TDebugJumpState *state)
 {
-	/* Setup scope if neccessary */
-	initGlobalScope();
-	initGlobalScopeStack();
-	initGlobalChangeables();
+	g = state;
 
-	g.result.range.left.line = 0;
-	g.result.range.left.colum = 0;
-	g.result.range.right.line = 0;
-	g.result.range.right.colum = 0;
+	g->result.range.left.line = 0;
+	g->result.range.left.colum = 0;
+	g->result.range.right.line = 0;
+	g->result.range.right.colum = 0;
 
 	/* Check for empty parse tree */
 	if (root == 0) {
-		g.result.status = DBG_RS_STATUS_ERROR;
-		g.result.position = DBG_RS_POSITION_UNSET;
+		g->result.status = DBG_RS_STATUS_ERROR;
+		g->result.position = DBG_RS_POSITION_UNSET;
 		clearGlobalScope();
 		clearGlobalScopeStack();
 		clearGlobalChangeables();
-		return &g.result;
+		return &g->result;
 	}
 
 	/* Check validity of debug request */
 
-	g.result.status = DBG_RS_STATUS_UNSET;
-	g.result.position = DBG_RS_POSITION_UNSET;
-	g.result.loopIteration = 0;
-	g.result.passedEmitVertex = false;
-	g.result.passedDiscard = false;
+	g->result.status = DBG_RS_STATUS_UNSET;
+	g->result.position = DBG_RS_POSITION_UNSET;
+	g->result.loopIteration = 0;
+	g->result.passedEmitVertex = false;
+	g->result.passedDiscard = false;
 
 	clearGlobalScope();
 	clearGlobalScopeStack();
 	clearGlobalChangeables();
 
-	if (!g.it) {
-		g.it = new TOutputDebugJumpTraverser(infoSink, m_debugProgram);
+	if (!g->it) {
+		g->it = new TOutputDebugJumpTraverser(infoSink, m_debugProgram);
 	}
 
-	g.it->root = root;
-
-	g.it->preVisit = false;
-	g.it->postVisit = false;
-	g.it->debugVisit = true;
-	g.it->rightToLeft = false;
-
-	g.it->dbgBehaviour = dbgBehaviour;
-
-	g.it->visitAggregate = TraverseAggregate;
-	g.it->visitBinary = TraverseBinary;
-	g.it->visitConstantUnion = 0;
-	g.it->visitSelection = TraverseSelection;
-	g.it->visitLoop = TraverseLoop;
-	g.it->visitSymbol = 0;
-	g.it->visitFuncParam = 0;
-	g.it->visitUnary = TraverseUnary;
-	g.it->visitBranch = TraverseBranch;
-	g.it->visitDeclaration = TraverseDeclaration;
-	g.it->visitFuncDeclaration = 0;
-	g.it->visitSpecification = 0;
-	g.it->visitParameter = 0;
-	g.it->visitDummy = TraverseDummy;
+	g->it->root = root;
+
+	g->it->preVisit = false;
+	g->it->postVisit = false;
+	g->it->debugVisit = true;
+	g->it->rightToLeft = false;
+
+	g->it->dbgBehaviour = dbgBehaviour;
+
+	g->it->visitAggregate = TraverseAggregate;
+	g->it->visitBinary = TraverseBinary;
+	g->it->visitConstantUnion = 0;
+	g->it->visitSelection = TraverseSelection;
+	g->it->visitLoop = TraverseLoop;
+	g->it->visitSymbol = 0;
+	g->it->visitFuncParam = 0;
+	g->it->visitUnary = TraverseUnary;
+	g->it->visitBranch = TraverseBranch;
+	g->it->visitDeclaration = TraverseDeclaration;
+	g->it->visitFuncDeclaration = 0;
+	g->it->visitSpecification = 0;
+	g->it->visitParameter = 0;
+	g->it->visitDummy = TraverseDummy;
 
 	m_debugProgram = "";
 
@@ -2034,56 +2026,56 @@ DbgResult* TTraverseDebugJump::process(TIntermNode *root)
 	if (dbgBehaviour != DBG_BH_RESET
 			&& root->getDebugState() == DbgStFinished) {
 		VPRINT(1, "!!! debugging already finished !!!\n");
-		g.result.status = DBG_RS_STATUS_FINISHED;
-		return &g.result;
+		g->result.status = DBG_RS_STATUS_FINISHED;
+		return &g->result;
 	}
 
 	/* In case of a reset clear DbgStates and empty stack */
 	if (dbgBehaviour == DBG_BH_RESET) {
-		g.it->operation = OTOpReset;
-		while (!(g.it->parseStack.empty())) {
-			g.it->parseStack.pop();
+		g->it->operation = OTOpReset;
+		while (!(g->it->parseStack.empty())) {
+			g->it->parseStack.pop();
 		}
 		VPRINT(1, "********* reset traverse **********\n");
-		root->traverse(g.it);
+		root->traverse(g->it);
 		return NULL;
 	}
 
 	/* Clear debug path, i.e remove all DbgStPath */
-	g.it->operation = OTOpPathClear;
+	g->it->operation = OTOpPathClear;
 	VPRINT(1, "********* clear path traverse **********\n");
-	root->traverse(g.it);
+	root->traverse(g->it);
 
 	/* Initialize parsetree for debugging if necessary */
-	g.it->operation = OTOpTargetUnset;
-	if (g.it->parseStack.empty()) {
+	g->it->operation = OTOpTargetUnset;
+	if (g->it->parseStack.empty()) {
 		TIntermNode *main;
 		main = getFunctionBySignature(MAIN_FUNC_SIGNATURE, root);
 		if (!main) {
-			g.result.status = DBG_RS_STATUS_ERROR;
-			return &g.result;
+			g->result.status = DBG_RS_STATUS_ERROR;
+			return &g->result;
 		}
-		g.it->operation = OTOpTargetSet;
-		g.it->parseStack.push(main);
+		g->it->operation = OTOpTargetSet;
+		g->it->parseStack.push(main);
 	}
 
 	/* Advance the debug trace; move DbgStTarget */
 	VPRINT(1, "********* jump traverse **********\n");
-	g.it->parseStack.top()->traverse(g.it);
+	g->it->parseStack.top()->traverse(g->it);
 
-	if (g.it->operation == OTOpFinished) {
+	if (g->it->operation == OTOpFinished) {
 		/* Debugging finished at the end of the code */
 		root->setDebugState(DbgStFinished);
-		g.result.status = DBG_RS_STATUS_FINISHED;
-		return &g.result;
+		g->result.status = DBG_RS_STATUS_FINISHED;
+		return &g->result;
 	} else {
 		/* Build up new debug path; all DbgStPath */
-		g.it->operation = OTOpPathBuild;
-		g.it->preVisit = false;
-		g.it->postVisit = true;
-		g.it->debugVisit = false;
+		g->it->operation = OTOpPathBuild;
+		g->it->preVisit = false;
+		g->it->postVisit = true;
+		g->it->debugVisit = false;
 		VPRINT(1, "********* create path traverse **********\n");
-		root->traverse(g.it);
+		root->traverse(g->it);
 	}
 
 	TScopeStackTraverser itScopeStack;
@@ -2110,7 +2102,7 @@ DbgResult* TTraverseDebugJump::process(TIntermNode *root)
 
 	root->traverse(&itScopeStack);
 
-	g.result.status = DBG_RS_STATUS_OK;
-	return &g.result;
+	g->result.status = DBG_RS_STATUS_OK;
+	return &g->result;
 }
 
@@ -3286,6 +3286,35 @@ bool TGenericCompiler::compileDbg(TIntermNode* root, ShChangeableList *cgbl,
 		cgInit(CG_TYPE_RESULT, &ret, vl, language);
 	}
 		break;
+	case DBG_CG_CHANGEABLE:
+		if (cgbl->numChangeables > 1) {
+			/* several watch items packed into one result, one component
+			 * each */
+			int i;
+			ShVariable ret;
+			ret.uniqueId = -1;
+			ret.builtin = 0;
+			ret.name = NULL;
+			ret.size = cgbl->numChangeables;
+			ret.isMatrix = 0;
+			ret.isArray = 0;
+			for (i = 0; i < MAX_ARRAYS; i++) {
+				ret.arraySize[i] = 0;
+			}
+			ret.structName = NULL;
+			ret.structSize = 0;
+			ret.structSpec = NULL;
+			ret.type = SH_FLOAT;
+			if (language == EShLangFragment) {
+				ret.qualifier = SH_TEMPORARY;
+			} else {
+				ret.qualifier = SH_VARYING_OUT;
+			}
+			cgInit(CG_TYPE_RESULT, &ret, vl, language);
+		} else {
+			cgInit(CG_TYPE_RESULT, NULL, vl, language);
+		}
+		break;
 	default:
 		cgInit(CG_TYPE_RESULT, NULL, vl, language);
 		break;
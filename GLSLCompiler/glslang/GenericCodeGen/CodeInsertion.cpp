@@ -363,6 +363,22 @@ void cgAddInitialization(cgTypes type, cgInitialization init, TString &prog,
 	prog += ")";
 }
 
+/* components of the fragment output written by the result; packed watch
+ * items use more than the red channel */
+static const char* getOutputSwizzle(ShVariable *v)
+{
+	switch (v->size) {
+	case 2:
+		return "xy";
+	case 3:
+		return "xyz";
+	case 4:
+		return "xyzw";
+	default:
+		return "x";
+	}
+}
+
 void cgAddOutput(cgTypes type, TString &prog, EShLanguage l, TQualifier o)
 {
 	/* TODO: fill out other possibilities */
@@ -385,18 +401,19 @@ void cgAddOutput(cgTypes type, TString &prog, EShLanguage l, TQualifier o)
 		case CG_TYPE_RESULT:
 			switch (o) {
 			case EvqFragColor:
-				prog += "gl_FragColor.x";
+				prog += "gl_FragColor.";
 				break;
 			case EvqFragData:
-				prog += "gl_FragData[0].x";
+				prog += "gl_FragData[0].";
 				break;
 			default:
 				dbgPrint(DBGLVL_WARNING,
 						"CodeInsertion - no valid output method set for fragment program.\n");
 				dbgPrint(DBGLVL_WARNING,
 						"CodeInsertion - assume gl_FragColor for further usage.\n");
-				prog += "gl_FragColor.x";
+				prog += "gl_FragColor.";
 			}
+			prog += getOutputSwizzle(g.result);
 			prog += " = ";
 			prog += g.result->name;
 			prog += ";\n";
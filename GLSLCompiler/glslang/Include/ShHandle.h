@@ -52,6 +52,7 @@
 
 class TCompiler;
 class TLinker;
+struct TDebugJumpState;
 class TUniformMap;
 struct TParseContext;
 
@@ -113,7 +114,7 @@ class TCompiler: public TShHandleBase {
 public:
 	TCompiler(EShLanguage l, TInfoSink& sink) :
 			infoSink(sink), language(l), haveValidObjectCode(false), parseContext(
-					NULL)
+					NULL), debugJumpState(NULL)
 	{
 	}
 	virtual ~TCompiler();
@@ -150,19 +151,25 @@ public:
 	{
 		parseContext = pC;
 	}
+
+	/* Position of ShDebugJumpToNext, every handle steps on its own */
+	TDebugJumpState* getDebugJumpState();
 protected:
 	EShLanguage language;
 	bool haveValidObjectCode;
 
 	/* Store TParseContext for further usage */
 	TParseContext* parseContext;
+	TDebugJumpState* debugJumpState;
 };
 
 //
 //
 //
 //
-void clearTraverseDebugJump(void);
+TDebugJumpState* newDebugJumpState(void);
+void deleteDebugJumpState(TDebugJumpState* state);
+void clearTraverseDebugJump(TDebugJumpState* state);
 
 class TTraverseDebugJump: public TCompiler {
 public:
@@ -170,7 +177,8 @@ public:
 			TCompiler(l, infoSink), debugOptions(dOptions), dbgBehaviour(dbgBh)
 	{
 	}
-	DbgResult* process(TIntermNode* root);
+	/* the result belongs to state */
+	DbgResult* process(TIntermNode* root, TDebugJumpState* state);
 	bool compile(TIntermNode* root)
 	{
 		UNUSED_ARG(root)
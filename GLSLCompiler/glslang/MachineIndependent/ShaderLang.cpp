@@ -59,6 +59,22 @@
 TSymbolTable SymbolTables[EShLangCount];
 
 TPoolAllocator* PerProcessGPA = 0;
+
+//
+// The built-in level on top of those, which depends on the resource limits,
+// is parsed once per language and TBuiltInResource contents. The cached
+// levels live in their own pool until ShFinalize and are shared read-only
+// by all compiles using the same limits.
+//
+struct TBuiltInLevelCacheEntry {
+	EShLanguage language;
+	TBuiltInResource resources;
+	TSymbolTableLevel* level;
+	int maxSymbolId;
+};
+
+static std::vector<TBuiltInLevelCacheEntry> BuiltInLevelCache;
+static TPoolAllocator* BuiltInCacheGPA = 0;
 //
 // This is the platform independent interface between an OGL driver
 // and the shading language compiler/linker.
@@ -769,32 +785,16 @@ int ShInitialize()
 	// we need to have thread synchronization code around the initialization of per process
 	// global pool allocator
 	if (!PerProcessGPA) {
-		TPoolAllocator *builtInPoolAllocator = new TPoolAllocator(true);
-		builtInPoolAllocator->push();
-		TPoolAllocator* gPoolAllocator = &GlobalPoolAllocator;
-		SetGlobalPoolAllocatorPtr(builtInPoolAllocator);
-
-		TSymbolTable symTables[EShLangCount];
-
-		GenerateBuiltInSymbolTable(0, infoSink, symTables);
-
 		PerProcessGPA = new TPoolAllocator(true);
 		PerProcessGPA->push();
+		TPoolAllocator* gPoolAllocator = &GlobalPoolAllocator;
 		SetGlobalPoolAllocatorPtr(PerProcessGPA);
 
-		SymbolTables[EShLangVertex].copyTable(symTables[EShLangVertex]);
-		SymbolTables[EShLangGeometry].copyTable(symTables[EShLangGeometry]);
-		SymbolTables[EShLangFragment].copyTable(symTables[EShLangFragment]);
+		// Parse the built-ins straight into the per process pool, cloning
+		// them out of a temporary pool only took time.
+		GenerateBuiltInSymbolTable(0, infoSink, SymbolTables);
 
 		SetGlobalPoolAllocatorPtr(gPoolAllocator);
-
-		symTables[EShLangVertex].pop();
-		symTables[EShLangGeometry].pop();
-		symTables[EShLangFragment].pop();
-
-		builtInPoolAllocator->popAll();
-		delete builtInPoolAllocator;
-
 	}
 
 	return ret ? 1 : 0;
@@ -840,6 +840,14 @@ ShHandle ShConstructUniformMap()
 TCompiler::~TCompiler()
 {
 	delete parseContext;
+	deleteDebugJumpState(debugJumpState);
+}
+
+TDebugJumpState* TCompiler::getDebugJumpState()
+{
+	if (!debugJumpState)
+		debugJumpState = newDebugJumpState();
+	return debugJumpState;
 }
 
 void ShDestruct(ShHandle handle)
@@ -887,6 +895,13 @@ void ShDestruct(ShHandle handle)
 //
 int __fastcall ShFinalize()
 {
+	BuiltInLevelCache.clear();
+	if (BuiltInCacheGPA) {
+		BuiltInCacheGPA->popAll();
+		delete BuiltInCacheGPA;
+		BuiltInCacheGPA = 0;
+	}
+
 	if (PerProcessGPA) {
 		PerProcessGPA->popAll();
 		delete PerProcessGPA;
@@ -903,8 +918,8 @@ bool GenerateBuiltInSymbolTable(const TBuiltInResource* resources,
 
 	if (resources) {
 		builtIns.initialize(*resources);
-		InitializeSymbolTable(builtIns.getBuiltInStrings(), language, infoSink,
-				resources, symbolTables);
+		return InitializeSymbolTable(builtIns.getBuiltInStrings(), language,
+				infoSink, resources, symbolTables);
 	} else {
 		builtIns.initialize();
 		dbgPrint(DBGLVL_COMPILERINFO,
@@ -993,6 +1008,51 @@ bool InitializeSymbolTable(TBuiltInStrings* BuiltInStrings,
 	return true;
 }
 
+//
+// Push the built-in level for the given resource limits on top of the shared
+// built-ins of symbolTable. It is looked up in the cache first, otherwise
+// parsed into the cache pool.
+//
+static bool PushBuiltInLevel(EShLanguage language,
+		const TBuiltInResource* resources, TInfoSink& infoSink,
+		TSymbolTable& symbolTable)
+{
+	std::vector<TBuiltInLevelCacheEntry>::iterator it;
+	for (it = BuiltInLevelCache.begin(); it != BuiltInLevelCache.end(); ++it) {
+		if (it->language == language
+				&& !memcmp(&it->resources, resources, sizeof(TBuiltInResource))) {
+			symbolTable.pushShared(it->level, it->maxSymbolId);
+			return true;
+		}
+	}
+
+	if (!BuiltInCacheGPA) {
+		BuiltInCacheGPA = new TPoolAllocator(true);
+		BuiltInCacheGPA->push();
+	}
+	TPoolAllocator* gPoolAllocator = &GlobalPoolAllocator;
+	SetGlobalPoolAllocatorPtr(BuiltInCacheGPA);
+
+	TBuiltInLevelCacheEntry entry;
+	TSymbolTable builtInTable(SymbolTables[language]);
+	bool success = GenerateBuiltInSymbolTable(resources, infoSink,
+			&builtInTable, language);
+	entry.language = language;
+	memcpy(&entry.resources, resources, sizeof(TBuiltInResource));
+	entry.maxSymbolId = builtInTable.getMaxSymbolId();
+	entry.level = builtInTable.releaseLevel();
+
+	SetGlobalPoolAllocatorPtr(gPoolAllocator);
+
+	// A level that failed to parse is used once, but not cached, so that
+	// the next compile reports the error again.
+	if (success)
+		BuiltInLevelCache.push_back(entry);
+	symbolTable.pushShared(entry.level, entry.maxSymbolId);
+
+	return success;
+}
+
 //
 // Do an actual compile on the given strings.  The result is left
 // in the given compile object.
@@ -1012,7 +1072,8 @@ int ShCompile(const ShHandle handle, const char* const shaderStrings[],
 	if (compiler == 0)
 		return 0;
 
-	clearTraverseDebugJump();
+	/* the stack of the last jump points into the old tree */
+	clearTraverseDebugJump(compiler->getDebugJumpState());
 
 	GlobalPoolAllocator.push();
 	compiler->infoSink.info.erase();
@@ -1027,8 +1088,8 @@ int ShCompile(const ShHandle handle, const char* const shaderStrings[],
 	TIntermediate intermediate(compiler->infoSink);
 	TSymbolTable symbolTable(SymbolTables[compiler->getLanguage()]);
 
-	GenerateBuiltInSymbolTable(resources, compiler->infoSink, &symbolTable,
-			compiler->getLanguage());
+	PushBuiltInLevel(compiler->getLanguage(), resources, compiler->infoSink,
+			symbolTable);
 
 	TBuiltInResource* rs = new TBuiltInResource;
 	memcpy(rs, resources, sizeof(TBuiltInResource));
@@ -1168,7 +1229,8 @@ DbgResult* ShDebugJumpToNext(const ShHandle handle, int debugOptions, int dbgBh)
 	TCompiler* traverser = ConstructTraverseDebugJump(compiler->getLanguage(),
 			debugOptions, dbgBh);
 
-	result = ((TTraverseDebugJump*) traverser)->process(parseContext->treeRoot);
+	result = ((TTraverseDebugJump*) traverser)->process(parseContext->treeRoot,
+			compiler->getDebugJumpState());
 
 	TIntermediate intermediate(compiler->infoSink);
 	intermediate.outputTree(parseContext->treeRoot);
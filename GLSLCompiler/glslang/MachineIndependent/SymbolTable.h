@@ -373,7 +373,7 @@ protected:
 class TSymbolTable {
 public:
 	TSymbolTable() :
-			uniqueId(0)
+			uniqueId(0), sharedLevels(0)
 	{
 		//
 		// The symbol table cannot be used until push() is called, but
@@ -386,6 +386,7 @@ public:
 	{
 		table.push_back(symTable.table[0]);
 		uniqueId = symTable.uniqueId;
+		sharedLevels = 1;
 	}
 
 	~TSymbolTable()
@@ -421,10 +422,36 @@ public:
 		table.push_back(new TSymbolTableLevel);
 	}
 
+	//
+	// Levels shared with other symbol tables, like the cached built-in
+	// levels, are only unlinked by pop(), never deleted.
+	//
+	void pushShared(TSymbolTableLevel* level, int maxSymbolId)
+	{
+		assert(table.size() == (unsigned int) sharedLevels);
+		table.push_back(level);
+		uniqueId = maxSymbolId;
+		sharedLevels++;
+	}
+
 	void pop()
 	{
-		delete table[currentLevel()];
+		if (currentLevel() < sharedLevels)
+			sharedLevels = currentLevel();
+		else
+			delete table[currentLevel()];
+		table.pop_back();
+	}
+
+	//
+	// Take the current level out of the table without deleting it, the
+	// caller owns it afterwards.
+	//
+	TSymbolTableLevel* releaseLevel()
+	{
+		TSymbolTableLevel* level = table[currentLevel()];
 		table.pop_back();
+		return level;
 	}
 
 	bool insert(TSymbol& symbol)
@@ -485,6 +512,7 @@ protected:
 
 	std::vector<TSymbolTableLevel*> table;
 	int uniqueId;     // for unique identification in code generation
+	int sharedLevels; // bottom levels not owned by this table
 };
 
 #endif // _SYMBOL_TABLE_INCLUDED_
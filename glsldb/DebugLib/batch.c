@@ -0,0 +1,176 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+#include <stdlib.h>
+
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "batch.h"
+#include "readback.h"
+#include "dbgprint.h"
+
+/* only operations that are handled by executeDefaultDbgOperation can be
+ * batched, everything else needs the function hook
+ */
+static int isBatchable(ALIGNED_DATA op)
+{
+	switch (op) {
+	case DBG_ALLOC_MEM:
+	case DBG_FREE_MEM:
+	case DBG_READ_RENDER_BUFFER:
+	case DBG_CLEAR_RENDER_BUFFER:
+	case DBG_SET_DBG_TARGET:
+	case DBG_RESTORE_RENDER_TARGET:
+	case DBG_START_RECORDING:
+	case DBG_REPLAY:
+	case DBG_END_REPLAY:
+	case DBG_STORE_ACTIVE_SHADER:
+	case DBG_RESTORE_ACTIVE_SHADER:
+	case DBG_SET_DBG_SHADER:
+	case DBG_GET_SHADER_CODE:
+	case DBG_SHADER_STEP:
+	case DBG_SAVE_AND_INTERRUPT_QUERIES:
+	case DBG_RESTART_QUERIES:
+	case DBG_GET_DBG_SHADER_CACHE_STATS:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* returns the size of the sub-command list or -1 if it is malformed */
+static long validateBatch(DbgRec *rec)
+{
+	char *end = (char*) &rec->items[SHM_MAX_ITEMS];
+	DbgBatchCmd *cmd = DBG_BATCH_FIRST(rec->items);
+	ALIGNED_DATA i;
+
+	if (rec->items[1] < 0) {
+		return -1;
+	}
+	for (i = 0; i < rec->items[1]; i++) {
+		if ((char*) (cmd + 1) > end || cmd->numSlots < 0
+				|| cmd->numSlots > DBG_BATCH_MAX_SLOTS || cmd->dataSize < 0
+				|| cmd->dataSize != (ALIGNED_DATA) DBG_BATCH_PAD(cmd->dataSize)
+				|| cmd->dataSize > end - DBG_BATCH_CMD_DATA(cmd)) {
+			dbgPrint(DBGLVL_ERROR, "executeBatch: sub-command %li corrupt\n",
+					(long)i);
+			return -1;
+		}
+		if (!isBatchable(cmd->operation)) {
+			dbgPrint(DBGLVL_ERROR,
+					"executeBatch: operation %li cannot be batched\n",
+					(long)cmd->operation);
+			return -1;
+		}
+		cmd = DBG_BATCH_NEXT(cmd);
+	}
+	return (char*) cmd - (char*) DBG_BATCH_FIRST(rec->items);
+}
+
+void executeBatch(void)
+{
+	DbgRec *rec = getThreadRecord();
+	ALIGNED_DATA numCommands = rec->items[1];
+	ALIGNED_DATA executed = 0;
+	ALIGNED_DATA *items;
+	DbgBatchCmd *batch, *cmd;
+	long size;
+	int error = DBG_NO_ERROR;
+	int readBackError;
+	int i;
+
+	size = validateBatch(rec);
+	if (size < 0) {
+		rec->items[2] = 0;
+		setErrorCode(DBG_ERROR_INVALID_VALUE);
+		return;
+	}
+
+	/* the handlers use rec->items themselves, so work on a private copy */
+	if (!(batch = (DbgBatchCmd*) malloc(size ? size : 1))) {
+		rec->items[2] = 0;
+		setErrorCode(DBG_ERROR_MEMORY_ALLOCATION_FAILED);
+		return;
+	}
+	memcpy(batch, DBG_BATCH_FIRST(rec->items), size);
+
+	beginReadBackQueue();
+	for (cmd = batch; executed < numCommands; cmd = DBG_BATCH_NEXT(cmd)) {
+		items = DBG_BATCH_CMD_ITEMS(cmd);
+		rec->operation = cmd->operation;
+		rec->numItems = cmd->numSlots;
+		/* unused parameters, e.g. DBG_INLINE_SOURCES, read as 0 */
+		memset(rec->items, 0, DBG_BATCH_MAX_SLOTS * sizeof(ALIGNED_DATA));
+		for (i = 0; i < cmd->numSlots; i++) {
+			if (i < (int) (8 * sizeof(ALIGNED_DATA))
+					&& (cmd->relocate & ((ALIGNED_DATA) 1 << i))) {
+				rec->items[i] = (ALIGNED_DATA) (DBG_BATCH_CMD_DATA(cmd)
+						+ items[i]);
+			} else {
+				rec->items[i] = items[i];
+			}
+		}
+
+		setReadBackQueueTarget(&cmd->result, items);
+		executeDefaultDbgOperation(cmd->operation);
+
+		cmd->result = rec->result;
+		cmd->numItems = rec->numItems;
+		memcpy(items, rec->items, cmd->numSlots * sizeof(ALIGNED_DATA));
+		executed++;
+		if (rec->result == DBG_ERROR_CODE && rec->items[0] != DBG_NO_ERROR) {
+			error = (int) rec->items[0];
+			break;
+		}
+	}
+	/* fragment shader steps only started their readbacks */
+	readBackError = endReadBackQueue();
+	if (error == DBG_NO_ERROR) {
+		error = readBackError;
+	}
+
+	memcpy(DBG_BATCH_FIRST(rec->items), batch, size);
+	free(batch);
+	rec->operation = DBG_BATCH;
+	rec->numItems = 3;
+	rec->items[1] = numCommands;
+	rec->items[2] = executed;
+	setErrorCode(error);
+}
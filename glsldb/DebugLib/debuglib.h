@@ -53,6 +53,8 @@ WINGDIAPI DWORD WINAPI wglSwapMultipleBuffers(UINT, CONST WGLSWAP *);
 
 #include <stdint.h>
 
+#include "../utils/sync.h"
+
 enum DBG_ERROR_CODES {
 	DBG_NO_ERROR = 0,
 	DBG_ERROR_NO_ACTIVE_SHADER,
@@ -101,6 +103,12 @@ enum DBG_RETURNS {
 	 Returned by a successful call to DBG_SHADER_STEP
 	 */
 
+	DBG_READBACK_RESULT_FRAGMENT_STATISTICS,
+	/*
+	 Returned by a successful call to DBG_SHADER_STEP that only asked for
+	 statistics of the fragment data
+	 */
+
 	DBG_SHADER_CODE,
 	/*
 	 Returned by a successful call to DBG_GET_SHADER_CODE
@@ -145,8 +153,10 @@ enum DBG_OPERATIONS {
 	 DBG_JUMP_TO_DRAW_CALL - run until drawcall reached or
 	 DBG_STOP_EXECUTION is set
 	 items[1]: if 1 stop execution on OpenGL error
-	 fname   : if items[0] == DBG_JUMP_TO_USER_DEFINED - the name of the function
-	 that terminates the run when reached
+	 items[2]: if 1 append every call that is executed to the trace ring
+	 (see DbgTraceRing); reset to 0 if no ring could be set up
+	 items[3]: if items[0] == DBG_JUMP_TO_USER_DEFINED - the ID of the function
+	 that terminates the run when reached (see functionIds.h)
 	 Returns: -
 	 */
 
@@ -247,6 +257,12 @@ enum DBG_OPERATIONS {
 	 items[2] : one of DBG_PFT_OPTIONS for depth test
 	 items[3] : one of DBG_PFT_OPTIONS for stencil test
 	 items[4] : one of DBG_PFT_OPTIONS for blending
+	 items[5] : x of the focus region, from the left of the viewport
+	 items[6] : y of the focus region, from the top of the viewport
+	 items[7] : width of the focus region
+	 items[8] : height of the focus region, 0 here or as width debugs
+	 the whole viewport; shader steps only shade and read back the
+	 focus region then
 
 	 Returns:
 	 result: DBG_ERROR_CODE
@@ -339,6 +355,9 @@ enum DBG_OPERATIONS {
 	 items[1] : pointer to geometry shader src
 	 items[2] : pointer to fragment shader src
 	 items[3] : debug target, see DBG_TARGETS below
+	 items[4] : force point primitive mode, as for DBG_SHADER_STEP
+	 items[8] : non-zero if the sources are passed inline, see
+	 DBG_INLINE_SOURCES below; items[0..2] are ignored then
 	 Returns:
 	 result   : DBG_ERROR_CODE
 	 */
@@ -355,23 +374,51 @@ enum DBG_OPERATIONS {
 	 items[3] : debug target, see DBG_TARGETS below
 	 if target == DBG_TARGET_FRAGMENT_SHADER:
 	 items[4] : number of components to read (1:R, 3:RGB, 4:RGBA)
+	 items[5] : format of readback (GL_FLOAT, GL_INT, GL_UINT, or one of
+	 the packed formats, see DBG_MASK_ROW_WORDS below)
+	 items[6] : non-zero to reduce the red channel to statistics on the
+	 GPU instead of reading back the image
+	 items[7] : if items[6] is non-zero, pointer to a mask that limits the
+	 statistics to the pixels set in it, or 0 to count all pixels;
+	 the mask is the width and height of the image as two unsigned
+	 ints followed by the GL_BITMAP rows (see DBG_MASK_ROW_WORDS)
 	 if target == DBG_TARGET_VERTEX_SHADER or DBG_TARGET_GEOMETRY_SHADER:
 	 items[4] : primitive mode
 	 items[5] : force primitive mode even for geometry shader target
 	 items[6] : expected size of debugResult (# floats) per vertex
+	 items[7] : format of the returned data, GL_FLOAT if 0, or one of the
+	 packed formats
+	 items[8] : non-zero if the sources are passed inline, see
+	 DBG_INLINE_SOURCES below; items[0..2] are ignored then
 	 Returns:
 	 if target == DBG_TARGET_FRAGMENT_SHADER:
 	 result   : DBG_READBACK_RESULT_FRAGMENT_DATA or DBG_ERROR_CODE
 	 on error
-	 items[0] : buffer address
+	 items[0] : buffer address, or offset into the result arena
 	 items[1] : image width
 	 items[2] : image height
+	 items[3] : result arena generation, 0 if the buffer is heap memory
+	 that has to be released with DBG_FREE_MEM
+	 items[4] : x of the image in the viewport, from the left
+	 items[5] : y of the image in the viewport, from the top
+	 items[6] : viewport width
+	 items[7] : viewport height; the image is the focus region set by
+	 DBG_SET_DBG_TARGET, or the whole viewport
+	 if target == DBG_TARGET_FRAGMENT_SHADER and items[6] was non-zero:
+	 result   : DBG_READBACK_RESULT_FRAGMENT_STATISTICS or DBG_ERROR_CODE
+	 on error
+	 items[0] : number of pixels with red above 0.5 (covered), within the
+	 mask of items[7] if given
+	 items[1] : number of pixels with red above 0.75 (loop active), within
+	 the mask as well
+	 items[2] : number of pixels in the focus region or viewport
 	 if target == DBG_TARGET_VERTEX_SHADER or DBG_TARGET_GEOMETRY_SHADER:
 	 result   : DBG_READBACK_RESULT_VERTEX_DATA or DBG_ERROR_CODE on
 	 error
-	 items[0] : buffer address
+	 items[0] : buffer address, or offset into the result arena
 	 items[1] : number of vertices
 	 items[2] : number of primitives
+	 items[3] : result arena generation, see above
 	 */
 
 	DBG_SAVE_AND_INTERRUPT_QUERIES,
@@ -390,6 +437,37 @@ enum DBG_OPERATIONS {
 	 result   : DBG_ERROR_CODE
 	 */
 
+	DBG_BATCH,
+	/*
+	 Execute a list of sub-commands in one go, so that operations that need
+	 several commands cost a single stop of the debuggee. Each sub-command is
+	 executed exactly as if it had been sent on its own; execution stops at
+	 the first sub-command that returns an error. The readbacks of fragment
+	 shader steps are only started and all of them are waited for at the
+	 end, so several steps are replayed back to back.
+	 Parameters:
+	 items[1] : number of sub-commands
+	 items[3] : first sub-command, see DbgBatchCmd below
+	 Returns:
+	 result   : DBG_ERROR_CODE
+	 items[0] : error code of the failed sub-command or DBG_NO_ERROR
+	 items[2] : number of sub-commands executed
+	 items[3] : sub-commands with their result and output items filled in
+	 */
+
+	DBG_GET_DBG_SHADER_CACHE_STATS,
+	/*
+	 Report how often DBG_SET_DBG_SHADER and DBG_SHADER_STEP could reuse an
+	 already linked debug program.
+	 Parameters:
+	 items[0] : non-zero to reset the counters afterwards
+	 Returns:
+	 result   : DBG_ERROR_CODE
+	 items[1] : number of cache hits
+	 items[2] : number of cache misses
+	 items[3] : number of cached programs
+	 */
+
 	DBG_DONE
 /*
  Quit command loop for the current call and proceed to next call.
@@ -455,17 +533,25 @@ typedef intptr_t ALIGNED_DATA;
 #	define SHM_SIZE (32*1024*1024)
 #endif
 #define SHM_MAX_FUNCNAME 1024
+/* thread records inside the main segment, further threads get their own */
 #define SHM_MAX_THREADS	 16
+/* maximum number of threads alive at the same time */
+#define SHM_MAX_THREAD_SLOTS 128
+/* space reserved behind the thread records for DbgShmControl */
+#define SHM_CONTROL_SIZE 8192
 #ifdef _WIN32
-#define SHM_MAX_ITEMS ((SHM_SIZE/SHM_MAX_THREADS - SHM_MAX_FUNCNAME - 5*sizeof(ALIGNED_DATA))/sizeof(ALIGNED_DATA))
+#define SHM_MAX_ITEMS (((SHM_SIZE - SHM_CONTROL_SIZE)/SHM_MAX_THREADS - SHM_MAX_FUNCNAME - 6*sizeof(ALIGNED_DATA))/sizeof(ALIGNED_DATA))
 #else /* _WIN32 */
-#define SHM_MAX_ITEMS ((SHM_SIZE/SHM_MAX_THREADS - SHM_MAX_FUNCNAME - 4*sizeof(ALIGNED_DATA))/sizeof(ALIGNED_DATA))
+#define SHM_MAX_ITEMS (((SHM_SIZE - SHM_CONTROL_SIZE)/SHM_MAX_THREADS - SHM_MAX_FUNCNAME - 5*sizeof(ALIGNED_DATA))/sizeof(ALIGNED_DATA))
 #endif /* _WIN32 */
 
 typedef struct {
 	ALIGNED_DATA threadId;
 	ALIGNED_DATA operation;
 	ALIGNED_DATA result;
+	/* ID of the current call, see functionIds.h */
+	ALIGNED_DATA function;
+	/* name of the debug function for DBG_CALL_FUNCTION */
 	char fname[SHM_MAX_FUNCNAME];
 	ALIGNED_DATA numItems;
 	ALIGNED_DATA items[SHM_MAX_ITEMS];
@@ -474,6 +560,164 @@ typedef struct {
 #endif /* _WIN32 */
 } DbgRec;
 
+/*
+ Entry of the thread directory. Slots below SHM_MAX_THREADS use the records
+ of the main segment, the others a segment with a single DbgRec, shmid.
+ threadId is 0 for slots that are free for reuse. stopped is set by the
+ thread when it rings the debugger doorbell and reset by the debugger when it
+ takes the stop; the thread then waits on continueDoorbell.
+ */
+typedef struct {
+	volatile ALIGNED_DATA threadId;
+	volatile ALIGNED_DATA shmid;
+	volatile ALIGNED_DATA stopped;
+	ShmEvent continueDoorbell;
+} DbgThreadSlot;
+
+/*
+ Process wide control block, located directly behind the thread records.
+
+ Result arena: shader step readbacks are written by the debuggee into a
+ separate shared memory segment (resultShmid, resultSize bytes) that the
+ debugger maps once and reads in place. Every result placed in the arena gets
+ a new resultGeneration; the debuggee does not touch the arena again before
+ the debugger has set resultReleased to that generation. If the arena is
+ still in use, the debuggee falls back to heap memory and DBG_FREE_MEM.
+ resultSize == 0 means there is no arena. The arena is a System V segment;
+ on windows there is none and every result takes the heap path.
+
+ Doorbells: if doorbell is set by the debugger, a debuggee thread hands
+ control back by setting stopped in its thread slot, setting debuggerDoorbell
+ and waiting on the continueDoorbell of its slot instead of raising SIGSTOP.
+ Several threads may ring at once, so the debugger claims one stopped slot at
+ a time with compare-and-swap, uses its record and continues just that thread
+ by setting its continueDoorbell instead of PTRACE_CONT. ptrace is then only
+ used to start the debuggee and to notice its termination or crash.
+
+ Thread directory: every debuggee thread claims a slot of threadSlots
+ atomically the first time it needs its record and releases it when it
+ terminates; numThreadSlots is the number of slots ever used. A child forked
+ by the debuggee claims a slot of its own. Without doorbells, activeThread is
+ the id of the thread that stopped last, i.e. whose record the debugger has
+ to use for its commands; the threads of the debuggee stop one at a time then.
+ */
+typedef struct {
+	ALIGNED_DATA resultShmid;
+	ALIGNED_DATA resultSize;
+	volatile ALIGNED_DATA resultGeneration;
+	volatile ALIGNED_DATA resultReleased;
+	ALIGNED_DATA doorbell;
+	ShmEvent debuggerDoorbell;
+	volatile ALIGNED_DATA activeThread;
+	volatile ALIGNED_DATA numThreadSlots;
+	DbgThreadSlot threadSlots[SHM_MAX_THREAD_SLOTS];
+	ALIGNED_DATA traceShmid;
+	ALIGNED_DATA traceSize;
+} DbgShmControl;
+
+/* fails to compile if DbgShmControl outgrows its space in the segment */
+typedef char DbgShmControlFits[
+		(sizeof(DbgShmControl) <= SHM_CONTROL_SIZE) ? 1 : -1];
+
+/*
+ Trace ring of a traced DBG_EXECUTE: a separate shared memory segment
+ (traceShmid, traceSize bytes including this header) created by the debuggee.
+ The debuggee is the only producer: it appends one DbgTraceRecord per call it
+ executes and then advances head. The debugger is the only consumer and
+ advances tail. head and tail count bytes and never decrease; the offset of a
+ record in the data area is the counter modulo size. Records never wrap: if
+ fewer than sizeof(DbgTraceRecord) bytes are left at the end of the data area,
+ or the record there has function == DBG_TRACE_WRAP, the next record starts at
+ offset 0. If the ring is full, the producer waits for the consumer; dropped
+ counts the records it had to throw away while a stop was pending. There is
+ no trace ring on windows.
+ */
+typedef struct {
+	volatile ALIGNED_DATA head;
+	volatile ALIGNED_DATA tail;
+	ALIGNED_DATA size;
+	volatile ALIGNED_DATA dropped;
+} DbgTraceRing;
+
+/*
+ A traced call: size is the record size in bytes, function the function ID.
+ The record header is followed by numArgs pairs (type, address in the
+ debuggee), then the argument values, each padded to DBG_INLINE_PAD.
+ */
+typedef struct {
+	ALIGNED_DATA size;
+	ALIGNED_DATA function;
+	ALIGNED_DATA threadId;
+	ALIGNED_DATA numArgs;
+} DbgTraceRecord;
+
+#define DBG_TRACE_WRAP -1
+#define DBG_TRACE_DATA(ring) ((char*)((ring) + 1))
+#define DBG_TRACE_ARGS(record) ((ALIGNED_DATA*)((record) + 1))
+
+/*
+ Inline shader sources of DBG_SHADER_STEP and DBG_SET_DBG_SHADER. If
+ items[DBG_INLINE_SOURCES] is set, the vertex, geometry, and fragment shader
+ sources follow from items[DBG_INLINE_SOURCES + 1] on, each as one item
+ holding the length in bytes including the terminating '\0' (0 if there is
+ no such shader), followed by the string padded to DBG_INLINE_PAD. Sources
+ that do not fit into the record are copied to debuggee memory instead.
+ */
+#define DBG_INLINE_SOURCES 8
+#define DBG_INLINE_PAD(size) (((size) + sizeof(ALIGNED_DATA) - 1) & ~(sizeof(ALIGNED_DATA) - 1))
+
+/*
+ Packed readback formats of DBG_SHADER_STEP for passes that only carry a
+ condition or a small number per pixel or vertex:
+ GL_UNSIGNED_BYTE : 8-bit unorm per component, values are clamped to [0, 1]
+ GL_HALF_FLOAT    : 16-bit float per component
+ GL_BITMAP        : 1-bit mask of the values above 0.5, single component only;
+ each row is packed into DBG_MASK_ROW_WORDS(width) 32-bit words, bit i of
+ word j holds the value 32 * j + i of the row. Vertex data is one row.
+ Rows are padded to whole RGBA32UI texels of 128 values, the texels the GPU
+ packs them into.
+ */
+#define DBG_MASK_ROW_WORDS(width) ((((width) + 127) / 128) * 4)
+
+/*
+ Sub-command of a DBG_BATCH. The header is followed by numSlots items and
+ then dataSize bytes of inline data; the next sub-command starts right after
+ that. numSlots has to be large enough to hold both parameters and returned
+ items of the operation. Items that have their bit set in relocate are byte
+ offsets into the inline data and are replaced by the address of that data
+ before the sub-command is executed, so e.g. shader sources can be passed
+ without allocating memory in the debuggee first. The inline data is only
+ valid while the batch is being executed. After execution result and
+ numItems hold what the operation returned.
+ */
+typedef struct {
+	ALIGNED_DATA operation;
+	ALIGNED_DATA result;
+	ALIGNED_DATA numSlots;
+	ALIGNED_DATA numItems;
+	ALIGNED_DATA dataSize;
+	ALIGNED_DATA relocate;
+} DbgBatchCmd;
+
+#define DBG_BATCH_MAX_SLOTS 16
+#define DBG_BATCH_FIRST(items) ((DbgBatchCmd*)&(items)[3])
+#define DBG_BATCH_CMD_ITEMS(cmd) ((ALIGNED_DATA*)((cmd) + 1))
+#define DBG_BATCH_CMD_DATA(cmd) ((char*)(DBG_BATCH_CMD_ITEMS(cmd) + (cmd)->numSlots))
+#define DBG_BATCH_NEXT(cmd) ((DbgBatchCmd*)(DBG_BATCH_CMD_DATA(cmd) + (cmd)->dataSize))
+/* inline data sizes are padded to keep the following sub-command aligned */
+#define DBG_BATCH_PAD(size) DBG_INLINE_PAD(size)
+
+#define SHM_CONTROL(fcalls) ((DbgShmControl*)((fcalls) + SHM_MAX_THREADS))
+
+/* bits of glFunctionFlags, which is indexed by function ID */
+#define DBG_FUNCTION_DRAW_CALL          0x01
+#define DBG_FUNCTION_SHADER_SWITCH      0x02
+#define DBG_FUNCTION_FRAME_END          0x04
+#define DBG_FUNCTION_FRAMEBUFFER_CHANGE 0x08
+#define DBG_FUNCTION_GL                 0x10
+#define DBG_FUNCTION_GLX                0x20
+#define DBG_FUNCTION_WGL                0x40
+
 typedef struct {
 	const char *prefix;
 	const char *extname;
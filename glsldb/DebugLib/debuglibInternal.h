@@ -51,6 +51,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../utils/hash.h"
 
 #include "generated/functionPointerTypes.inc"
+#include "generated/functionIds.h"
 
 #define TRANSFORM_FEEDBACK_BUFFER_SIZE (1<<24)
 
@@ -65,6 +66,10 @@ typedef struct {
     Hash queries;
 } Globals;
 
+/* indexed by function ID */
+extern GLFunctionList glFunctions[];
+extern const unsigned char glFunctionFlags[];
+
 DBGLIBLOCAL int checkGLVersionSupported(int majorVersion, int minorVersion);
 DBGLIBLOCAL int checkGLExtensionSupported(const char *extension);
 
@@ -94,13 +99,26 @@ DBGLIBLOCAL void (*getOrigFunc(const char *fname))(void);
     ? (Orig##fname) : (PFN##fname##PROC) getOrigFunc(#fname)))
 #else /* _WIN32 */
 #define ORIG_GL(fname) ((PFN##fname##PROC)getOrigFunc(#fname))
+/* Resolve fname only once into a static slot owned by the caller (the
+ * generated hooks). Threads racing on the first call store the same pointer.
+ */
+#define ORIG_GL_CACHED(fname, slot) \
+    ((PFN##fname##PROC)getCachedOrigFunc(&(slot), #fname))
+static inline void (*getCachedOrigFunc(void (**slot)(void),
+        const char *fname))(void)
+{
+    if (!*slot) {
+        *slot = getOrigFunc(fname);
+    }
+    return *slot;
+}
 #endif /* _WIN32 */
 
-#ifdef _WIN32
-DBGLIBLOCAL DbgRec *getThreadRecord(DWORD pid);
-#else /* _WIN32 */
-DBGLIBLOCAL DbgRec *getThreadRecord(pid_t pid);
-#endif /* _WIN32 */
+/* record of the calling thread */
+DBGLIBLOCAL DbgRec *getThreadRecord(void);
+
+/* process wide part of the shared memory segment */
+DBGLIBLOCAL DbgShmControl *getShmControl(void);
 
 /* check GL error code */DBGLIBLOCAL int glError(void);
 
@@ -116,7 +134,7 @@ DBGLIBLOCAL void (*glXGetProcAddressHook(const GLubyte *n))(void);
 
 DBGLIBLOCAL void (*getDbgFunction(void))(void);
 
-DBGLIBLOCAL void storeFunctionCall(const char *fname, int numArgs, ...);
+DBGLIBLOCAL void storeFunctionCall(int function, int numArgs, ...);
 
 DBGLIBLOCAL void storeResultOrError(unsigned int error, void *result, int type);
 
@@ -128,7 +146,10 @@ DBGLIBLOCAL int getDbgOperation(void);
 
 DBGLIBLOCAL void setExecuting(void);
 
-DBGLIBLOCAL int keepExecuting(const char *calledName);
+/* 0 if the debuggee has to stop at this call, KEEP_EXECUTING_TRACED if the
+ * call is executed and has to be passed to traceFunctionCall, 1 otherwise */
+#define KEEP_EXECUTING_TRACED 2
+DBGLIBLOCAL int keepExecuting(int function);
 
 DBGLIBLOCAL int checkGLErrorInExecution(void);
 
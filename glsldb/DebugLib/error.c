@@ -47,13 +47,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 void setErrorCode(int error)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
 	UT_NOTIFY_VA(LV_INFO, "STORE ERROR: %i", error);
 	rec->result = DBG_ERROR_CODE;
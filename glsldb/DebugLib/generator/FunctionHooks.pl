@@ -67,11 +67,15 @@ sub print_defines
 "
 	}
 
+	my $getError = defined $WIN32 ? "ORIG_GL(glGetError)" :
+		"ORIG_GL_CACHED(glGetError, origGetError)";
+	my $getErrorSlot = defined $WIN32 ? "" :
+		"\tstatic void (*origGetError)(void);\n";
 	print "
 int check_error(int check_allowed, int dummy)
 {
-	if (!dummy && (!check_allowed || G.errorCheckAllowed))
-		return ORIG_GL(glGetError)();
+${getErrorSlot}	if (!dummy && (!check_allowed || G.errorCheckAllowed))
+		return ${getError}();
 	return GL_NO_ERROR;
 }
 
@@ -161,7 +165,7 @@ sub thread_statement
         $statement = "
 	DbgRec *rec;
     dbgPrint(DBGLVL_DEBUG, \"entering $fname\\n\");
-    rec = getThreadRecord(GetCurrentProcessId());
+    rec = getThreadRecord();
     ${check_allowed}if(rec->isRecursing) {
         dbgPrint(DBGLVL_DEBUG, \"stopping recursion\\n\");
         ${preexec}${retval_assign}ORIG_GL($fname)($argstring);
@@ -223,6 +227,21 @@ sub createBody
 
     my $thread_statement = thread_statement($fname,
                     $retval, $retval_assign, $return_name, @arguments);
+
+    # Windows keeps the original functions in the Orig* pointers of the
+    # trampolines, otherwise every hook resolves its own slot only once
+    my $orig = "ORIG_GL($fname)";
+    my $orig_slot = "";
+    my $check_allowed = "";
+    if (not defined $WIN32) {
+        $orig = "ORIG_GL_CACHED($fname, orig)";
+        $orig_slot = "static void (*orig)(void);\n    ";
+        # no glGetError between glBegin and glEnd
+        $check_allowed = "G.errorCheckAllowed = 0;" if $fname eq "glBegin";
+        $check_allowed = "G.errorCheckAllowed = 1;" if $fname eq "glEnd";
+    }
+    my $check_allowed_run = $check_allowed ? "$check_allowed\n        " : "";
+    $check_allowed .= "\n            " if $check_allowed;
     my $errstr = check_error_string($checkError, $return_void, $fname);
 
     my $output = "";
@@ -250,11 +269,13 @@ sub createBody
     # for the debugger to handle the actual debugging
     $output .= ")
 {
-    ${retval_init}int op, error;${thread_statement}
+    ${orig_slot}${retval_init}int op, error;${thread_statement}
 	ENTER_CS(&G.lock);
-    if (keepExecuting(\"$fname\")) {
+    if ((op = keepExecuting(DBG_FUNC_$ucfname))) {
+        if (op == KEEP_EXECUTING_TRACED)
+            traceFunctionCall(DBG_FUNC_$ucfname, ${argcount}${argtypes});
         EXIT_CS(&G.lock);
-        ${preexec}${retval_assign}ORIG_GL($fname)($argstring);
+        ${check_allowed_run}${preexec}${retval_assign}${orig}($argstring);
 		error = GL_NO_ERROR;
         if (checkGLErrorInExecution())
 			error = ${errstr};
@@ -264,13 +285,13 @@ sub createBody
 		}
     }
     //fprintf(stderr, \"ThreadID: %li\\n\", (unsigned long)pthread_self());
-    storeFunctionCall(\"$fname\", ${argcount}${argtypes});
+    storeFunctionCall(DBG_FUNC_$ucfname, ${argcount}${argtypes});
     stop();
     op = getDbgOperation();
     while (op != DBG_DONE) {
         switch (op) {
         case DBG_CALL_FUNCTION:
-            ${retval_assign}(($pfname)getDbgFunction())($argstring);";
+            ${check_allowed}${retval_assign}(($pfname)getDbgFunction())($argstring);";
     if (not $return_void) {
         $output .= "
             storeResult(&result, $return_type);";
@@ -280,7 +301,7 @@ sub createBody
         case DBG_RECORD_CALL:
 #ifdef DBG_STREAM_HINT_$ucfname
 #  if DBG_STREAM_HINT_$ucfname != DBG_NO_RECORD
-            recordFunctionCall(&G.recordedStream, \"$fname\", ${argcount}${argsizes});
+            recordFunctionCall(&G.recordedStream, DBG_FUNC_$ucfname, ${argcount}${argsizes});
 #  endif
 #  if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
             break;
@@ -289,14 +310,14 @@ sub createBody
 #  endif
 #endif
         case DBG_CALL_ORIGFUNCTION:
-            ${preexec}${retval_assign}ORIG_GL($fname)($argstring);
+            ${check_allowed}${preexec}${retval_assign}${orig}($argstring);
 %s
             break;
         case DBG_EXECUTE:
             setExecuting();
             stop();
             EXIT_CS(&G.lock);
-            ${preexec}${win_recursing}${retval_assign}ORIG_GL($fname)($argstring);
+            ${check_allowed}${preexec}${win_recursing}${retval_assign}${orig}($argstring);
 			error = GL_NO_ERROR;
             if (checkGLErrorInExecution())
 				error = ${errstr};
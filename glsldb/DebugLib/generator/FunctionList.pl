@@ -34,6 +34,7 @@
 use FindBin;
 use lib "$FindBin::Bin";
 
+use Getopt::Std;
 require genTools;
 
 # edit this list for new extensions that include drawcalls
@@ -120,30 +121,70 @@ if ($^O =~ /Win32/) {
     $WIN32 = 1;
 }
 
-sub createHeader
+# -mids: enum of function IDs, otherwise glFunctions and glFunctionFlags
+my %options;
+getopt('m:' => \%options);
+my $mode = $options{m} || "list";
+if ($mode ne "list" and $mode ne "ids") {
+    die "Argument must be one of list, ids\n";
+}
+
+# functions may be declared by several headers, the first one counts
+my %seen;
+my @entries;
+
+sub createIds
 {
-    #print "#include <stdlib.h>\n";
-    #print "struct {\n";
-    #print "\tconst char *prefix;\n";
-    #print "\tconst char *extname;\n";
-    #print "\tconst char *fname;\n";
-    #print "\tint isDrawDebuggableCall;\n";
-    #print "\tint primitiveModeIndex;\n";
-    #print "\tint isShaderSwitch;\n";
-    #print "\tint isFrameEnd;\n";
-    #print "} glFunctions[] = {\n";
+    print "#ifndef FUNCTION_IDS_H
+#define FUNCTION_IDS_H
+
+/* index into glFunctions and glFunctionFlags */
+enum DBG_FUNCTION_IDS {
+";
+    foreach my $entry (@entries) {
+        printf "\tDBG_FUNC_%s,\n", uc($entry->{fname});
+    }
+    print "\tDBG_NUM_FUNCTIONS
+};
 
+#endif
+";
+}
+
+sub createList
+{
     print '#include <stdlib.h>
 #include "debuglib.h"
 GLFunctionList glFunctions[] = {
 ';
-}
-
-
-sub createFooter
-{
+    foreach my $entry (@entries) {
+        printf "  {\"%s\", \"%s\", \"%s\", %s, %s, %s, %s, %s},\n",
+            $entry->{prefix}, $entry->{extname}, $entry->{fname},
+            $entry->{drawCall}, $entry->{primitiveModeIndex},
+            $entry->{shaderSwitch}, $entry->{frameEnd},
+            $entry->{framebufferChange};
+    }
     print "  {NULL, NULL, NULL, 0, -1, 0, 0}
 };
+
+const unsigned char glFunctionFlags[] = {
+";
+    my %prefixFlags = (
+        "GL" => "DBG_FUNCTION_GL",
+        "GLX" => "DBG_FUNCTION_GLX",
+        "WGL" => "DBG_FUNCTION_WGL"
+    );
+    foreach my $entry (@entries) {
+        my @flags = ($prefixFlags{$entry->{prefix}});
+        push @flags, "DBG_FUNCTION_DRAW_CALL" if $entry->{drawCall};
+        push @flags, "DBG_FUNCTION_SHADER_SWITCH" if $entry->{shaderSwitch};
+        push @flags, "DBG_FUNCTION_FRAME_END" if $entry->{frameEnd};
+        push @flags, "DBG_FUNCTION_FRAMEBUFFER_CHANGE"
+            if $entry->{framebufferChange};
+        printf "  /* %s */ %s,\n", $entry->{fname}, join(" | ", @flags);
+    }
+    print "  0
+};
 ";
 }
 
@@ -152,14 +193,22 @@ sub createListEntry
     my $prefix = shift;
     my $extname = shift;
     my $fname = shift;
+    return if $seen{$fname};
+    $seen{$fname} = 1;
+
     my @abla = grep {$fname eq $_->[0]} @debuggableDrawCalls;
     my $bla = @abla ? $abla[0]->[1] : -1;
 
-    printf "  {\"$prefix\", \"$extname\", \"$fname\", %s, $bla, %s, %s, %s},
-", (scalar grep {$fname eq $_->[0]} @debuggableDrawCalls),
-   (scalar grep {$fname eq $_} @shaderSwitches),
-   (scalar grep {$fname eq $_} @frameEndMarkers),
-   (scalar grep {$fname eq $_} @framebufferChanges);
+    push @entries, {
+        prefix => $prefix,
+        extname => $extname,
+        fname => $fname,
+        drawCall => (scalar grep {$fname eq $_->[0]} @debuggableDrawCalls),
+        primitiveModeIndex => $bla,
+        shaderSwitch => (scalar grep {$fname eq $_} @shaderSwitches),
+        frameEnd => (scalar grep {$fname eq $_} @frameEndMarkers),
+        framebufferChange => (scalar grep {$fname eq $_} @framebufferChanges)
+    };
 }
 
 
@@ -196,8 +245,11 @@ if (defined $WIN32) {
     $add_actions = { $regexps{"glxfunc"} => \&glx_entry }
 }
 
-header_generated();
-createHeader();
 parse_gl_files($gl_actions, $add_actions, defined $WIN32, \&wgl_entry);
-createFooter();
+header_generated();
+if ($mode eq "ids") {
+    createIds();
+} else {
+    createList();
+}
 
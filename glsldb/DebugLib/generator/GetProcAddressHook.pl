@@ -89,8 +89,7 @@ __declspec(dllexport) PROC APIENTRY HookedwglGetProcAddress(LPCSTR arg0) {
         if (!strcmp(gpa_FuncsNames[i], arg0)) {
             if (*gpa_OrigFuncs[i] == NULL) {
                 /* *gpa_OrigFuncs[i] = (PFN${fname}PROC)OrigwglGetProcAddress(gpa_FuncsNames[i]); */
-                /* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-                DbgRec *rec = getThreadRecord(GetCurrentProcessId());
+                DbgRec *rec = getThreadRecord();
                 rec->isRecursing = 1;
                 initExtensionTrampolines();
                 rec->isRecursing = 0;
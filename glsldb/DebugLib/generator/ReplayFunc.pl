@@ -41,6 +41,14 @@ require genTypes;
 our %regexps;
 
 
+if ($^O =~ /Win32/) {
+    $WIN32 = 1;
+}
+
+# functions may be declared by several headers
+my %seen;
+my @replayed;
+
 sub createBodyHeader
 {
     print '#include <stdio.h>
@@ -61,15 +69,34 @@ sub createBodyHeader
 #include "streamRecording.h"
 #include "replayFunction.h"
 
-void replayFunctionCall(StoredCall *f, int final)
-{
+typedef void (*ReplayFunc)(StoredCall *f, int final);
 ';
 }
 
 sub createBodyFooter
 {
-    print '    {
-        fprintf(stderr, "Cannot replay %s: unknown function\n", f->fname);
+    print "
+/* indexed by function ID, NULL for functions that are not replayed */
+static const ReplayFunc replayFunctions[DBG_NUM_FUNCTIONS] = {
+";
+    foreach my $fname (@replayed) {
+        my $ucfname = uc($fname);
+        print "#if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_REPLAY || DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
+    [DBG_FUNC_$ucfname] = replay_$fname,
+#endif
+";
+    }
+    print '};
+
+void replayFunctionCall(StoredCall *f, int final)
+{
+    ReplayFunc replay = replayFunctions[f->function];
+
+    if (replay) {
+        replay(f, final);
+    } else {
+        fprintf(stderr, "Cannot replay %s: unknown function\n",
+                glFunctions[f->function].fname);
     }
 }
 ';
@@ -86,17 +113,25 @@ sub createFunctionHook
     my @arguments = buildArgumentList($argString);
     my $argOutput = arguments_types_array($fname, "f->arguments", @arguments);
 
-    printf "#if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_REPLAY || DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
-    if (!strcmp(\"$fname\", (char*)f->fname)) {
-#if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
-        if (final) {
-#endif
-            ORIG_GL($fname)($argOutput);
+    return if $seen{$fname};
+    $seen{$fname} = 1;
+    push @replayed, $fname;
+
+    # see FunctionHooks.pl for the slot of the original function
+    my $orig = defined $WIN32 ? "ORIG_GL($fname)" : "ORIG_GL_CACHED($fname, orig)";
+    my $orig_slot = defined $WIN32 ? "" : "    static void (*orig)(void);\n";
+
+    print "#if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_REPLAY || DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
+static void replay_$fname(StoredCall *f, int final)
+{
+${orig_slot}    (void) final;
 #if DBG_STREAM_HINT_$ucfname == DBG_RECORD_AND_FINAL
-        }
-#endif
+    if (!final) {
         return;
     }
+#endif
+    ${orig}($argOutput);
+}
 #endif
 ";
 }
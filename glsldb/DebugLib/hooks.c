@@ -50,6 +50,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "debuglibInternal.h"
 #include "streamRecording.h"
+#include "traceRing.h"
 #include "../utils/dbgprint.h"
 
 extern Globals G;
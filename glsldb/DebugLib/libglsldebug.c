@@ -38,6 +38,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/shm.h>
+#include <sys/syscall.h>
+#include <pthread.h>
 #endif /* _WIN32 */
 #include <errno.h>
 #include <string.h>
@@ -82,9 +84,13 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "debuglibInternal.h"
 #include "glstate.h"
 #include "readback.h"
+#include "reduction.h"
 #include "streamRecorder.h"
 #include "streamRecording.h"
 #include "memory.h"
+#include "resultArena.h"
+#include "traceRing.h"
+#include "batch.h"
 #include "shader.h"
 #include "initLib.h"
 #include "queries.h"
@@ -101,8 +107,6 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define USE_DLSYM_HARDCODED_LIB
 
-extern GLFunctionList glFunctions[];
-
 
 typedef struct {
 	LibraryHandle handle;
@@ -162,6 +166,34 @@ static struct {
 /* global data */
 DBGLIBLOCAL Globals G;
 
+#ifdef _WIN32
+#	define THREAD_LOCAL __declspec(thread)
+#else /* _WIN32 */
+#	define THREAD_LOCAL __thread
+#endif /* _WIN32 */
+
+/* record of the calling thread, claimed from the thread directory on first
+ * use
+ */
+static THREAD_LOCAL DbgRec *threadRecord = NULL;
+/* its slot in the directory */
+static THREAD_LOCAL ALIGNED_DATA threadSlot = 0;
+
+/* without doorbells the whole process stops, one thread at a time */
+static ThdLock stopLock;
+
+#ifndef _WIN32
+/* records of the threads beyond SHM_MAX_THREADS, by directory slot */
+static DbgRec *extraThreadRecords[SHM_MAX_THREAD_SLOTS];
+
+/* releases the directory slot (+1) of a terminating thread */
+static pthread_key_t threadSlotKey;
+
+static void releaseThreadRecord(void *value);
+static void freeThreadRecords(void);
+static void forkedChild(void);
+#endif /* !_WIN32 */
+
 
 #ifndef _WIN32
 static int getShmid()
@@ -390,7 +422,9 @@ __declspec(dllexport) BOOL __cdecl uninitialiseDll(void) {
 
 	freeDbgFunctions();
 
-	clearRecordedCalls(&G.recordedStream);
+	freeRecordedCalls(&G.recordedStream);
+
+	freeDbgShaderCache();
 
 	cleanupQueryStateTracker();
 
@@ -454,6 +488,7 @@ BOOL APIENTRY DllMain(HANDLE hModule, DWORD reason_for_call, LPVOID lpReserved)
 
 		/* Create global crit section. */
 		InitializeCriticalSection(&G.lock);
+		createThdLock(&stopLock);
 
 		if (!attachTrampolines())
 			return FALSE;
@@ -516,6 +551,7 @@ BOOL APIENTRY DllMain(HANDLE hModule, DWORD reason_for_call, LPVOID lpReserved)
 		EnterCriticalSection(&G.lock);
 		retval = uninitialiseDll();
 		DeleteCriticalSection(&G.lock);
+		deleteThdLock(&stopLock);
 		break;
 	}
 
@@ -546,6 +582,9 @@ void __attribute__ ((constructor)) debuglib_init(void)
 	}
 
 	pthread_mutex_init(&G.lock, NULL);
+	createThdLock(&stopLock);
+	pthread_key_create(&threadSlotKey, releaseThreadRecord);
+	pthread_atfork(NULL, NULL, forkedChild);
 
 	hash_create(&g.origFunctions, hashString, compString, 512, 0);
 
@@ -591,7 +630,11 @@ void __attribute__ ((constructor)) debuglib_init(void)
 
 void __attribute__ ((destructor)) debuglib_fini(void)
 {
-	/* detach shared mem segment */
+	/* detach shared mem segments */
+	freeResultArena();
+	freeTraceRing();
+	freeDbgShaderCache();
+	freeThreadRecords();
 	shmdt(g.fcalls);
 
 #ifdef USE_DLSYM_HARDCODED_LIB
@@ -606,33 +649,160 @@ void __attribute__ ((destructor)) debuglib_fini(void)
 
 	cleanupQueryStateTracker();
 
-	clearRecordedCalls(&G.recordedStream);
+	freeRecordedCalls(&G.recordedStream);
 
 	quitLogging();
 
+	deleteThdLock(&stopLock);
 	pthread_mutex_destroy(&G.lock);
 }
 #endif
 
+static ALIGNED_DATA getCurrentThreadId(void)
+{
+#ifdef _WIN32
+	return (ALIGNED_DATA) GetCurrentThreadId();
+#elif defined(GLSLDB_OSX)
+	return (ALIGNED_DATA) pthread_mach_thread_np(pthread_self());
+#else
+	return (ALIGNED_DATA) syscall(SYS_gettid);
+#endif
+}
+
+static DbgRec *mapThreadRecord(DbgShmControl *control, ALIGNED_DATA slot)
+{
+	if (slot < SHM_MAX_THREADS) {
+		return &g.fcalls[slot];
+	}
 #ifndef _WIN32
-DbgRec *getThreadRecord(pid_t pid)
+	/* reused slots keep their segment */
+	if (!extraThreadRecords[slot]) {
+		int shmid = shmget(IPC_PRIVATE, sizeof(DbgRec),
+				IPC_CREAT | SHM_R | SHM_W);
+		void *rec;
+
+		if (shmid == -1) {
+			dbgPrint(DBGLVL_ERROR, "Could not create thread record: %s\n",
+					strerror(errno));
+			return NULL;
+		}
+		rec = shmat(shmid, NULL, 0);
+		if (rec == (void*) -1) {
+			dbgPrint(DBGLVL_ERROR, "Could not attach thread record: %s\n",
+					strerror(errno));
+			shmctl(shmid, IPC_RMID, NULL);
+			return NULL;
+		}
+		extraThreadRecords[slot] = (DbgRec*) rec;
+		control->threadSlots[slot].shmid = shmid;
+	}
+	return extraThreadRecords[slot];
+#else /* !_WIN32 */
+	UNUSED_ARG(control)
+	return NULL;
+#endif /* !_WIN32 */
+}
+
+static DbgRec *claimThreadRecord(void)
+{
+	DbgShmControl *control = SHM_CONTROL(g.fcalls);
+	ALIGNED_DATA tid = getCurrentThreadId();
+	ALIGNED_DATA slot, numSlots;
+	DbgRec *rec = NULL;
+#ifdef _WIN32
+	const ALIGNED_DATA maxSlots = SHM_MAX_THREADS;
 #else /* _WIN32 */
-DbgRec *getThreadRecord(DWORD pid)
+	const ALIGNED_DATA maxSlots = SHM_MAX_THREAD_SLOTS;
 #endif /* _WIN32 */
-{
-	int i;
-	for (i = 0; i < SHM_MAX_THREADS; i++) {
-		if (g.fcalls[i].threadId == 0 || g.fcalls[i].threadId == pid) {
+
+	for (;;) {
+		/* reuse the slot of a terminated thread... */
+		numSlots = control->numThreadSlots;
+		for (slot = 0; slot < numSlots && slot < maxSlots; slot++) {
+			if (!control->threadSlots[slot].threadId
+					&& casIntPtr(&control->threadSlots[slot].threadId, 0, tid)) {
+				break;
+			}
+		}
+		if (slot < numSlots && slot < maxSlots) {
+			break;
+		}
+		/* ...or append a new one; somebody else might grab it as free slot
+		 * before we can, then try again
+		 */
+		slot = fetchAddIntPtr(&control->numThreadSlots, 1);
+		if (slot >= maxSlots) {
+			break;
+		}
+		if (casIntPtr(&control->threadSlots[slot].threadId, 0, tid)) {
 			break;
 		}
 	}
-	if (i == SHM_MAX_THREADS) {
-		/* TODO */
+
+	if (slot < maxSlots) {
+		rec = mapThreadRecord(control, slot);
+	}
+	if (!rec) {
 		dbgPrint(DBGLVL_ERROR,
 				"Error: max. number of debugable threads exceeded!\n");
 		exit(1);
 	}
-	return &g.fcalls[i];
+	rec->threadId = tid;
+	threadSlot = slot;
+#ifndef _WIN32
+	pthread_setspecific(threadSlotKey, (void*) (slot + 1));
+#endif /* !_WIN32 */
+	return rec;
+}
+
+#ifndef _WIN32
+static void releaseThreadRecord(void *value)
+{
+	DbgShmControl *control = SHM_CONTROL(g.fcalls);
+	ALIGNED_DATA slot = (ALIGNED_DATA) value - 1;
+
+	mapThreadRecord(control, slot)->threadId = 0;
+	memoryBarrier();
+	control->threadSlots[slot].threadId = 0;
+}
+
+/* The child of a fork runs in a copy of the forking thread, which must not
+ * keep using the slot of its parent. It claims one of its own on its next
+ * call.
+ */
+static void forkedChild(void)
+{
+	threadRecord = NULL;
+	threadSlot = 0;
+	pthread_setspecific(threadSlotKey, NULL);
+}
+
+static void freeThreadRecords(void)
+{
+	DbgShmControl *control = SHM_CONTROL(g.fcalls);
+	int slot;
+
+	for (slot = SHM_MAX_THREADS; slot < SHM_MAX_THREAD_SLOTS; slot++) {
+		if (extraThreadRecords[slot]) {
+			shmdt(extraThreadRecords[slot]);
+			shmctl(control->threadSlots[slot].shmid, IPC_RMID, NULL);
+			extraThreadRecords[slot] = NULL;
+		}
+	}
+}
+#endif /* !_WIN32 */
+
+DbgRec *getThreadRecord(void)
+{
+	if (!threadRecord) {
+		threadRecord = claimThreadRecord();
+	}
+	return threadRecord;
+}
+
+DbgShmControl *getShmControl(void)
+{
+	return SHM_CONTROL(g.fcalls);
 }
 
 static void printArgument(void *addr, int type)
@@ -699,24 +869,17 @@ static void printArgument(void *addr, int type)
 	}
 }
 
-void storeFunctionCall(const char *fname, int numArgs, ...)
+void storeFunctionCall(int function, int numArgs, ...)
 {
 	int i;
 	va_list argp;
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
-	rec->threadId = pid;
 	rec->result = DBG_FUNCTION_CALL;
-	strncpy(rec->fname, fname, SHM_MAX_FUNCNAME);
+	rec->function = function;
 	rec->numItems = numArgs;
 
-	dbgPrintNoPrefix(DBGLVL_INFO, "STORE CALL: %s(", rec->fname);
+	dbgPrintNoPrefix(DBGLVL_INFO, "STORE CALL: %s(", glFunctions[function].fname);
 	va_start(argp, numArgs);
 	for (i = 0; i < numArgs; i++) {
 		rec->items[2 * i] = (ALIGNED_DATA) va_arg(argp, void*);
@@ -729,13 +892,7 @@ void storeFunctionCall(const char *fname, int numArgs, ...)
 
 void storeResult(void *result, int type)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
 	dbgPrintNoPrefix(DBGLVL_INFO, "STORE RESULT: ");
 	printArgument(result, type);
@@ -747,13 +904,7 @@ void storeResult(void *result, int type)
 
 void storeResultOrError(unsigned int error, void *result, int type)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
 	if (error) {
 		setErrorCode(error);
@@ -770,7 +921,34 @@ void storeResultOrError(unsigned int error, void *result, int type)
 
 void stop(void)
 {
+	DbgShmControl *control = SHM_CONTROL(g.fcalls);
+	DbgRec *rec = getThreadRecord();
+
 	dbgPrint(DBGLVL_DEBUG, "RAISED STOP\n");
+#ifndef _WIN32
+	if (control->doorbell) {
+		DbgThreadSlot *slot = &control->threadSlots[threadSlot];
+		int error;
+
+		/* the record has to be complete before the debugger takes the stop */
+		memoryBarrier();
+		slot->stopped = 1;
+		setShmEvent(&control->debuggerDoorbell);
+		error = waitShmEvent(&slot->continueDoorbell, TIMEOUT_INFINITE);
+		if (error) {
+			dbgPrint(DBGLVL_ERROR, "Waiting for continue doorbell failed: %s\n",
+					strerror(error));
+		}
+		return;
+	}
+#endif /* !_WIN32 */
+
+	/* tell the debugger whose record to use; nobody else may stop until it
+	 * continues this thread
+	 */
+	acquireThdLock(&stopLock);
+	control->activeThread = rec->threadId;
+	memoryBarrier();
 #ifdef _WIN32
 	if (!SetEvent(g.hEvtDebugger)) {
 		dbgPrint(DBGLVL_ERROR, "could not signal Debugger: %u\n", GetLastError());
@@ -784,6 +962,7 @@ void stop(void)
 #else /* _WIN32 */
 	raise(SIGSTOP);
 #endif /* _WIN32 */
+	releaseThdLock(&stopLock);
 }
 
 static void startRecording(void)
@@ -823,41 +1002,65 @@ static void endReplay(void)
  *		items[2] : pointer to fragment shader src
  *		items[3] : debug target, see DBG_TARGETS below
  *		if target == DBG_TARGET_FRAGMENT_SHADER:
- *			items[4] : number of components to read (1:R, 3:RGB, 4:RGBA)
- *			items[5] : format of readback (GL_FLOAT, GL_INT, GL_UINT)
+ *			items[4] : number of components to read (1:R, 3:RGB, 4:RGBA);
+ *					   with 3 the debug shader writes packed watch items
+ *					   to red, green and blue
+ *			items[5] : format of readback (GL_FLOAT, GL_INT, GL_UINT) or a
+ *					   packed format, see DBG_MASK_ROW_WORDS
+ *			items[6] : non-zero for statistics instead of the image, see
+ *					   reduceRenderBuffer
+ *			items[7] : mask limiting the statistics or 0
  *		if target == DBG_TARGET_VERTEX_SHADER or DBG_TARGET_GEOMETRY_SHADER:
  *			items[4] : primitive mode
  *			items[5] : force primitive mode even for geometry shader target
- *			items[6] : expected size of debugResult (# floats) per vertex
+ *			items[6] : expected size of debugResult (# floats) per vertex,
+ *					   one per packed watch item
+ *			items[7] : format of the returned data, GL_FLOAT if 0
+ *		items[8] : non-zero if the sources are inline, see DBG_INLINE_SOURCES
  *	Returns:
  *		if target == DBG_TARGET_FRAGMENT_SHADER:
  *			result   : DBG_READBACK_RESULT_FRAGMENT_DATA or DBG_ERROR_CODE
  *					   on error
- *			items[0] : buffer address
+ *			items[0] : buffer address, or offset into the result arena
  *			items[1] : image width
  *			items[2] : image height
+ *			items[3] : result arena generation, 0 for heap memory
+ *			items[4] : x of the image in the viewport, from the left
+ *			items[5] : y of the image in the viewport, from the top
+ *			items[6] : viewport width
+ *			items[7] : viewport height
+ *		if target == DBG_TARGET_FRAGMENT_SHADER and items[6] is non-zero:
+ *			result   : DBG_READBACK_RESULT_FRAGMENT_STATISTICS or
+ *					   DBG_ERROR_CODE on error
+ *			items[0] : number of covered pixels
+ *			items[1] : number of active pixels
+ *			items[2] : number of pixels
  *		if target == DBG_TARGET_VERTEX_SHADER or DBG_TARGET_GEOMETRY_SHADER:
  *			result   : DBG_READBACK_RESULT_VERTEX_DATA or DBG_ERROR_CODE on
  *					   error
- *			items[0] : buffer address
+ *			items[0] : buffer address, or offset into the result arena
  *			items[1] : number of vertices
  *			items[2] : number of primitives
+ *			items[3] : result arena generation, 0 for heap memory
  */
 static void shaderStep(void)
 {
 	int error;
 
-#ifdef _WIN32
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DbgRec *rec = getThreadRecord(GetCurrentProcessId());
-#else /* _WIN32 */
-	DbgRec *rec = getThreadRecord(getpid());
-#endif /* _WIN32 */
-	const char *vshader = (const char *) rec->items[0];
-	const char *gshader = (const char *) rec->items[1];
-	const char *fshader = (const char *) rec->items[2];
+	DbgRec *rec = getThreadRecord();
+	const char *sources[3];
+	const char *vshader, *gshader, *fshader;
 	int target = (int) rec->items[3];
 
+	error = getDbgShaderSources(rec, sources);
+	if (error) {
+		setErrorCode(error);
+		return;
+	}
+	vshader = sources[0];
+	gshader = sources[1];
+	fshader = sources[2];
+
 	dbgPrint(DBGLVL_COMPILERINFO,
 			"SHADER STEP: v=%p g=%p f=%p target=%i\n", vshader, gshader, fshader, target);
 
@@ -873,9 +1076,11 @@ static void shaderStep(void)
 		int primitiveMode = (int) rec->items[4];
 		int forcePointPrimitiveMode = (int) rec->items[5];
 		int numFloatsPerVertex = (int) rec->items[6];
+		int format = rec->items[7] ? (int) rec->items[7] : GL_FLOAT;
 		int numVertices;
 		int numPrimitives;
-		float *buffer;
+		void *buffer;
+		ALIGNED_DATA generation;
 
 		/* set debug shader code */
 		error = loadDbgShader(vshader, gshader, fshader, target,
@@ -918,21 +1123,24 @@ static void shaderStep(void)
 		}
 
 		/* readback feedback buffer */
-		error = endTransformFeedback(primitiveMode, numFloatsPerVertex, &buffer,
-				&numPrimitives, &numVertices);
+		error = endTransformFeedback(primitiveMode, numFloatsPerVertex, format,
+				&buffer, &numPrimitives, &numVertices, &generation);
 		if (error) {
 			setErrorCode(error);
 		} else {
 			rec->result = DBG_READBACK_RESULT_VERTEX_DATA;
-			rec->items[0] = (ALIGNED_DATA) buffer;
+			rec->items[0] = generation ? 0 : (ALIGNED_DATA) buffer;
 			rec->items[1] = (ALIGNED_DATA) numVertices;
 			rec->items[2] = (ALIGNED_DATA) numPrimitives;
+			rec->items[3] = generation;
 		}
 	} else if (target == DBG_TARGET_FRAGMENT_SHADER) {
 		int numComponents = (int) rec->items[4];
 		int format = (int) rec->items[5];
-		int width, height;
+		int statistics = (int) rec->items[6];
+		int width, height, placement[4];
 		void *buffer;
+		ALIGNED_DATA generation;
 
 		/* set debug shader code */
 		error = loadDbgShader(vshader, gshader, fshader, target, 0);
@@ -947,6 +1155,8 @@ static void shaderStep(void)
 			setErrorCode(error);
 			return;
 		}
+		setDbgColorMask(numComponents);
+		setDbgFocusScissor();
 		replayFunctionCalls(&G.recordedStream, 0);
 		error = glError();
 		if (error) {
@@ -954,18 +1164,52 @@ static void shaderStep(void)
 			return;
 		}
 
-		/* readback framebuffer */
+		/* only the numbers, the image stays on the GPU */
+		if (statistics) {
+			const int *region = getDbgFocusRegion();
+			const unsigned int *limit = (const unsigned int*) rec->items[7];
+			int numCovered, numActive;
+
+			error = reduceRenderBuffer(region, limit, &numCovered,
+					&numActive);
+			if (error) {
+				setErrorCode(error);
+				return;
+			}
+			getDbgFocusPlacement(placement);
+			rec->result = DBG_READBACK_RESULT_FRAGMENT_STATISTICS;
+			rec->items[0] = (ALIGNED_DATA) numCovered;
+			rec->items[1] = (ALIGNED_DATA) numActive;
+			rec->items[2] = region ? (ALIGNED_DATA) region[2] * region[3] :
+					(ALIGNED_DATA) placement[2] * placement[3];
+			return;
+		}
+
+		/* readback framebuffer, in a batch it is finished when the batch ends */
 		DMARK
-		error = readBackRenderBuffer(numComponents, format, &width, &height,
-				&buffer);
+		if (isReadBackQueued()) {
+			error = queueReadBackRenderBuffer(numComponents, format,
+					getDbgFocusRegion(), &width, &height);
+			buffer = NULL;
+			generation = 0;
+		} else {
+			error = readBackRenderBuffer(numComponents, format,
+					getDbgFocusRegion(), &width, &height, &buffer, &generation);
+		}
 		DMARK
 		if (error) {
 			setErrorCode(error);
 		} else {
 			rec->result = DBG_READBACK_RESULT_FRAGMENT_DATA;
-			rec->items[0] = (ALIGNED_DATA) buffer;
+			rec->items[0] = generation ? 0 : (ALIGNED_DATA) buffer;
 			rec->items[1] = (ALIGNED_DATA) width;
 			rec->items[2] = (ALIGNED_DATA) height;
+			rec->items[3] = generation;
+			getDbgFocusPlacement(placement);
+			rec->items[4] = (ALIGNED_DATA) placement[0];
+			rec->items[5] = (ALIGNED_DATA) placement[1];
+			rec->items[6] = (ALIGNED_DATA) placement[2];
+			rec->items[7] = (ALIGNED_DATA) placement[3];
 		}
 	} else {
 		dbgPrint(DBGLVL_COMPILERINFO, "\n");
@@ -975,93 +1219,56 @@ static void shaderStep(void)
 
 int getDbgOperation(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	dbgPrint(DBGLVL_INFO, "OPERATION: %li\n", rec->operation);
 	return rec->operation;
 }
 
-static int isDebuggableDrawCall(const char *name)
+int keepExecuting(int function)
 {
-	int i = 0;
-	while (glFunctions[i].fname != NULL) {
-		if (!strcmp(name, glFunctions[i].fname)) {
-			return glFunctions[i].isDebuggableDrawCall;
-		}
-		i++;
-	}
-	return 0;
-}
+	DbgRec *rec = getThreadRecord();
+	int keep;
 
-static int isShaderSwitch(const char *name)
-{
-	int i = 0;
-	while (glFunctions[i].fname != NULL) {
-		if (!strcmp(name, glFunctions[i].fname)) {
-			return glFunctions[i].isShaderSwitch;
-		}
-		i++;
-	}
-	return 0;
-}
-
-int keepExecuting(const char *calledName)
-{
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
 	if (rec->operation == DBG_STOP_EXECUTION) {
 		return 0;
 	} else if (rec->operation == DBG_EXECUTE) {
 		switch (rec->items[0]) {
 		case DBG_EXECUTE_RUN:
-			return 1;
+			keep = 1;
+			break;
 		case DBG_JUMP_TO_SHADER_SWITCH:
-			return !isShaderSwitch(calledName);
+			keep = !(glFunctionFlags[function] & DBG_FUNCTION_SHADER_SWITCH);
+			break;
 		case DBG_JUMP_TO_DRAW_CALL:
 			/* TODO:  allow also jumps to non-debuggable draw calls */
-			return !isDebuggableDrawCall(calledName);
+			keep = !(glFunctionFlags[function] & DBG_FUNCTION_DRAW_CALL);
+			break;
 		case DBG_JUMP_TO_USER_DEFINED:
-			return strcmp(rec->fname, calledName);
-		default:
+			keep = rec->items[3] != function;
 			break;
+		default:
+			setErrorCode(DBG_ERROR_INVALID_OPERATION);
+			return 0;
 		}
-		setErrorCode(DBG_ERROR_INVALID_OPERATION);
+		return (keep && rec->items[2]) ? KEEP_EXECUTING_TRACED : keep;
 	}
 	return 0;
 }
 
 int checkGLErrorInExecution(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	return rec->items[1];
 	return 1;
 }
 
 void setExecuting(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
+	if (rec->items[2] && !openTraceRing()) {
+		/* tell the debugger to fall back to stepping */
+		rec->items[2] = 0;
+	}
 	rec->result = DBG_EXECUTE_IN_PROGRESS;
 }
 
@@ -1130,6 +1337,12 @@ void executeDefaultDbgOperation(int op)
 	case DBG_RESTART_QUERIES:
 		restartQueries();
 		break;
+	case DBG_BATCH:
+		executeBatch();
+		break;
+	case DBG_GET_DBG_SHADER_CACHE_STATS:
+		getDbgShaderCacheStats();
+		break;
 	default:
 		dbgPrint(DBGLVL_INFO, "UNKNOWN DEBUG OPERATION %i\n", op);
 		break;
@@ -1144,13 +1357,7 @@ static void dbgFunctionNOP(void)
 
 void (*getDbgFunction(void))(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	int i;
 
 	for (i = 0; i < g.numDbgFunctions; i++) {
@@ -1162,7 +1369,6 @@ void (*getDbgFunction(void))(void)
 	return dbgFunctionNOP;
 }
 
-/* HAZARD: Windows will never set G.errorCheckAllowed for Begin/End as below!!! */
 #ifdef _WIN32
 __declspec(dllexport) PROC APIENTRY HookedwglGetProcAddress(LPCSTR arg0);
 void (*getOrigFunc(const char *fname))(void)
@@ -1195,16 +1401,9 @@ void (*getOrigFunc(const char *fname))(void)
 				}
 			}
 			hash_insert(&g.origFunctions, (void*)fname, origFunc);
+			dbgPrint(DBGLVL_INFO, "ORIG_GL: %s (%p)\n", fname, origFunc);
 			result = origFunc;
 		}
-
-		/* FIXME: Is there a better place for this ??? */
-		if (!strcmp(fname, "glBegin")) {
-			G.errorCheckAllowed = 0;
-		} else if (!strcmp(fname, "glEnd")) {
-			G.errorCheckAllowed = 1;
-		}
-		dbgPrint(DBGLVL_INFO, "ORIG_GL: %s (%p)\n", fname, result);
 		return (void (*)(void))result;
 	}
 }
@@ -46,13 +46,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 void allocMem(void)
 {
 	int i;
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
 	for (i = 0; i < rec->numItems; i++) {
 		rec->items[i] = (ALIGNED_DATA) malloc(rec->items[i] * sizeof(char));
@@ -72,13 +66,7 @@ void allocMem(void)
 void freeMem(void)
 {
 	int i;
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 
 	for (i = 0; i < rec->numItems; i++) {
 		free((void*) rec->items[i]);
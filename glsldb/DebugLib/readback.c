@@ -43,6 +43,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "debuglib.h"
 #include "debuglibInternal.h"
 #include "readback.h"
+#include "reduction.h"
+#include "resultArena.h"
 #include "glstate.h"
 #include "shader.h"
 #include "glenumerants.h"
@@ -102,6 +104,12 @@ static struct {
 	GLfloat *colorBuffer;
 	GLfloat *depthBuffer;
 	GLint *stencilBuffer;
+	/* focus region in window coordinates, the whole viewport if not focused;
+	 * the saved buffers above only hold this region
+	 */
+	int focused;
+	GLint focus[4];
+	GLint focusViewport[4];
 
 	/* transform feedback dbg state */
 	GLuint tfbBuffer;
@@ -152,7 +160,8 @@ DMARK	/* pixel packing */
 	ORIG_GL(glGetBooleanv)(GL_PACK_LSB_FIRST, &savedState->pack_lsb_first);
 	ORIG_GL(glPixelStorei)(GL_PACK_LSB_FIRST, GL_FALSE);
 	ORIG_GL(glGetIntegerv)(GL_PACK_ALIGNMENT, &savedState->pack_alignment);
-	ORIG_GL(glPixelStorei)(GL_PACK_ALIGNMENT, 4);
+	/* rows of 8-bit and half float readbacks are not padded either */
+	ORIG_GL(glPixelStorei)(GL_PACK_ALIGNMENT, 1);
 	ORIG_GL(glGetIntegerv)(GL_PACK_SKIP_PIXELS, &savedState->pack_skip_pixels);
 	ORIG_GL(glPixelStorei)(GL_PACK_SKIP_PIXELS, 0);
 	ORIG_GL(glGetIntegerv)(GL_PACK_SKIP_ROWS, &savedState->pack_skip_rows);
@@ -423,6 +432,98 @@ static void restoreTransformFeedbackState(TFBState *tfbState)
 	dbgPrint(DBGLVL_INFO, "\tTODO!!!!!!!!!!!!!!!!!!!!!!!\n");
 }
 
+/* Packed watch items go to the green and blue channels as well; alpha keeps
+ * the mask of the debugged program so that the alpha test still sees the
+ * alpha it wrote.
+ */
+void setDbgColorMask(int numComponents)
+{
+	ORIG_GL(glColorMask)(GL_TRUE, numComponents > 1, numComponents > 1,
+			g.activeColorMask[3]);
+}
+
+/* The scissor test of the debugged program only ever shrinks the focus
+ * region, the fragments outside of both are not shaded at all.
+ */
+void setDbgFocusScissor(void)
+{
+	GLboolean scissorTest;
+	GLint box[4], x0, y0, x1, y1;
+
+	if (!g.focused) {
+		return;
+	}
+	x0 = g.focus[0];
+	y0 = g.focus[1];
+	x1 = g.focus[0] + g.focus[2];
+	y1 = g.focus[1] + g.focus[3];
+	ORIG_GL(glGetBooleanv)(GL_SCISSOR_TEST, &scissorTest);
+	if (scissorTest) {
+		ORIG_GL(glGetIntegerv)(GL_SCISSOR_BOX, box);
+		x0 = box[0] > x0 ? box[0] : x0;
+		y0 = box[1] > y0 ? box[1] : y0;
+		x1 = box[0] + box[2] < x1 ? box[0] + box[2] : x1;
+		y1 = box[1] + box[3] < y1 ? box[1] + box[3] : y1;
+		if (x1 < x0) {
+			x1 = x0;
+		}
+		if (y1 < y0) {
+			y1 = y0;
+		}
+	}
+	ORIG_GL(glEnable)(GL_SCISSOR_TEST);
+	ORIG_GL(glScissor)(x0, y0, x1 - x0, y1 - y0);
+}
+
+const int *getDbgFocusRegion(void)
+{
+	return g.focused ? g.focus : NULL;
+}
+
+void getDbgFocusPlacement(int placement[4])
+{
+	placement[0] = g.focus[0] - g.focusViewport[0];
+	placement[1] = g.focusViewport[1] + g.focusViewport[3] - g.focus[1]
+			- g.focus[3];
+	placement[2] = g.focusViewport[2];
+	placement[3] = g.focusViewport[3];
+}
+
+/* Clips the focus region, given from the top left corner of the viewport, to
+ * the viewport and stores it in window coordinates. An empty focus region
+ * selects the whole viewport.
+ */
+static void setFocusRegion(const GLint viewport[4], const int focus[4])
+{
+	int x0, y0, x1, y1;
+
+	memcpy(g.focusViewport, viewport, sizeof(g.focusViewport));
+	memcpy(g.focus, viewport, sizeof(g.focus));
+	g.focused = 0;
+	if (focus[2] <= 0 || focus[3] <= 0) {
+		return;
+	}
+
+	x0 = focus[0] > 0 ? focus[0] : 0;
+	y0 = focus[1] > 0 ? focus[1] : 0;
+	x1 = focus[0] + focus[2] < viewport[2] ? focus[0] + focus[2] : viewport[2];
+	y1 = focus[1] + focus[3] < viewport[3] ? focus[1] + focus[3] : viewport[3];
+	if (x0 >= x1 || y0 >= y1) {
+		dbgPrint(DBGLVL_WARNING, "focus region %i,%i %ix%i outside of the "
+				"viewport, debugging the whole viewport\n", focus[0], focus[1],
+				focus[2], focus[3]);
+		return;
+	}
+
+	g.focused = 1;
+	g.focus[0] = viewport[0] + x0;
+	g.focus[1] = viewport[1] + viewport[3] - y1;
+	g.focus[2] = x1 - x0;
+	g.focus[3] = y1 - y0;
+	dbgPrint(DBGLVL_INFO, "focus region: %i %i %i %i\n", g.focus[0],
+			g.focus[1], g.focus[2], g.focus[3]);
+}
+
 static int restoreDbgRenderState(int target)
 {
 	DMARK
@@ -576,14 +677,95 @@ DMARK
 	return error;
 }
 
+/* IEEE half float of f rounded to nearest, a carry of the mantissa rounds
+ * into the exponent
+ */
+static GLhalf floatToHalf(float f)
+{
+	union {
+		float f;
+		GLuint u;
+	} v;
+	GLuint sign, mantissa;
+	int exponent;
+
+	v.f = f;
+	sign = (v.u >> 16) & 0x8000;
+	exponent = (int) ((v.u >> 23) & 0xff) - 127 + 15;
+	mantissa = v.u & 0x7fffff;
+
+	if (((v.u >> 23) & 0xff) == 0xff) {
+		/* infinity or NaN */
+		return (GLhalf) (sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	} else if (exponent >= 31) {
+		return (GLhalf) (sign | 0x7c00);
+	} else if (exponent <= 0) {
+		/* denormalized or zero */
+		if (exponent < -10) {
+			return (GLhalf) sign;
+		}
+		mantissa |= 0x800000;
+		return (GLhalf) (sign
+				| ((mantissa + (1 << (13 - exponent))) >> (14 - exponent)));
+	}
+	return (GLhalf) ((sign | (exponent << 10) | (mantissa >> 13))
+			+ ((mantissa >> 12) & 1));
+}
+
+/* Converts the floats of a transform feedback into one of the packed formats
+ * of DBG_SHADER_STEP, a mask is a single row.
+ */
+static void packFeedbackData(const GLfloat *src, int count, int dataFormat,
+		void *dst)
+{
+	int i;
+
+	switch (dataFormat) {
+	case GL_HALF_FLOAT:
+		for (i = 0; i < count; i++) {
+			((GLhalf*) dst)[i] = floatToHalf(src[i]);
+		}
+		break;
+	case GL_UNSIGNED_BYTE:
+		for (i = 0; i < count; i++) {
+			((GLubyte*) dst)[i] = src[i] <= 0.0f ? 0 :
+					src[i] >= 1.0f ? 255 : (GLubyte) (src[i] * 255.0f + 0.5f);
+		}
+		break;
+	case GL_BITMAP:
+		memset(dst, 0, DBG_MASK_ROW_WORDS(count) * sizeof(GLuint));
+		for (i = 0; i < count; i++) {
+			if (src[i] > 0.5f) {
+				((GLuint*) dst)[i / 32] |= (GLuint) 1 << (i % 32);
+			}
+		}
+		break;
+	default:
+		memcpy(dst, src, count * sizeof(GLfloat));
+		break;
+	}
+}
+
 int endTransformFeedback(int primitiveType, int numFloatsPerVertex,
-		float **data, int *numPrimitives, int *numVertices)
+		int dataFormat, void **data, int *numPrimitives, int *numVertices,
+		ALIGNED_DATA *generation)
 {
 	GLuint primitivesGenerated, primitivesWritten;
 	void *mappedBuffer = NULL;
-	int error;
+	int count, size, error;
 
 	DMARK
+	switch (dataFormat) {
+	case GL_FLOAT:
+	case GL_HALF_FLOAT:
+	case GL_UNSIGNED_BYTE:
+	case GL_BITMAP:
+		break;
+	default:
+		dbgPrint(DBGLVL_WARNING, "endTransformFeedback "
+		"Error: requested format %i invalid\n", dataFormat);
+		return DBG_ERROR_READBACK_INVALID_FORMAT;
+	}
 
 	switch (getTFBVersion()) {
 	case TFBVersion_NV:
@@ -654,24 +836,39 @@ int endTransformFeedback(int primitiveType, int numFloatsPerVertex,
 		break;
 	}
 
-	if (!(*data = malloc(*numVertices * numFloatsPerVertex * sizeof(GLfloat)))) {
+	count = *numVertices * numFloatsPerVertex;
+	switch (dataFormat) {
+	case GL_HALF_FLOAT:
+		size = count * sizeof(GLhalf);
+		break;
+	case GL_UNSIGNED_BYTE:
+		size = count * sizeof(GLubyte);
+		break;
+	case GL_BITMAP:
+		size = DBG_MASK_ROW_WORDS(count) * sizeof(GLuint);
+		break;
+	default:
+		size = count * sizeof(GLfloat);
+		break;
+	}
+	if (!(*data = allocResultBuffer(size, generation))) {
 		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
 	}
 	mappedBuffer = ORIG_GL(glMapBuffer)(GL_ARRAY_BUFFER, GL_READ_ONLY);
 	error = glError();
 	if (error) {
-		free(*data);
+		freeResultBuffer(*data, generation ? *generation : 0);
 		*data = NULL;
 		return error;
 	}
 
-	memcpy(*data, mappedBuffer,
-			*numVertices * numFloatsPerVertex * sizeof(GLfloat));
+	/* pack before the data is transferred to the debugger */
+	packFeedbackData((const GLfloat*) mappedBuffer, count, dataFormat, *data);
 
 	ORIG_GL(glUnmapBuffer)(GL_ARRAY_BUFFER);
 	error = glError();
 	if (error) {
-		free(*data);
+		freeResultBuffer(*data, generation ? *generation : 0);
 		*data = NULL;
 		return error;
 	}
@@ -689,7 +886,8 @@ static void writeDbgImage(const char *filename, int width, int height,
 #endif
 
 static void setDbgOutputTargetFragmentData(int alphaTestOption,
-		int depthTestOption, int stencilTestOption, int blendingOption)
+		int depthTestOption, int stencilTestOption, int blendingOption,
+		const int focus[4])
 {
 	pixelTransferState savedState;
 	GLint viewport[4];
@@ -701,6 +899,7 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 	g.stencilBuffer = NULL;
 
 	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+	setFocusRegion(viewport, focus);
 
 	/* TODO: check for fbo support! Do it in debugger!*/
 
@@ -734,14 +933,14 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 
 	/* store color buffer content */
 	if (!(g.colorBuffer = (GLfloat*) malloc(
-			4 * viewport[2] * viewport[3] * sizeof(GLfloat)))) {
+			4 * g.focus[2] * g.focus[3] * sizeof(GLfloat)))) {
 		dbgPrint(DBGLVL_WARNING, "ALLOCATION OF COLOR BUFFER BACKUP FAILED\n");
 		setErrorCode(DBG_ERROR_MEMORY_ALLOCATION_FAILED);
 		return;
 	}
 	ORIG_GL(glGetIntegerv)(GL_READ_BUFFER, &g.activeReadbuffer);
 	ORIG_GL(glReadBuffer)(g.activeDrawbuffer);
-	ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2], viewport[3],
+	ORIG_GL(glReadPixels)(g.focus[0], g.focus[1], g.focus[2], g.focus[3],
 			GL_RGBA, GL_FLOAT, g.colorBuffer);
 	if (setGLErrorCode()) {
 		return;
@@ -750,15 +949,15 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 	/* store depth buffer content */
 	if (g.activeDepthBits) {
 		if (!(g.depthBuffer = (GLfloat*) malloc(
-				viewport[2] * viewport[3] * sizeof(GLfloat)))) {
+				g.focus[2] * g.focus[3] * sizeof(GLfloat)))) {
 			dbgPrint(DBGLVL_WARNING,
 					"ALLOCATION OF DEPTH BUFFER BACKUP FAILED\n");
 			free(g.colorBuffer);
 			setErrorCode(DBG_ERROR_MEMORY_ALLOCATION_FAILED);
 			return;
 		}
-		ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2],
-				viewport[3], GL_DEPTH_COMPONENT, GL_FLOAT, g.depthBuffer);
+		ORIG_GL(glReadPixels)(g.focus[0], g.focus[1], g.focus[2],
+				g.focus[3], GL_DEPTH_COMPONENT, GL_FLOAT, g.depthBuffer);
 #if 0
 		fprintf(stderr, "XXXXXXXXXXXXXX %f %f %f\n",
 				g.depthBuffer[512*256-1], g.depthBuffer[512*256], g.depthBuffer[512*256+1]);
@@ -772,7 +971,7 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 	/* store stencil buffer content */
 	if (g.activeStencilBits) {
 		if (!(g.stencilBuffer = (GLint*) malloc(
-				viewport[2] * viewport[3] * sizeof(GLint)))) {
+				g.focus[2] * g.focus[3] * sizeof(GLint)))) {
 			dbgPrint(DBGLVL_WARNING,
 					"ALLOCATION OF STENCIL BUFFER BACKUP FAILED\n");
 			free(g.colorBuffer);
@@ -780,8 +979,8 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 			setErrorCode(DBG_ERROR_MEMORY_ALLOCATION_FAILED);
 			return;
 		}
-		ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2],
-				viewport[3], GL_STENCIL_INDEX, GL_INT, g.stencilBuffer);
+		ORIG_GL(glReadPixels)(g.focus[0], g.focus[1], g.focus[2],
+				g.focus[3], GL_STENCIL_INDEX, GL_INT, g.stencilBuffer);
 		if (setGLErrorCode()) {
 			return;
 		}
@@ -903,13 +1102,8 @@ static void setDbgOutputTargetFragmentData(int alphaTestOption,
 
 void setDbgOutputTarget(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
+	int focus[4];
 
 	DMARK
 	switch (rec->items[0]) {
@@ -918,8 +1112,12 @@ void setDbgOutputTarget(void)
 		setDbgOutputTargetVertexData();
 		break;
 	case DBG_TARGET_FRAGMENT_SHADER:
+		focus[0] = (int) rec->items[5];
+		focus[1] = (int) rec->items[6];
+		focus[2] = (int) rec->items[7];
+		focus[3] = (int) rec->items[8];
 		setDbgOutputTargetFragmentData((int) rec->items[1], (int) rec->items[2],
-				(int) rec->items[3], (int) rec->items[4]);
+				(int) rec->items[3], (int) rec->items[4], focus);
 		break;
 	default:
 		setErrorCode(DBG_ERROR_INVALID_DBG_TARGET);
@@ -935,6 +1133,7 @@ static void restoreOutputTargetFragmentData(void)
 
 	free(g.colorBuffer);
 	g.colorBuffer = NULL;
+	freeRenderBufferReduction();
 
 	ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, g.activeFBO);
 	ORIG_GL(glDeleteRenderbuffersEXT)(1, &g.dbgBufferFloat);
@@ -983,13 +1182,7 @@ DMARK	ORIG_GL(glDeleteBuffers)(1, &g.tfbBuffer);
 
 void restoreOutputTarget(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	int error;
 
 	DMARK
@@ -1015,80 +1208,417 @@ void restoreOutputTarget(void)
 
 }
 
-int readBackRenderBuffer(int numComponents, int dataFormat, int *width,
-		int *height, void **buffer)
-{
-	pixelTransferState savedState;
-	GLint viewport[4];
-	int format, lineWidth;
-	void *line;
-	char *bf, *bb;
-	int j, error;
-	int formatSize;
+/* nanoseconds to wait for a readback before checking again */
+#define READBACK_WAIT_TIMEOUT 100000000
 
-DMARK	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+/* A readback into a pixel pack buffer, see beginReadBackQueue */
+typedef struct {
+	GLuint buffer;
+	GLsync fence; /* 0 if not fenced */
+	int numComponents;
+	int dataFormat;
+	int width;
+	int height;
+	/* GL_BITMAP only: the buffer holds the mask packed by the GPU, not bytes */
+	int packed;
+	/* where the result is stored when the readback is queued */
+	ALIGNED_DATA *result;
+	ALIGNED_DATA *items;
+} PackReadBack;
 
+/* FIXME: not thread-safe! */
+static struct {
+	int open;
+	int supported; /* -1 if not checked yet */
+	ALIGNED_DATA *result;
+	ALIGNED_DATA *items;
+	PackReadBack *readBacks;
+	int numReadBacks;
+	int maxReadBacks;
+} queue;
+
+/* format, type and component size glReadPixels uses for dataFormat; masks
+ * are read as bytes if the GPU does not pack them
+ */
+static int readBackFormat(int numComponents, int dataFormat, int *format,
+		int *type, int *formatSize)
+{
 	switch (numComponents) {
 	case 1:
-		format = GL_RED;
+		*format = GL_RED;
 		break;
 	case 3:
-		format = GL_RGB;
+		*format = GL_RGB;
 		break;
 	case 4:
-		format = GL_RGBA;
+		*format = GL_RGBA;
 		break;
 	default:
 		dbgPrint(DBGLVL_WARNING, "readBackRenderBuffer "
 		"Error: requested %i components\n", numComponents);
 		return DBG_ERROR_READBACK_INVALID_COMPONENTS;
 	}
+	*type = dataFormat;
 	switch (dataFormat) {
 	case GL_FLOAT:
-		formatSize = sizeof(GLfloat);
+		*formatSize = sizeof(GLfloat);
 		break;
 	case GL_INT:
-		formatSize = sizeof(GLint);
+		*formatSize = sizeof(GLint);
 		break;
 	case GL_UNSIGNED_INT:
-		formatSize = sizeof(GLuint);
+		*formatSize = sizeof(GLuint);
+		break;
+	case GL_UNSIGNED_BYTE:
+		*formatSize = sizeof(GLubyte);
+		break;
+	case GL_HALF_FLOAT:
+		if (!checkGLVersionSupported(3, 0)
+				&& !checkGLExtensionSupported("GL_ARB_half_float_pixel")) {
+			dbgPrint(DBGLVL_WARNING, "readBackRenderBuffer "
+			"Error: half float readback not supported\n");
+			return DBG_ERROR_READBACK_INVALID_FORMAT;
+		}
+		*formatSize = sizeof(GLhalf);
+		break;
+	case GL_BITMAP:
+		if (numComponents != 1) {
+			dbgPrint(DBGLVL_WARNING, "readBackRenderBuffer "
+			"Error: requested %i components for a mask\n", numComponents);
+			return DBG_ERROR_READBACK_INVALID_COMPONENTS;
+		}
+		*type = GL_UNSIGNED_BYTE;
+		*formatSize = sizeof(GLubyte);
 		break;
 	default:
 		dbgPrint(DBGLVL_WARNING, "readBackRenderBuffer "
-		"Error: requested format %i invalid\n", format);
+		"Error: requested format %i invalid\n", dataFormat);
 		return DBG_ERROR_READBACK_INVALID_FORMAT;
 	}
+	return DBG_NO_ERROR;
+}
+
+/* bytes of one row of a readback result */
+static int readBackLineWidth(int numComponents, int dataFormat,
+		int formatSize, int width)
+{
+	if (dataFormat == GL_BITMAP) {
+		return DBG_MASK_ROW_WORDS(width) * sizeof(GLuint);
+	}
+	return numComponents * width * formatSize;
+}
+
+/* Packs rows of bytes read for a GL_BITMAP readback, the rows are addressed
+ * bottom-up to flip the image on the way.
+ */
+static void packMaskRows(const GLubyte *bytes, int width, int height,
+		GLuint *mask)
+{
+	const GLubyte *row;
+	GLuint *words;
+	int x, y, rowWords = DBG_MASK_ROW_WORDS(width);
+
+	memset(mask, 0, rowWords * height * sizeof(GLuint));
+	for (y = 0; y < height; y++) {
+		row = bytes + (height - 1 - y) * width;
+		words = mask + y * rowWords;
+		for (x = 0; x < width; x++) {
+			/* above one half as the GPU classifies it */
+			if (row[x] > 128) {
+				words[x / 32] |= (GLuint) 1 << (x % 32);
+			}
+		}
+	}
+}
+
+static int hasPixelPackBuffers(void)
+{
+	return checkGLVersionSupported(2, 1)
+			|| checkGLExtensionSupported("GL_ARB_pixel_buffer_object");
+}
+
+static int hasSyncObjects(void)
+{
+	return checkGLVersionSupported(3, 2)
+			|| checkGLExtensionSupported("GL_ARB_sync");
+}
+
+static void deletePackReadBack(PackReadBack *rb)
+{
+	if (rb->fence) {
+		ORIG_GL(glDeleteSync)(rb->fence);
+		rb->fence = 0;
+	}
+	ORIG_GL(glDeleteBuffers)(1, &rb->buffer);
+	rb->buffer = 0;
+}
+
+/* Starts reading the region, or the viewport if NULL, of the current read
+ * buffer into a new pixel pack buffer without waiting for the rendering to
+ * finish. Masks are packed on the GPU first if it can.
+ */
+static int startPackReadBack(PackReadBack *rb, int numComponents,
+		int dataFormat, const int *region, int fence)
+{
+	pixelTransferState savedState;
+	GLint viewport[4], packBuffer, fbo = 0;
+	GLuint maskFBO = 0;
+	int format, type, formatSize, error;
+
+	error = readBackFormat(numComponents, dataFormat, &format, &type,
+			&formatSize);
+	if (error) {
+		return error;
+	}
+	error = glError();
+	if (error) {
+		return error;
+	}
+
+	if (region) {
+		memcpy(viewport, region, sizeof(viewport));
+	} else {
+		ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+	}
+	rb->numComponents = numComponents;
+	rb->dataFormat = dataFormat;
+	rb->width = viewport[2];
+	rb->height = viewport[3];
+	rb->packed = 0;
+	rb->fence = 0;
+
+	/* read the words of the packed mask instead of the region */
+	if (dataFormat == GL_BITMAP && hasRenderBufferMaskPacking()) {
+		error = packRenderBufferMask(viewport, &maskFBO, &viewport[2],
+				&viewport[3]);
+		if (error) {
+			return error;
+		}
+		viewport[0] = viewport[1] = 0;
+		numComponents = 4;
+		format = GL_RGBA_INTEGER;
+		type = GL_UNSIGNED_INT;
+		formatSize = sizeof(GLuint);
+		rb->packed = 1;
+		ORIG_GL(glGetIntegerv)(GL_FRAMEBUFFER_BINDING_EXT, &fbo);
+		ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, maskFBO);
+	}
+
+	/* the debugged program may have a pack buffer of its own bound */
+	ORIG_GL(glGetIntegerv)(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+	ORIG_GL(glGenBuffers)(1, &rb->buffer);
+	ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, rb->buffer);
+	ORIG_GL(glBufferData)(GL_PIXEL_PACK_BUFFER,
+			numComponents * viewport[2] * viewport[3] * formatSize, NULL,
+			GL_STREAM_READ);
+	savePixelTransferState(&savedState);
+	ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2], viewport[3],
+			format, type, NULL);
+	restorePixelTransferState(&savedState);
+	ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, packBuffer);
+	if (maskFBO) {
+		ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, fbo);
+	}
+	if (fence) {
+		rb->fence = ORIG_GL(glFenceSync)(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	error = glError();
+	if (error) {
+		deletePackReadBack(rb);
+	}
+	return error;
+}
+
+/* Waits for a started readback and copies it into a result buffer, the rows
+ * are addressed bottom-up to flip the image on the way. The pack buffer is
+ * deleted in any case.
+ */
+static int finishPackReadBack(PackReadBack *rb, void **buffer,
+		ALIGNED_DATA *generation)
+{
+	GLint packBuffer;
+	GLenum status;
+	const char *mapped;
+	char *rows;
+	int lineWidth, formatSize, format, type, j, error;
+
+	if (rb->fence) {
+		do {
+			status = ORIG_GL(glClientWaitSync)(rb->fence,
+					GL_SYNC_FLUSH_COMMANDS_BIT, READBACK_WAIT_TIMEOUT);
+		} while (status == GL_TIMEOUT_EXPIRED);
+		if (status == GL_WAIT_FAILED) {
+			dbgPrint(DBGLVL_WARNING, "readBackRenderBuffer: waiting for "
+					"the readback failed\n");
+			error = glError();
+			deletePackReadBack(rb);
+			return error ? error : GL_INVALID_OPERATION;
+		}
+	}
+
+	readBackFormat(rb->numComponents, rb->dataFormat, &format, &type,
+			&formatSize);
+	lineWidth = readBackLineWidth(rb->numComponents, rb->dataFormat,
+			formatSize, rb->width);
+	if (!(*buffer = allocResultBuffer(lineWidth * rb->height, generation))) {
+		dbgPrint(DBGLVL_WARNING,
+				"readBackRenderBuffer: Allocation of %i bytes failed\n", lineWidth*rb->height);
+		deletePackReadBack(rb);
+		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+	}
+
+	ORIG_GL(glGetIntegerv)(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+	ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, rb->buffer);
+	mapped = (const char*) ORIG_GL(glMapBuffer)(GL_PIXEL_PACK_BUFFER,
+			GL_READ_ONLY);
+	if (mapped && rb->dataFormat == GL_BITMAP && !rb->packed) {
+		packMaskRows((const GLubyte*) mapped, rb->width, rb->height,
+				(GLuint*) *buffer);
+		ORIG_GL(glUnmapBuffer)(GL_PIXEL_PACK_BUFFER);
+	} else if (mapped) {
+		/* rows of a packed mask are as wide as the rows of the result */
+		rows = (char*) *buffer;
+		for (j = 0; j < rb->height; j++) {
+			memcpy(rows + j * lineWidth,
+					mapped + (rb->height - 1 - j) * lineWidth, lineWidth);
+		}
+		ORIG_GL(glUnmapBuffer)(GL_PIXEL_PACK_BUFFER);
+	}
+	ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, packBuffer);
+	deletePackReadBack(rb);
+
+	error = glError();
+	if (!error && !mapped) {
+		error = GL_INVALID_OPERATION;
+	}
+	if (error) {
+		freeResultBuffer(*buffer, generation ? *generation : 0);
+		*buffer = NULL;
+	}
+	return error;
+}
+
+/* GL_BITMAP readback without pixel pack buffers, the bytes are packed here */
+static int readBackMask(const GLint viewport[4], void **buffer,
+		ALIGNED_DATA *generation)
+{
+	pixelTransferState savedState;
+	GLubyte *bytes;
+	int error;
+
+	if (!(bytes = (GLubyte*) malloc(viewport[2] * viewport[3]))) {
+		dbgPrint(DBGLVL_WARNING,
+				"readBackRenderBuffer: Allocation of %i bytes failed\n", viewport[2]*viewport[3]);
+		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+	}
+	savePixelTransferState(&savedState);
+	ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2], viewport[3],
+			GL_RED, GL_UNSIGNED_BYTE, bytes);
+	restorePixelTransferState(&savedState);
+	error = glError();
+	if (error) {
+		free(bytes);
+		return error;
+	}
+
+	if (!(*buffer = allocResultBuffer(
+			DBG_MASK_ROW_WORDS(viewport[2]) * viewport[3] * sizeof(GLuint),
+			generation))) {
+		free(bytes);
+		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+	}
+	packMaskRows(bytes, viewport[2], viewport[3], (GLuint*) *buffer);
+	free(bytes);
+	return DBG_NO_ERROR;
+}
+
+int readBackRenderBuffer(int numComponents, int dataFormat,
+		const int *region, int *width, int *height, void **buffer,
+		ALIGNED_DATA *generation)
+{
+	pixelTransferState savedState;
+	PackReadBack rb;
+	GLint viewport[4];
+	int format, type, lineWidth;
+	void *line;
+	char *bf, *bb;
+	int j, error;
+	int formatSize;
+
+	DMARK
+	if (hasPixelPackBuffers()) {
+		error = startPackReadBack(&rb, numComponents, dataFormat, region, 0);
+		if (!error) {
+			error = finishPackReadBack(&rb, buffer, generation);
+		}
+		if (!error) {
+			*width = rb.width;
+			*height = rb.height;
+		}
+		return error;
+	}
+
+	if (region) {
+		memcpy(viewport, region, sizeof(viewport));
+	} else {
+		ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+	}
+
+	error = readBackFormat(numComponents, dataFormat, &format, &type,
+			&formatSize);
+	if (error) {
+		return error;
+	}
+
+	if (dataFormat == GL_BITMAP) {
+		error = readBackMask(viewport, buffer, generation);
+		if (!error) {
+			*width = viewport[2];
+			*height = viewport[3];
+		}
+		return error;
+	}
 
-	if (!(*buffer = malloc(
-			numComponents * viewport[2] * viewport[3] * formatSize)) || !(line =
-			malloc(numComponents * viewport[2] * formatSize))) {
+	if (!(line = malloc(numComponents * viewport[2] * formatSize))) {
+		dbgPrint(DBGLVL_WARNING,
+				"readBackRenderBuffer: Allocation of %i bytes failed\n", numComponents*viewport[2]*formatSize);
+		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+	}
+	if (!(*buffer = allocResultBuffer(
+			numComponents * viewport[2] * viewport[3] * formatSize,
+			generation))) {
 		dbgPrint(DBGLVL_WARNING,
 				"readBackRenderBuffer: Allocation of %i bytes failed\n", numComponents*viewport[2]*viewport[3]*formatSize);
+		free(line);
 		return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
 	}
 
 	error = glError();
 	if (error) {
-		free(*buffer);
+		free(line);
+		freeResultBuffer(*buffer, generation ? *generation : 0);
 		return error;
 	}
 	savePixelTransferState(&savedState);
 	error = glError();
 	if (error) {
-		free(*buffer);
+		free(line);
+		freeResultBuffer(*buffer, generation ? *generation : 0);
 		return error;
 	}
 	ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2], viewport[3],
-			format, dataFormat, *buffer);
+			format, type, *buffer);
 	error = glError();
 	if (error) {
-		free(*buffer);
+		free(line);
+		freeResultBuffer(*buffer, generation ? *generation : 0);
 		return error;
 	}
 	restorePixelTransferState(&savedState);
 	error = glError();
 	if (error) {
-		free(*buffer);
+		free(line);
+		freeResultBuffer(*buffer, generation ? *generation : 0);
 		return error;
 	}
 
@@ -1096,7 +1626,7 @@ DMARK	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
 	*height = viewport[3];
 
 	/* flip buffer content */
-	lineWidth = numComponents * viewport[2] * sizeof(float);
+	lineWidth = numComponents * viewport[2] * formatSize;
 	bf = (char*) *buffer;
 	bb = (char*) *buffer + (viewport[3] - 1) * lineWidth;
 	for (j = 0; j < viewport[3] / 2; j++) {
@@ -1111,6 +1641,91 @@ DMARK	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
 	return DBG_NO_ERROR;
 }
 
+void beginReadBackQueue(void)
+{
+	queue.open = 1;
+	queue.supported = -1;
+	queue.result = NULL;
+	queue.items = NULL;
+	queue.numReadBacks = 0;
+}
+
+void setReadBackQueueTarget(ALIGNED_DATA *result, ALIGNED_DATA *items)
+{
+	queue.result = result;
+	queue.items = items;
+}
+
+int isReadBackQueued(void)
+{
+	if (!queue.open || !queue.items) {
+		return 0;
+	}
+	if (queue.supported < 0) {
+		queue.supported = hasPixelPackBuffers() && hasSyncObjects();
+	}
+	return queue.supported;
+}
+
+int queueReadBackRenderBuffer(int numComponents, int dataFormat,
+		const int *region, int *width, int *height)
+{
+	PackReadBack *rb;
+	int max, error;
+
+	if (queue.numReadBacks == queue.maxReadBacks) {
+		max = queue.maxReadBacks ? 2 * queue.maxReadBacks : 8;
+		if (!(rb = (PackReadBack*) realloc(queue.readBacks,
+				max * sizeof(PackReadBack)))) {
+			return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+		}
+		queue.readBacks = rb;
+		queue.maxReadBacks = max;
+	}
+
+	rb = &queue.readBacks[queue.numReadBacks];
+	error = startPackReadBack(rb, numComponents, dataFormat, region, 1);
+	if (error) {
+		return error;
+	}
+	rb->result = queue.result;
+	rb->items = queue.items;
+	queue.numReadBacks++;
+
+	*width = rb->width;
+	*height = rb->height;
+	return DBG_NO_ERROR;
+}
+
+int endReadBackQueue(void)
+{
+	PackReadBack *rb;
+	ALIGNED_DATA generation;
+	void *buffer;
+	int i, error, firstError = DBG_NO_ERROR;
+
+	for (i = 0; i < queue.numReadBacks; i++) {
+		rb = &queue.readBacks[i];
+		error = finishPackReadBack(rb, &buffer, &generation);
+		if (error) {
+			*rb->result = DBG_ERROR_CODE;
+			rb->items[0] = (ALIGNED_DATA) error;
+			if (!firstError) {
+				firstError = error;
+			}
+		} else {
+			rb->items[0] = generation ? 0 : (ALIGNED_DATA) buffer;
+			rb->items[3] = generation;
+		}
+	}
+
+	queue.open = 0;
+	queue.result = NULL;
+	queue.items = NULL;
+	queue.numReadBacks = 0;
+	return firstError;
+}
+
 /*
  SHM IN:
  fname    : *
@@ -1125,20 +1740,14 @@ DMARK	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
  */
 void readRenderBuffer(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	int numComponents = (int) rec->items[0];
 	int width, height, error;
 	void *buffer;
 
 	DMARK
-	error = readBackRenderBuffer(numComponents, GL_FLOAT, &width, &height,
-			&buffer);
+	error = readBackRenderBuffer(numComponents, GL_FLOAT, NULL, &width,
+			&height, &buffer, NULL);
 	if (error != DBG_NO_ERROR) {
 		setErrorCode(error);
 	} else {
@@ -1388,19 +1997,12 @@ static void setCopyState(copyStateTarget csTarget)
  */
 void clearRenderBuffer(void)
 {
-#ifndef _WIN32
-	pid_t pid = getpid();
-#else /* _WIN32 */
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DWORD pid = GetCurrentProcessId();
-#endif /* _WIN32 */
-	DbgRec *rec = getThreadRecord(pid);
+	DbgRec *rec = getThreadRecord();
 	GLbitfield clearBits = 0;
 
 	GLfloat clearColor[4];
 	GLfloat clearDepth;
 	GLint clearStencil;
-	GLint viewport[4];
 	GLfloat rasterPos[4];
 	GLfloat projectionMatrix[16];
 	GLfloat modelViewMatrix[16];
@@ -1413,7 +2015,6 @@ void clearRenderBuffer(void)
 	/* save state */
 	saveCopyState(&copyState);
 
-	ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
 	ORIG_GL(glGetFloatv)(GL_CURRENT_RASTER_POSITION, rasterPos);
 	ORIG_GL(glGetFloatv)(GL_PROJECTION_MATRIX, projectionMatrix);
 	ORIG_GL(glGetFloatv)(GL_MODELVIEW_MATRIX, modelViewMatrix);
@@ -1423,8 +2024,9 @@ void clearRenderBuffer(void)
 	ORIG_GL(glLoadIdentity)();
 	ORIG_GL(glMatrixMode)(GL_MODELVIEW);
 	ORIG_GL(glLoadIdentity)();
-	ORIG_GL(glRasterPos2i)(viewport[0], viewport[1]);
-	ORIG_GL(glWindowPos2i)(viewport[0], viewport[1]);
+	/* the saved buffers only hold the focus region */
+	ORIG_GL(glRasterPos2i)(g.focus[0], g.focus[1]);
+	ORIG_GL(glWindowPos2i)(g.focus[0], g.focus[1]);
 
 	dbgPrint(DBGLVL_INFO,
 			"clearRenderBuffer: clearRGB: %li (%f %f %f) "
@@ -1446,16 +2048,19 @@ void clearRenderBuffer(void)
 		} else {
 			/* copy depth buffer content */
 			setCopyState(CS_DEPTH);
-			ORIG_GL(glDrawPixels)(viewport[2], viewport[3], GL_DEPTH_COMPONENT,
+			ORIG_GL(glDrawPixels)(g.focus[2], g.focus[3], GL_DEPTH_COMPONENT,
 					GL_FLOAT, g.depthBuffer);
 #ifdef DEBUG
 			{
-				float *data = (float*)malloc(viewport[2]*viewport[3]*sizeof(GLfloat));
+				GLint viewport[4];
+				float *data;
+				ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+				data = (float*)malloc(viewport[2]*viewport[3]*sizeof(GLfloat));
 				ORIG_GL(glReadPixels)(viewport[0], viewport[1], viewport[2], viewport[3],
 						GL_DEPTH_COMPONENT, GL_FLOAT, data);
 				fprintf(stderr, "XXXXXXXXXXXXXX %f %f %f\n",
 						g.depthBuffer[512*256-1], g.depthBuffer[512*256], g.depthBuffer[512*256+1]);
-				writeDbgImage("DBG-STORED-DEPTHBUFFER.pfm", viewport[2], viewport[3], 1, g.depthBuffer);
+				writeDbgImage("DBG-STORED-DEPTHBUFFER.pfm", g.focus[2], g.focus[3], 1, g.depthBuffer);
 				fprintf(stderr, "XXXXXXXXXXXXXX %f %f %f\n", data[512*256-1], data[512*256], data[512*256+1]);
 				writeDbgImage("DBG-FBO-DEPTHBUFFER.pfm", viewport[2], viewport[3], 1, data);
 				free(data);
@@ -1473,7 +2078,7 @@ void clearRenderBuffer(void)
 		} else {
 			/* copy stencil buffer content */
 			setCopyState(CS_STENCIL);
-			ORIG_GL(glDrawPixels)(viewport[2], viewport[3], GL_STENCIL_INDEX,
+			ORIG_GL(glDrawPixels)(g.focus[2], g.focus[3], GL_STENCIL_INDEX,
 					GL_INT, g.stencilBuffer);
 		}
 	}
@@ -1504,6 +2109,10 @@ void clearRenderBuffer(void)
 	} else {
 		ORIG_GL(glStencilMask)(GL_FALSE);
 	}
+	if (g.focused) {
+		ORIG_GL(glEnable)(GL_SCISSOR_TEST);
+		ORIG_GL(glScissor)(g.focus[0], g.focus[1], g.focus[2], g.focus[3]);
+	}
 	dbgPrint(DBGLVL_INFO, "glClear: %s\n", dissectBitfield(clearBits));
 	ORIG_GL(glClear)(clearBits);
 
@@ -1515,7 +2124,7 @@ void clearRenderBuffer(void)
 				!(rec->items[0] & DBG_CLEAR_RGB),
 				!(rec->items[0] & DBG_CLEAR_RGB),
 				!(rec->items[0] & DBG_CLEAR_ALPHA));
-		ORIG_GL(glDrawPixels)(viewport[2], viewport[3], GL_RGBA, GL_FLOAT,
+		ORIG_GL(glDrawPixels)(g.focus[2], g.focus[3], GL_RGBA, GL_FLOAT,
 				g.colorBuffer);
 	}
 
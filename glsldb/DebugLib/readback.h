@@ -35,6 +35,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define READBACK_H
 
 #include "debuglibExport.h"
+#include "debuglib.h"
 
 DBGLIBLOCAL void setDbgOutputTarget(void);
 
@@ -42,17 +43,64 @@ DBGLIBLOCAL void restoreOutputTarget(void);
 
 DBGLIBLOCAL void readRenderBuffer(void);
 
-DBGLIBLOCAL int readBackRenderBuffer(int numComponents, int format, int *width,
-		int *height, void **buffer);
+/* format: GL_FLOAT, GL_INT, GL_UNSIGNED_INT or one of the packed formats of
+ * DBG_SHADER_STEP; width and height are in pixels for all of them
+ * region: x, y, width and height in window coordinates, NULL for the viewport
+ * generation: see allocResultBuffer, NULL to always read into heap memory
+ */
+DBGLIBLOCAL int readBackRenderBuffer(int numComponents, int format,
+		const int *region, int *width, int *height, void **buffer,
+		ALIGNED_DATA *generation);
+
+/* Queued readbacks of a DBG_BATCH: while the queue is open, fragment shader
+ * steps only start reading the debug render target into a pixel pack buffer
+ * and fence it, so the passes of a step are replayed back to back. The
+ * results are mapped when the queue ends and stored into the result and
+ * items the batch set as target for the step, exactly as readBackRenderBuffer
+ * would have returned them.
+ */
+DBGLIBLOCAL void beginReadBackQueue(void);
+
+DBGLIBLOCAL void setReadBackQueueTarget(ALIGNED_DATA *result,
+		ALIGNED_DATA *items);
+
+/* non-zero if the next readback can be queued; needs pixel buffer objects and
+ * sync objects
+ */
+DBGLIBLOCAL int isReadBackQueued(void);
+
+DBGLIBLOCAL int queueReadBackRenderBuffer(int numComponents, int format,
+		const int *region, int *width, int *height);
+
+/* returns the first error of the queued readbacks */
+DBGLIBLOCAL int endReadBackQueue(void);
 
 DBGLIBLOCAL void clearRenderBuffer(void);
 
+/* enable the channels of the debug render target a shader step writes */
+DBGLIBLOCAL void setDbgColorMask(int numComponents);
+
+/* Focus region of DBG_SET_DBG_TARGET: the scissor limits the shaded
+ * fragments of a shader step to it and readbacks to it are cropped.
+ */
+DBGLIBLOCAL void setDbgFocusScissor(void);
+
+/* region to read back, NULL if the whole viewport is debugged */
+DBGLIBLOCAL const int *getDbgFocusRegion(void);
+
+/* x and y of the focus region from the top left of the viewport, followed
+ * by the viewport size
+ */
+DBGLIBLOCAL void getDbgFocusPlacement(int placement[4]);
+
 /* FIXME CHECK AGAIN!!!
  DBGLIBLOCAL int setDbgRenderState(int target);
  */
 
+/* dataFormat: GL_FLOAT or one of the packed formats of DBG_SHADER_STEP */
 DBGLIBLOCAL int endTransformFeedback(int primitiveType, int numFloatsPerVertex,
-		float **data, int *numPrimitives, int *numVertices);
+		int dataFormat, void **data, int *numPrimitives, int *numVertices,
+		ALIGNED_DATA *generation);
 
 DBGLIBLOCAL int beginTransformFeedback(int primitiveType);
 
@@ -0,0 +1,572 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "reduction.h"
+#include "dbgprint.h"
+
+#ifdef _WIN32
+#include "generated/trampolines.h"
+#endif /* _WIN32 */
+
+/* texels summed up by one fragment of a reduction pass in each direction */
+#define REDUCTION_FACTOR 4
+
+/* The first pass classifies the red channel of the debug render target as
+ * getCoverageFromData and LoopData do, the later passes only sum up. Each
+ * fragment covers REDUCTION_FACTOR x REDUCTION_FACTOR source texels. If
+ * limited, the first pass only counts the pixels set in the limit texture,
+ * which has the size of the region.
+ */
+static const char *reductionShaderSrc =
+		"#version 120\n"
+		"uniform sampler2D source;\n"
+		"uniform sampler2D limit;\n"
+		"uniform vec2 sourceSize;\n"
+		"uniform vec2 textureScale;\n"
+		"uniform bool classify;\n"
+		"uniform bool limited;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 base = floor(gl_FragCoord.xy) * 4.0;\n"
+		"	vec2 sum = vec2(0.0);\n"
+		"	for (int j = 0; j < 4; j++) {\n"
+		"		for (int i = 0; i < 4; i++) {\n"
+		"			vec2 p = base + vec2(i, j);\n"
+		"			if (p.x < sourceSize.x && p.y < sourceSize.y) {\n"
+		"				vec4 v = texture2D(source, (p + 0.5) * textureScale);\n"
+		"				if (!classify) {\n"
+		"					sum += v.rg;\n"
+		"				} else if (!limited\n"
+		"						|| texture2D(limit, (p + 0.5) / sourceSize).r > 0.5) {\n"
+		"					sum += vec2(greaterThan(v.rr, vec2(0.5, 0.75)));\n"
+		"				}\n"
+		"			}\n"
+		"		}\n"
+		"	}\n"
+		"	gl_FragColor = vec4(sum, 0.0, 0.0);\n"
+		"}\n";
+
+/* Packs the red channel into a 1-bit mask as getCoverageFromData classifies
+ * it, each fragment packs 128 pixels of a row into the four words of one
+ * RGBA32UI texel; see DBG_MASK_ROW_WORDS.
+ */
+static const char *maskShaderSrc =
+		"#version 130\n"
+		"uniform sampler2D source;\n"
+		"uniform int sourceWidth;\n"
+		"out uvec4 mask;\n"
+		"void main()\n"
+		"{\n"
+		"	int x = int(gl_FragCoord.x) * 128;\n"
+		"	int y = int(gl_FragCoord.y);\n"
+		"	for (int c = 0; c < 4; c++) {\n"
+		"		uint word = 0u;\n"
+		"		for (int i = 0; i < 32; i++, x++) {\n"
+		"			if (x < sourceWidth\n"
+		"					&& texelFetch(source, ivec2(x, y), 0).r > 0.5) {\n"
+		"				word |= 1u << uint(i);\n"
+		"			}\n"
+		"		}\n"
+		"		mask[c] = word;\n"
+		"	}\n"
+		"}\n";
+
+/* FIXME: not thread-safe! */
+static struct {
+	GLuint program;
+	GLint sourceLoc;
+	GLint sourceSizeLoc;
+	GLint textureScaleLoc;
+	GLint classifyLoc;
+	GLint limitLoc;
+	GLint limitedLoc;
+	GLuint maskProgram;
+	GLint maskSourceLoc;
+	GLint maskSourceWidthLoc;
+	GLuint fbo;
+	/* copy of the region and the two textures the passes alternate on */
+	GLuint textures[3];
+	int width;
+	int height;
+	GLuint maskTexture;
+	int maskWidth;
+	int maskHeight;
+	/* GL_BITMAP limit of reduceRenderBuffer expanded to one byte per pixel */
+	GLuint limitTexture;
+	unsigned char *limitBytes;
+	size_t limitSize;
+} r;
+
+/* program and pipeline state saved around the passes */
+typedef struct {
+	GLint fbo;
+	GLint program;
+	GLint packBuffer;
+	GLint unpackBuffer;
+	/* setReductionState pushed the matrices, they have to be popped even
+	 * if the passes failed
+	 */
+	int matricesPushed;
+} ReductionState;
+
+/* output is the fragment shader output bound to the first draw buffer, NULL
+ * for gl_FragColor
+ */
+static int createReductionProgram(const char *src, const char *output,
+		GLuint *program)
+{
+	GLuint shader;
+	GLint status;
+	int error;
+
+	shader = ORIG_GL(glCreateShader)(GL_FRAGMENT_SHADER);
+	ORIG_GL(glShaderSource)(shader, 1, &src, NULL);
+	ORIG_GL(glCompileShader)(shader);
+	ORIG_GL(glGetShaderiv)(shader, GL_COMPILE_STATUS, &status);
+	if (!status) {
+		dbgPrint(DBGLVL_ERROR, "REDUCTION SHADER COMPILATION failed!\n");
+		ORIG_GL(glDeleteShader)(shader);
+		error = glError();
+		return error ? error : DBG_ERROR_DBG_SHADER_COMPILE_FAILED;
+	}
+
+	*program = ORIG_GL(glCreateProgram)();
+	ORIG_GL(glAttachShader)(*program, shader);
+	ORIG_GL(glDeleteShader)(shader);
+	if (output) {
+		ORIG_GL(glBindFragDataLocation)(*program, 0, output);
+	}
+	ORIG_GL(glLinkProgram)(*program);
+	ORIG_GL(glGetProgramiv)(*program, GL_LINK_STATUS, &status);
+	if (!status) {
+		dbgPrint(DBGLVL_ERROR, "REDUCTION SHADER LINKING failed!\n");
+		ORIG_GL(glDeleteProgram)(*program);
+		*program = 0;
+		error = glError();
+		return error ? error : DBG_ERROR_DBG_SHADER_LINK_FAILED;
+	}
+	return glError();
+}
+
+/* the textures are kept as long as the region size does not change */
+static int allocReductionTextures(int width, int height)
+{
+	int i, w, h;
+
+	if (r.textures[0] && r.width == width && r.height == height) {
+		return DBG_NO_ERROR;
+	}
+	if (r.textures[0]) {
+		ORIG_GL(glDeleteTextures)(3, r.textures);
+	}
+	ORIG_GL(glGenTextures)(3, r.textures);
+	for (i = 0; i < 3; i++) {
+		w = i ? (width + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR : width;
+		h = i ? (height + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR : height;
+		ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.textures[i]);
+		ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+				GL_NEAREST);
+		ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+				GL_NEAREST);
+		ORIG_GL(glTexImage2D)(GL_TEXTURE_2D, 0, GL_RGBA32F_ARB, w, h, 0,
+				GL_RGBA, GL_FLOAT, NULL);
+	}
+	r.width = width;
+	r.height = height;
+	return glError();
+}
+
+static int allocMaskTexture(int width, int height)
+{
+	if (r.maskTexture && r.maskWidth == width && r.maskHeight == height) {
+		return DBG_NO_ERROR;
+	}
+	if (!r.maskTexture) {
+		ORIG_GL(glGenTextures)(1, &r.maskTexture);
+	}
+	ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.maskTexture);
+	ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	ORIG_GL(glTexImage2D)(GL_TEXTURE_2D, 0, GL_RGBA32UI, width, height, 0,
+			GL_RGBA_INTEGER, GL_UNSIGNED_INT, NULL);
+	r.maskWidth = width;
+	r.maskHeight = height;
+	return glError();
+}
+
+/* neutral pipeline state for the passes, undone by glPopAttrib */
+static void setReductionState(void)
+{
+	ORIG_GL(glDisable)(GL_ALPHA_TEST);
+	ORIG_GL(glDisable)(GL_BLEND);
+	ORIG_GL(glDisable)(GL_CULL_FACE);
+	ORIG_GL(glDisable)(GL_DEPTH_TEST);
+	ORIG_GL(glDisable)(GL_SCISSOR_TEST);
+	ORIG_GL(glDisable)(GL_STENCIL_TEST);
+	ORIG_GL(glColorMask)(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	ORIG_GL(glPolygonMode)(GL_FRONT_AND_BACK, GL_FILL);
+
+	/* the copy and the final read are pixel transfers */
+	ORIG_GL(glPixelTransferi)(GL_MAP_COLOR, GL_FALSE);
+	ORIG_GL(glPixelTransferf)(GL_RED_SCALE, 1.0f);
+	ORIG_GL(glPixelTransferf)(GL_GREEN_SCALE, 1.0f);
+	ORIG_GL(glPixelTransferf)(GL_RED_BIAS, 0.0f);
+	ORIG_GL(glPixelTransferf)(GL_GREEN_BIAS, 0.0f);
+	ORIG_GL(glPixelStorei)(GL_PACK_ALIGNMENT, 4);
+	ORIG_GL(glPixelStorei)(GL_PACK_ROW_LENGTH, 0);
+	ORIG_GL(glPixelStorei)(GL_PACK_SKIP_PIXELS, 0);
+	ORIG_GL(glPixelStorei)(GL_PACK_SKIP_ROWS, 0);
+
+	ORIG_GL(glActiveTexture)(GL_TEXTURE0);
+	ORIG_GL(glMatrixMode)(GL_PROJECTION);
+	ORIG_GL(glPushMatrix)();
+	ORIG_GL(glLoadIdentity)();
+	ORIG_GL(glMatrixMode)(GL_MODELVIEW);
+	ORIG_GL(glPushMatrix)();
+	ORIG_GL(glLoadIdentity)();
+}
+
+static void restoreReductionMatrices(void)
+{
+	ORIG_GL(glMatrixMode)(GL_PROJECTION);
+	ORIG_GL(glPopMatrix)();
+	ORIG_GL(glMatrixMode)(GL_MODELVIEW);
+	ORIG_GL(glPopMatrix)();
+}
+
+/* Expands the GL_BITMAP limit of a width x height region into a luminance
+ * texture on texture unit 1.
+ */
+static int uploadLimit(const unsigned int *limit, int width, int height)
+{
+	size_t size = (size_t) width * height;
+	const unsigned int *row;
+	unsigned char *bytes;
+	int x, y;
+
+	if (size > r.limitSize) {
+		bytes = (unsigned char*) realloc(r.limitBytes, size);
+		if (!bytes) {
+			return DBG_ERROR_MEMORY_ALLOCATION_FAILED;
+		}
+		r.limitBytes = bytes;
+		r.limitSize = size;
+	}
+	bytes = r.limitBytes;
+	for (y = 0, row = limit; y < height; y++, row += DBG_MASK_ROW_WORDS(width)) {
+		for (x = 0; x < width; x++) {
+			*bytes++ = (row[x >> 5] >> (x & 31)) & 1 ? 255 : 0;
+		}
+	}
+
+	if (!r.limitTexture) {
+		ORIG_GL(glGenTextures)(1, &r.limitTexture);
+	}
+	ORIG_GL(glActiveTexture)(GL_TEXTURE1);
+	ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.limitTexture);
+	ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	ORIG_GL(glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	ORIG_GL(glPixelStorei)(GL_UNPACK_ALIGNMENT, 1);
+	ORIG_GL(glPixelStorei)(GL_UNPACK_ROW_LENGTH, 0);
+	ORIG_GL(glPixelStorei)(GL_UNPACK_SKIP_PIXELS, 0);
+	ORIG_GL(glPixelStorei)(GL_UNPACK_SKIP_ROWS, 0);
+	ORIG_GL(glTexImage2D)(GL_TEXTURE_2D, 0, GL_LUMINANCE8, width, height, 0,
+			GL_LUMINANCE, GL_UNSIGNED_BYTE, r.limitBytes);
+	ORIG_GL(glActiveTexture)(GL_TEXTURE0);
+	return glError();
+}
+
+/* Sums up the classified region pass by pass until one texel is left, each
+ * pass shrinks it by REDUCTION_FACTOR in both directions.
+ */
+static void runReductionPasses(const int region[4], int limited,
+		GLfloat sums[4])
+{
+	int pass, src, dst, w, h, dstWidth, dstHeight;
+
+	ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.textures[0]);
+	ORIG_GL(glCopyTexSubImage2D)(GL_TEXTURE_2D, 0, 0, 0, region[0], region[1],
+			region[2], region[3]);
+
+	ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, r.fbo);
+	ORIG_GL(glUseProgram)(r.program);
+	ORIG_GL(glUniform1i)(r.sourceLoc, 0);
+	ORIG_GL(glUniform1i)(r.limitLoc, 1);
+	ORIG_GL(glUniform1i)(r.limitedLoc, limited);
+
+	w = region[2];
+	h = region[3];
+	src = 0;
+	for (pass = 0; pass == 0 || w > 1 || h > 1; pass++) {
+		dst = src == 1 ? 2 : 1;
+		dstWidth = (w + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR;
+		dstHeight = (h + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR;
+
+		ORIG_GL(glFramebufferTexture2DEXT)(GL_FRAMEBUFFER_EXT,
+				GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, r.textures[dst], 0);
+		ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.textures[src]);
+		ORIG_GL(glUniform2f)(r.sourceSizeLoc, (GLfloat) w, (GLfloat) h);
+		if (src) {
+			ORIG_GL(glUniform2f)(r.textureScaleLoc,
+					1.0f / ((r.width + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR),
+					1.0f / ((r.height + REDUCTION_FACTOR - 1) / REDUCTION_FACTOR));
+		} else {
+			ORIG_GL(glUniform2f)(r.textureScaleLoc, 1.0f / r.width,
+					1.0f / r.height);
+		}
+		ORIG_GL(glUniform1i)(r.classifyLoc, pass == 0);
+		ORIG_GL(glViewport)(0, 0, dstWidth, dstHeight);
+		ORIG_GL(glRectf)(-1.0f, -1.0f, 1.0f, 1.0f);
+
+		src = dst;
+		w = dstWidth;
+		h = dstHeight;
+	}
+
+	ORIG_GL(glReadPixels)(0, 0, 1, 1, GL_RGBA, GL_FLOAT, sums);
+}
+
+/* Saves the state the passes change and sets up the objects they share.
+ * endReduction has to be called in any case.
+ */
+static int beginReduction(ReductionState *saved, int width, int height)
+{
+	int error;
+
+	ORIG_GL(glGetIntegerv)(GL_FRAMEBUFFER_BINDING_EXT, &saved->fbo);
+	ORIG_GL(glGetIntegerv)(GL_CURRENT_PROGRAM, &saved->program);
+	ORIG_GL(glGetIntegerv)(GL_PIXEL_PACK_BUFFER_BINDING, &saved->packBuffer);
+	ORIG_GL(glGetIntegerv)(GL_PIXEL_UNPACK_BUFFER_BINDING,
+			&saved->unpackBuffer);
+	ORIG_GL(glPushAttrib)(GL_ALL_ATTRIB_BITS);
+	ORIG_GL(glPushClientAttrib)(GL_CLIENT_PIXEL_STORE_BIT);
+	saved->matricesPushed = 0;
+
+	error = glError();
+	if (!error && !r.fbo) {
+		ORIG_GL(glGenFramebuffersEXT)(1, &r.fbo);
+		error = glError();
+	}
+	if (!error) {
+		error = allocReductionTextures(width, height);
+	}
+	if (!error) {
+		setReductionState();
+		saved->matricesPushed = 1;
+		ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, 0);
+		ORIG_GL(glBindBuffer)(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	return error;
+}
+
+static int endReduction(ReductionState *saved, int error)
+{
+	ORIG_GL(glBindBuffer)(GL_PIXEL_PACK_BUFFER, saved->packBuffer);
+	ORIG_GL(glBindBuffer)(GL_PIXEL_UNPACK_BUFFER, saved->unpackBuffer);
+	if (saved->matricesPushed) {
+		restoreReductionMatrices();
+		saved->matricesPushed = 0;
+	}
+	if (!error) {
+		error = glError();
+	}
+	ORIG_GL(glPopClientAttrib)();
+	ORIG_GL(glPopAttrib)();
+	ORIG_GL(glUseProgram)(saved->program);
+	ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, saved->fbo);
+	if (!error) {
+		error = glError();
+	}
+	return error;
+}
+
+int reduceRenderBuffer(const int *region, const unsigned int *limit,
+		int *numCovered, int *numActive)
+{
+	ReductionState saved;
+	GLint viewport[4];
+	GLfloat sums[4];
+	int error;
+
+	if (region) {
+		memcpy(viewport, region, sizeof(viewport));
+	} else {
+		ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+	}
+	if (viewport[2] <= 0 || viewport[3] <= 0) {
+		*numCovered = *numActive = 0;
+		return DBG_NO_ERROR;
+	}
+	if (limit && ((int) limit[0] != viewport[2]
+			|| (int) limit[1] != viewport[3])) {
+		dbgPrint(DBGLVL_ERROR, "reduceRenderBuffer: limit of %ix%i for %ix%i\n",
+				(int) limit[0], (int) limit[1], viewport[2], viewport[3]);
+		return DBG_ERROR_INVALID_VALUE;
+	}
+	error = glError();
+	if (error) {
+		return error;
+	}
+
+	error = beginReduction(&saved, viewport[2], viewport[3]);
+	if (!error && !r.program) {
+		error = createReductionProgram(reductionShaderSrc, NULL, &r.program);
+		if (!error) {
+			r.sourceLoc = ORIG_GL(glGetUniformLocation)(r.program, "source");
+			r.sourceSizeLoc = ORIG_GL(glGetUniformLocation)(r.program,
+					"sourceSize");
+			r.textureScaleLoc = ORIG_GL(glGetUniformLocation)(r.program,
+					"textureScale");
+			r.classifyLoc = ORIG_GL(glGetUniformLocation)(r.program,
+					"classify");
+			r.limitLoc = ORIG_GL(glGetUniformLocation)(r.program, "limit");
+			r.limitedLoc = ORIG_GL(glGetUniformLocation)(r.program,
+					"limited");
+			error = glError();
+		}
+	}
+	if (!error && limit) {
+		error = uploadLimit(limit + 2, viewport[2], viewport[3]);
+	}
+	if (!error) {
+		runReductionPasses(viewport, limit != NULL, sums);
+	}
+	error = endReduction(&saved, error);
+	if (error) {
+		return error;
+	}
+
+	*numCovered = (int) (sums[0] + 0.5f);
+	*numActive = (int) (sums[1] + 0.5f);
+	dbgPrint(DBGLVL_INFO, "reduceRenderBuffer: %ix%i%s covered=%i active=%i\n",
+			viewport[2], viewport[3], limit ? " limited" : "", *numCovered,
+			*numActive);
+	return DBG_NO_ERROR;
+}
+
+int hasRenderBufferMaskPacking(void)
+{
+	return checkGLVersionSupported(3, 0);
+}
+
+int packRenderBufferMask(const int *region, unsigned int *framebuffer,
+		int *width, int *height)
+{
+	ReductionState saved;
+	GLint viewport[4];
+	int error;
+
+	if (region) {
+		memcpy(viewport, region, sizeof(viewport));
+	} else {
+		ORIG_GL(glGetIntegerv)(GL_VIEWPORT, viewport);
+	}
+	*width = DBG_MASK_ROW_WORDS(viewport[2]) / 4;
+	*height = viewport[3];
+	if (viewport[2] <= 0 || viewport[3] <= 0) {
+		return DBG_ERROR_INVALID_VALUE;
+	}
+	error = glError();
+	if (error) {
+		return error;
+	}
+
+	error = beginReduction(&saved, viewport[2], viewport[3]);
+	if (!error && !r.maskProgram) {
+		error = createReductionProgram(maskShaderSrc, "mask", &r.maskProgram);
+		if (!error) {
+			r.maskSourceLoc = ORIG_GL(glGetUniformLocation)(r.maskProgram,
+					"source");
+			r.maskSourceWidthLoc = ORIG_GL(glGetUniformLocation)(
+					r.maskProgram, "sourceWidth");
+			error = glError();
+		}
+	}
+	if (!error) {
+		error = allocMaskTexture(*width, *height);
+	}
+	if (!error) {
+		ORIG_GL(glBindTexture)(GL_TEXTURE_2D, r.textures[0]);
+		ORIG_GL(glCopyTexSubImage2D)(GL_TEXTURE_2D, 0, 0, 0, viewport[0],
+				viewport[1], viewport[2], viewport[3]);
+
+		ORIG_GL(glBindFramebufferEXT)(GL_FRAMEBUFFER_EXT, r.fbo);
+		ORIG_GL(glFramebufferTexture2DEXT)(GL_FRAMEBUFFER_EXT,
+				GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, r.maskTexture, 0);
+		ORIG_GL(glUseProgram)(r.maskProgram);
+		ORIG_GL(glUniform1i)(r.maskSourceLoc, 0);
+		ORIG_GL(glUniform1i)(r.maskSourceWidthLoc, viewport[2]);
+		ORIG_GL(glViewport)(0, 0, *width, *height);
+		ORIG_GL(glRectf)(-1.0f, -1.0f, 1.0f, 1.0f);
+	}
+	error = endReduction(&saved, error);
+	if (error) {
+		return error;
+	}
+
+	*framebuffer = r.fbo;
+	dbgPrint(DBGLVL_INFO, "packRenderBufferMask: %ix%i into %ix%i\n",
+			viewport[2], viewport[3], *width, *height);
+	return DBG_NO_ERROR;
+}
+
+void freeRenderBufferReduction(void)
+{
+	if (r.program) {
+		ORIG_GL(glDeleteProgram)(r.program);
+	}
+	if (r.maskProgram) {
+		ORIG_GL(glDeleteProgram)(r.maskProgram);
+	}
+	if (r.fbo) {
+		ORIG_GL(glDeleteFramebuffersEXT)(1, &r.fbo);
+	}
+	if (r.textures[0]) {
+		ORIG_GL(glDeleteTextures)(3, r.textures);
+	}
+	if (r.maskTexture) {
+		ORIG_GL(glDeleteTextures)(1, &r.maskTexture);
+	}
+	if (r.limitTexture) {
+		ORIG_GL(glDeleteTextures)(1, &r.limitTexture);
+	}
+	free(r.limitBytes);
+	memset(&r, 0, sizeof(r));
+	glError();
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "debuglibExport.h"
+
+/* Statistics of the debug render target computed on the GPU instead of
+ * reading it back: the number of pixels whose red channel is above 0.5
+ * (covered, as for coverage images) and above 0.75 (active, as for loop
+ * conditions). region as for readBackRenderBuffer, NULL for the viewport.
+ * If limit is not NULL, only the pixels set in this mask of the region are
+ * counted: its width and height followed by GL_BITMAP rows (see
+ * DBG_MASK_ROW_WORDS). A mask of another size is an invalid value.
+ */
+DBGLIBLOCAL int reduceRenderBuffer(const int *region,
+		const unsigned int *limit, int *numCovered, int *numActive);
+
+/* non-zero if packRenderBufferMask can be used, it needs OpenGL 3.0 */
+DBGLIBLOCAL int hasRenderBufferMaskPacking(void);
+
+/* Packs the red channel of the region, NULL for the viewport, into a GL_BITMAP
+ * mask (see DBG_MASK_ROW_WORDS) on the GPU. On success framebuffer holds the
+ * mask as RGBA32UI image of width x height texels until the next reduction,
+ * the state of the debug target is left as it was.
+ */
+DBGLIBLOCAL int packRenderBufferMask(const int *region,
+		unsigned int *framebuffer, int *width, int *height);
+
+/* release the GL objects of the reductions, e.g. with the debug target */
+DBGLIBLOCAL void freeRenderBufferReduction(void);
+
+#endif
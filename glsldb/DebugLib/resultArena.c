@@ -0,0 +1,155 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif /* _WIN32 */
+
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "resultArena.h"
+#include "dbgprint.h"
+
+#define RESULT_ARENA_MIN_SIZE (1<<20)
+
+#ifndef _WIN32
+static struct {
+	int shmid;
+	void *base;
+	size_t size;
+} arena = { -1, NULL, 0 };
+
+static void detachArena(DbgShmControl *control)
+{
+	if (arena.base) {
+		shmdt(arena.base);
+		/* the debugger marks the segment for removal once it attached, but it
+		 * may never have seen this one */
+		shmctl(arena.shmid, IPC_RMID, NULL);
+		arena.base = NULL;
+		arena.size = 0;
+		arena.shmid = -1;
+	}
+	if (control) {
+		control->resultSize = 0;
+	}
+}
+
+static int growArena(DbgShmControl *control, size_t size)
+{
+	size_t newSize = RESULT_ARENA_MIN_SIZE;
+	void *base;
+	int shmid;
+
+	while (newSize < size) {
+		newSize *= 2;
+	}
+
+	detachArena(control);
+
+	shmid = shmget(IPC_PRIVATE, newSize, IPC_CREAT | SHM_R | SHM_W);
+	if (shmid == -1) {
+		dbgPrint(DBGLVL_WARNING,
+				"Creation of result arena (%lu bytes) failed: %s\n", (unsigned long)newSize, strerror(errno));
+		return 0;
+	}
+	base = shmat(shmid, NULL, 0);
+	if (base == (void*) -1) {
+		dbgPrint(DBGLVL_WARNING,
+				"Attaching to result arena failed: %s\n", strerror(errno));
+		shmctl(shmid, IPC_RMID, NULL);
+		return 0;
+	}
+	arena.shmid = shmid;
+	arena.base = base;
+	arena.size = newSize;
+
+	control->resultShmid = (ALIGNED_DATA) shmid;
+	control->resultSize = (ALIGNED_DATA) newSize;
+	dbgPrint(DBGLVL_INFO, "result arena: shmid %i, %lu bytes\n", shmid, (unsigned long)newSize);
+	return 1;
+}
+#endif /* _WIN32 */
+
+void *allocResultBuffer(size_t size, ALIGNED_DATA *generation)
+{
+#ifndef _WIN32
+	DbgShmControl *control;
+
+	if (!generation) {
+		return malloc(size);
+	}
+	*generation = 0;
+
+	control = getShmControl();
+	if (control->resultGeneration != control->resultReleased) {
+		/* debugger still holds the previous result */
+		dbgPrint(DBGLVL_DEBUG, "result arena busy, using heap\n");
+		return malloc(size);
+	}
+	if (size > arena.size && !growArena(control, size)) {
+		return malloc(size);
+	}
+	*generation = control->resultGeneration + 1;
+	control->resultGeneration = *generation;
+	return arena.base;
+#else /* _WIN32 */
+	/* no arena, the debugger copies the result out of the heap */
+	if (generation) {
+		*generation = 0;
+	}
+	return malloc(size);
+#endif /* _WIN32 */
+}
+
+void freeResultBuffer(void *buffer, ALIGNED_DATA generation)
+{
+	if (generation) {
+		/* nobody will ever see this result */
+		getShmControl()->resultReleased = generation;
+	} else {
+		free(buffer);
+	}
+}
+
+void freeResultArena(void)
+{
+#ifndef _WIN32
+	detachArena(NULL);
+#endif /* _WIN32 */
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef RESULT_ARENA_H
+#define RESULT_ARENA_H
+
+#include <stddef.h>
+
+#include "debuglibExport.h"
+#include "debuglib.h"
+
+/* Allocate size bytes for a readback result. If generation is not NULL the
+ * buffer is placed in the result arena when possible; *generation is then set
+ * to the arena generation of the result, or to 0 if the buffer was taken from
+ * the heap. In the arena case the returned pointer is the arena base.
+ * There is no arena on windows, results always come from the heap there.
+ */
+DBGLIBLOCAL void *allocResultBuffer(size_t size, ALIGNED_DATA *generation);
+
+/* Give back a buffer from allocResultBuffer that will not be passed to the
+ * debugger (error paths).
+ */
+DBGLIBLOCAL void freeResultBuffer(void *buffer, ALIGNED_DATA generation);
+
+DBGLIBLOCAL void freeResultArena(void);
+
+#endif
@@ -92,10 +92,29 @@ typedef struct {
 	GLint geoOutputType;
 } ShaderProgram;
 
+/* linked debug program, reused while its key matches; see loadDbgShader */
+typedef struct {
+	GLuint handle;
+	unsigned long long key;
+	char *sources[3];
+	int target;
+	int forcePointPrimitiveMode;
+	void *context;
+	unsigned int lastUse;
+} DbgProgramCacheEntry;
+
+#define DBG_PROGRAM_CACHE_SIZE 16
+
 /* FIXME: not thread-safe! */
 static struct {
 	ShaderProgram storedShader;
 	GLint dbgShaderHandle;
+	/* g.dbgShaderHandle is owned by this cache entry, or NULL */
+	DbgProgramCacheEntry *dbgShaderEntry;
+	DbgProgramCacheEntry cache[DBG_PROGRAM_CACHE_SIZE];
+	unsigned int cacheClock;
+	unsigned int cacheHits;
+	unsigned int cacheMisses;
 } g = {{0, 0, NULL, 0, NULL, 0, NULL}, -1};
 
 /* TODO TODO TODO Geometry Shader!!!!!!!!!!!!!! */
@@ -1224,12 +1243,7 @@ void getShaderCode(void)
 	DbgRec* rec;
 	int i, j;
 
-#ifdef _WIN32
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	rec = getThreadRecord(GetCurrentProcessId());
-#else /* _WIN32 */
-	rec = getThreadRecord(getpid());
-#endif /* _WIN32 */
+	rec = getThreadRecord();
 
 	/* clear smem */
 	rec->numItems = 0;
@@ -1470,6 +1484,16 @@ static int attachShaderObject(GLint programHandle, GLenum type, const char *src)
 	return DBG_NO_ERROR;
 }
 
+static void freeDbgProgramCacheEntry(DbgProgramCacheEntry *entry)
+{
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		free(entry->sources[i]);
+	}
+	memset(entry, 0, sizeof(DbgProgramCacheEntry));
+}
+
 /* TODO: error checking */
 static void freeDbgShader(void)
 {
@@ -1478,16 +1502,299 @@ static void freeDbgShader(void)
 		glError();
 		g.dbgShaderHandle = -1;
 	}
+	if (g.dbgShaderEntry) {
+		freeDbgProgramCacheEntry(g.dbgShaderEntry);
+		g.dbgShaderEntry = NULL;
+	}
+}
+
+/* Detach the active debug program; it is only deleted if the cache does not
+ * own it.
+ */
+static void releaseDbgShader(void)
+{
+	if (g.dbgShaderEntry) {
+		g.dbgShaderHandle = -1;
+		g.dbgShaderEntry = NULL;
+	} else {
+		freeDbgShader();
+	}
+}
+
+static void *getCurrentContext(void)
+{
+#ifdef _WIN32
+	return (void*)wglGetCurrentContext();
+#else /* _WIN32 */
+	return (void*)ORIG_GL(glXGetCurrentContext)();
+#endif /* _WIN32 */
+}
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static unsigned long long fnvBytes(unsigned long long h, const void *data,
+                                    size_t size)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		h = (h ^ p[i]) * FNV_PRIME;
+	}
+	return h;
+}
+
+static unsigned long long fnvString(unsigned long long h, const char *s)
+{
+	/* the terminator keeps ("ab", "c") and ("a", "bc") apart */
+	return s ? fnvBytes(h, s, strlen(s) + 1) : fnvBytes(h, "", 0) ^ 1;
+}
+
+/* Everything loadDbgShader reads to build the program goes into the key: the
+ * sources, the debug target, the primitive mode, and the pre-link state taken
+ * from the stored shader. The sources are compared in full on a hit.
+ */
+static unsigned long long dbgProgramKey(const char *sources[3], int target,
+                                        int forcePointPrimitiveMode,
+                                        void *context)
+{
+	unsigned long long h = FNV_OFFSET_BASIS;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		h = fnvString(h, sources[i]);
+	}
+	h = fnvBytes(h, &target, sizeof(target));
+	h = fnvBytes(h, &forcePointPrimitiveMode, sizeof(forcePointPrimitiveMode));
+	h = fnvBytes(h, &context, sizeof(context));
+	h = fnvBytes(h, &g.storedShader.programHandle, sizeof(GLuint));
+	h = fnvBytes(h, &g.storedShader.geoVerticesOut, sizeof(GLint));
+	h = fnvBytes(h, &g.storedShader.geoInputType, sizeof(GLint));
+	h = fnvBytes(h, &g.storedShader.geoOutputType, sizeof(GLint));
+	for (i = 0; i < g.storedShader.numAttributes; i++) {
+		ActiveAttribute *a = &g.storedShader.attributes[i];
+		if (!a->builtin) {
+			h = fnvString(h, a->name);
+			h = fnvBytes(h, &a->location, sizeof(a->location));
+		}
+	}
+	return h;
+}
+
+static int sameSource(const char *a, const char *b)
+{
+	return a == b || (a && b && !strcmp(a, b));
+}
+
+static DbgProgramCacheEntry *findDbgProgram(unsigned long long key,
+                                            const char *sources[3], int target,
+                                            int forcePointPrimitiveMode,
+                                            void *context)
+{
+	int i;
+
+	for (i = 0; i < DBG_PROGRAM_CACHE_SIZE; i++) {
+		DbgProgramCacheEntry *entry = &g.cache[i];
+		if (entry->handle && entry->key == key && entry->target == target &&
+		    entry->forcePointPrimitiveMode == forcePointPrimitiveMode &&
+		    entry->context == context &&
+		    sameSource(entry->sources[0], sources[0]) &&
+		    sameSource(entry->sources[1], sources[1]) &&
+		    sameSource(entry->sources[2], sources[2])) {
+			if (!ORIG_GL(glIsProgram)(entry->handle)) {
+				/* deleted behind our back, e.g. with a shared context */
+				glError();
+				freeDbgProgramCacheEntry(entry);
+				return NULL;
+			}
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Pick the slot for a new program of context: a free one, else the least
+ * recently used program of context, else the least recently used one at all.
+ */
+static DbgProgramCacheEntry *findFreeDbgProgramSlot(void *context)
+{
+	DbgProgramCacheEntry *own = NULL, *other = NULL;
+	int i;
+
+	for (i = 0; i < DBG_PROGRAM_CACHE_SIZE; i++) {
+		DbgProgramCacheEntry *entry = &g.cache[i];
+		if (!entry->handle) {
+			return entry;
+		}
+		if (entry->context == context) {
+			if (!own || entry->lastUse < own->lastUse) {
+				own = entry;
+			}
+		} else if (!other || entry->lastUse < other->lastUse) {
+			other = entry;
+		}
+	}
+	return own ? own : other;
+}
+
+/* Hand the freshly linked g.dbgShaderHandle over to the cache, evicting the
+ * least recently used program if necessary. The handle of a program of
+ * another context means something else in this one, so such a program is only
+ * forgotten and dies with its context. On allocation failure the program
+ * simply stays uncached.
+ */
+static void cacheDbgProgram(unsigned long long key, const char *sources[3],
+                            int target, int forcePointPrimitiveMode,
+                            void *context)
+{
+	DbgProgramCacheEntry *entry = findFreeDbgProgramSlot(context);
+	int i;
+
+	if (entry->handle && entry->context == context) {
+		dbgPrint(DBGLVL_INFO, "evicting debug program %u\n", entry->handle);
+		ORIG_GL(glDeleteProgram)(entry->handle);
+		glError();
+		freeDbgProgramCacheEntry(entry);
+	} else if (entry->handle) {
+		dbgPrint(DBGLVL_INFO, "dropping debug program %u of context %p\n",
+		         entry->handle, entry->context);
+		freeDbgProgramCacheEntry(entry);
+	}
+
+	for (i = 0; i < 3; i++) {
+		if (sources[i] && !(entry->sources[i] = strdup(sources[i]))) {
+			dbgPrint(DBGLVL_WARNING,
+			         "cacheDbgProgram: Allocation of source copy failed\n");
+			freeDbgProgramCacheEntry(entry);
+			return;
+		}
+	}
+	entry->handle = g.dbgShaderHandle;
+	entry->key = key;
+	entry->target = target;
+	entry->forcePointPrimitiveMode = forcePointPrimitiveMode;
+	entry->context = context;
+	entry->lastUse = ++g.cacheClock;
+	g.dbgShaderEntry = entry;
 }
 
+/* upload the uniforms of the stored shader into the active debug program */
+static int copyUniforms(void)
+{
+	int i, error;
+
+	for (i = 0; i < g.storedShader.numUniforms; i++) {
+		ActiveUniform *u = &g.storedShader.uniforms[i];
+		if (!u->builtin) {
+			error = setUniform(g.dbgShaderHandle, u);
+			if (error) {
+				return error;
+			}
+		}
+	}
+	return DBG_NO_ERROR;
+}
+
+/* Reactivate a cached program; only the uniforms have to be uploaded again.
+ * An entry that fails here is dropped.
+ */
+static int useCachedDbgProgram(DbgProgramCacheEntry *entry)
+{
+	int error;
+
+	g.dbgShaderHandle = entry->handle;
+	g.dbgShaderEntry = entry;
+	entry->lastUse = ++g.cacheClock;
+
+	ORIG_GL(glUseProgram)(g.dbgShaderHandle);
+	error = glError();
+	if (!error) {
+		error = copyUniforms();
+	}
+	if (error) {
+		freeDbgShader();
+	}
+	return error;
+}
+
+void freeDbgShaderCache(void)
+{
+	int i;
+
+	/* the programs die with their contexts, the process is going away */
+	for (i = 0; i < DBG_PROGRAM_CACHE_SIZE; i++) {
+		freeDbgProgramCacheEntry(&g.cache[i]);
+	}
+	g.dbgShaderEntry = NULL;
+	g.dbgShaderHandle = -1;
+}
+
+/*
+ *	SHM IN:
+ *		fname    : *
+ *		operation: DBG_GET_DBG_SHADER_CACHE_STATS
+ *		items[0] : non-zero to reset the counters afterwards
+ *	SHM out:
+ *		fname    : *
+ *		result   : DBG_ERROR_CODE
+ *		items[1] : number of cache hits
+ *		items[2] : number of cache misses
+ *		items[3] : number of cached programs
+ */
+void getDbgShaderCacheStats(void)
+{
+	DbgRec *rec = getThreadRecord();
+	int reset = (int)rec->items[0];
+	int i, numEntries = 0;
+
+	for (i = 0; i < DBG_PROGRAM_CACHE_SIZE; i++) {
+		if (g.cache[i].handle) {
+			numEntries++;
+		}
+	}
+	setErrorCode(DBG_NO_ERROR);
+	rec->items[1] = (ALIGNED_DATA)g.cacheHits;
+	rec->items[2] = (ALIGNED_DATA)g.cacheMisses;
+	rec->items[3] = (ALIGNED_DATA)numEntries;
+	if (reset) {
+		g.cacheHits = 0;
+		g.cacheMisses = 0;
+	}
+}
+
+/* Linked debug programs are kept in a small LRU cache, so stepping back to a
+ * statement or refreshing a watch item does not compile and link the same
+ * sources again. A hit only re-uploads the uniforms of the stored shader.
+ */
 int loadDbgShader(const char* vshader, const char *gshader, const char *fshader,
                   int target, int forcePointPrimitiveMode)
 {
 	int haveGeometryShader = checkGLExtensionSupported("GL_EXT_geometry_shader4");
+	const char *sources[3];
+	DbgProgramCacheEntry *entry;
+	unsigned long long key = 0;
+	void *context = NULL;
 	GLint status;
 	int i, error;
 
-	freeDbgShader();
+	releaseDbgShader();
+
+	if (g.storedShader.programHandle != 0) {
+		sources[0] = vshader;
+		sources[1] = target != DBG_TARGET_VERTEX_SHADER ? gshader : NULL;
+		sources[2] = fshader;
+		context = getCurrentContext();
+		key = dbgProgramKey(sources, target, forcePointPrimitiveMode, context);
+		entry = findDbgProgram(key, sources, target, forcePointPrimitiveMode,
+		                       context);
+		if (entry) {
+			g.cacheHits++;
+			dbgPrint(DBGLVL_COMPILERINFO, "REUSE DBG SHADER %u\n", entry->handle);
+			return useCachedDbgProgram(entry);
+		}
+		g.cacheMisses++;
+	}
 
 	g.dbgShaderHandle = ORIG_GL(glCreateProgram)();
 	error = glError();
@@ -1688,17 +1995,14 @@ int loadDbgShader(const char* vshader, const char *gshader, const char *fshader,
 
 	/* copy execution environment of previous active shader */
 	/* post-link part */
-	for (i = 0; i < g.storedShader.numUniforms; i++) {
-		ActiveUniform *u = &g.storedShader.uniforms[i];
-		if (!u->builtin) {
-			error = setUniform(g.dbgShaderHandle, u);
-			if (error) {
-				freeDbgShader();
-				return error;
-			}
-		}
+	error = copyUniforms();
+	if (error) {
+		freeDbgShader();
+		return error;
 	}
 
+	cacheDbgProgram(key, sources, target, forcePointPrimitiveMode, context);
+
 	/* TODO: other state (GL_EXT_bindable_uniform etc.) !!! */
 
 	return DBG_NO_ERROR;
@@ -1712,24 +2016,59 @@ int loadDbgShader(const char* vshader, const char *gshader, const char *fshader,
  *		items[1] : pointer to geometry shader src
  *		items[2] : pointer to fragment shader src
  *		items[3] : debug target
+ *		items[4] : force point primitive mode
  *	SHM out:
  *		fname    : *
  *		result   : DBG_ERROR_CODE on error; else DBG_NO_ERROR
  */
 void setDbgShader(void)
 {
-#ifdef _WIN32
-	/* HAZARD BUG OMGWTF This is plain wrong. Use GetCurrentThreadId() */
-	DbgRec *rec = getThreadRecord(GetCurrentProcessId());
-#else /* _WIN32 */
-	DbgRec *rec = getThreadRecord(getpid());
-#endif /* _WIN32 */
+	DbgRec *rec = getThreadRecord();
 
-	const char *vshader = (const char *)rec->items[0];
-	const char *gshader = (const char *)rec->items[1];
-	const char *fshader = (const char *)rec->items[2];
+	const char *sources[3];
 	int target = (int)rec->items[3];
+	int forcePointPrimitiveMode = (int)rec->items[4];
+	int error;
 
-	setErrorCode(loadDbgShader(vshader, gshader, fshader, target, 0));
+	error = getDbgShaderSources(rec, sources);
+	if (error) {
+		setErrorCode(error);
+		return;
+	}
+	setErrorCode(loadDbgShader(sources[0], sources[1], sources[2], target,
+	                           forcePointPrimitiveMode));
+}
+
+int getDbgShaderSources(DbgRec *rec, const char *sources[3])
+{
+	ALIGNED_DATA *item = &rec->items[DBG_INLINE_SOURCES + 1];
+	ALIGNED_DATA *end = &rec->items[SHM_MAX_ITEMS];
+	ALIGNED_DATA length;
+	int i;
+
+	if (!rec->items[DBG_INLINE_SOURCES]) {
+		for (i = 0; i < 3; i++) {
+			sources[i] = (const char *)rec->items[i];
+		}
+		return DBG_NO_ERROR;
+	}
+
+	/* the strings stay in the record, nothing overwrites them before the
+	 * shaders are compiled
+	 */
+	for (i = 0; i < 3; i++) {
+		if (item >= end) {
+			return DBG_ERROR_INVALID_VALUE;
+		}
+		length = *item++;
+		if (length < 0 || (size_t)length > (size_t)(end - item) * sizeof(ALIGNED_DATA)
+				|| (length > 0 && ((char *)item)[length - 1] != '\0')) {
+			dbgPrint(DBGLVL_ERROR, "invalid inline shader source %i\n", i);
+			return DBG_ERROR_INVALID_VALUE;
+		}
+		sources[i] = length ? (const char *)item : NULL;
+		item += DBG_INLINE_PAD(length) / sizeof(ALIGNED_DATA);
+	}
+	return DBG_NO_ERROR;
 }
 
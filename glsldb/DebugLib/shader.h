@@ -35,6 +35,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SHADER_H
 
 #include "debuglibExport.h"
+#include "debuglib.h"
 
 DBGLIBLOCAL void getShaderCode(void);
 
@@ -44,10 +45,18 @@ DBGLIBLOCAL void restoreActiveShader(void);
 
 DBGLIBLOCAL void setDbgShader(void);
 
+/* sources of DBG_SET_DBG_SHADER or DBG_SHADER_STEP, inline or by address */
+DBGLIBLOCAL int getDbgShaderSources(DbgRec *rec, const char *sources[3]);
+
 DBGLIBLOCAL int loadDbgShader(const char* vshader, const char *gshader,
                               const char *fshader, int target,
                               int forcePointPrimitiveMode);
 
 DBGLIBLOCAL int getShaderPrimitiveMode(void);
 
+DBGLIBLOCAL void getDbgShaderCacheStats(void);
+
+/* drop the cached debug programs, see loadDbgShader */
+DBGLIBLOCAL void freeDbgShaderCache(void);
+
 #endif
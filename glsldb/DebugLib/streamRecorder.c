@@ -36,86 +36,166 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <stdarg.h>
 
+#include "debuglibInternal.h"
 #include "streamRecorder.h"
 #include "replayFunction.h"
 #include "utils/dbgprint.h"
 
+#define STREAM_BLOCK_SIZE (1<<16)
+
+#define STREAM_BLOCK_DATA(block) ((char*)((block) + 1))
+#define STORED_CALL_SIZES(header) \
+	((int*)((char*)(header) + DBG_INLINE_PAD(sizeof(StoredCallHeader))))
+
 void initStreamRecorder(StreamRecorder *rec)
 {
 	rec->numCalls = 0;
-	rec->calls = NULL;
-	rec->lastCall = NULL;
+	rec->blocks = NULL;
+	rec->current = NULL;
+	rec->usedBytes = 0;
+	rec->allocatedBytes = 0;
 }
 
-void recordFunctionCall(StreamRecorder *rec, const char *fname, int numArgs, ...)
+/* return space for a record of size bytes at the end of the stream */
+static char *allocRecord(StreamRecorder *rec, size_t size)
+{
+	StreamBlock *block = rec->current;
+	StreamBlock *next;
+	size_t blockSize;
+
+	if (block && block->size - block->used >= size) {
+		return STREAM_BLOCK_DATA(block) + block->used;
+	}
+
+	next = block ? block->next : rec->blocks;
+	if (!next || next->size < size) {
+		blockSize = size > STREAM_BLOCK_SIZE ? size : STREAM_BLOCK_SIZE;
+		next = malloc(sizeof(StreamBlock) + blockSize);
+		if (!next) {
+			return NULL;
+		}
+		next->size = blockSize;
+		rec->allocatedBytes += sizeof(StreamBlock) + blockSize;
+		/* a block that is too small stays behind the new one */
+		if (block) {
+			next->next = block->next;
+			block->next = next;
+		} else {
+			next->next = rec->blocks;
+			rec->blocks = next;
+		}
+	}
+	next->used = 0;
+	rec->current = next;
+	return STREAM_BLOCK_DATA(next);
+}
+
+void recordFunctionCall(StreamRecorder *rec, int function, int numArgs, ...)
 {
 	int i;
 	va_list argp;
-	StoredCall *newCall;
+	StoredCallHeader *header;
+	int *sizes;
+	char *data;
+	size_t size;
 
-	dbgPrint(DBGLVL_INFO, "RECORD CALL: %s\n", fname);
+	dbgPrint(DBGLVL_INFO, "RECORD CALL: %s\n", glFunctions[function].fname);
 
-	rec->numCalls++;
-	newCall = malloc(sizeof(StoredCall));
-	if (!newCall) {
-		dbgPrint(DBGLVL_ERROR, "Allocation of recorded call failed\n");
-		exit(1); /* TODO: proper error handling */
+	if (numArgs > STREAM_MAX_ARGUMENTS) {
+		dbgPrint(DBGLVL_ERROR, "Cannot record %s: too many arguments\n",
+				glFunctions[function].fname);
+		return;
+	}
+
+	size = DBG_INLINE_PAD(sizeof(StoredCallHeader))
+			+ DBG_INLINE_PAD(numArgs * sizeof(int));
+	va_start(argp, numArgs);
+	for (i = 0; i < numArgs; i++) {
+		(void) va_arg(argp, void*);
+		size += DBG_INLINE_PAD(va_arg(argp, int));
 	}
-	newCall->fname = strdup(fname);
-	newCall->numArguments = numArgs;
-	newCall->arguments = malloc(numArgs * sizeof(sizeof(void*)));
-	if (!newCall->fname || !newCall->arguments) {
+	va_end(argp);
+
+	header = (StoredCallHeader*) allocRecord(rec, size);
+	if (!header) {
 		dbgPrint(DBGLVL_ERROR, "Allocation of recorded call failed\n");
 		exit(1); /* TODO: proper error handling */
 	}
+	header->function = function;
+	header->numArguments = numArgs;
+	header->size = (int) size;
+	sizes = STORED_CALL_SIZES(header);
+	data = (char*) sizes + DBG_INLINE_PAD(numArgs * sizeof(int));
 	va_start(argp, numArgs);
 	for (i = 0; i < numArgs; i++) {
 		void *ptr = (void*) va_arg(argp, void*);
-		int size = (int) va_arg(argp, int);
-		newCall->arguments[i] = malloc(size);
-		if (!newCall->arguments[i]) {
-			dbgPrint(DBGLVL_ERROR, "Allocation of recorded call failed\n");
-			exit(1); /* TODO: proper error handling */
-		}
-		memcpy(newCall->arguments[i], ptr, size);
+		sizes[i] = (int) va_arg(argp, int);
+		memcpy(data, ptr, sizes[i]);
+		data += DBG_INLINE_PAD(sizes[i]);
 	}
 	va_end(argp);
-	if (rec->calls) {
-		rec->lastCall->nextCall = newCall;
-	} else {
-		rec->calls = newCall;
-	}
-	rec->lastCall = newCall;
+
+	rec->current->used += size;
+	rec->usedBytes += size;
+	rec->numCalls++;
 }
 
 void replayFunctionCalls(StreamRecorder *rec, int final)
 {
-	int i;
-	StoredCall *call = rec->calls;
-
-	for (i = 0; i < rec->numCalls; i++) {
-		replayFunctionCall(call, final);
-		call = call->nextCall;
+	void *arguments[STREAM_MAX_ARGUMENTS];
+	StreamBlock *block;
+	StoredCall call;
+	char *pos, *end, *data;
+	int i, *sizes;
+
+	call.arguments = arguments;
+	for (block = rec->blocks; block; block = block->next) {
+		pos = STREAM_BLOCK_DATA(block);
+		end = pos + block->used;
+		while (pos < end) {
+			StoredCallHeader *header = (StoredCallHeader*) pos;
+			call.function = header->function;
+			call.numArguments = header->numArguments;
+			sizes = STORED_CALL_SIZES(header);
+			data = (char*) sizes
+					+ DBG_INLINE_PAD(header->numArguments * sizeof(int));
+			for (i = 0; i < header->numArguments; i++) {
+				arguments[i] = data;
+				data += DBG_INLINE_PAD(sizes[i]);
+			}
+			replayFunctionCall(&call, final);
+			pos += header->size;
+		}
+		if (block == rec->current) {
+			break;
+		}
 	}
 }
 
 void clearRecordedCalls(StreamRecorder *rec)
 {
-	int i, j;
-
-	StoredCall *sc = rec->calls;
-	for (i = 0; i < rec->numCalls; i++) {
-		StoredCall *current = sc;
-		free(current->fname);
-		for (j = 0; j < current->numArguments; j++) {
-			free(current->arguments[j]);
-		}
-		free(current->arguments);
-		sc = current->nextCall;
-		free(current);
+	if (rec->numCalls) {
+		dbgPrint(DBGLVL_INFO, "recorded stream: %i calls, %lu bytes, "
+				"%lu bytes allocated\n", rec->numCalls,
+				(unsigned long) rec->usedBytes,
+				(unsigned long) rec->allocatedBytes);
 	}
 	rec->numCalls = 0;
-	rec->calls = NULL;
-	rec->lastCall = NULL;
+	rec->usedBytes = 0;
+	rec->current = rec->blocks;
+	if (rec->current) {
+		rec->current->used = 0;
+	}
 }
 
+void freeRecordedCalls(StreamRecorder *rec)
+{
+	StreamBlock *block = rec->blocks;
+
+	while (block) {
+		StreamBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+	initStreamRecorder(rec);
+}
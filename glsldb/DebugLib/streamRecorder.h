@@ -34,32 +34,64 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _STREAMRECORDER_H
 #define _STREAMRECORDER_H
 
+#include <stddef.h>
+
 #include "debuglibExport.h"
 
 #define DBG_RECORD_AND_REPLAY 1
 #define DBG_NO_RECORD         2
 #define DBG_RECORD_AND_FINAL  3
 
-typedef struct StoredCall_t {
-	char *fname;
+/* more than any GL function takes */
+#define STREAM_MAX_ARGUMENTS 32
+
+/*
+ Recorded calls are stored back to back in a list of blocks. A record is a
+ StoredCallHeader, numArguments argument sizes (int) and then the argument
+ bytes. The header, the size table and every argument are padded to
+ DBG_INLINE_PAD.
+ */
+typedef struct {
+	/* function ID, see functionIds.h */
+	int function;
+	int numArguments;
+	/* size of the whole record in bytes */
+	int size;
+} StoredCallHeader;
+
+typedef struct StreamBlock_t {
+	struct StreamBlock_t *next;
+	size_t size;
+	size_t used;
+} StreamBlock;
+
+/* decoded view of a record for replayFunctionCall; arguments point into the
+ * stream */
+typedef struct {
+	int function;
 	int numArguments;
 	void **arguments;
-	struct StoredCall_t *nextCall;
 } StoredCall;
 
 typedef struct {
 	int numCalls;
-	StoredCall *calls;
-	StoredCall *lastCall;
+	StreamBlock *blocks;
+	/* block that is filled right now; blocks behind it are kept for reuse */
+	StreamBlock *current;
+	/* bytes of recorded calls and bytes allocated for blocks */
+	size_t usedBytes;
+	size_t allocatedBytes;
 } StreamRecorder;
 
 DBGLIBLOCAL void initStreamRecorder(StreamRecorder *rec);
 
-DBGLIBLOCAL void recordFunctionCall(StreamRecorder *rec, const char *fname, int numArgs, ...);
+DBGLIBLOCAL void recordFunctionCall(StreamRecorder *rec, int function, int numArgs, ...);
 
 DBGLIBLOCAL void replayFunctionCalls(StreamRecorder *rec, int final);
 
+/* forget the recorded calls but keep the blocks */
 DBGLIBLOCAL void clearRecordedCalls(StreamRecorder *rec);
 
-#endif
+DBGLIBLOCAL void freeRecordedCalls(StreamRecorder *rec);
 
+#endif
@@ -0,0 +1,233 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif /* _WIN32 */
+
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "traceRing.h"
+#include "dbgprint.h"
+
+#define TRACE_RING_SIZE (1<<22)
+/* interval in us to check whether the debugger drained a full ring */
+#define TRACE_RING_POLL_INTERVAL 100
+
+#ifndef _WIN32
+static int traceShmid = -1;
+static DbgTraceRing *traceRing = NULL;
+
+static size_t argumentSize(int type)
+{
+	switch (type) {
+	case DBG_TYPE_CHAR:
+		return sizeof(char);
+	case DBG_TYPE_UNSIGNED_CHAR:
+		return sizeof(unsigned char);
+	case DBG_TYPE_SHORT_INT:
+		return sizeof(short);
+	case DBG_TYPE_UNSIGNED_SHORT_INT:
+		return sizeof(unsigned short);
+	case DBG_TYPE_INT:
+		return sizeof(int);
+	case DBG_TYPE_UNSIGNED_INT:
+		return sizeof(unsigned int);
+	case DBG_TYPE_LONG_INT:
+		return sizeof(long);
+	case DBG_TYPE_UNSIGNED_LONG_INT:
+		return sizeof(unsigned long);
+	case DBG_TYPE_LONG_LONG_INT:
+		return sizeof(long long);
+	case DBG_TYPE_UNSIGNED_LONG_LONG_INT:
+		return sizeof(unsigned long long);
+	case DBG_TYPE_FLOAT:
+		return sizeof(float);
+	case DBG_TYPE_DOUBLE:
+		return sizeof(double);
+	case DBG_TYPE_POINTER:
+		return sizeof(void*);
+	case DBG_TYPE_BOOLEAN:
+		return sizeof(GLboolean);
+	case DBG_TYPE_BITFIELD:
+		return sizeof(GLbitfield);
+	case DBG_TYPE_ENUM:
+		return sizeof(GLenum);
+	default:
+		return 0;
+	}
+}
+
+/* wait until needed bytes are free; fails if the debugger does not drain the
+ * ring any more because it is about to stop us */
+static int waitForSpace(DbgRec *rec, ALIGNED_DATA needed)
+{
+	while (traceRing->size - (traceRing->head - traceRing->tail) < needed) {
+		if (rec->operation != DBG_EXECUTE) {
+			return 0;
+		}
+		usleep(TRACE_RING_POLL_INTERVAL);
+	}
+	memoryBarrier();
+	return 1;
+}
+#endif /* _WIN32 */
+
+int openTraceRing(void)
+{
+#ifndef _WIN32
+	DbgShmControl *control = getShmControl();
+	void *base;
+	int shmid;
+
+	if (!traceRing) {
+		shmid = shmget(IPC_PRIVATE, TRACE_RING_SIZE, IPC_CREAT | SHM_R | SHM_W);
+		if (shmid == -1) {
+			dbgPrint(DBGLVL_WARNING,
+					"Creation of trace ring failed: %s\n", strerror(errno));
+			return 0;
+		}
+		base = shmat(shmid, NULL, 0);
+		if (base == (void*) -1) {
+			dbgPrint(DBGLVL_WARNING,
+					"Attaching to trace ring failed: %s\n", strerror(errno));
+			shmctl(shmid, IPC_RMID, NULL);
+			return 0;
+		}
+		traceShmid = shmid;
+		traceRing = (DbgTraceRing*) base;
+		traceRing->size = TRACE_RING_SIZE - sizeof(DbgTraceRing);
+		control->traceShmid = (ALIGNED_DATA) shmid;
+		control->traceSize = (ALIGNED_DATA) TRACE_RING_SIZE;
+		dbgPrint(DBGLVL_INFO, "trace ring: shmid %i\n", shmid);
+	}
+	/* the debugger is waiting for us, so nobody reads the ring right now */
+	traceRing->head = 0;
+	traceRing->tail = 0;
+	traceRing->dropped = 0;
+	return 1;
+#else /* _WIN32 */
+	/* not supported, tracing needs a System V segment */
+	return 0;
+#endif /* _WIN32 */
+}
+
+void traceFunctionCall(int function, int numArgs, ...)
+{
+#ifndef _WIN32
+	DbgRec *rec = getThreadRecord();
+	DbgTraceRecord *record;
+	ALIGNED_DATA *args;
+	ALIGNED_DATA size, pos, skip = 0;
+	char *data;
+	va_list argp;
+	void *addr;
+	int i, type;
+
+	if (!traceRing) {
+		return;
+	}
+
+	size = sizeof(DbgTraceRecord) + 2 * numArgs * sizeof(ALIGNED_DATA);
+	va_start(argp, numArgs);
+	for (i = 0; i < numArgs; i++) {
+		addr = va_arg(argp, void*);
+		type = va_arg(argp, int);
+		size += DBG_INLINE_PAD(argumentSize(type));
+	}
+	va_end(argp);
+
+	pos = traceRing->head % traceRing->size;
+	if (traceRing->size - pos < size) {
+		skip = traceRing->size - pos;
+	}
+	if (skip + size > traceRing->size || !waitForSpace(rec, skip + size)) {
+		traceRing->dropped++;
+		return;
+	}
+	if (skip) {
+		if (skip >= (ALIGNED_DATA) sizeof(DbgTraceRecord)) {
+			record = (DbgTraceRecord*) (DBG_TRACE_DATA(traceRing) + pos);
+			record->size = skip;
+			record->function = DBG_TRACE_WRAP;
+		}
+		pos = 0;
+	}
+
+	record = (DbgTraceRecord*) (DBG_TRACE_DATA(traceRing) + pos);
+	record->size = size;
+	record->function = function;
+	record->threadId = rec->threadId;
+	record->numArgs = numArgs;
+	args = DBG_TRACE_ARGS(record);
+	data = (char*) (args + 2 * numArgs);
+	va_start(argp, numArgs);
+	for (i = 0; i < numArgs; i++) {
+		addr = va_arg(argp, void*);
+		type = va_arg(argp, int);
+		args[2 * i] = (ALIGNED_DATA) type;
+		args[2 * i + 1] = (ALIGNED_DATA) addr;
+		memcpy(data, addr, argumentSize(type));
+		data += DBG_INLINE_PAD(argumentSize(type));
+	}
+	va_end(argp);
+
+	/* publish the record only after it is complete */
+	memoryBarrier();
+	traceRing->head += skip + size;
+#else /* _WIN32 */
+	(void) function;
+	(void) numArgs;
+#endif /* _WIN32 */
+}
+
+void freeTraceRing(void)
+{
+#ifndef _WIN32
+	if (traceRing) {
+		shmdt(traceRing);
+		/* the debugger marks the segment for removal once it attached, but it
+		 * may never have seen this one */
+		shmctl(traceShmid, IPC_RMID, NULL);
+		traceRing = NULL;
+		traceShmid = -1;
+	}
+#endif /* _WIN32 */
+}
@@ -28,3 +28,15 @@ GLFunctionList* FunctionsMap::operator[](const std::string& name)
 		func = it->second;
 	return func;
 }
+
+int FunctionsMap::id(const std::string& name)
+{
+	GLFunctionList* func = (*this)[name];
+	return func ? (int)(func - glFunctions) : -1;
+}
+
+const char* FunctionsMap::name(int id)
+{
+	/* the names are unique, so the map holds all of glFunctions */
+	return id >= 0 && id < (int)_map.size() ? glFunctions[id].fname : 0;
+}
@@ -12,6 +12,10 @@ public:
 	static FunctionsMap& instance();
 	void initialize();
 	GLFunctionList* operator[](const std::string& name);
+	/* function ID (index into glFunctions), -1 for unknown names */
+	int id(const std::string& name);
+	/* name of a function ID, 0 for IDs outside glFunctions */
+	const char* name(int id);
 private:
 	static FunctionsMap* _instance;
 	GLFunctionsMap _map;
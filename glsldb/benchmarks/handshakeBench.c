@@ -0,0 +1,164 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/*
+ * Round trip latency of the debugger/debuggee command handshake: SIGSTOP +
+ * PTRACE_CONT/waitpid versus the shared memory doorbells.
+ *
+ * A forked child that is traced by this process serves as stand-in for the
+ * debuggee. Usage: handshakeBench [number of round trips]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+
+#include "sync.h"
+#include "benchtime.h"
+
+typedef struct {
+	ShmEvent debuggeeDoorbell;
+	ShmEvent debuggerDoorbell;
+} Doorbells;
+
+static void debuggee(int useDoorbell, Doorbells *d, long rounds)
+{
+	long i;
+
+	ptrace(PTRACE_TRACEME, 0, 0, 0);
+	raise(SIGSTOP);
+	for (i = 0; i < rounds; i++) {
+		if (useDoorbell) {
+			setShmEvent(&d->debuggerDoorbell);
+			waitShmEvent(&d->debuggeeDoorbell, TIMEOUT_INFINITE);
+		} else {
+			raise(SIGSTOP);
+		}
+	}
+	_exit(0);
+}
+
+static int debugger(int useDoorbell, Doorbells *d, long rounds, pid_t child)
+{
+	int status;
+	long i;
+	double t0, t;
+
+	/* initial stop */
+	if (waitpid(child, &status, WUNTRACED) != child || !WIFSTOPPED(status)) {
+		return 1;
+	}
+	ptrace(PTRACE_CONT, child, 0, 0);
+	if (useDoorbell) {
+		waitShmEvent(&d->debuggerDoorbell, TIMEOUT_INFINITE);
+	} else {
+		waitpid(child, &status, WUNTRACED);
+	}
+
+	t0 = now();
+	for (i = 1; i < rounds; i++) {
+		if (useDoorbell) {
+			setShmEvent(&d->debuggeeDoorbell);
+			waitShmEvent(&d->debuggerDoorbell, TIMEOUT_INFINITE);
+		} else {
+			ptrace(PTRACE_CONT, child, 0, 0);
+			if (waitpid(child, &status, WUNTRACED) != child
+					|| !WIFSTOPPED(status)) {
+				return 1;
+			}
+		}
+	}
+	t = now() - t0;
+
+	if (useDoorbell) {
+		setShmEvent(&d->debuggeeDoorbell);
+	} else {
+		ptrace(PTRACE_CONT, child, 0, 0);
+	}
+	waitpid(child, &status, 0);
+
+	printf("%-10s %8ld round trips  %8.2f us/round trip\n",
+			useDoorbell ? "doorbell" : "signal", rounds - 1,
+			t * 1e6 / (rounds - 1));
+	fflush(stdout);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	long rounds = 20000;
+	int useDoorbell, error = 0;
+	Doorbells *d;
+	pid_t child;
+
+	if (argc > 1) {
+		rounds = strtol(argv[1], NULL, 10);
+	}
+	if (rounds < 2) {
+		rounds = 2;
+	}
+
+	d = mmap(NULL, sizeof(Doorbells), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (d == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	for (useDoorbell = 0; useDoorbell < 2 && !error; useDoorbell++) {
+		initShmEvent(&d->debuggeeDoorbell, 0);
+		initShmEvent(&d->debuggerDoorbell, 0);
+
+		child = fork();
+		if (child == -1) {
+			perror("fork");
+			return 1;
+		} else if (child == 0) {
+			debuggee(useDoorbell, d, rounds);
+		}
+		error = debugger(useDoorbell, d, rounds, child);
+		if (error) {
+			fprintf(stderr, "handshake failed\n");
+			kill(child, SIGKILL);
+		}
+	}
+
+	munmap(d, sizeof(Doorbells));
+	return error;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/*
+ * Per call overhead of the generated glVertex3f hook of libglsldebug in
+ * DBG_EXECUTE_RUN mode, against a direct call of the original function and
+ * against resolving the original through getOrigFunc on every call, as
+ * ORIG_GL did before the hooks cached it.
+ *
+ * The benchmark plays the debugger: it creates the shared memory segment,
+ * puts the first thread record into DBG_EXECUTE_RUN and runs itself again
+ * with libglsldebug preloaded, like ProgramControl sets up the debuggee.
+ * The original function lives in a stub libGL (stubGL) that is first in the
+ * library path when the debug library opens libGL.so.
+ * Usage: hookBench [number of calls]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+
+#include "DebugLib/debuglib.h"
+#include "benchtime.h"
+
+typedef void (*PFNglVertex3fPROC)(float, float, float);
+typedef void (*(*PFNgetOrigFuncPROC)(const char*))(void);
+
+static PFNgetOrigFuncPROC getOrigFunc;
+
+static void lookup(float x, float y, float z)
+{
+	((PFNglVertex3fPROC)getOrigFunc("glVertex3f"))(x, y, z);
+}
+
+static void run(const char *name, void (*hook)(float, float, float),
+		long calls)
+{
+	double t0, t;
+	long i;
+
+	hook(0.0f, 0.0f, 0.0f);
+	t0 = now();
+	for (i = 0; i < calls; i++) {
+		hook((float) i, 1.0f, 2.0f);
+	}
+	t = now() - t0;
+	printf("%-10s %10ld calls  %8.2f ns/call\n", name, calls, t * 1e9 / calls);
+	fflush(stdout);
+}
+
+/* the debuggee side, running with libglsldebug preloaded */
+static int bench(long calls)
+{
+	PFNglVertex3fPROC direct, hooked;
+
+	/* dlsym is the debug library's and hands out its hooks */
+	hooked = (PFNglVertex3fPROC) dlsym(RTLD_DEFAULT, "glVertex3f");
+	getOrigFunc = (PFNgetOrigFuncPROC) dlsym(RTLD_DEFAULT,
+			"DEBUGLIB_EXTERNAL_getOrigFunc");
+	if (!hooked || !getOrigFunc) {
+		fprintf(stderr, "debug library not loaded\n");
+		return 1;
+	}
+	if (!dlopen(STUBGL_DIR "/libGL.so", RTLD_LAZY | RTLD_NOLOAD)) {
+		fprintf(stderr, "stub libGL not loaded\n");
+		return 1;
+	}
+	direct = (PFNglVertex3fPROC) getOrigFunc("glVertex3f");
+
+	run("direct", direct, calls);
+	run("hook", hooked, calls);
+	run("lookup", lookup, calls);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	long calls = 10000000;
+	char shmid[32], count[32];
+	char plugins[] = "/tmp/hookBenchXXXXXX";
+	DbgRec *fcalls;
+	int id, status;
+	pid_t pid;
+
+	if (argc > 1) {
+		calls = strtol(argv[1], NULL, 10);
+	}
+	if (calls < 1) {
+		calls = 1;
+	}
+	if (getenv("GLSL_DEBUGGER_SHMID")) {
+		return bench(calls);
+	}
+
+	id = shmget(IPC_PRIVATE, SHM_SIZE, SHM_R | SHM_W);
+	if (id == -1) {
+		fprintf(stderr, "shmget failed: %s\n", strerror(errno));
+		return 1;
+	}
+	fcalls = (DbgRec*) shmat(id, NULL, 0);
+	if ((void*) fcalls == (void*) -1) {
+		fprintf(stderr, "shmat failed: %s\n", strerror(errno));
+		shmctl(id, IPC_RMID, NULL);
+		return 1;
+	}
+	memset(fcalls, 0, SHM_SIZE);
+	/* the first thread of the debuggee claims slot 0 */
+	fcalls[0].operation = DBG_EXECUTE;
+	fcalls[0].items[0] = DBG_EXECUTE_RUN;
+
+	/* no debug functions */
+	if (!mkdtemp(plugins)) {
+		fprintf(stderr, "mkdtemp failed: %s\n", strerror(errno));
+		shmctl(id, IPC_RMID, NULL);
+		shmdt(fcalls);
+		return 1;
+	}
+
+	snprintf(shmid, sizeof(shmid), "%i", id);
+	snprintf(count, sizeof(count), "%ld", calls);
+	pid = fork();
+	if (pid == 0) {
+		/* a released debuggee does not print at INFO level */
+		setenv("GLSL_DEBUGGER_LOGLEVEL", "0", 1);
+		setenv("GLSL_DEBUGGER_SHMID", shmid, 1);
+		setenv("GLSL_DEBUGGER_DBGFCTNS_PATH", plugins, 1);
+		setenv("GLSL_DEBUGGER_LIBDLSYM", LIBDLSYM, 1);
+		setenv("LD_PRELOAD", GLSLDEBUG_LIBRARY, 1);
+		setenv("LD_LIBRARY_PATH", STUBGL_DIR, 1);
+		execl("/proc/self/exe", argv[0], count, (char*) NULL);
+		fprintf(stderr, "exec failed: %s\n", strerror(errno));
+		_exit(1);
+	}
+	status = 1;
+	if (pid == -1) {
+		fprintf(stderr, "fork failed: %s\n", strerror(errno));
+	} else {
+		waitpid(pid, &status, 0);
+	}
+
+	rmdir(plugins);
+	shmctl(id, IPC_RMID, NULL);
+	shmdt(fcalls);
+	return !WIFEXITED(status) || WEXITSTATUS(status);
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/*
+ * Throughput of cpyFromProcess/cpyToProcess for each transfer method.
+ *
+ * A forked child that is traced by this process serves as stand-in for the
+ * debuggee. Usage: p2pcopyBench [max. size in MB] [max. ptrace size in MB]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/ptrace.h>
+
+#include "p2pcopy.h"
+#include "dbgprint.h"
+#include "benchtime.h"
+
+#define KB (1024)
+#define MB (1024*1024)
+
+/* repeat each transfer until at least this many bytes have been copied */
+#define MIN_BYTES_PER_SIZE (64*MB)
+
+static const char *modeName(int mode)
+{
+	switch (mode) {
+	case P2P_COPY_VM:
+		return "process_vm";
+	case P2P_COPY_PROCMEM:
+		return "/proc/pid/mem";
+	case P2P_COPY_PTRACE:
+		return "ptrace";
+	default:
+		return "auto";
+	}
+}
+
+static int benchMode(pid_t child, int mode, char *remote, char *local,
+		size_t maxSize)
+{
+	size_t size;
+
+	if (setP2PCopyMode(mode) != 0) {
+		printf("%-14s not available\n", modeName(mode));
+		return 0;
+	}
+	for (size = KB; size <= maxSize; size *= 4) {
+		int i, reps = (int) (MIN_BYTES_PER_SIZE / size);
+		double t0, tRead, tWrite;
+
+		if (reps < 2) {
+			reps = 2;
+		}
+
+		memset(local, 0, size);
+		t0 = now();
+		for (i = 0; i < reps; i++) {
+			cpyFromProcess(child, local, remote, size);
+		}
+		tRead = now() - t0;
+
+		if (local[0] != (char) 0x5a || local[size - 1] != (char) 0x5a) {
+			fprintf(stderr, "%s: data mismatch at %lu bytes\n", modeName(mode),
+					(unsigned long) size);
+			return 1;
+		}
+
+		t0 = now();
+		for (i = 0; i < reps; i++) {
+			cpyToProcess(child, remote, local, size);
+		}
+		tWrite = now() - t0;
+
+		printf("%-14s %10lu KB  read %10.1f MB/s  write %10.1f MB/s\n",
+				modeName(mode), (unsigned long) (size / KB),
+				(double) size * reps / MB / tRead,
+				(double) size * reps / MB / tWrite);
+		fflush(stdout);
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	size_t maxSize = 256 * (size_t) MB;
+	size_t maxPtraceSize = 16 * (size_t) MB;
+	int status, error = 0;
+	char *remote, *local;
+	pid_t child;
+
+	if (argc > 1) {
+		maxSize = strtoul(argv[1], NULL, 10) * MB;
+	}
+	if (argc > 2) {
+		maxPtraceSize = strtoul(argv[2], NULL, 10) * MB;
+	}
+	if (maxPtraceSize > maxSize) {
+		maxPtraceSize = maxSize;
+	}
+
+	setMaxDebugOutputLevel(DBGLVL_ERROR);
+
+	/* same virtual address in parent and child after fork */
+	remote = malloc(maxSize);
+	local = malloc(maxSize);
+	if (!remote || !local) {
+		fprintf(stderr, "not enough memory for %lu MB buffers\n",
+				(unsigned long) (maxSize / MB));
+		return 1;
+	}
+
+	child = fork();
+	if (child == -1) {
+		perror("fork");
+		return 1;
+	} else if (child == 0) {
+		ptrace(PTRACE_TRACEME, 0, 0, 0);
+		memset(remote, 0x5a, maxSize);
+		raise(SIGSTOP);
+		pause();
+		_exit(0);
+	}
+
+	if (waitpid(child, &status, WUNTRACED) == -1 || !WIFSTOPPED(status)) {
+		fprintf(stderr, "stand-in debuggee did not stop\n");
+		return 1;
+	}
+
+	error |= benchMode(child, P2P_COPY_VM, remote, local, maxSize);
+	error |= benchMode(child, P2P_COPY_PROCMEM, remote, local, maxSize);
+	error |= benchMode(child, P2P_COPY_PTRACE, remote, local, maxPtraceSize);
+
+	kill(child, SIGKILL);
+	waitpid(child, &status, 0);
+	free(remote);
+	free(local);
+	return error;
+}
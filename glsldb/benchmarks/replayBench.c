@@ -0,0 +1,167 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/*
+ * Replay of a recorded stream through replayFunctionCall into a stub libGL
+ * (stubGL), compared to calling the stub directly with the same arguments.
+ *
+ * Usage: replayBench [number of calls]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+
+#include "debuglibInternal.h"
+#include "streamRecorder.h"
+#include "dbgprint.h"
+#include "benchtime.h"
+
+#define ROUNDS 20
+
+/* written by the stub, keeps it linked */
+extern volatile float stubGLSink;
+
+/* the debug library resolves the originals the same way */
+void (*getOrigFunc(const char *fname))(void)
+{
+	return (void (*)(void)) dlsym(RTLD_NEXT, fname);
+}
+
+static void callDirect(long calls)
+{
+	GLfloat x = 1.0f, y = 2.0f, z = 3.0f;
+	GLubyte c = 255;
+	long i;
+
+	for (i = 0; i < calls; i++) {
+		switch (i % 8) {
+		case 0:
+			glBindTexture(GL_TEXTURE_2D, (GLuint) i);
+			break;
+		case 1:
+			glColor4ub(c, c, c, c);
+			break;
+		case 2:
+		case 3:
+			glNormal3f(x, y, z);
+			break;
+		case 4:
+		case 5:
+			glTexCoord2f(x, y);
+			break;
+		default:
+			glVertex3f(x, y, z);
+		}
+	}
+}
+
+static void record(StreamRecorder *stream, long calls)
+{
+	GLfloat x = 1.0f, y = 2.0f, z = 3.0f;
+	GLenum target = GL_TEXTURE_2D;
+	GLubyte c = 255;
+	GLuint texture;
+	long i;
+
+	for (i = 0; i < calls; i++) {
+		texture = (GLuint) i;
+		switch (i % 8) {
+		case 0:
+			recordFunctionCall(stream, DBG_FUNC_GLBINDTEXTURE, 2,
+					&target, sizeof(GLenum), &texture, sizeof(GLuint));
+			break;
+		case 1:
+			recordFunctionCall(stream, DBG_FUNC_GLCOLOR4UB, 4,
+					&c, sizeof(GLubyte), &c, sizeof(GLubyte),
+					&c, sizeof(GLubyte), &c, sizeof(GLubyte));
+			break;
+		case 2:
+		case 3:
+			recordFunctionCall(stream, DBG_FUNC_GLNORMAL3F, 3,
+					&x, sizeof(GLfloat), &y, sizeof(GLfloat),
+					&z, sizeof(GLfloat));
+			break;
+		case 4:
+		case 5:
+			recordFunctionCall(stream, DBG_FUNC_GLTEXCOORD2F, 2,
+					&x, sizeof(GLfloat), &y, sizeof(GLfloat));
+			break;
+		default:
+			recordFunctionCall(stream, DBG_FUNC_GLVERTEX3F, 3,
+					&x, sizeof(GLfloat), &y, sizeof(GLfloat),
+					&z, sizeof(GLfloat));
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	long calls = 100000;
+	StreamRecorder stream;
+	double t;
+	int round;
+
+	if (argc > 1) {
+		calls = strtol(argv[1], NULL, 10);
+	}
+	if (calls < 1) {
+		calls = 1;
+	}
+	setMaxDebugOutputLevel(DBGLVL_ERROR);
+
+	initStreamRecorder(&stream);
+	record(&stream, calls);
+	/* resolve the originals outside of the measurement */
+	replayFunctionCalls(&stream, 0);
+	callDirect(calls);
+
+	t = now();
+	for (round = 0; round < ROUNDS; round++) {
+		callDirect(calls);
+	}
+	t = now() - t;
+	printf("%-8s %8ld calls  %6.2f ns/call\n", "direct", calls,
+			t * 1e9 / (ROUNDS * calls));
+
+	t = now();
+	for (round = 0; round < ROUNDS; round++) {
+		replayFunctionCalls(&stream, 0);
+	}
+	t = now() - t;
+	printf("%-8s %8ld calls  %6.2f ns/call\n", "replay", calls,
+			t * 1e9 / (ROUNDS * calls));
+
+	freeRecordedCalls(&stream);
+	return stubGLSink < 0.0f;
+}
@@ -0,0 +1,251 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/*
+ * Record and replay of a call stream: the block stream of streamRecorder.c
+ * against the previous layout with one allocation per call, name and
+ * argument. Replay goes to a stub that only touches the arguments.
+ *
+ * Usage: streamBench [number of calls]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "debuglibInternal.h"
+#include "streamRecorder.h"
+#include "replayFunction.h"
+#include "dbgprint.h"
+#include "benchtime.h"
+
+#define ROUNDS 10
+
+static double sink;
+
+/* stands in for the generated replay code */
+void replayFunctionCall(StoredCall *f, int final)
+{
+	(void) final;
+	switch (f->function) {
+	case DBG_FUNC_GLVERTEX3F:
+		sink += *(GLfloat*) f->arguments[0] + *(GLfloat*) f->arguments[2];
+		break;
+	case DBG_FUNC_GLMULTMATRIXF:
+		sink += ((GLfloat*) f->arguments[0])[15];
+		break;
+	case DBG_FUNC_GLBINDTEXTURE:
+		sink += *(GLuint*) f->arguments[1];
+		break;
+	}
+}
+
+/* the previous recorder: a list with a malloc per call, name and argument */
+typedef struct ListCall_t {
+	char *fname;
+	int numArguments;
+	void **arguments;
+	struct ListCall_t *nextCall;
+} ListCall;
+
+typedef struct {
+	ListCall *calls;
+	ListCall *lastCall;
+	size_t allocatedBytes;
+} ListRecorder;
+
+static void listRecord(ListRecorder *rec, const char *fname, int numArgs, ...)
+{
+	ListCall *call = malloc(sizeof(ListCall));
+	va_list argp;
+	int i;
+
+	call->fname = strdup(fname);
+	call->numArguments = numArgs;
+	call->arguments = malloc(numArgs * sizeof(void*));
+	call->nextCall = NULL;
+	rec->allocatedBytes += sizeof(ListCall) + strlen(fname) + 1
+			+ numArgs * sizeof(void*);
+	va_start(argp, numArgs);
+	for (i = 0; i < numArgs; i++) {
+		void *ptr = va_arg(argp, void*);
+		int size = va_arg(argp, int);
+		call->arguments[i] = malloc(size);
+		memcpy(call->arguments[i], ptr, size);
+		rec->allocatedBytes += size;
+	}
+	va_end(argp);
+	if (rec->calls) {
+		rec->lastCall->nextCall = call;
+	} else {
+		rec->calls = call;
+	}
+	rec->lastCall = call;
+}
+
+static void listReplay(ListRecorder *rec)
+{
+	ListCall *call;
+	StoredCall view;
+
+	for (call = rec->calls; call; call = call->nextCall) {
+		if (!strcmp(call->fname, "glVertex3f")) {
+			view.function = DBG_FUNC_GLVERTEX3F;
+		} else if (!strcmp(call->fname, "glMultMatrixf")) {
+			view.function = DBG_FUNC_GLMULTMATRIXF;
+		} else {
+			view.function = DBG_FUNC_GLBINDTEXTURE;
+		}
+		view.numArguments = call->numArguments;
+		view.arguments = call->arguments;
+		replayFunctionCall(&view, 0);
+	}
+}
+
+static void listClear(ListRecorder *rec)
+{
+	ListCall *call = rec->calls;
+	int i;
+
+	while (call) {
+		ListCall *next = call->nextCall;
+		free(call->fname);
+		for (i = 0; i < call->numArguments; i++) {
+			free(call->arguments[i]);
+		}
+		free(call->arguments);
+		free(call);
+		call = next;
+	}
+	rec->calls = NULL;
+	rec->lastCall = NULL;
+	rec->allocatedBytes = 0;
+}
+
+int main(int argc, char **argv)
+{
+	long calls = 100000, i;
+	int round;
+	GLfloat x = 1.0f, y = 2.0f, z = 3.0f, m[16];
+	GLenum target = GL_TEXTURE_2D;
+	GLuint texture;
+	StreamRecorder stream;
+	ListRecorder list = { NULL, NULL, 0 };
+	double tRecord = 0.0, tReplay = 0.0, tClear = 0.0, t;
+	size_t listBytes = 0;
+
+	if (argc > 1) {
+		calls = strtol(argv[1], NULL, 10);
+	}
+	if (calls < 1) {
+		calls = 1;
+	}
+	setMaxDebugOutputLevel(DBGLVL_ERROR);
+	for (i = 0; i < 16; i++) {
+		m[i] = (GLfloat) i;
+	}
+
+	initStreamRecorder(&stream);
+	for (round = 0; round < ROUNDS; round++) {
+		t = now();
+		for (i = 0; i < calls; i++) {
+			texture = (GLuint) i;
+			switch (i % 8) {
+			case 0:
+				recordFunctionCall(&stream, DBG_FUNC_GLMULTMATRIXF, 1,
+						m, 16 * sizeof(GLfloat));
+				break;
+			case 1:
+				recordFunctionCall(&stream, DBG_FUNC_GLBINDTEXTURE, 2,
+						&target, sizeof(GLenum), &texture, sizeof(GLuint));
+				break;
+			default:
+				recordFunctionCall(&stream, DBG_FUNC_GLVERTEX3F, 3,
+						&x, sizeof(GLfloat), &y, sizeof(GLfloat),
+						&z, sizeof(GLfloat));
+			}
+		}
+		tRecord += now() - t;
+		t = now();
+		replayFunctionCalls(&stream, 0);
+		tReplay += now() - t;
+		if (round == ROUNDS - 1) {
+			break;
+		}
+		t = now();
+		clearRecordedCalls(&stream);
+		tClear += now() - t;
+	}
+	printf("%-8s %8ld calls  record %7.2f ns/call  replay %6.2f ns/call  "
+			"clear %8.2f us  %lu bytes (%lu allocated)\n", "stream", calls,
+			tRecord * 1e9 / (ROUNDS * calls), tReplay * 1e9 / (ROUNDS * calls),
+			tClear * 1e6 / (ROUNDS - 1), (unsigned long) stream.usedBytes,
+			(unsigned long) stream.allocatedBytes);
+	freeRecordedCalls(&stream);
+
+	tRecord = tReplay = tClear = 0.0;
+	for (round = 0; round < ROUNDS; round++) {
+		t = now();
+		for (i = 0; i < calls; i++) {
+			texture = (GLuint) i;
+			switch (i % 8) {
+			case 0:
+				listRecord(&list, "glMultMatrixf", 1, m, 16 * sizeof(GLfloat));
+				break;
+			case 1:
+				listRecord(&list, "glBindTexture", 2,
+						&target, sizeof(GLenum), &texture, sizeof(GLuint));
+				break;
+			default:
+				listRecord(&list, "glVertex3f", 3, &x, sizeof(GLfloat),
+						&y, sizeof(GLfloat), &z, sizeof(GLfloat));
+			}
+		}
+		tRecord += now() - t;
+		t = now();
+		listReplay(&list);
+		tReplay += now() - t;
+		listBytes = list.allocatedBytes;
+		t = now();
+		listClear(&list);
+		tClear += now() - t;
+	}
+	printf("%-8s %8ld calls  record %7.2f ns/call  replay %6.2f ns/call  "
+			"clear %8.2f us  %lu bytes (without malloc overhead)\n", "list",
+			calls, tRecord * 1e9 / (ROUNDS * calls),
+			tReplay * 1e9 / (ROUNDS * calls), tClear * 1e6 / ROUNDS,
+			(unsigned long) listBytes);
+
+	return sink < 0.0;
+}
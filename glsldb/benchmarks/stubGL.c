@@ -0,0 +1,77 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+/* stand-in for the original libGL of the benchmarks */
+
+#include "GL/gl.h"
+
+volatile float stubGLSink;
+
+void glVertex3f(GLfloat x, GLfloat y, GLfloat z)
+{
+	stubGLSink = x + y + z;
+}
+
+void glNormal3f(GLfloat x, GLfloat y, GLfloat z)
+{
+	stubGLSink = x - y + z;
+}
+
+void glTexCoord2f(GLfloat s, GLfloat t)
+{
+	stubGLSink = s + t;
+}
+
+void glColor4ub(GLubyte r, GLubyte g, GLubyte b, GLubyte a)
+{
+	stubGLSink = (GLfloat) (r + g + b + a);
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+	stubGLSink = (GLfloat) (target + texture);
+}
+
+GLenum glGetError(void)
+{
+	return GL_NO_ERROR;
+}
+
+/* the debug library insists on resolving it; the functions above are found
+ * by dlsym on the library handle
+ */
+void (*glXGetProcAddress(const GLubyte *procName))(void)
+{
+	(void) procName;
+	return NULL;
+}
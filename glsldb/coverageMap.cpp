@@ -0,0 +1,211 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+#include <string.h>
+
+#include "coverageMap.h"
+
+static inline int popCount(unsigned int word)
+{
+#ifdef __GNUC__
+	return __builtin_popcount(word);
+#else
+	word = word - ((word >> 1) & 0x55555555u);
+	word = (word & 0x33333333u) + ((word >> 2) & 0x33333333u);
+	return (int) ((((word + (word >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+#endif
+}
+
+CoverageMap::CoverageMap(int i_nSize, bool i_bValue)
+{
+	m_pWords = NULL;
+	m_nSize = 0;
+	fill(i_bValue, i_nSize);
+}
+
+CoverageMap::CoverageMap(const CoverageMap &src)
+{
+	m_nSize = src.m_nSize;
+	m_pWords = new unsigned int[numWords(m_nSize)];
+	memcpy(m_pWords, src.m_pWords, numWords(m_nSize) * sizeof(unsigned int));
+}
+
+CoverageMap::~CoverageMap()
+{
+	delete[] m_pWords;
+}
+
+CoverageMap& CoverageMap::operator=(const CoverageMap &src)
+{
+	if (this != &src) {
+		if (numWords(src.m_nSize) != numWords(m_nSize)) {
+			delete[] m_pWords;
+			m_pWords = new unsigned int[numWords(src.m_nSize)];
+		}
+		m_nSize = src.m_nSize;
+		memcpy(m_pWords, src.m_pWords,
+				numWords(m_nSize) * sizeof(unsigned int));
+	}
+	return *this;
+}
+
+bool CoverageMap::operator==(const CoverageMap &m) const
+{
+	return m_nSize == m.m_nSize
+			&& !memcmp(m_pWords, m.m_pWords,
+					numWords(m_nSize) * sizeof(unsigned int));
+}
+
+void CoverageMap::resize(int i_nSize)
+{
+	if (numWords(i_nSize) != numWords(m_nSize) || !m_pWords) {
+		delete[] m_pWords;
+		m_pWords = new unsigned int[numWords(i_nSize)];
+	}
+	m_nSize = i_nSize;
+}
+
+void CoverageMap::clearTail(void)
+{
+	if (m_nSize % 32) {
+		m_pWords[m_nSize / 32] &= (1u << (m_nSize % 32)) - 1;
+	}
+}
+
+void CoverageMap::fill(bool value, int i_nSize)
+{
+	if (i_nSize >= 0) {
+		resize(i_nSize);
+	}
+	memset(m_pWords, value ? 0xff : 0,
+			numWords(m_nSize) * sizeof(unsigned int));
+	clearTail();
+}
+
+int CoverageMap::count(void) const
+{
+	int w, n = 0;
+
+	for (w = 0; w < numWords(m_nSize); w++) {
+		n += popCount(m_pWords[w]);
+	}
+	return n;
+}
+
+int CoverageMap::countAnd(const CoverageMap &m) const
+{
+	int w, n = 0;
+
+	for (w = 0; w < numWords(m_nSize) && w < numWords(m.m_nSize); w++) {
+		n += popCount(m_pWords[w] & m.m_pWords[w]);
+	}
+	return n;
+}
+
+int CoverageMap::countAndNot(const CoverageMap &m) const
+{
+	int w, n = 0;
+
+	for (w = 0; w < numWords(m_nSize); w++) {
+		n += popCount(
+				w < numWords(m.m_nSize) ?
+						m_pWords[w] & ~m.m_pWords[w] : m_pWords[w]);
+	}
+	return n;
+}
+
+bool CoverageMap::contains(const CoverageMap &m) const
+{
+	return m.countAndNot(*this) == 0;
+}
+
+void CoverageMap::andWith(const CoverageMap &m)
+{
+	int w;
+
+	for (w = 0; w < numWords(m_nSize); w++) {
+		m_pWords[w] &= w < numWords(m.m_nSize) ? m.m_pWords[w] : 0;
+	}
+}
+
+void CoverageMap::orWith(const CoverageMap &m)
+{
+	int w;
+
+	for (w = 0; w < numWords(m_nSize) && w < numWords(m.m_nSize); w++) {
+		m_pWords[w] |= m.m_pWords[w];
+	}
+	clearTail();
+}
+
+void CoverageMap::andNotWith(const CoverageMap &m)
+{
+	int w;
+
+	for (w = 0; w < numWords(m_nSize) && w < numWords(m.m_nSize); w++) {
+		m_pWords[w] &= ~m.m_pWords[w];
+	}
+}
+
+void CoverageMap::packRows(int i_nWidth, int i_nRowWords,
+		unsigned int *o_pRows) const
+{
+	int y, j, n, bit, w, shift;
+	unsigned int word;
+
+	if (i_nWidth <= 0) {
+		return;
+	}
+	for (y = 0; y * i_nWidth < m_nSize; y++, o_pRows += i_nRowWords) {
+		for (j = 0; j < i_nRowWords; j++) {
+			n = i_nWidth - 32 * j;
+			if (n <= 0) {
+				o_pRows[j] = 0;
+				continue;
+			}
+			/* the row need not start at a word, the tail bits are clear */
+			bit = y * i_nWidth + 32 * j;
+			w = bit >> 5;
+			shift = bit & 31;
+			word = m_pWords[w] >> shift;
+			if (shift && w + 1 < numWords(m_nSize)) {
+				word |= m_pWords[w + 1] << (32 - shift);
+			}
+			if (n < 32) {
+				word &= (1u << n) - 1;
+			}
+			o_pRows[j] = word;
+		}
+	}
+}
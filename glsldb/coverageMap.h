@@ -0,0 +1,147 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+#ifndef _COVERAGE_MAP_H_
+#define _COVERAGE_MAP_H_
+
+/* One bit per pixel or vertex, e.g. whether a shader step covered it or
+ * whether data is available for it. The bits past the size are always
+ * clear, so maps of the same size are combined and counted a word at a time.
+ */
+class CoverageMap {
+public:
+	CoverageMap(int i_nSize = 0, bool i_bValue = false);
+	CoverageMap(const CoverageMap &src);
+	~CoverageMap();
+
+	CoverageMap& operator=(const CoverageMap &src);
+	bool operator==(const CoverageMap &m) const;
+	bool operator!=(const CoverageMap &m) const
+	{
+		return !(*this == m);
+	}
+
+	int getSize(void) const
+	{
+		return m_nSize;
+	}
+
+	bool test(int i) const
+	{
+		return (m_pWords[i >> 5] >> (i & 31)) & 1;
+	}
+	void set(int i, bool value = true)
+	{
+		if (value) {
+			m_pWords[i >> 5] |= 1u << (i & 31);
+		} else {
+			m_pWords[i >> 5] &= ~(1u << (i & 31));
+		}
+	}
+
+	/* set all bits, the size is kept unless i_nSize is given */
+	void fill(bool value, int i_nSize = -1);
+
+	/* Sets bit i if i_pValues[i * i_nStride] is above i_threshold and
+	 * resizes to i_nSize if needed. Returns whether a bit or the size
+	 * changed.
+	 */
+	template<typename vType>
+	bool setFromValues(int i_nSize, const vType *i_pValues, int i_nStride,
+			vType i_threshold);
+
+	/* number of set bits */
+	int count(void) const;
+	/* number of bits set in this and in m */
+	int countAnd(const CoverageMap &m) const;
+	/* number of bits set in this but not in m */
+	int countAndNot(const CoverageMap &m) const;
+	/* whether all bits set in m are set in this */
+	bool contains(const CoverageMap &m) const;
+
+	void andWith(const CoverageMap &m);
+	void orWith(const CoverageMap &m);
+	/* clears the bits set in m */
+	void andNotWith(const CoverageMap &m);
+
+	/* Copies the map as rows of i_nWidth bits into i_nRowWords words per
+	 * row, bit i of word j holds bit 32 * j + i of the row. The words past
+	 * the width are cleared.
+	 */
+	void packRows(int i_nWidth, int i_nRowWords, unsigned int *o_pRows) const;
+
+private:
+	static int numWords(int size)
+	{
+		return (size + 31) / 32;
+	}
+	void resize(int i_nSize);
+	/* clear the bits of the last word past the size */
+	void clearTail(void);
+
+	unsigned int *m_pWords;
+	int m_nSize;
+};
+
+template<typename vType>
+bool CoverageMap::setFromValues(int i_nSize, const vType *i_pValues,
+		int i_nStride, vType i_threshold)
+{
+	int i, w, n;
+	unsigned int word;
+	bool changed = false;
+
+	if (i_nSize != m_nSize) {
+		resize(i_nSize);
+		changed = true;
+	}
+
+	for (w = 0; w < numWords(m_nSize); w++) {
+		n = (m_nSize - 32 * w < 32) ? m_nSize - 32 * w : 32;
+		word = 0;
+		for (i = 0; i < n; i++) {
+			if (*i_pValues > i_threshold) {
+				word |= 1u << i;
+			}
+			i_pValues += i_nStride;
+		}
+		if (word != m_pWords[w]) {
+			m_pWords[w] = word;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+#endif
@@ -88,6 +88,8 @@ void FragmentTestDialog::setDefaults()
 	m_depthValue = 0.0;
 	m_stencilValue = 0;
 
+	m_halfFloatValues = false;
+
 	resetSettings();
 }
 
@@ -105,6 +107,8 @@ void FragmentTestDialog::resetSettings()
 	leAlphaValue->setText(QString::number(m_alphaValue));
 	leDepthValue->setText(QString::number(m_depthValue));
 	leStencilValue->setText(QString::number(m_stencilValue, 16));
+
+	cbHalfFloat->setChecked(m_halfFloatValues);
 }
 
 void FragmentTestDialog::apply()
@@ -121,6 +125,8 @@ void FragmentTestDialog::apply()
 	m_alphaValue = leAlphaValue->text().toFloat();
 	m_depthValue = leDepthValue->text().toFloat();
 	m_stencilValue = leStencilValue->text().toInt();
+
+	m_halfFloatValues = cbHalfFloat->isChecked();
 	accept();
 }
 
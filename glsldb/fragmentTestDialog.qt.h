@@ -85,6 +85,11 @@ public:
 		return m_stencilValue;
 	}
 
+	bool halfFloatValues()
+	{
+		return m_halfFloatValues;
+	}
+
 public slots:
 	void setDefaults();
 
@@ -106,6 +111,8 @@ private:
 	float m_alphaValue;
 	float m_depthValue;
 	int m_stencilValue;
+
+	bool m_halfFloatValues;
 };
 
 #endif
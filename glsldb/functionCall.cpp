@@ -46,17 +46,18 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "errno.h"
 #include "debuglib.h"
 #include "functionCall.h"
-#include "FunctionsMap.h"
 
 extern "C" {
 #include "DebugLib/glenumerants.h"
 }
 
-//extern "C" GLFunctionList glFunctions[];
+/* indexed by function ID */
+extern "C" GLFunctionList glFunctions[];
+extern "C" const unsigned char glFunctionFlags[];
 
 FunctionCall::FunctionCall()
 {
-	m_pName = NULL;
+	m_iFunction = -1;
 	m_iNumArgs = 0;
 	m_pArguments = NULL;
 }
@@ -64,7 +65,7 @@ FunctionCall::FunctionCall()
 FunctionCall::FunctionCall(const FunctionCall *copyOf)
 {
 	int i;
-	m_pName = strdup(copyOf->getName());
+	m_iFunction = copyOf->getFunction();
 	m_iNumArgs = 0;
 	m_pArguments = NULL;
 	for (i = 0; i < copyOf->getNumArguments(); i++) {
@@ -81,26 +82,31 @@ FunctionCall::~FunctionCall()
 		free(m_pArguments[i].pData);
 	}
 	free(m_pArguments);
-	free(m_pName);
 }
 
 const char* FunctionCall::getName(void) const
 {
-	return m_pName;
+	return m_iFunction >= 0 ? glFunctions[m_iFunction].fname : NULL;
 }
 
-void FunctionCall::setName(const char *i_pName)
+int FunctionCall::getFunction(void) const
 {
-	if (m_pName) {
-		free(m_pName);
-	}
-	m_pName = strdup(i_pName);
+	return m_iFunction;
+}
+
+void FunctionCall::setFunction(int i_iFunction)
+{
+	m_iFunction = i_iFunction;
 }
 
 const char* FunctionCall::getExtension(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	return f ? f->extname : 0;
+	return m_iFunction >= 0 ? glFunctions[m_iFunction].extname : 0;
+}
+
+bool FunctionCall::hasFlag(int flag) const
+{
+	return m_iFunction >= 0 && (glFunctionFlags[m_iFunction] & flag);
 }
 
 int FunctionCall::getNumArguments(void) const
@@ -224,7 +230,7 @@ bool FunctionCall::operator==(const FunctionCall &right)
 {
 	int i;
 
-	if (strcmp(m_pName, right.getName()) != 0) {
+	if (m_iFunction != right.getFunction()) {
 		return false;
 	}
 	if (m_iNumArgs != right.getNumArguments()) {
@@ -410,7 +416,7 @@ char* FunctionCall::getCallString(void) const
 	int i;
 	char *callString = (char*) malloc(4096);
 
-	strcpy(callString, m_pName);
+	strcpy(callString, getName());
 	strcat(callString, "(");
 	for (i = 0; i < m_iNumArgs; i++) {
 		char *argstr = getArgumentString(m_pArguments[i]);
@@ -445,17 +451,13 @@ bool FunctionCall::isDebuggable(int *primitiveMode) const
 
 bool FunctionCall::isDebuggableDrawCall(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && f->isDebuggableDrawCall)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_DRAW_CALL);
 }
 
 bool FunctionCall::isDebuggableDrawCall(int *primitiveMode) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && f->isDebuggableDrawCall) {
-		int idx = f->primitiveModeIndex;
+	if (hasFlag(DBG_FUNCTION_DRAW_CALL)) {
+		int idx = glFunctions[m_iFunction].primitiveModeIndex;
 		*primitiveMode = *(GLenum*) m_pArguments[idx].pData;
 		return true;
 	}
@@ -470,49 +472,31 @@ bool FunctionCall::isEditable(void) const
 
 bool FunctionCall::isShaderSwitch(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && f->isShaderSwitch)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_SHADER_SWITCH);
 }
 
 bool FunctionCall::isGlFunc(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && strcmp("GL", f->prefix) == 0)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_GL);
 }
 
 bool FunctionCall::isGlxFunc(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && strcmp("GLX", f->prefix) == 0)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_GLX);
 }
 
 bool FunctionCall::isWglFunc(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && strcmp("WGL", f->prefix) == 0)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_WGL);
 }
 
 bool FunctionCall::isFrameEnd(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && f->isFrameEnd)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_FRAME_END);
 }
 
 bool FunctionCall::isFramebufferChange(void) const
 {
-	GLFunctionList *f = FunctionsMap::instance()[m_pName];
-	if (f && f->isFramebufferChange)
-		return true;
-	return false;
+	return hasFlag(DBG_FUNCTION_FRAMEBUFFER_CHANGE);
 }
 
@@ -46,8 +46,10 @@ public:
 		void *pAddress;
 	};
 
+	/* names are resolved from the function ID for display only */
 	const char* getName(void) const;
-	void setName(const char*);
+	int getFunction(void) const;
+	void setFunction(int);
 
 	const char* getExtension(void) const;
 
@@ -75,9 +77,10 @@ public:
 
 private:
 	char* getArgumentString(Argument arg) const;
+	bool hasFlag(int flag) const;
 	void* copyArgument(int type, void *addr);
 
-	char *m_pName;
+	int m_iFunction;
 	char *m_pExtension;
 	int m_iNumArgs;
 	Argument *m_pArguments;
@@ -73,8 +73,8 @@ bool GeoShaderDataModel::isBasicPrimitive(int primType)
 
 GeoShaderDataModel::GeoShaderDataModel(int inPrimitiveType,
 		int outPrimitiveType, VertexBox *primitiveMap,
-		VertexBox *vertexCountMap, VertexBox *condition, bool *initialCoverage,
-		QObject *parent) :
+		VertexBox *vertexCountMap, VertexBox *condition,
+		CoverageMap *initialCoverage, QObject *parent) :
 		QAbstractItemModel(parent)
 {
 	m_inPrimitiveType = inPrimitiveType;
@@ -76,7 +76,8 @@ Q_OBJECT
 public:
 	GeoShaderDataModel(int inPrimitiveType, int outPrimitiveType,
 			VertexBox *primitiveMap, VertexBox *vertexCount,
-			VertexBox *condition, bool *initialCoverage, QObject *parent = 0);
+			VertexBox *condition, CoverageMap *initialCoverage,
+			QObject *parent = 0);
 	~GeoShaderDataModel();
 
 	QVariant data(const QModelIndex &index, int role) const;
@@ -127,7 +128,7 @@ private:
 	int m_numOutPrimitives;
 	int m_numOutVertices;
 	VertexBox * m_condition;
-	bool * m_initialCoverage;
+	CoverageMap * m_initialCoverage;
 	QList<VertexBox*> m_currentData;
 	QList<VertexBox*> m_vertexData;
 	QList<QString> m_dataNames;
@@ -114,7 +114,8 @@ int GeoShaderTreeItem::isVertexItem() const
 }
 
 GeoShaderTreeInPrimItem::GeoShaderTreeInPrimItem(QString name, int dataIdx,
-		QList<VertexBox*> *data, VertexBox *condition, bool *initialCondition,
+		QList<VertexBox*> *data, VertexBox *condition,
+		CoverageMap *initialCondition,
 		GeoShaderTreeItem *parent) :
 		GeoShaderTreeItem(name, dataIdx, data, parent)
 {
@@ -144,9 +145,9 @@ QVariant GeoShaderTreeInPrimItem::data(int column) const
 			return m_name;
 		} else {
 			if (m_initialCondition && column == 1) {
-				if (m_initialCondition[m_dataIdx]) {
+				if (m_initialCondition->test(m_dataIdx)) {
 					if (m_condition->getCoveragePointer()
-							&& m_condition->getCoveragePointer()[m_dataIdx]
+							&& m_condition->getCoveragePointer()->test(m_dataIdx)
 									== true) {
 						if (m_condition->getDataPointer()
 								&& m_condition->getDataPointer()[m_dataIdx]
@@ -174,7 +175,7 @@ QVariant GeoShaderTreeInPrimItem::data(int column) const
 			} else if (m_data && column - 2 >= 0
 					&& column - 2 < m_data->size()) {
 				if (((*m_data)[column - 2]->getDataMapPointer()
-						&& !(*m_data)[column - 2]->getDataMapPointer()[m_dataIdx])) {
+						&& !(*m_data)[column - 2]->getDataMapPointer()->test(m_dataIdx))) {
 					return QVariant("-");
 				} else {
 					return QVariant(
@@ -191,7 +192,7 @@ QVariant GeoShaderTreeInPrimItem::data(int column) const
 			if (flags(0) == 0) {
 				return QVariant("%");
 			} else if (((*m_data)[column - 1]->getDataMapPointer()
-					&& !(*m_data)[column - 1]->getDataMapPointer()[m_dataIdx])) {
+					&& !(*m_data)[column - 1]->getDataMapPointer()->test(m_dataIdx))) {
 				return QVariant("-");
 			} else {
 				return QVariant(
@@ -207,9 +208,9 @@ QVariant GeoShaderTreeInPrimItem::displayColor(int) const
 {
 	if (m_condition) {
 		if (m_initialCondition) {
-			if (m_initialCondition[m_dataIdx]) {
+			if (m_initialCondition->test(m_dataIdx)) {
 				if (m_condition->getCoveragePointer()
-						&& m_condition->getCoveragePointer()[m_dataIdx]
+						&& m_condition->getCoveragePointer()->test(m_dataIdx)
 								== true) {
 					if (m_condition->getDataPointer()
 							&& m_condition->getDataPointer()[m_dataIdx]
@@ -243,7 +244,7 @@ Qt::ItemFlags GeoShaderTreeInPrimItem::flags(int column) const
 	if (column == 0) {
 		if (m_condition) {
 			if (m_condition->getCoveragePointer()
-					&& m_condition->getCoveragePointer()[m_dataIdx] == false) {
+					&& m_condition->getCoveragePointer()->test(m_dataIdx) == false) {
 				return 0;
 			} else if (!m_data) {
 				/* non-basic input primitive */
@@ -260,7 +261,7 @@ Qt::ItemFlags GeoShaderTreeInPrimItem::flags(int column) const
 		} else {
 			if (m_data && !m_data->empty() && (*m_data)[0]
 					&& ((*m_data)[0]->getCoveragePointer()
-							&& !(*m_data)[0]->getCoveragePointer()[m_dataIdx])) {
+							&& !(*m_data)[0]->getCoveragePointer()->test(m_dataIdx))) {
 				return 0;
 			} else if (!m_data) {
 				/* non-basic input primitive */
@@ -319,8 +320,8 @@ QVariant GeoShaderTreeVertexItem::data(int column) const
 		return m_name;
 	} else if (m_data && column - 1 >= 0 && column - 1 < m_data->size()) {
 		float *dp = (*m_data)[column - 1]->getDataPointer();
-		bool *dmp = (*m_data)[column - 1]->getDataMapPointer();
-		if (!dmp[m_dataIdx]) {
+		CoverageMap *dmp = (*m_data)[column - 1]->getDataMapPointer();
+		if (!dmp->test(m_dataIdx)) {
 			return QVariant("-");
 		} else if (dp[2 * m_dataIdx + 1] == 0.0f
 				|| dp[2 * m_dataIdx + 1] == -0.0f) {
@@ -38,6 +38,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QtCore/QVariant>
 
 class VertexBox;
+class CoverageMap;
 
 class GeoShaderTreeItem {
 public:
@@ -70,7 +71,7 @@ protected:
 class GeoShaderTreeInPrimItem: public GeoShaderTreeItem {
 public:
 	GeoShaderTreeInPrimItem(QString name, int dataIdx, QList<VertexBox*> *data,
-			VertexBox *condition, bool *initialCondition,
+			VertexBox *condition, CoverageMap *initialCondition,
 			GeoShaderTreeItem *parent = 0);
 
 	virtual int columnCount() const;
@@ -80,7 +81,7 @@ public:
 
 protected:
 	VertexBox *m_condition;
-	bool *m_initialCondition;
+	CoverageMap *m_initialCondition;
 };
 
 class GeoShaderTreeOutPrimItem: public GeoShaderTreeItem {
@@ -127,6 +127,12 @@ void ImageView::mouseMoveEvent(QMouseEvent *event)
 					QRect(m_minMaxLensOrigin, event->pos()).normalized());
 		}
 		break;
+	case MM_FOCUS:
+		if ((event->buttons() & Qt::LeftButton) && m_rubberBand->isVisible()) {
+			m_rubberBand->setGeometry(
+					QRect(m_rubberBandOrigin, event->pos()).normalized());
+		}
+		break;
 	default:
 		break;
 	}
@@ -159,6 +165,11 @@ void ImageView::mousePressEvent(QMouseEvent *event)
 			emit picked(x, y);
 		}
 		break;
+	case MM_FOCUS:
+		m_rubberBand->setGeometry(0, 0, 0, 0);
+		m_rubberBandOrigin = event->pos();
+		m_rubberBand->show();
+		break;
 	default:
 		break;
 	}
@@ -234,6 +245,26 @@ void ImageView::mouseReleaseEvent(QMouseEvent *event)
 		}
 	}
 		break;
+	case MM_FOCUS: {
+		QRect selRect = m_rubberBand->geometry().intersected(
+				QRect(0, 0, width(), height()));
+		int left = selRect.left(), top = selRect.top();
+		int right = selRect.left() + selRect.width();
+		int bottom = selRect.top() + selRect.height();
+
+		m_rubberBand->hide();
+		if (selRect.isEmpty()) {
+			/* a click without dragging drops the region */
+			emit focusRegionChanged(QRect());
+			break;
+		}
+		/* all image pixels touched by the band */
+		canvasToImage(left, top);
+		right = ::ceilf(static_cast<float>(right) / m_zoomLevel);
+		bottom = ::ceilf(static_cast<float>(bottom) / m_zoomLevel);
+		emit focusRegionChanged(QRect(left, top, right - left, bottom - top));
+	}
+		break;
 	default:
 		break;
 	}
@@ -326,6 +357,9 @@ void ImageView::setMouseMode(int mouseMode)
 	case MM_MINMAX:
 		setCustomCursor(":/cursors/cursors/min-max.png");
 		break;
+	case MM_FOCUS:
+		setCursor(Qt::CrossCursor);
+		break;
 	default:
 		break;
 	}
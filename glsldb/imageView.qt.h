@@ -48,7 +48,8 @@ public:
 		MM_NONE,
 		MM_ZOOM,
 		MM_PICK,
-		MM_MINMAX
+		MM_MINMAX,
+		MM_FOCUS
 	};
 
 	ImageView(QWidget *parent = 0);
@@ -83,6 +84,8 @@ signals:
 	void viewCenterChanged(int x, int y);
 	void minMaxAreaChanged(const QRect& minMaxArea);
 	void setMappingBounds();
+	/* region dragged in focus mode in image coordinates, empty on a click */
+	void focusRegionChanged(const QRect& region);
 
 protected:
 	QRubberBand *m_minMaxLens;
@@ -46,11 +46,10 @@ LoopData::LoopData(PixelBoxFloat *condition, QObject *parent) :
 	m_qModel.setHorizontalHeaderItem(3, new QStandardItem("out"));
 
 	m_nIteration = 0;
-	if (condition->getWidth() * condition->getHeight()) {
-		m_pInitialCoverage = new bool[condition->getWidth()
-				* condition->getHeight()];
-		memcpy(m_pInitialCoverage, condition->getCoveragePointer(),
-				condition->getWidth() * condition->getHeight() * sizeof(bool));
+	m_pInitialCoverage = new CoverageMap(
+			condition->getWidth() * condition->getHeight(), true);
+	if (condition->getCoveragePointer()) {
+		m_pInitialCoverage->andWith(*condition->getCoveragePointer());
 	}
 	m_pActualFData = new PixelBoxFloat(condition);
 	updateStatistic();
@@ -67,10 +66,9 @@ LoopData::LoopData(VertexBox *condition, QObject *parent) :
 	m_qModel.setHorizontalHeaderItem(3, new QStandardItem("out"));
 
 	m_nIteration = 0;
-	if (condition->getNumVertices()) {
-		m_pInitialCoverage = new bool[condition->getNumVertices()];
-		memcpy(m_pInitialCoverage, condition->getCoveragePointer(),
-				condition->getNumVertices() * sizeof(bool));
+	m_pInitialCoverage = new CoverageMap(condition->getNumVertices(), true);
+	if (condition->getCoveragePointer()) {
+		m_pInitialCoverage->andWith(*condition->getCoveragePointer());
 	}
 	m_pActualVData = new VertexBox();
 	m_pActualVData->copyFrom(condition);
@@ -79,7 +77,7 @@ LoopData::LoopData(VertexBox *condition, QObject *parent) :
 
 LoopData::~LoopData()
 {
-	delete[] m_pInitialCoverage;
+	delete m_pInitialCoverage;
 	delete m_pActualFData;
 	delete m_pActualVData;
 }
@@ -99,74 +97,65 @@ void LoopData::addLoopIteration(VertexBox *condition, int iteration)
 	updateStatistic();
 }
 
+void LoopData::addLoopIteration(int numCovered, int numActive, int iteration)
+{
+	/* counted within the initial coverage, so as updateStatistic does */
+	m_nIteration = iteration;
+	m_nActive = numActive;
+	m_nDone = numCovered - numActive;
+	m_nOut = m_nTotal - numCovered;
+	appendStatistic();
+}
+
+/* The pixels or vertices of the initial coverage are active if they are
+ * still covered and their condition is true, done if it is false and out if
+ * they are not covered any more.
+ */
 void LoopData::updateStatistic(void)
 {
-	int x, y, c;
-	int width;
-	int height;
-	int channel;
-	float *pConditionData;
-	bool *pConditionCover;
-	bool *pInitialCover;
+	CoverageMap *pConditionCover;
+	CoverageMap covered(*m_pInitialCoverage);
+	CoverageMap condition;
+	int nCovered;
 
 	if (m_pActualFData) {
-		width = m_pActualFData->getWidth();
-		height = m_pActualFData->getHeight();
-		channel = m_pActualFData->getChannel();
-		pConditionData = m_pActualFData->getDataPointer();
 		pConditionCover = m_pActualFData->getCoveragePointer();
-		pInitialCover = m_pInitialCoverage;
+		condition.setFromValues(
+				m_pActualFData->getWidth() * m_pActualFData->getHeight(),
+				m_pActualFData->getDataPointer(),
+				m_pActualFData->getChannel(), 0.75f);
 	} else if (m_pActualVData) {
-		width = 1;
-		height = m_pActualVData->getNumVertices();
-		channel = 1;
-		pConditionData = m_pActualVData->getDataPointer();
 		pConditionCover = m_pActualVData->getCoveragePointer();
-		pInitialCover = m_pInitialCoverage;
+		condition.setFromValues(m_pActualVData->getNumVertices(),
+				m_pActualVData->getDataPointer(), 1, 0.75f);
 	} else {
 		fprintf(stderr, "E! LoopData features vertex and fragment data\n");
 		exit(1);
 	}
 
-	int nActive = 0;
-	int nDone = 0;
-	int nOut = 0;
-
-	for (y = 0; y < height; y++) {
-		for (x = 0; x < width; x++) {
-			if (*pInitialCover) {
-				if (*pConditionCover) {
-					if (*pConditionData > 0.75f) {
-						nActive++;
-					} else {
-						nDone++;
-					}
-				} else {
-					nOut++;
-				}
-			}
-			for (c = 0; c < channel; c++) {
-				pConditionData++;
-			}
-			pInitialCover++;
-			pConditionCover++;
-		}
+	if (pConditionCover) {
+		covered.andWith(*pConditionCover);
 	}
+	nCovered = covered.count();
 
-	m_nTotal = nActive + nDone + nOut;
-	m_nActive = nActive;
-	m_nDone = nDone;
-	m_nOut = nOut;
+	m_nTotal = m_pInitialCoverage->count();
+	m_nActive = covered.countAnd(condition);
+	m_nDone = nCovered - m_nActive;
+	m_nOut = m_nTotal - nCovered;
+	appendStatistic();
+}
 
+void LoopData::appendStatistic(void)
+{
 	QList<QStandardItem*> rowData;
 	rowData << new QStandardItem(QVariant(m_nIteration).toString());
-	rowData << new QStandardItem(QVariant(nActive).toString());
-	rowData << new QStandardItem(QVariant(nDone).toString());
-	rowData << new QStandardItem(QVariant(nOut).toString());
+	rowData << new QStandardItem(QVariant(m_nActive).toString());
+	rowData << new QStandardItem(QVariant(m_nDone).toString());
+	rowData << new QStandardItem(QVariant(m_nOut).toString());
 	m_qModel.appendRow(rowData);
 }
 
-bool* LoopData::getActualCoverage(void)
+CoverageMap* LoopData::getActualCoverage(void)
 {
 	if (m_pActualFData) {
 		return m_pActualFData->getCoveragePointer();
@@ -227,14 +216,13 @@ QImage LoopData::getImage(void)
 	QImage image(width, height, QImage::Format_RGB32);
 
 	float *pConditionData = m_pActualFData->getDataPointer();
-	bool *pConditionCover = m_pActualFData->getCoveragePointer();
-	bool *pInitialCover = m_pInitialCoverage;
+	CoverageMap *pConditionCover = m_pActualFData->getCoveragePointer();
 
 	for (y = 0; y < height; y++) {
 		for (x = 0; x < width; x++) {
-			if (*pInitialCover) {
+			if (m_pInitialCoverage->test(y * width + x)) {
 				/* initial data available */
-				if (*pConditionCover) {
+				if (!pConditionCover || pConditionCover->test(y * width + x)) {
 					/* actual data available */
 					if (*pConditionData > 0.75f) {
 						image.setPixel(x, y, DBG_GREEN.rgb());
@@ -256,8 +244,6 @@ QImage LoopData::getImage(void)
 			for (c = 0; c < channel; c++) {
 				pConditionData++;
 			}
-			pInitialCover++;
-			pConditionCover++;
 		}
 	}
 	return image;
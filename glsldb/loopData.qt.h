@@ -53,17 +53,23 @@ public:
 
 	void addLoopIteration(PixelBoxFloat *condition, int iteration);
 	void addLoopIteration(VertexBox *condition, int iteration);
+	/* An iteration known only by the number of covered pixels and of pixels
+	 * with an active condition, both counted within the initial coverage,
+	 * see ProgramControl::shaderStepFragmentStatistics. The condition image
+	 * stays the one of the last iteration added with its data.
+	 */
+	void addLoopIteration(int numCovered, int numActive, int iteration);
 
 	QStandardItemModel* getModel(void)
 	{
 		return &m_qModel;
 	}
 
-	bool* getInitialCoverage(void)
+	CoverageMap* getInitialCoverage(void)
 	{
 		return m_pInitialCoverage;
 	}
-	bool* getActualCoverage(void);
+	CoverageMap* getActualCoverage(void);
 	float* getActualCondition(void);
 
 	PixelBoxFloat* getActualPixelBox(void)
@@ -114,9 +120,10 @@ private slots:
 
 private:
 	void updateStatistic(void);
+	void appendStatistic(void);
 
 	int m_nIteration;
-	bool *m_pInitialCoverage;
+	CoverageMap *m_pInitialCoverage;
 	PixelBoxFloat *m_pActualFData;
 	VertexBox *m_pActualVData;
 
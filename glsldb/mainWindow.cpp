@@ -38,6 +38,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QFileDialog>
 #include <QtCore/QSettings>
+#include <QtCore/QCryptographicHash>
 #include <QtWidgets/QMdiArea>
 #include <QtWidgets/QMdiSubWindow>
 #include <QtWidgets/QTabWidget>
@@ -71,6 +72,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MAX(a,b) ( a < b ? b : a )
 #define MIN(a,b) ( a > b ? b : a )
 
+/* defaults of the ResultCache/MemoryBudget and ResultCache/DiskBudget
+ * settings, in MB
+ */
+#define RESULT_CACHE_MEMORY_BUDGET 256
+#define RESULT_CACHE_DISK_BUDGET 1024
+
+/* default of the Prefetch/Steps setting, 0 disables step prefetching */
+#define PREFETCH_STEPS 3
+
 #ifdef _WIN32
 #define REGISTRY_KEY "Software\\VIS\\glslDevil"
 #endif /* _WIN32 */
@@ -131,12 +141,15 @@ MainWindow::MainWindow(char *pname, const QStringList& args) :
 	agWatchControl->addAction(aZoom);
 	agWatchControl->addAction(aSelectPixel);
 	agWatchControl->addAction(aMinMaxLens);
+	agWatchControl->addAction(aFocusRegion);
 	agWatchControl->setEnabled(false);
 
 	/* per frgamnet operations */
 	m_pftDialog = new FragmentTestDialog(this);
 
 	pc = new ProgramControl(pname);
+	m_pTraceConsumer = NULL;
+	m_bTracedExecution = false;
 
 	m_pCurrentCall = NULL;
 	m_pShVarModel = NULL;
@@ -187,8 +200,23 @@ MainWindow::MainWindow(char *pname, const QStringList& args) :
 
 	m_pCoverage = NULL;
 
+	{
+		QSettings settings;
+		qint64 memoryBudget = settings.value("ResultCache/MemoryBudget",
+				RESULT_CACHE_MEMORY_BUDGET).toLongLong();
+		qint64 diskBudget = settings.value("ResultCache/DiskBudget",
+				RESULT_CACHE_DISK_BUDGET).toLongLong();
+		m_pResultCache = new ResultCache(memoryBudget << 20, diskBudget << 20);
+		m_pPrefetcher = new StepPrefetcher(pc,
+				settings.value("Prefetch/Steps", PREFETCH_STEPS).toInt());
+	}
+	m_pPrefetchTimer = new QTimer(this);
+	m_pPrefetchTimer->setInterval(0);
+	connect(m_pPrefetchTimer, SIGNAL(timeout()), this, SLOT(prefetchSteps()));
+
 	m_selectedPixel[0] = -1;
 	m_selectedPixel[1] = -1;
+	m_halfFloatValues = false;
 	lWatchSelectionPos->setText("No Selection");
 
 #ifdef _WIN32
@@ -224,10 +252,12 @@ MainWindow::~MainWindow()
 	delete m_pWglCallPfst;
 	delete m_pWglExtPfst;
 
-	delete[] m_pCoverage;
+	delete m_pCoverage;
 	delete m_pGeometryMap;
 	delete m_pVertexCount;
 	//delete m_pGeoDataModel;
+	delete m_pResultCache;
+	delete m_pPrefetcher;
 
 	delete m_pCurrentCall;
 
@@ -246,6 +276,7 @@ MainWindow::~MainWindow()
 void MainWindow::killProgram(int hard)
 {
 	UT_NOTIFY(LV_TRACE, "Killing debugee");
+	finishTrace();
 	pc->killProgram(hard);
 	/* status log */
 	if (hard) {
@@ -668,24 +699,7 @@ void MainWindow::addGlTraceItem()
 		iconType = GlTraceListItem::IT_EMPTY;
 	}
 
-	if (m_pCurrentCall->isGlFunc()) {
-		m_pGlCallSt->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pGlExtSt->incCallStatistic(QString(m_pCurrentCall->getExtension()));
-		m_pGlCallPfst->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pGlExtPfst->incCallStatistic(QString(m_pCurrentCall->getExtension()));
-	} else if (m_pCurrentCall->isGlxFunc()) {
-		m_pGlxCallSt->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pGlxExtSt->incCallStatistic(QString(m_pCurrentCall->getExtension()));
-		m_pGlxCallPfst->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pGlxExtPfst->incCallStatistic(
-				QString(m_pCurrentCall->getExtension()));
-	} else if (m_pCurrentCall->isWglFunc()) {
-		m_pWglCallSt->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pWglExtSt->incCallStatistic(QString(m_pCurrentCall->getExtension()));
-		m_pWglCallPfst->incCallStatistic(QString(m_pCurrentCall->getName()));
-		m_pWglExtPfst->incCallStatistic(
-				QString(m_pCurrentCall->getExtension()));
-	}
+	incCallStatistics(m_pCurrentCall);
 
 	/* Check what options are valid depending on the command */
 	if (m_pCurrentCall->isDebuggable()) {
@@ -699,6 +713,26 @@ void MainWindow::addGlTraceItem()
 	free(callString);
 }
 
+void MainWindow::incCallStatistics(const FunctionCall *call)
+{
+	if (call->isGlFunc()) {
+		m_pGlCallSt->incCallStatistic(QString(call->getName()));
+		m_pGlExtSt->incCallStatistic(QString(call->getExtension()));
+		m_pGlCallPfst->incCallStatistic(QString(call->getName()));
+		m_pGlExtPfst->incCallStatistic(QString(call->getExtension()));
+	} else if (call->isGlxFunc()) {
+		m_pGlxCallSt->incCallStatistic(QString(call->getName()));
+		m_pGlxExtSt->incCallStatistic(QString(call->getExtension()));
+		m_pGlxCallPfst->incCallStatistic(QString(call->getName()));
+		m_pGlxExtPfst->incCallStatistic(QString(call->getExtension()));
+	} else if (call->isWglFunc()) {
+		m_pWglCallSt->incCallStatistic(QString(call->getName()));
+		m_pWglExtSt->incCallStatistic(QString(call->getExtension()));
+		m_pWglCallPfst->incCallStatistic(QString(call->getName()));
+		m_pWglExtPfst->incCallStatistic(QString(call->getExtension()));
+	}
+}
+
 void MainWindow::addGlTraceErrorItem(const char *text)
 {
 	if (m_pGlTraceModel) {
@@ -987,6 +1021,7 @@ void MainWindow::waitForEndOfExecution()
 #else /* !_WIN32 */
 		Sleep(1);
 #endif /* !_WIN32 */
+		addTracedCalls();
 		int state;
 		error = pc->checkExecuteState(&state);
 		if (isErrorCritical(error)) {
@@ -998,7 +1033,13 @@ void MainWindow::waitForEndOfExecution()
 			pc->executeContinueOnError();
 			pc->checkChildStatus();
 			m_pCurrentCall = pc->getCurrentCall();
-			addGlTraceItem();
+			if (m_pTraceConsumer) {
+				/* the failing call was the last one traced */
+				finishTrace();
+				setGlTraceItemIconType(GlTraceListItem::IT_ERROR);
+			} else {
+				addGlTraceItem();
+			}
 			setErrorStatus(error);
 			pc->callDone();
 			error = getNextCall();
@@ -1023,6 +1064,8 @@ void MainWindow::waitForEndOfExecution()
 			return;
 		}
 	}
+	/* all calls before the stop are in the ring now */
+	finishTrace();
 	if (currentRunLevel == RL_TRACE_EXECUTE_RUN) {
 		pc->checkChildStatus();
 		error = getNextCall();
@@ -1038,6 +1081,102 @@ void MainWindow::waitForEndOfExecution()
 	}
 }
 
+bool MainWindow::executeTraced(int mode, const char *fname)
+{
+	pcErrorCode error;
+	bool stopOnGLError = tbToggleHaltOnError->isChecked();
+
+	/* automatic capturing needs a stop at every framebuffer change */
+	if (!pc->canTrace() || tbBVCaptureAutomatic->isChecked()) {
+		return false;
+	}
+
+	resetPerFrameStatistics();
+	setGlTraceItemIconType(GlTraceListItem::IT_OK);
+	if (m_pCurrentCall && m_pCurrentCall->isShaderSwitch()) {
+		/* executed without reading back the new shaders */
+		m_bHaveValidShaderCode = false;
+	}
+	delete m_pCurrentCall;
+	m_pCurrentCall = NULL;
+
+	switch (mode) {
+	case DBG_JUMP_TO_SHADER_SWITCH:
+		error = pc->executeToShaderSwitch(stopOnGLError, true);
+		break;
+	case DBG_JUMP_TO_DRAW_CALL:
+		error = pc->executeToDrawCall(stopOnGLError, true);
+		break;
+	case DBG_JUMP_TO_USER_DEFINED:
+		error = pc->executeToUserDefined(fname, stopOnGLError, true);
+		break;
+	default:
+		error = pc->execute(stopOnGLError, true);
+		break;
+	}
+	setErrorStatus(error);
+	if (error != PCE_NONE) {
+		killProgram(1);
+		setRunLevel(RL_SETUP);
+		return true;
+	}
+	if (pc->tracing()) {
+		m_pTraceConsumer = new TraceConsumer(pc);
+		m_pTraceConsumer->start();
+	} else {
+		addGlTraceWarningItem("Call tracing failed, running without it");
+	}
+	m_bTracedExecution = true;
+	waitForEndOfExecution();
+	m_bTracedExecution = false;
+	return true;
+}
+
+void MainWindow::addTracedCalls()
+{
+	std::vector<FunctionCall*> calls;
+
+	if (!m_pTraceConsumer) {
+		return;
+	}
+	m_pTraceConsumer->takeCalls(calls);
+	if (calls.empty()) {
+		return;
+	}
+
+	for (size_t i = 0; i < calls.size(); i++) {
+		FunctionCall *call = calls[i];
+		char *callString = call->getCallString();
+
+		incCallStatistics(call);
+		if (call->isFrameEnd()) {
+			clearPerFrameStatistics();
+		}
+		if (call->isShaderSwitch()) {
+			m_bHaveValidShaderCode = false;
+		}
+		if (m_pGlTraceModel) {
+			m_pGlTraceModel->addGlTraceItem(GlTraceListItem::IT_OK,
+					callString);
+		}
+		free(callString);
+		delete call;
+	}
+	lvGlTrace->scrollToBottom();
+}
+
+void MainWindow::finishTrace()
+{
+	if (!m_pTraceConsumer) {
+		return;
+	}
+	m_pTraceConsumer->finish();
+	m_pTraceConsumer->wait();
+	addTracedCalls();
+	delete m_pTraceConsumer;
+	m_pTraceConsumer = NULL;
+}
+
 void MainWindow::on_tbJumpToDrawCall_clicked()
 {
 	/* cleanup dbg state */
@@ -1068,6 +1207,10 @@ void MainWindow::on_tbJumpToDrawCall_clicked()
 			return;
 		}
 		waitForEndOfExecution(); /* last statement!! */
+	} else if (executeTraced(DBG_JUMP_TO_DRAW_CALL)) {
+		if (currentRunLevel == RL_SETUP) {
+			return;
+		}
 	} else {
 		if (m_pCurrentCall && m_pCurrentCall->isDebuggableDrawCall()) {
 			singleStep();
@@ -1124,6 +1267,10 @@ void MainWindow::on_tbJumpToShader_clicked()
 			return;
 		}
 		waitForEndOfExecution(); /* last statement!! */
+	} else if (executeTraced(DBG_JUMP_TO_SHADER_SWITCH)) {
+		if (currentRunLevel == RL_SETUP) {
+			return;
+		}
 	} else {
 		if (m_pCurrentCall && m_pCurrentCall->isShaderSwitch()) {
 			singleStep();
@@ -1187,6 +1334,12 @@ void MainWindow::on_tbJumpToUserDef_clicked()
 				return;
 			}
 			waitForEndOfExecution(); /* last statement!! */
+		} else if (executeTraced(DBG_JUMP_TO_USER_DEFINED,
+				targetName.toLatin1().data())) {
+			if (currentRunLevel == RL_SETUP) {
+				delete pJumpToDialog;
+				return;
+			}
 		} else {
 
 			singleStep();
@@ -1259,7 +1412,7 @@ void MainWindow::on_tbRun_clicked()
 
 void MainWindow::on_tbPause_clicked()
 {
-	if (tbToggleNoTrace->isChecked()) {
+	if (tbToggleNoTrace->isChecked() || m_bTracedExecution) {
 		pc->stop();
 	} else {
 		setRunLevel(RL_TRACE_EXECUTE);
@@ -1366,12 +1519,50 @@ void MainWindow::on_tbSave_clicked()
 	delete sDialog;
 }
 
+/* The recording is not part of the key, the cache is cleared for every new
+ * one. params holds everything besides the sources that changes the result.
+ */
+static QByteArray resultCacheKey(char *shaders[3], const double *params,
+		int numParams)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	int i, length;
+
+	for (i = 0; i < 3; i++) {
+		length = shaders[i] ? (int) strlen(shaders[i]) : -1;
+		hash.addData((const char*) &length, sizeof(length));
+		if (shaders[i]) {
+			hash.addData(shaders[i], length);
+		}
+	}
+	hash.addData((const char*) params, numParams * sizeof(double));
+	return hash.result();
+}
+
+/* Coverage and loop conditions are 0 or 1 and read back as bit masks,
+ * selection conditions also tell uncovered ones apart and need a byte.
+ */
+static int conditionReadBackFormat(DbgCgOptions option)
+{
+	switch (option) {
+	case DBG_CG_COVERAGE:
+	case DBG_CG_LOOP_CONDITIONAL:
+		return GL_BITMAP;
+	case DBG_CG_SELECTION_CONDITIONAL:
+		return GL_UNSIGNED_BYTE;
+	default:
+		return GL_FLOAT;
+	}
+}
+
 bool MainWindow::getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
-		bool *coverage, VertexBox *vdata)
+		CoverageMap *coverage, VertexBox *vdata)
 {
 	int target, elementsPerVertex, numVertices, numPrimitives,
-			forcePointPrimitiveMode;
-	float *data = NULL;
+			forcePointPrimitiveMode, format;
+	void *data = NULL;
+	float *unpacked = NULL;
+	SharedResult *shared = NULL;
 	pcErrorCode error;
 
 	char *shaders[] = {
@@ -1381,6 +1572,7 @@ bool MainWindow::getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
 
 	char *debugCode = NULL;
 	debugCode = ShDebugGetProg(m_dShCompiler, cl, &m_dShVariableList, option);
+	m_pPrefetcher->used(debugCode);
 	switch (currentRunLevel) {
 	case RL_DBG_VERTEX_SHADER:
 		shaders[0] = debugCode;
@@ -1415,6 +1607,10 @@ bool MainWindow::getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
 		forcePointPrimitiveMode = 0;
 		break;
 	case DBG_CG_CHANGEABLE:
+		/* one float per packed watch item */
+		elementsPerVertex = cl->numChangeables;
+		forcePointPrimitiveMode = (target == DBG_TARGET_GEOMETRY_SHADER);
+		break;
 	case DBG_CG_COVERAGE:
 	case DBG_CG_SELECTION_CONDITIONAL:
 	case DBG_CG_SWITCH_CONDITIONAL:
@@ -1433,9 +1629,41 @@ bool MainWindow::getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
 		break;
 	}
 
-	error = pc->shaderStepVertex(shaders, target, m_primitiveMode,
-			forcePointPrimitiveMode, elementsPerVertex, &numPrimitives,
-			&numVertices, &data);
+	/* vertex counts carry the primitive id and stay float */
+	format = conditionReadBackFormat(option);
+
+	double keyParams[] = { (double) option, (double) target,
+			(double) m_primitiveMode, (double) forcePointPrimitiveMode,
+			(double) elementsPerVertex, (double) format };
+	QByteArray key = resultCacheKey(shaders, keyParams,
+			sizeof(keyParams) / sizeof(keyParams[0]));
+	CachedResult cached;
+	bool isCached = m_pResultCache->find(key, cached);
+
+	if (isCached) {
+		numVertices = cached.extent[0];
+		numPrimitives = cached.extent[1];
+		shared = cached.data;
+		data = shared->getDataPointer();
+		error = PCE_NONE;
+	} else {
+		error = pc->shaderStepVertex(shaders, target, m_primitiveMode,
+				forcePointPrimitiveMode, elementsPerVertex, format,
+				&numPrimitives, &numVertices, &data, &shared);
+		if (error == PCE_NONE) {
+			/* the cache keeps a reference instead of a copy */
+			if (!shared) {
+				shared = new SharedResult(data,
+						ProgramControl::readBackSize(format, 1,
+								numVertices * elementsPerVertex, 1));
+			}
+			cached.extent[0] = numVertices;
+			cached.extent[1] = numPrimitives;
+			cached.data = shared;
+			m_pResultCache->insert(key, cached);
+			data = shared->getDataPointer();
+		}
+	}
 
 	/////// DEBUG
 	UT_NOTIFY(LV_DEBUG, ">>>>> DEBUG CG: ");
@@ -1499,18 +1727,118 @@ bool MainWindow::getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
 		return false;
 	}
 
-	vdata->setData(data, elementsPerVertex, numVertices, numPrimitives,
-			coverage);
-	free(data);
+	if (PixelBox::isPackedFormat(format) && numVertices > 0) {
+		unpacked = PixelBox::unpackData(format,
+				numVertices * elementsPerVertex, 1, 1, data);
+	}
+	vdata->setData(unpacked ? unpacked : (float*) data, elementsPerVertex,
+			numVertices, numPrimitives, coverage);
+	delete[] unpacked;
+	shared->unref();
 	UT_NOTIFY(LV_TRACE, "getDebugVertexData done");
 	return true;
 }
 
+/* components a fragment shader step reads back for option */
+static int fragmentChannels(DbgCgOptions option, ShChangeableList *cl)
+{
+	switch (option) {
+	case DBG_CG_CHANGEABLE:
+		/* packed watch items use red, green and blue */
+		return (cl->numChangeables > 1) ? 3 : 1;
+	case DBG_CG_COVERAGE:
+	case DBG_CG_SELECTION_CONDITIONAL:
+	case DBG_CG_SWITCH_CONDITIONAL:
+	case DBG_CG_LOOP_CONDITIONAL:
+		return 1;
+	default:
+		return 3;
+	}
+}
+
+QByteArray MainWindow::fragmentResultKey(char *shaders[3], DbgCgOptions option,
+		int channels, int rbFormat)
+{
+	double keyParams[] = { (double) option, (double) channels,
+			(double) rbFormat, (double) m_pftDialog->alphaTestOption(),
+			(double) m_pftDialog->depthTestOption(),
+			(double) m_pftDialog->stencilTestOption(),
+			(double) m_pftDialog->blendingOption(),
+			(double) m_pftDialog->copyAlpha(), (double) m_pftDialog->copyDepth(),
+			(double) m_pftDialog->copyStencil(), m_pftDialog->alphaValue(),
+			m_pftDialog->depthValue(), (double) m_pftDialog->stencilValue(),
+			(double) m_focusRegion.x(), (double) m_focusRegion.y(),
+			(double) m_focusRegion.width(), (double) m_focusRegion.height() };
+	return resultCacheKey(shaders, keyParams,
+			sizeof(keyParams) / sizeof(keyParams[0]));
+}
+
+int MainWindow::watchReadBackFormat(ShVarItem *item)
+{
+	int format = item->getReadbackFormat();
+
+	if (format == GL_FLOAT && m_halfFloatValues) {
+		return GL_HALF_FLOAT;
+	}
+	return format;
+}
+
+void MainWindow::addReadAheadPass(DbgCgOptions option, ShChangeableList *cl,
+		int rbFormat, std::vector<FragmentPass> &passes,
+		QList<QByteArray> &keys)
+{
+	FragmentPass pass;
+	QByteArray key;
+	char *debugCode;
+
+	debugCode = ShDebugGetProg(m_dShCompiler, cl, &m_dShVariableList, option);
+	if (!debugCode) {
+		return;
+	}
+	pass.shaders[0] = m_pShaders[0];
+	pass.shaders[1] = m_pShaders[1];
+	pass.shaders[2] = debugCode;
+	pass.numComponents = fragmentChannels(option, cl);
+	pass.format = rbFormat;
+
+	key = fragmentResultKey(pass.shaders, option, pass.numComponents,
+			rbFormat);
+	if (keys.contains(key) || m_pResultCache->contains(key)) {
+		free(debugCode);
+		return;
+	}
+	passes.push_back(pass);
+	keys.append(key);
+}
+
+/* Images of a focus region only cover the region, the box is placed at its
+ * position in the viewport.
+ */
+template<typename vType>
+static TypedPixelBox<vType>* newDebugPixelBox(int width, int height,
+		int channels, const int placement[4], void *imageData,
+		SharedResult *shared, CoverageMap *coverage)
+{
+	TypedPixelBox<vType> *fb;
+
+	if (shared) {
+		fb = new TypedPixelBox<vType>(width, height, channels, shared,
+				coverage);
+	} else {
+		fb = new TypedPixelBox<vType>(width, height, channels,
+				(vType*) imageData, coverage);
+	}
+	fb->setOrigin(QPoint(placement[0], placement[1]));
+	return fb;
+}
+
 bool MainWindow::getDebugImage(DbgCgOptions option, ShChangeableList *cl,
-		int rbFormat, bool *coverage, PixelBox **fbData)
+		int rbFormat, CoverageMap *coverage, PixelBox **fbData)
 {
-	int width, height, channels;
+	int width, height, channels, placement[4];
 	void *imageData;
+	float *unpacked = NULL;
+	SharedResult *shared = NULL, *packedShared = NULL;
 	pcErrorCode error;
 
 	char *shaders[] = {
@@ -1529,84 +1857,103 @@ bool MainWindow::getDebugImage(DbgCgOptions option, ShChangeableList *cl,
 
 	char *debugCode = NULL;
 	debugCode = ShDebugGetProg(m_dShCompiler, cl, &m_dShVariableList, option);
+	m_pPrefetcher->used(debugCode);
 	shaders[2] = debugCode;
 
-	switch (option) {
-	case DBG_CG_CHANGEABLE:
-	case DBG_CG_COVERAGE:
-		channels = 1;
-		break;
-	case DBG_CG_SELECTION_CONDITIONAL:
-	case DBG_CG_SWITCH_CONDITIONAL:
-	case DBG_CG_LOOP_CONDITIONAL:
-		if (currentRunLevel == RL_DBG_FRAGMENT_SHADER)
-			channels = 1;
-		else
-			channels = 3;
-		break;
-	default:
-		channels = 3;
-		break;
-	}
+	channels = fragmentChannels(option, cl);
+	QByteArray key = fragmentResultKey(shaders, option, channels, rbFormat);
+	CachedResult cached;
+	bool isCached = m_pResultCache->find(key, cached);
 
-	UT_NOTIFY(LV_TRACE, "Init buffers...");
-	switch (option) {
-	case DBG_CG_ORIGINAL_SRC:
-		error = pc->initializeRenderBuffer(true, true, true, true, 0.0, 0.0,
-				0.0, 0.0, 0.0, 0);
-		break;
-	case DBG_CG_COVERAGE:
-	case DBG_CG_SELECTION_CONDITIONAL:
-	case DBG_CG_SWITCH_CONDITIONAL:
-	case DBG_CG_LOOP_CONDITIONAL:
-	case DBG_CG_CHANGEABLE:
-		error = pc->initializeRenderBuffer(false, m_pftDialog->copyAlpha(),
-				m_pftDialog->copyDepth(), m_pftDialog->copyStencil(), 0.0, 0.0,
-				0.0, m_pftDialog->alphaValue(), m_pftDialog->depthValue(),
-				m_pftDialog->stencilValue());
-		break;
-	default: {
-		QString msg;
-		msg.append("Unhandled DbgCgCoption ");
-		msg.append(QString::number(option));
-		msg.append("<BR>Please report this probem to "
-				"<A HREF=\"mailto:glsldevil@vis.uni-stuttgart.de\">"
-				"glsldevil@vis.uni-stuttgart.de</A>.");
-		QMessageBox::critical(this, "Internal Error", msg, QMessageBox::Ok);
-		return false;
-	}
-	}
-	setErrorStatus(error);
-	if (isErrorCritical(error)) {
-		cleanupDBGShader();
-		setRunLevel(RL_SETUP);
-		QMessageBox::critical(this, "Error", "Could not initialize buffers for "
-				"fragment program debugging.", QMessageBox::Ok);
-		killProgram(1);
-		return false;
-	}
-
-	error = pc->shaderStepFragment(shaders, channels, rbFormat, &width, &height,
-			&imageData);
-	free(debugCode);
-	if (error != PCE_NONE) {
+	if (isCached) {
+		width = cached.extent[0];
+		height = cached.extent[1];
+		memcpy(placement, cached.placement, sizeof(placement));
+		shared = cached.data;
+		free(debugCode);
+	} else {
+		UT_NOTIFY(LV_TRACE, "Init buffers...");
+		switch (option) {
+		case DBG_CG_ORIGINAL_SRC:
+			error = pc->initializeRenderBuffer(true, true, true, true, 0.0, 0.0,
+					0.0, 0.0, 0.0, 0);
+			break;
+		case DBG_CG_COVERAGE:
+		case DBG_CG_SELECTION_CONDITIONAL:
+		case DBG_CG_SWITCH_CONDITIONAL:
+		case DBG_CG_LOOP_CONDITIONAL:
+		case DBG_CG_CHANGEABLE:
+			error = pc->initializeRenderBuffer(false, m_pftDialog->copyAlpha(),
+					m_pftDialog->copyDepth(), m_pftDialog->copyStencil(), 0.0, 0.0,
+					0.0, m_pftDialog->alphaValue(), m_pftDialog->depthValue(),
+					m_pftDialog->stencilValue());
+			break;
+		default: {
+			QString msg;
+			msg.append("Unhandled DbgCgCoption ");
+			msg.append(QString::number(option));
+			msg.append("<BR>Please report this probem to "
+					"<A HREF=\"mailto:glsldevil@vis.uni-stuttgart.de\">"
+					"glsldevil@vis.uni-stuttgart.de</A>.");
+			QMessageBox::critical(this, "Internal Error", msg, QMessageBox::Ok);
+			return false;
+		}
+		}
 		setErrorStatus(error);
 		if (isErrorCritical(error)) {
 			cleanupDBGShader();
 			setRunLevel(RL_SETUP);
+			QMessageBox::critical(this, "Error", "Could not initialize buffers for "
+					"fragment program debugging.", QMessageBox::Ok);
+			killProgram(1);
+			return false;
+		}
+
+		error = pc->shaderStepFragment(shaders, channels, rbFormat, &width,
+				&height, &imageData, &shared, placement);
+		free(debugCode);
+		if (error != PCE_NONE) {
+			setErrorStatus(error);
+			if (isErrorCritical(error)) {
+				cleanupDBGShader();
+				setRunLevel(RL_SETUP);
+				QMessageBox::critical(this, "Error", "Could not debug fragment "
+						"shader. An error occured!", QMessageBox::Ok);
+				killProgram(1);
+				return false;
+			}
 			QMessageBox::critical(this, "Error", "Could not debug fragment "
 					"shader. An error occured!", QMessageBox::Ok);
-			killProgram(1);
 			return false;
 		}
-		QMessageBox::critical(this, "Error", "Could not debug fragment "
-				"shader. An error occured!", QMessageBox::Ok);
-		return false;
+
+		/* the cache and the pixel box share the result instead of copies */
+		if (!shared) {
+			shared = new SharedResult(imageData,
+					ProgramControl::readBackSize(rbFormat, channels, width,
+							height));
+		}
+		cached.extent[0] = width;
+		cached.extent[1] = height;
+		memcpy(cached.placement, placement, sizeof(placement));
+		cached.data = shared;
+		m_pResultCache->insert(key, cached);
+	}
+	imageData = shared->getDataPointer();
+
+	m_imageOrigin = QPoint(placement[0], placement[1]);
+
+	/* packed formats are shown as floats, the box gets its own copy */
+	if (PixelBox::isPackedFormat(rbFormat)) {
+		unpacked = PixelBox::unpackData(rbFormat, width, height, channels,
+				imageData);
+		packedShared = shared;
+		shared = NULL;
 	}
 
-	if (rbFormat == GL_FLOAT) {
-		PixelBoxFloat *fb = new PixelBoxFloat(width, height, channels,
-				(float*) imageData, coverage);
+	if (unpacked || rbFormat == GL_FLOAT) {
+		PixelBoxFloat *fb = newDebugPixelBox<float>(width, height, channels,
+				placement, unpacked ? unpacked : imageData, shared, coverage);
 		if (*fbData) {
 			PixelBoxFloat *pfbData = dynamic_cast<PixelBoxFloat*>(*fbData);
 			pfbData->addPixelBox(fb);
@@ -1615,8 +1962,8 @@ bool MainWindow::getDebugImage(DbgCgOptions option, ShChangeableList *cl,
 			*fbData = fb;
 		}
 	} else if (rbFormat == GL_INT) {
-		PixelBoxInt *fb = new PixelBoxInt(width, height, channels,
-				(int*) imageData, coverage);
+		PixelBoxInt *fb = newDebugPixelBox<int>(width, height, channels,
+				placement, imageData, shared, coverage);
 		if (*fbData) {
 			PixelBoxInt *pfbData = dynamic_cast<PixelBoxInt*>(*fbData);
 			pfbData->addPixelBox(fb);
@@ -1625,8 +1972,8 @@ bool MainWindow::getDebugImage(DbgCgOptions option, ShChangeableList *cl,
 			*fbData = fb;
 		}
 	} else if (rbFormat == GL_UNSIGNED_INT) {
-		PixelBoxUInt *fb = new PixelBoxUInt(width, height, channels,
-				(unsigned int*) imageData, coverage);
+		PixelBoxUInt *fb = newDebugPixelBox<unsigned int>(width, height,
+				channels, placement, imageData, shared, coverage);
 		if (*fbData) {
 			PixelBoxUInt *pfbData = dynamic_cast<PixelBoxUInt*>(*fbData);
 			pfbData->addPixelBox(fb);
@@ -1636,13 +1983,84 @@ bool MainWindow::getDebugImage(DbgCgOptions option, ShChangeableList *cl,
 		}
 	} else {
 		UT_NOTIFY(LV_ERROR, "Invalid image data format");
+		shared->unref();
 	}
 
-	free(imageData);
+	/* the pixel box took over the reference to shared */
+	delete[] unpacked;
+	if (packedShared) {
+		packedShared->unref();
+	}
 	UT_NOTIFY(LV_TRACE, "getDebugImage done.");
 	return true;
 }
 
+/* Counts the covered and active pixels of a coverage or condition pass in
+ * the focus region without reading the image back. If limit is given, only
+ * its pixels are counted; it has to be a map of the focus region with rows
+ * of width pixels.
+ */
+bool MainWindow::getDebugStatistics(DbgCgOptions option,
+		const CoverageMap *limit, int width, int *numCovered, int *numActive)
+{
+	std::vector<unsigned int> rows;
+	int numPixels;
+	pcErrorCode error;
+
+	char *shaders[] = {
+		m_pShaders[0],
+		m_pShaders[1],
+		m_pShaders[2] };
+
+	char *debugCode = ShDebugGetProg(m_dShCompiler, NULL, &m_dShVariableList,
+			option);
+	m_pPrefetcher->used(debugCode);
+	shaders[2] = debugCode;
+
+	error = pc->initializeRenderBuffer(false, m_pftDialog->copyAlpha(),
+			m_pftDialog->copyDepth(), m_pftDialog->copyStencil(), 0.0, 0.0, 0.0,
+			m_pftDialog->alphaValue(), m_pftDialog->depthValue(),
+			m_pftDialog->stencilValue());
+	setErrorStatus(error);
+	if (isErrorCritical(error)) {
+		free(debugCode);
+		cleanupDBGShader();
+		setRunLevel(RL_SETUP);
+		QMessageBox::critical(this, "Error", "Could not initialize buffers for "
+				"fragment program debugging.", QMessageBox::Ok);
+		killProgram(1);
+		return false;
+	}
+
+	/* the debuggee checks the size against the focus region */
+	if (limit) {
+		int height = width > 0 ? (limit->getSize() + width - 1) / width : 0;
+		rows.resize(2 + (size_t) DBG_MASK_ROW_WORDS(width) * height);
+		rows[0] = (unsigned int) width;
+		rows[1] = (unsigned int) height;
+		limit->packRows(width, DBG_MASK_ROW_WORDS(width), &rows[2]);
+	}
+
+	error = pc->shaderStepFragmentStatistics(shaders,
+			limit ? &rows[0] : NULL, rows.size() * sizeof(unsigned int),
+			numCovered, numActive, &numPixels);
+	free(debugCode);
+	if (error != PCE_NONE) {
+		setErrorStatus(error);
+		if (isErrorCritical(error)) {
+			cleanupDBGShader();
+			setRunLevel(RL_SETUP);
+			QMessageBox::critical(this, "Error", "Could not debug fragment "
+					"shader. An error occured!", QMessageBox::Ok);
+			killProgram(1);
+		}
+		return false;
+	}
+	UT_NOTIFY(LV_TRACE, "getDebugStatistics: " << *numCovered << " covered, "
+			<< *numActive << " active of " << numPixels);
+	return true;
+}
+
 void MainWindow::updateWatchItemData(ShVarItem *watchItem)
 {
 	ShChangeableList cl;
@@ -1653,7 +2071,7 @@ void MainWindow::updateWatchItemData(ShVarItem *watchItem)
 	ShChangeable *watchItemCgbl = watchItem->getShChangeable();
 	addShChangeable(&cl, watchItemCgbl);
 
-	int rbFormat = watchItem->getReadbackFormat();
+	int rbFormat = watchReadBackFormat(watchItem);
 
 	if (currentRunLevel == RL_DBG_FRAGMENT_SHADER) {
 		PixelBox *fb = watchItem->getPixelBoxPointer();
@@ -1708,19 +2126,7 @@ void MainWindow::updateWatchItemData(ShVarItem *watchItem)
 				watchItem->setCurrentPointer(currentData);
 			}
 
-			VertexBox *vertexData = new VertexBox();
-
-			UT_NOTIFY(LV_TRACE, "Get GEOMETRY_CHANGABLE:");
-			if (getDebugVertexData(DBG_CG_GEOMETRY_CHANGEABLE, &cl, NULL,
-					vertexData)) {
-				VertexBox *vb = watchItem->getVertexBoxPointer();
-				if (vb) {
-					vb->addVertexBox(vertexData);
-					delete vertexData;
-				} else {
-					watchItem->setVertexBoxPointer(vertexData);
-				}
-			} else {
+			if (!getWatchItemGeometryData(watchItem, &cl)) {
 				QMessageBox::warning(this, "Warning",
 						"The requested data could "
 								"not be retrieved.");
@@ -1750,10 +2156,336 @@ static void invalidateWatchItemData(ShVarItem *item)
 	}
 }
 
+bool MainWindow::getWatchItemGeometryData(ShVarItem *watchItem,
+		ShChangeableList *cl)
+{
+	VertexBox *vertexData = new VertexBox();
+
+	UT_NOTIFY(LV_TRACE, "Get GEOMETRY_CHANGABLE:");
+	if (!getDebugVertexData(DBG_CG_GEOMETRY_CHANGEABLE, cl, NULL,
+			vertexData)) {
+		delete vertexData;
+		return false;
+	}
+	VertexBox *vb = watchItem->getVertexBoxPointer();
+	if (vb) {
+		vb->addVertexBox(vertexData);
+		delete vertexData;
+	} else {
+		watchItem->setVertexBoxPointer(vertexData);
+	}
+	return true;
+}
+
+/* Watch items read back by a single shader step: red, green and blue of the
+ * debug render target (alpha keeps what the debugged shader wrote for the
+ * alpha test) and the components of one vec4 transform feedback varying.
+ */
+#define MAX_PACKED_FRAGMENT_WATCH_ITEMS 3
+#define MAX_PACKED_VERTEX_WATCH_ITEMS 4
+
+static bool scopeContains(const DbgRsScope *scope, int id)
+{
+	for (int i = 0; i < scope->numIds; i++) {
+		if (scope->ids[i] == id) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* items that are only in scope of a caller are read at another position;
+ * with scope given, that of a position ahead, see prefetchSteps
+ */
+static bool isPackableWatchItem(ShVarItem *item, const DbgRsScope *scope)
+{
+	if (item->isBuildIn()) {
+		return true;
+	}
+	if (scope) {
+		ShChangeable *cgbl = item->getShChangeable();
+		bool inScope = scopeContains(scope, cgbl->id);
+		freeShChangeable(&cgbl);
+		return inScope;
+	}
+	return item->isInScope();
+}
+
+template<typename vType>
+static void setPackedPixelBox(ShVarItem *watchItem, PixelBox *packed,
+		int channel)
+{
+	TypedPixelBox<vType> *fb = new TypedPixelBox<vType>(
+			dynamic_cast<TypedPixelBox<vType>*>(packed), channel);
+	PixelBox *pb = watchItem->getPixelBoxPointer();
+
+	if (pb) {
+		dynamic_cast<TypedPixelBox<vType>*>(pb)->addPixelBox(fb);
+		delete fb;
+	} else {
+		watchItem->setPixelBoxPointer(fb);
+	}
+}
+
+/* Reads all watchItems with one debug shader and one replay of the draw call,
+ * each item in its own component of the debug result. Returns false if no
+ * data was stored.
+ */
+bool MainWindow::updatePackedWatchItemsData(QList<ShVarItem*> &watchItems)
+{
+	ShChangeableList cl;
+	bool success = false;
+	int i;
+
+	cl.numChangeables = 0;
+	cl.changeables = NULL;
+	for (i = 0; i < watchItems.count(); i++) {
+		addShChangeable(&cl, watchItems[i]->getShChangeable());
+	}
+
+	if (currentRunLevel == RL_DBG_FRAGMENT_SHADER) {
+		int rbFormat = watchReadBackFormat(watchItems[0]);
+		PixelBox *packed = NULL;
+
+		if (getDebugImage(DBG_CG_CHANGEABLE, &cl, rbFormat, m_pCoverage,
+				&packed) && packed) {
+			for (i = 0; i < watchItems.count(); i++) {
+				if (rbFormat == GL_FLOAT || rbFormat == GL_HALF_FLOAT) {
+					setPackedPixelBox<float>(watchItems[i], packed, i);
+				} else if (rbFormat == GL_INT) {
+					setPackedPixelBox<int>(watchItems[i], packed, i);
+				} else {
+					setPackedPixelBox<unsigned int>(watchItems[i], packed, i);
+				}
+				watchItems[i]->setCurrentValue(m_selectedPixel[0],
+						m_selectedPixel[1]);
+			}
+			success = true;
+		}
+		delete packed;
+	} else if (currentRunLevel == RL_DBG_VERTEX_SHADER
+			|| currentRunLevel == RL_DBG_GEOMETRY_SHADER) {
+		VertexBox *packed = new VertexBox();
+
+		if (getDebugVertexData(DBG_CG_CHANGEABLE, &cl, m_pCoverage, packed)) {
+			for (i = 0; i < watchItems.count(); i++) {
+				ShVarItem *watchItem = watchItems[i];
+				VertexBox *data = new VertexBox();
+				VertexBox *vb;
+
+				data->copyElementFrom(packed, i);
+				if (currentRunLevel == RL_DBG_VERTEX_SHADER) {
+					vb = watchItem->getVertexBoxPointer();
+				} else {
+					vb = watchItem->getCurrentPointer();
+				}
+				if (vb) {
+					vb->addVertexBox(data);
+					delete data;
+				} else if (currentRunLevel == RL_DBG_VERTEX_SHADER) {
+					watchItem->setVertexBoxPointer(data);
+				} else {
+					watchItem->setCurrentPointer(data);
+				}
+
+				if (currentRunLevel == RL_DBG_GEOMETRY_SHADER) {
+					/* the per vertex data has a different layout and is
+					 * still read per item */
+					ShChangeableList itemCl;
+					itemCl.numChangeables = 1;
+					itemCl.changeables = &cl.changeables[i];
+					if (!getWatchItemGeometryData(watchItem, &itemCl)) {
+						QMessageBox::warning(this, "Warning",
+								"The requested data could "
+										"not be retrieved.");
+					}
+					if (currentRunLevel == RL_SETUP) {
+						break;
+					}
+				}
+				watchItem->setCurrentValue(m_selectedPixel[0]);
+			}
+			success = true;
+		}
+		delete packed;
+	}
+
+	for (i = 0; i < cl.numChangeables; i++) {
+		freeShChangeable(&cl.changeables[i]);
+	}
+	free(cl.changeables);
+	return success;
+}
+
+/* Moves the items of the next shader step from watchItems to packed, the
+ * first one and as many of the others as can be read together with it.
+ * scope is that of the position they are read at, NULL for the current one.
+ */
+static void takePackedWatchItems(QList<ShVarItem*> &watchItems,
+		QList<ShVarItem*> &packed, int maxPacked, bool fragment,
+		const DbgRsScope *scope = NULL)
+{
+	ShVarItem *item = watchItems.takeFirst();
+	int i;
+
+	packed.clear();
+	packed.append(item);
+	if (isPackableWatchItem(item, scope)) {
+		i = 0;
+		while (i < watchItems.count() && packed.count() < maxPacked) {
+			/* a fragment shader step reads back a single format */
+			if (isPackableWatchItem(watchItems[i], scope)
+					&& (!fragment
+							|| watchItems[i]->getReadbackFormat()
+									== item->getReadbackFormat())) {
+				packed.append(watchItems.takeAt(i));
+			} else {
+				i++;
+			}
+		}
+	}
+}
+
+/* Updates the data of watchItems, packing as many of them into one shader
+ * step as the debug outputs allow. watchItems is emptied.
+ */
+void MainWindow::updateWatchItemsData(QList<ShVarItem*> &watchItems)
+{
+	QList<ShVarItem*> packed;
+	bool fragment = currentRunLevel == RL_DBG_FRAGMENT_SHADER;
+	int i;
+
+	while (!watchItems.isEmpty()) {
+		takePackedWatchItems(watchItems, packed,
+				fragment ?
+						MAX_PACKED_FRAGMENT_WATCH_ITEMS :
+						MAX_PACKED_VERTEX_WATCH_ITEMS, fragment);
+
+		if (packed.count() == 1 || !updatePackedWatchItemsData(packed)) {
+			for (i = 0; i < packed.count() && currentRunLevel != RL_SETUP;
+					i++) {
+				updateWatchItemData(packed[i]);
+			}
+		}
+		/* HACK: when an error occurs in shader debugging the runlevel
+		 * might change to RL_SETUP and all shader debugging data will
+		 * be invalid; so we have to check it here
+		 */
+		if (currentRunLevel == RL_SETUP) {
+			watchItems.clear();
+			return;
+		}
+	}
+}
+
+/* Reads what ShaderStep is going to ask for at a fragment shader position in
+ * a single stop of the debuggee and leaves it in the result cache: the
+ * coverage, the condition of a branch or loop and the watch items that
+ * changed. The debuggee runs these passes back to back and only waits for
+ * the readbacks at the end. Watch items that are read because the coverage
+ * grew are not known yet and are read on their own, as is everything after
+ * an error here.
+ */
+void MainWindow::readAheadFragmentPasses(DbgResult *dr, bool updateWatchData)
+{
+	std::vector<FragmentPass> passes;
+	QList<QByteArray> keys;
+	QList<ShVarItem*> watchItems, updateItems, packed;
+	ShChangeableList cl;
+	CachedResult cached;
+	SharedResult *shared;
+	bool forceUpdate = dr->passedEmitVertex || dr->passedDiscard;
+	pcErrorCode error;
+	int i;
+
+	addReadAheadPass(DBG_CG_COVERAGE, NULL,
+			conditionReadBackFormat(DBG_CG_COVERAGE), passes, keys);
+	switch (dr->position) {
+	case DBG_RS_POSITION_SELECTION_IF_CHOOSE:
+	case DBG_RS_POSITION_SELECTION_IF_ELSE_CHOOSE:
+		addReadAheadPass(DBG_CG_SELECTION_CONDITIONAL, NULL,
+				conditionReadBackFormat(DBG_CG_SELECTION_CONDITIONAL), passes,
+				keys);
+		break;
+	case DBG_RS_POSITION_LOOP_CHOOSE:
+		addReadAheadPass(DBG_CG_LOOP_CONDITIONAL, NULL,
+				conditionReadBackFormat(DBG_CG_LOOP_CONDITIONAL), passes, keys);
+		break;
+	default:
+		break;
+	}
+
+	if (updateWatchData && m_pShVarModel) {
+		watchItems = m_pShVarModel->getAllWatchItemPointers();
+	}
+	/* as updateWatchListData selects them */
+	for (i = 0; i < watchItems.count(); i++) {
+		ShVarItem *item = watchItems[i];
+		if (forceUpdate ?
+				(item->isInScope() || item->isBuildIn()
+						|| item->isInScopeStack()) :
+				((item->isChanged() || item->hasEnteredScope())
+						&& (item->isInScope() || item->isInScopeStack()))) {
+			updateItems.append(item);
+		}
+	}
+	while (!updateItems.isEmpty()) {
+		takePackedWatchItems(updateItems, packed,
+				MAX_PACKED_FRAGMENT_WATCH_ITEMS, true);
+		cl.numChangeables = 0;
+		cl.changeables = NULL;
+		for (i = 0; i < packed.count(); i++) {
+			addShChangeable(&cl, packed[i]->getShChangeable());
+		}
+		addReadAheadPass(DBG_CG_CHANGEABLE, &cl,
+				watchReadBackFormat(packed[0]), passes, keys);
+		for (i = 0; i < cl.numChangeables; i++) {
+			freeShChangeable(&cl.changeables[i]);
+		}
+		free(cl.changeables);
+	}
+
+	/* a single pass is read just as well by getDebugImage */
+	if (passes.size() > 1) {
+		error = pc->shaderStepFragments(&passes[0], (int) passes.size(),
+				m_pftDialog->copyAlpha(), m_pftDialog->copyDepth(),
+				m_pftDialog->copyStencil(), m_pftDialog->alphaValue(),
+				m_pftDialog->depthValue(), m_pftDialog->stencilValue());
+		if (error != PCE_NONE) {
+			UT_NOTIFY(LV_WARN,
+					"Read ahead of fragment passes failed: " << getErrorDescription(error));
+		}
+		for (i = 0; i < (int) passes.size(); i++) {
+			if (passes[i].error != PCE_NONE) {
+				continue;
+			}
+			shared = passes[i].shared;
+			if (!shared) {
+				shared = new SharedResult(passes[i].image,
+						ProgramControl::readBackSize(passes[i].format,
+								passes[i].numComponents, passes[i].width,
+								passes[i].height));
+			}
+			cached.extent[0] = passes[i].width;
+			cached.extent[1] = passes[i].height;
+			memcpy(cached.placement, passes[i].placement,
+					sizeof(cached.placement));
+			cached.data = shared;
+			m_pResultCache->insert(keys[i], cached);
+			shared->unref();
+		}
+	}
+
+	for (i = 0; i < (int) passes.size(); i++) {
+		free(passes[i].shaders[2]);
+	}
+}
+
 void MainWindow::updateWatchListData(CoverageMapStatus cmstatus,
 		bool forceUpdate)
 {
 	QList<ShVarItem*> watchItems;
+	QList<ShVarItem*> updateItems;
 	int i;
 
 	if (m_pShVarModel) {
@@ -1769,13 +2501,13 @@ void MainWindow::updateWatchListData(CoverageMapStatus cmstatus,
 		if (forceUpdate) {
 			if (item->isInScope() || item->isBuildIn()
 					|| item->isInScopeStack()) {
-				updateWatchItemData(item);
+				updateItems.append(item);
 			} else {
 				invalidateWatchItemData(item);
 			}
 		} else if ((item->isChanged() || item->hasEnteredScope())
 				&& (item->isInScope() || item->isInScopeStack())) {
-			updateWatchItemData(item);
+			updateItems.append(item);
 		} else if (item->hasLeftScope()) {
 			invalidateWatchItemData(item);
 		} else {
@@ -1786,23 +2518,22 @@ void MainWindow::updateWatchListData(CoverageMapStatus cmstatus,
 					if (currentRunLevel == RL_DBG_FRAGMENT_SHADER) {
 						PixelBox *dataBox = item->getPixelBoxPointer();
 						if (!(dataBox->isAllDataAvailable())) {
-							updateWatchItemData(item);
+							updateItems.append(item);
 						}
 					} else {
-						updateWatchItemData(item);
+						updateItems.append(item);
 					}
 				} else {
 					invalidateWatchItemData(item);
 				}
 			}
 		}
-		/* HACK: when an error occurs in shader debugging the runlevel
-		 * might change to RL_SETUP and all shader debugging data will
-		 * be invalid; so we have to check it here
-		 */
-		if (currentRunLevel == RL_SETUP) {
-			return;
-		}
+	}
+
+	/* one shader step for as many items as fit into the debug outputs */
+	updateWatchItemsData(updateItems);
+	if (currentRunLevel == RL_SETUP) {
+		return;
 	}
 
 	/* Now update all windows to update themselves if necessary */
@@ -1816,7 +2547,7 @@ void MainWindow::updateWatchListData(CoverageMapStatus cmstatus,
 	m_pShVarModel->currentValuesChanged();
 }
 
-void MainWindow::updateWatchItemsCoverage(bool *coverage)
+void MainWindow::updateWatchItemsCoverage(CoverageMap *coverage)
 {
 	QList<ShVarItem*> watchItems;
 	int i;
@@ -1848,6 +2579,7 @@ void MainWindow::updateWatchItemsCoverage(bool *coverage)
 void MainWindow::resetWatchListData(void)
 {
 	QList<ShVarItem*> watchItems;
+	QList<ShVarItem*> updateItems;
 	int i;
 
 	if (m_pShVarModel) {
@@ -1855,18 +2587,15 @@ void MainWindow::resetWatchListData(void)
 		for (i = 0; i < watchItems.count(); i++) {
 			ShVarItem *item = watchItems[i];
 			if (item->isInScope() || item->isBuildIn()) {
-				updateWatchItemData(item);
-				/* HACK: when an error occurs in shader debugging the runlevel
-				 * might change to RL_SETUP and all shader debugging data will
-				 * be invalid; so we have to check it here
-				 */
-				if (currentRunLevel == RL_SETUP) {
-					return;
-				}
+				updateItems.append(item);
 			} else {
 				invalidateWatchItemData(item);
 			}
 		}
+		updateWatchItemsData(updateItems);
+		if (currentRunLevel == RL_SETUP) {
+			return;
+		}
 		/* Now notify all windows to update themselves if necessary */
 		QList<QMdiSubWindow*> windowList = workspace->subWindowList();
 		for (i = 0; i < windowList.count(); i++) {
@@ -1878,6 +2607,86 @@ void MainWindow::resetWatchListData(void)
 	}
 }
 
+/* Whether ShaderStep updates item at the position dr ahead of the current
+ * one, as updateWatchListData selects the items of a step that neither
+ * emits a vertex nor discards.
+ */
+static bool isWatchItemUpdatedAt(ShVarItem *item, DbgResult *dr)
+{
+	ShChangeable *cgbl = item->getShChangeable();
+	bool changed = false, inScope;
+	int i;
+
+	for (i = 0; i < dr->cgbls.numChangeables && !changed; i++) {
+		changed = dr->cgbls.changeables[i]->id == cgbl->id;
+	}
+	inScope = item->isBuildIn() || scopeContains(&dr->scope, cgbl->id);
+	if (!changed && !item->isBuildIn() && !item->isInScope()) {
+		/* entering the scope */
+		changed = inScope;
+	}
+	inScope = inScope || scopeContains(&dr->scopeStack, cgbl->id);
+	freeShChangeable(&cgbl);
+	return changed && inScope;
+}
+
+void MainWindow::prefetchSteps()
+{
+	QList<ShVarItem*> watchItems, updateItems, packed;
+	ShChangeableList cl;
+	DbgResult *dr;
+	bool fragment = currentRunLevel == RL_DBG_FRAGMENT_SHADER;
+	bool more;
+	int i;
+
+	switch (currentRunLevel) {
+	case RL_DBG_VERTEX_SHADER:
+	case RL_DBG_GEOMETRY_SHADER:
+	case RL_DBG_FRAGMENT_SHADER:
+		break;
+	default:
+		m_pPrefetchTimer->stop();
+		return;
+	}
+
+	if (m_pShVarModel) {
+		watchItems = m_pShVarModel->getAllWatchItemPointers();
+	}
+
+	dr = m_pPrefetcher->advance(watchItems.count(), &more);
+	if (dr) {
+		/* the programs updateWatchItemsData generates there, so that their
+		 * code matches the one of the step
+		 */
+		for (i = 0; i < watchItems.count(); i++) {
+			if (isWatchItemUpdatedAt(watchItems[i], dr)) {
+				updateItems.append(watchItems[i]);
+			}
+		}
+		while (!updateItems.isEmpty() && more) {
+			takePackedWatchItems(updateItems, packed,
+					fragment ?
+							MAX_PACKED_FRAGMENT_WATCH_ITEMS :
+							MAX_PACKED_VERTEX_WATCH_ITEMS, fragment,
+					&dr->scope);
+			cl.numChangeables = 0;
+			cl.changeables = NULL;
+			for (i = 0; i < packed.count(); i++) {
+				addShChangeable(&cl, packed[i]->getShChangeable());
+			}
+			more = m_pPrefetcher->prefetchChangeables(&cl);
+			for (i = 0; i < cl.numChangeables; i++) {
+				freeShChangeable(&cl.changeables[i]);
+			}
+			free(cl.changeables);
+		}
+	}
+
+	if (!more) {
+		m_pPrefetchTimer->stop();
+	}
+}
+
 void MainWindow::ShaderStep(int action, bool updateWatchData,
 		bool updateCovermap)
 {
@@ -1898,9 +2707,21 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 	int debugOptions = EDebugOpIntermediate;
 	DbgResult *dr = NULL;
 	static int nOldCoverageMap = 0;
+	int nNewCoverageMap = 0;
 	CoverageMapStatus cmstatus = COVERAGEMAP_UNCHANGED;
 
+	/* The statistics run of the loop dialog only needs the numbers of the
+	 * iterations, the images are read by the full step at its end. Every
+	 * other step still reads the coverage image: the watch items and the
+	 * pixel views need the cover map itself, not just its count, and their
+	 * images are fetched with the step whether a view is open or not.
+	 */
+	bool statisticsOnly = currentRunLevel == RL_DBG_FRAGMENT_SHADER
+			&& !updateGUI && !updateWatchData;
+
 	dr = ShDebugJumpToNext(m_dShCompiler, debugOptions, action);
+	m_pPrefetcher->stepped(action);
+	m_pPrefetchTimer->start();
 
 	if (dr) {
 		switch (dr->status) {
@@ -1909,10 +2730,36 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 			m_pShVarModel->setChangedAndScope(dr->cgbls, dr->scope,
 					dr->scopeStack);
 
-			if (currentRunLevel == RL_DBG_FRAGMENT_SHADER && updateCovermap) {
+			if (currentRunLevel == RL_DBG_FRAGMENT_SHADER && updateCovermap
+					&& statisticsOnly) {
+				/* Count the cover map on the GPU, it is read again by the
+				 * next full step
+				 */
+				int nActive;
+				if (!getDebugStatistics(DBG_CG_COVERAGE, NULL, 0,
+						&nNewCoverageMap, &nActive)) {
+					QMessageBox::warning(this, "Warning", "An error "
+							"occurred while reading coverage.");
+					return;
+				}
+
+				if (nNewCoverageMap == nOldCoverageMap) {
+					cmstatus = COVERAGEMAP_UNCHANGED;
+				} else if (nNewCoverageMap > nOldCoverageMap) {
+					cmstatus = COVERAGEMAP_GROWN;
+				} else {
+					cmstatus = COVERAGEMAP_SHRINKED;
+				}
+				nOldCoverageMap = nNewCoverageMap;
+			} else if (currentRunLevel == RL_DBG_FRAGMENT_SHADER
+					&& updateCovermap) {
+				/* all passes of this step in one go */
+				readAheadFragmentPasses(dr, updateWatchData);
+
 				/* Read cover map */
 				PixelBoxFloat *pCoverageBox = NULL;
-				if (!(getDebugImage(DBG_CG_COVERAGE, NULL, GL_FLOAT, NULL,
+				if (!(getDebugImage(DBG_CG_COVERAGE, NULL,
+						conditionReadBackFormat(DBG_CG_COVERAGE), NULL,
 						(PixelBox**) &pCoverageBox))) {
 					QMessageBox::warning(this, "Warning", "An error "
 							"occurred while reading coverage.");
@@ -1920,18 +2767,20 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 				}
 
 				/* Retrieve covermap from CoverageBox */
-				int nNewCoverageMap;
-				delete[] m_pCoverage;
-				m_pCoverage = pCoverageBox->getCoverageFromData(
-						&nNewCoverageMap);
+				if (!m_pCoverage) {
+					m_pCoverage = new CoverageMap();
+				}
+				bool coverageChanged = pCoverageBox->getCoverageFromData(
+						m_pCoverage, &nNewCoverageMap);
 				updateWatchItemsCoverage(m_pCoverage);
 
-				if (nNewCoverageMap == nOldCoverageMap) {
+				/* a map can change without its number of pixels */
+				if (!coverageChanged && nNewCoverageMap == nOldCoverageMap) {
 					cmstatus = COVERAGEMAP_UNCHANGED;
-				} else if (nNewCoverageMap > nOldCoverageMap) {
-					cmstatus = COVERAGEMAP_GROWN;
-				} else {
+				} else if (nNewCoverageMap < nOldCoverageMap) {
 					cmstatus = COVERAGEMAP_SHRINKED;
+				} else {
+					cmstatus = COVERAGEMAP_GROWN;
 				}
 				nOldCoverageMap = nNewCoverageMap;
 
@@ -1953,14 +2802,15 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 					return;
 				}
 
-				/* Convert data to bool map: VertexBox -> bool
+				/* Convert data to cover map: VertexBox -> CoverageMap
 				 * Check for change of covermap */
-				bool *newCoverage;
-				bool coverageChanged;
-				newCoverage = pCoverageBox->getCoverageFromData(m_pCoverage,
-						&coverageChanged);
-				delete[] m_pCoverage;
-				m_pCoverage = newCoverage;
+				bool coverageChanged = !m_pCoverage;
+				if (!m_pCoverage) {
+					m_pCoverage = new CoverageMap();
+				}
+				if (pCoverageBox->getCoverageFromData(m_pCoverage)) {
+					coverageChanged = true;
+				}
 				updateWatchItemsCoverage(m_pCoverage);
 
 				if (coverageChanged) {
@@ -2016,7 +2866,8 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 			switch (currentRunLevel) {
 			case RL_DBG_FRAGMENT_SHADER: {
 				PixelBoxFloat *imageBox = NULL;
-				if (getDebugImage(DBG_CG_SELECTION_CONDITIONAL, NULL, GL_FLOAT,
+				if (getDebugImage(DBG_CG_SELECTION_CONDITIONAL, NULL,
+						conditionReadBackFormat(DBG_CG_SELECTION_CONDITIONAL),
 						m_pCoverage, (PixelBox**) &imageBox)) {
 				} else {
 					QMessageBox::warning(this, "Warning",
@@ -2112,17 +2963,44 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 			switch (currentRunLevel) {
 			case RL_DBG_FRAGMENT_SHADER: {
 				PixelBoxFloat *loopCondition = NULL;
-
-				if (updateCovermap) {
+				int nCovered = 0, nActive = 0;
+				bool knownLoop = dr->loopIteration != 0
+						&& !m_qLoopData.isEmpty();
+
+				if (updateCovermap && statisticsOnly && knownLoop) {
+					/* only count the pixels that entered the loop */
+					LoopData *known = m_qLoopData.top();
+					if (!getDebugStatistics(DBG_CG_LOOP_CONDITIONAL,
+							known->getInitialCoverage(), known->getWidth(),
+							&nCovered, &nActive)) {
+						QMessageBox::warning(this, "Warning",
+								"An error occurred while retrieving "
+										"the loop statistics.");
+						return;
+					}
+				} else if (updateCovermap) {
 					/* First get image of loop condition */
-					if (!getDebugImage(DBG_CG_LOOP_CONDITIONAL, NULL, GL_FLOAT,
-							m_pCoverage, (PixelBox**) &loopCondition)) {
+					if (!getDebugImage(DBG_CG_LOOP_CONDITIONAL, NULL,
+							conditionReadBackFormat(DBG_CG_LOOP_CONDITIONAL),
+							statisticsOnly ? NULL : m_pCoverage,
+							(PixelBox**) &loopCondition)) {
 						QMessageBox::warning(this, "Warning",
 								"An error occurred while retrieving "
 										"the loop image.");
 						delete loopCondition;
 						return;
 					}
+					if (statisticsOnly) {
+						/* the statistics run did not read the cover map, the
+						 * condition marks the covered pixels as well
+						 */
+						if (!m_pCoverage) {
+							m_pCoverage = new CoverageMap();
+						}
+						loopCondition->getCoverageFromData(m_pCoverage,
+								&nCovered);
+						loopCondition->setNewCoverage(m_pCoverage);
+					}
 				}
 
 				/* Add data to the loop storage */
@@ -2135,7 +3013,10 @@ void MainWindow::ShaderStep(int action, bool updateWatchData,
 							"==> known loop at " << dr->loopIteration);
 					if (!m_qLoopData.isEmpty()) {
 						lData = m_qLoopData.top();
-						if (updateCovermap) {
+						if (updateCovermap && statisticsOnly && knownLoop) {
+							lData->addLoopIteration(nCovered, nActive,
+									dr->loopIteration);
+						} else if (updateCovermap) {
 							lData->addLoopIteration(loopCondition,
 									dr->loopIteration);
 						}
@@ -2362,6 +3243,8 @@ pcErrorCode MainWindow::recordCall()
 
 void MainWindow::recordDrawCall()
 {
+	/* results of the previous recording are of no use anymore */
+	m_pResultCache->clear();
 	pc->initRecording();
 	if (!strcmp(m_pCurrentCall->getName(), "glBegin")) {
 		while (currentRunLevel == RL_DBG_RECORD_DRAWCALL
@@ -2463,10 +3346,16 @@ void MainWindow::on_tbShaderExecute_clicked()
 				DBG_PFT_KEEP, DBG_PFT_KEEP, DBG_PFT_KEEP);
 		break;
 	case 2:
+		m_focusRegion = QSettings().value("FragmentDebug/FocusRegion",
+				QRect()).toRect();
+		m_imageOrigin = QPoint();
+		m_halfFloatValues = m_pftDialog->halfFloatValues();
 		error = pc->setDbgTarget(DBG_TARGET_FRAGMENT_SHADER,
 				m_pftDialog->alphaTestOption(), m_pftDialog->depthTestOption(),
 				m_pftDialog->stencilTestOption(),
-				m_pftDialog->blendingOption());
+				m_pftDialog->blendingOption(), m_focusRegion.x(),
+				m_focusRegion.y(), m_focusRegion.width(),
+				m_focusRegion.height());
 		break;
 	}
 	setErrorStatus(error);
@@ -2555,6 +3444,11 @@ void MainWindow::on_tbShaderExecute_clicked()
 		return;
 	}
 
+	m_pPrefetcher->start(language, shaderCode, &m_dShResources, m_pShaders,
+			type == 0 ? DBG_TARGET_VERTEX_SHADER :
+			type == 1 ? DBG_TARGET_GEOMETRY_SHADER :
+			DBG_TARGET_FRAGMENT_SHADER);
+
 	m_pShVarModel = new ShVarModel(&m_dShVariableList, this, qApp);
 	connect(m_pShVarModel, SIGNAL(newWatchItem(ShVarItem*)), this,
 			SLOT(updateWatchItemData(ShVarItem*)));
@@ -2770,6 +3664,10 @@ WatchView* MainWindow::newWatchWindowFragment(QModelIndexList &list)
 						SLOT(setPickMode()));
 				connect(aMinMaxLens, SIGNAL(triggered()), window,
 						SLOT(setMinMaxMode()));
+				connect(aFocusRegion, SIGNAL(triggered()), window,
+						SLOT(setFocusMode()));
+				connect(window, SIGNAL(focusRegionChanged(const QRect &)), this,
+						SLOT(setFocusRegion(const QRect &)));
 				/* initialize mouse mode */
 				agWatchControl->setEnabled(true);
 				if (agWatchControl->checkedAction() == aZoom) {
@@ -2778,6 +3676,8 @@ WatchView* MainWindow::newWatchWindowFragment(QModelIndexList &list)
 					window->setPickMode();
 				} else if (agWatchControl->checkedAction() == aMinMaxLens) {
 					window->setMinMaxMode();
+				} else if (agWatchControl->checkedAction() == aFocusRegion) {
+					window->setFocusMode();
 				}
 				window->setWorkspace(workspace);
 				workspace->addSubWindow(window);
@@ -3055,8 +3955,19 @@ void MainWindow::leaveDBGState()
 			setRunLevel(RL_SETUP);
 			return;
 		}
+		{
+			int hits, misses, numPrograms;
+			if (pc->getDbgShaderCacheStats(&hits, &misses, &numPrograms, true)
+					== PCE_NONE) {
+				dbgPrint(DBGLVL_INFO, "debug program cache: %i hits, %i misses, "
+						"%i programs\n", hits, misses, numPrograms);
+			}
+		}
+		dbgPrint(DBGLVL_INFO, "shader step result cache: %i hits, %i misses\n",
+				m_pResultCache->hits(), m_pResultCache->misses());
+		m_pResultCache->clear();
 		/* TODO: close all windows (obsolete?) */
-		delete[] m_pCoverage;
+		delete m_pCoverage;
 		m_pCoverage = NULL;
 		break;
 	default:
@@ -3150,6 +4061,9 @@ void MainWindow::cleanupDBGShader()
 			m_pShVarModel = NULL;
 		}
 
+		m_pPrefetchTimer->stop();
+		m_pPrefetcher->stop();
+
 		if (m_dShCompiler) {
 			// It is not needed in mesa-glsl
 			freeShVariableList(&m_dShVariableList);
@@ -3772,7 +4686,8 @@ void MainWindow::setMouseOverValues(int x, int y, const bool *active,
 		lSBCurrentValueB->clear();
 	} else {
 		lSBCurrentPosition->setText(
-				QString::number(x) + "," + QString::number(y));
+				QString::number(x + m_imageOrigin.x()) + ","
+						+ QString::number(y + m_imageOrigin.y()));
 		if (active[0]) {
 			lSBCurrentValueR->setText(values[0].toString());
 		} else {
@@ -3796,12 +4711,30 @@ void MainWindow::newSelectedPixel(int x, int y)
 	m_selectedPixel[0] = x;
 	m_selectedPixel[1] = y;
 	lWatchSelectionPos->setText(
-			"Pixel " + QString::number(x) + ", " + QString::number(y));
+			"Pixel " + QString::number(x + m_imageOrigin.x()) + ", "
+					+ QString::number(y + m_imageOrigin.y()));
 	if (m_pShVarModel && m_selectedPixel[0] >= 0 && m_selectedPixel[1] >= 0) {
 		m_pShVarModel->setCurrentValues(m_selectedPixel[0], m_selectedPixel[1]);
 	}
 }
 
+/* The saved buffers of a debug session depend on the region, so it is kept
+ * for the next one.
+ */
+void MainWindow::setFocusRegion(const QRect &region)
+{
+	QSettings().setValue("FragmentDebug/FocusRegion", region);
+	if (region.isEmpty()) {
+		statusbar->showMessage("Focus region cleared, the next fragment shader "
+				"debug session covers the whole viewport");
+	} else {
+		statusbar->showMessage(
+				QString("Focus region %1,%2 %3x%4 is used from the next fragment "
+						"shader debug session on").arg(region.x()).arg(
+						region.y()).arg(region.width()).arg(region.height()));
+	}
+}
+
 void MainWindow::newSelectedVertex(int n)
 {
 	m_selectedPixel[0] = n;
@@ -3823,15 +4756,20 @@ void MainWindow::newSelectedPrimitive(int dataIdx)
 void MainWindow::resetPerFrameStatistics(void)
 {
 	if (m_pCurrentCall && m_pCurrentCall->isFrameEnd()) {
-		m_pGlCallPfst->resetStatistic();
-		m_pGlExtPfst->resetStatistic();
-		m_pGlxCallPfst->resetStatistic();
-		m_pGlxExtPfst->resetStatistic();
-		m_pWglCallPfst->resetStatistic();
-		m_pWglExtPfst->resetStatistic();
+		clearPerFrameStatistics();
 	}
 }
 
+void MainWindow::clearPerFrameStatistics(void)
+{
+	m_pGlCallPfst->resetStatistic();
+	m_pGlExtPfst->resetStatistic();
+	m_pGlxCallPfst->resetStatistic();
+	m_pGlxExtPfst->resetStatistic();
+	m_pWglCallPfst->resetStatistic();
+	m_pWglExtPfst->resetStatistic();
+}
+
 void MainWindow::resetAllStatistics(void)
 {
 	m_pGlCallSt->resetStatistic();
@@ -39,6 +39,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif /* _WIN32 */
 
 #include <QtCore/QTextStream>
+#include <QtCore/QTimer>
 
 #include "globaldefines.h"
 #include "ui_mainWindow.h"
@@ -50,6 +51,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ShaderLang.h"
 
 #include "progControl.qt.h"
+#include "traceConsumer.h"
+#include "resultCache.h"
+#include "stepPrefetcher.h"
 #include "shVarModel.qt.h"
 #include "errorCodes.h"
 #include "functionCall.h"
@@ -142,11 +146,13 @@ private slots:
 	void newSelectedPixel(int x, int y);
 	void newSelectedVertex(int n);
 	void newSelectedPrimitive(int dataIdx);
+	void setFocusRegion(const QRect &region);
 	void changedActiveWindow(QMdiSubWindow *w);
 	void ShaderStep(int action, bool updateData = true, bool updateCovermap =
 			true);
 
 	void singleStep();
+	void prefetchSteps();
 
 private:
 	void closeEvent(QCloseEvent *event);
@@ -159,15 +165,28 @@ private:
 	void leaveDBGState();
 	void cleanupDBGShader();
 	bool getDebugImage(DbgCgOptions option, ShChangeableList *cl, int rbFormat,
-			bool *coverage, PixelBox **fbData);
+			CoverageMap *coverage, PixelBox **fbData);
+	bool getDebugStatistics(DbgCgOptions option, const CoverageMap *limit,
+			int width, int *numCovered, int *numActive);
+	QByteArray fragmentResultKey(char *shaders[3], DbgCgOptions option,
+			int channels, int rbFormat);
+	int watchReadBackFormat(ShVarItem *item);
+	void addReadAheadPass(DbgCgOptions option, ShChangeableList *cl,
+			int rbFormat, std::vector<FragmentPass> &passes,
+			QList<QByteArray> &keys);
+	void readAheadFragmentPasses(DbgResult *dr, bool updateWatchData);
 	bool getDebugVertexData(DbgCgOptions option, ShChangeableList *cl,
-			bool *coverage, VertexBox *vdata);
+			CoverageMap *coverage, VertexBox *vdata);
+	bool getWatchItemGeometryData(ShVarItem *watchItem, ShChangeableList *cl);
+	void updateWatchItemsData(QList<ShVarItem*> &watchItems);
+	bool updatePackedWatchItemsData(QList<ShVarItem*> &watchItems);
 
 	/* Gui update handling */
 	void setGuiUpdates(bool);
 	void updateWatchGui(int s);
 
 	void addGlTraceItem();
+	void incCallStatistics(const FunctionCall *call);
 	void addGlTraceErrorItem(const char *text);
 	void addGlTraceWarningItem(const char *text);
 	void setGlTraceItemText(const char *text);
@@ -179,6 +198,14 @@ private:
 	pcErrorCode recordCall();
 	void recordDrawCall();
 	void waitForEndOfExecution();
+	/* Run to the stop of the given DBG_EXECUTE_MODES mode while the debuggee
+	 * reports the executed calls through the trace ring, so the trace is
+	 * complete without a stop per call. Returns false if that is not
+	 * possible; the caller has to step then.
+	 */
+	bool executeTraced(int mode, const char *fname = NULL);
+	void addTracedCalls();
+	void finishTrace();
 
 	/* Workspace */
 	QMdiArea *workspace;
@@ -204,6 +231,8 @@ private:
 	QStringList dbgProgArgs;
 	QString workDir;
 	ProgramControl *pc;
+	TraceConsumer *m_pTraceConsumer;
+	bool m_bTracedExecution;
 
 	const FunctionCall *m_pCurrentCall;
 
@@ -212,6 +241,7 @@ private:
 
 	void setGlStatisticTabs(int n, int m);
 	void resetPerFrameStatistics(void);
+	void clearPerFrameStatistics(void);
 	void resetAllStatistics(void);
 
 	GlCallStatistics *m_pGlCallSt;
@@ -247,7 +277,15 @@ private:
 	VertexBox *m_pVertexCount;
 	//GeoShaderDataModel *m_pGeoDataModel;
 
-	bool *m_pCoverage;
+	/* cover map of the current shader step, updated in place */
+	CoverageMap *m_pCoverage;
+
+	/* shader step results of the current recording */
+	ResultCache *m_pResultCache;
+
+	/* debug programs of upcoming steps, built while the GUI is idle */
+	StepPrefetcher *m_pPrefetcher;
+	QTimer *m_pPrefetchTimer;
 
 	enum CoverageMapStatus {
 		COVERAGEMAP_UNCHANGED,
@@ -255,7 +293,7 @@ private:
 		COVERAGEMAP_SHRINKED
 	};
 	void updateWatchListData(CoverageMapStatus cmstatus, bool forceUpdate);
-	void updateWatchItemsCoverage(bool *coverage);
+	void updateWatchItemsCoverage(CoverageMap *coverage);
 	void resetWatchListData(void);
 	void updateSelectedPixelValues(void);
 	QModelIndexList cleanupSelectionList(QModelIndexList input);
@@ -271,6 +309,19 @@ private:
 
 	int m_selectedPixel[2];
 
+	/* FragmentDebug/FocusRegion setting of the current debug session, empty
+	 * to debug the whole viewport
+	 */
+	QRect m_focusRegion;
+	/* viewport position of the images of the current debug session, the
+	 * watch windows show and pick pixels relative to it
+	 */
+	QPoint m_imageOrigin;
+	/* half float option of the fragment test dialog for the current debug
+	 * session, reads float watch items back as half floats
+	 */
+	bool m_halfFloatValues;
+
 	/* MRU program. */
 	bool loadMruProgram(QString& outProgram, QString& outArguments,
 			QString& outWorkDir);
@@ -33,6 +33,17 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "pixelBox.qt.h"
 
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+extern "C" {
+#include "GL/gl.h"
+#include "GL/glext.h"
+#include "debuglib.h"
+}
 #include "dbgprint.h"
 
 PixelBox::PixelBox(QObject *i_qParent) :
@@ -49,34 +60,81 @@ PixelBox::~PixelBox()
 {
 	emit dataDeleted();
 
-	delete[] m_pDataMap;
+	delete m_pDataMap;
 }
 
 bool PixelBox::isAllDataAvailable()
 {
-	int x, y;
-	bool *pDataMap;
-	bool *pCoverage;
+	if (!m_pDataMap || !m_pCoverage) {
+		return false;
+	}
 
-	if (!m_pDataMap) {
+	if (!m_pDataMap->contains(*m_pCoverage)) {
+		dbgPrint(DBGLVL_INFO,
+				"NOT ALL DATA AVILABLE, NEED READBACK =========================\n");
 		return false;
 	}
+	return true;
+}
 
-	pDataMap = m_pDataMap;
-	pCoverage = m_pCoverage;
+bool PixelBox::isPackedFormat(int i_nFormat)
+{
+	return i_nFormat == GL_BITMAP || i_nFormat == GL_UNSIGNED_BYTE
+			|| i_nFormat == GL_HALF_FLOAT;
+}
 
-	for (y = 0; y < m_nHeight; y++) {
-		for (x = 0; x < m_nWidth; x++) {
-			if (*pCoverage && !*pDataMap) {
-				dbgPrint(DBGLVL_INFO,
-						"NOT ALL DATA AVILABLE, NEED READBACK =========================\n");
-				return false;
+static float halfToFloat(unsigned short h)
+{
+	int exponent = (h >> 10) & 0x1f;
+	int mantissa = h & 0x3ff;
+	float f;
+
+	if (exponent == 0) {
+		f = ldexpf((float) mantissa, -24);
+	} else if (exponent == 31) {
+		f = mantissa ? NAN : INFINITY;
+	} else {
+		f = ldexpf((float) (mantissa | 0x400), exponent - 25);
+	}
+	return (h & 0x8000) ? -f : f;
+}
+
+float* PixelBox::unpackData(int i_nFormat, int i_nWidth, int i_nHeight,
+		int i_nChannel, const void *i_pData)
+{
+	int i, x, y, rowWords;
+	int numValues = i_nWidth * i_nHeight * i_nChannel;
+	float *data = new float[numValues];
+	const unsigned int *words;
+
+	switch (i_nFormat) {
+	case GL_BITMAP:
+		rowWords = DBG_MASK_ROW_WORDS(i_nWidth);
+		for (y = 0; y < i_nHeight; y++) {
+			words = (const unsigned int*) i_pData + y * rowWords;
+			for (x = 0; x < i_nWidth; x++) {
+				data[y * i_nWidth + x] =
+						(words[x / 32] >> (x % 32)) & 1 ? 1.0f : 0.0f;
 			}
-			pDataMap++;
-			pCoverage++;
 		}
+		break;
+	case GL_UNSIGNED_BYTE:
+		for (i = 0; i < numValues; i++) {
+			data[i] = ((const unsigned char*) i_pData)[i] / 255.0f;
+		}
+		break;
+	case GL_HALF_FLOAT:
+		for (i = 0; i < numValues; i++) {
+			data[i] = halfToFloat(((const unsigned short*) i_pData)[i]);
+		}
+		break;
+	default:
+		dbgPrint(DBGLVL_ERROR, "PixelBox::unpackData: unknown format %i\n",
+				i_nFormat);
+		memset(data, 0, numValues * sizeof(float));
+		break;
 	}
-	return true;
+	return data;
 }
 
 void PixelBox::setMinMaxArea(const QRect& minMaxArea)
@@ -47,17 +47,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template<typename vType>
 TypedPixelBox<vType>::TypedPixelBox(int i_nWidth, int i_nHeight, int i_nChannel,
-		vType *i_pData, bool *i_pCoverage, QObject *i_qParent) :
+		vType *i_pData, CoverageMap *i_pCoverage, QObject *i_qParent) :
 		PixelBox(i_qParent)
 {
-	int i;
-
 	m_nWidth = i_nWidth;
 	m_nHeight = i_nHeight;
 	m_nChannel = i_nChannel;
 
+	m_pShared = NULL;
 	m_pData = new vType[m_nWidth * m_nHeight * m_nChannel];
-	m_pDataMap = new bool[m_nWidth * m_nHeight];
 
 	/* Initially use all given data */
 	if (i_pData) {
@@ -67,17 +65,35 @@ TypedPixelBox<vType>::TypedPixelBox(int i_nWidth, int i_nHeight, int i_nChannel,
 		memset(m_pData, 0, m_nWidth * m_nHeight * m_nChannel * sizeof(vType));
 	}
 
+	init(i_pData, i_pCoverage);
+}
+
+template<typename vType>
+TypedPixelBox<vType>::TypedPixelBox(int i_nWidth, int i_nHeight, int i_nChannel,
+		SharedResult *i_pShared, CoverageMap *i_pCoverage, QObject *i_qParent) :
+		PixelBox(i_qParent)
+{
+	m_nWidth = i_nWidth;
+	m_nHeight = i_nHeight;
+	m_nChannel = i_nChannel;
+
+	m_pShared = i_pShared;
+	m_pData = (vType*) i_pShared->getDataPointer();
+
+	init(m_pData, i_pCoverage);
+}
+
+template<typename vType>
+void TypedPixelBox<vType>::init(vType *i_pData, CoverageMap *i_pCoverage)
+{
 	/* Initially use all given data */
+	m_pDataMap = new CoverageMap(m_nWidth * m_nHeight, true);
 	if (i_pCoverage) {
-		memcpy(m_pDataMap, i_pCoverage, m_nWidth * m_nHeight * sizeof(bool));
-	} else {
-		for (i = 0; i < m_nWidth * m_nHeight; i++) {
-			m_pDataMap[i] = true;
-		}
+		m_pDataMap->andWith(*i_pCoverage);
 	}
 	m_pCoverage = i_pCoverage;
 
-	if (i_nChannel && i_pData) {
+	if (m_nChannel && i_pData) {
 		m_nMinData = new vType[m_nChannel];
 		m_nMaxData = new vType[m_nChannel];
 		m_nAbsMinData = new vType[m_nChannel];
@@ -98,14 +114,15 @@ TypedPixelBox<vType>::TypedPixelBox(TypedPixelBox *src) :
 	m_nWidth = src->m_nWidth;
 	m_nHeight = src->m_nHeight;
 	m_nChannel = src->m_nChannel;
+	m_origin = src->m_origin;
 	m_pCoverage = src->m_pCoverage;
 
+	m_pShared = NULL;
 	m_pData = new vType[m_nWidth * m_nHeight * m_nChannel];
-	m_pDataMap = new bool[m_nWidth * m_nHeight];
+	m_pDataMap = new CoverageMap(*src->m_pDataMap);
 
 	memcpy(m_pData, src->m_pData,
 			m_nWidth * m_nHeight * m_nChannel * sizeof(vType));
-	memcpy(m_pDataMap, src->m_pDataMap, m_nWidth * m_nHeight * sizeof(bool));
 
 	m_nMinData = new vType[m_nChannel];
 	m_nMaxData = new vType[m_nChannel];
@@ -118,10 +135,35 @@ TypedPixelBox<vType>::TypedPixelBox(TypedPixelBox *src) :
 	memcpy(m_nAbsMaxData, src->m_nAbsMaxData, m_nChannel * sizeof(vType));
 }
 
+template<typename vType>
+TypedPixelBox<vType>::TypedPixelBox(TypedPixelBox *src, int i_nChannel) :
+		PixelBox(src->parent())
+{
+	int i;
+
+	m_nWidth = src->m_nWidth;
+	m_nHeight = src->m_nHeight;
+	m_nChannel = 1;
+	m_origin = src->m_origin;
+	m_minMaxArea = src->m_minMaxArea;
+
+	m_pShared = NULL;
+	m_pData = new vType[m_nWidth * m_nHeight];
+	for (i = 0; i < m_nWidth * m_nHeight; i++) {
+		m_pData[i] = src->m_pData[i * src->m_nChannel + i_nChannel];
+	}
+
+	init(m_pData, src->m_pCoverage);
+}
+
 template<typename vType>
 TypedPixelBox<vType>::~TypedPixelBox()
 {
-	delete[] m_pData;
+	if (m_pShared) {
+		m_pShared->unref();
+	} else {
+		delete[] m_pData;
+	}
 	delete[] m_nMinData;
 	delete[] m_nMaxData;
 	delete[] m_nAbsMinData;
@@ -133,7 +175,7 @@ void TypedPixelBox<vType>::calcMinMax(QRect area)
 {
 	int x, y, c;
 	int left, right, top, bottom;
-	bool *pCoverage;
+	CoverageMap *pCoverage;
 
 	for (c = 0; c < m_nChannel; c++) {
 		m_nMinData[c] = sc_maxVal;
@@ -169,7 +211,7 @@ void TypedPixelBox<vType>::calcMinMax(QRect area)
 		for (x = left; x < right; x++) {
 			for (c = 0; c < m_nChannel; c++) {
 				int idx = y * m_nWidth + x;
-				if (pCoverage[idx]) {
+				if (pCoverage->test(idx)) {
 					idx += c;
 					if (m_pData[idx] < m_nMinData[c]) {
 						m_nMinData[c] = m_pData[idx];
@@ -303,12 +345,15 @@ double TypedPixelBox<vType>::getAbsMax(int channel)
 
 template<typename vType>
 void TypedPixelBox<vType>::setData(int i_nWidth, int i_nHeight, int i_nChannel,
-		vType *i_pData, bool *i_pCoverage)
+		vType *i_pData, CoverageMap *i_pCoverage)
 {
-	int i;
-
-	delete[] m_pData;
-	delete[] m_pDataMap;
+	if (m_pShared) {
+		m_pShared->unref();
+		m_pShared = NULL;
+	} else {
+		delete[] m_pData;
+	}
+	delete m_pDataMap;
 	delete[] m_nMinData;
 	delete[] m_nMaxData;
 	delete[] m_nAbsMinData;
@@ -319,7 +364,6 @@ void TypedPixelBox<vType>::setData(int i_nWidth, int i_nHeight, int i_nChannel,
 	m_nChannel = i_nChannel;
 
 	m_pData = new vType[m_nWidth * m_nHeight * m_nChannel];
-	m_pDataMap = new bool[m_nWidth * m_nHeight];
 
 	/* Initially use all given data */
 	if (i_pData) {
@@ -330,12 +374,9 @@ void TypedPixelBox<vType>::setData(int i_nWidth, int i_nHeight, int i_nChannel,
 	}
 
 	/* Initially use all given data */
+	m_pDataMap = new CoverageMap(m_nWidth * m_nHeight, true);
 	if (i_pCoverage) {
-		memcpy(m_pDataMap, i_pCoverage, m_nWidth * m_nHeight * sizeof(bool));
-	} else {
-		for (i = 0; i < m_nWidth * m_nHeight; i++) {
-			m_pDataMap[i] = true;
-		}
+		m_pDataMap->andWith(*i_pCoverage);
 	}
 	m_pCoverage = i_pCoverage;
 
@@ -353,77 +394,69 @@ void TypedPixelBox<vType>::setData(int i_nWidth, int i_nHeight, int i_nChannel,
 	}
 }
 
+template<typename vType>
+void TypedPixelBox<vType>::unshareData(void)
+{
+	vType *pData;
+
+	if (!m_pShared || !m_pShared->isShared()) {
+		return;
+	}
+
+	pData = new vType[m_nWidth * m_nHeight * m_nChannel];
+	memcpy(pData, m_pData, m_nWidth * m_nHeight * m_nChannel * sizeof(vType));
+	m_pData = pData;
+
+	m_pShared->unref();
+	m_pShared = NULL;
+}
+
 template<typename vType>
 void TypedPixelBox<vType>::addPixelBox(TypedPixelBox<vType> *f)
 {
 	int i, j;
 	vType *pDstData, *pSrcData;
-	bool *pDstDataMap, *pSrcDataMap;
+	CoverageMap *pSrcDataMap;
 
 	if (m_nWidth != f->getWidth() || m_nHeight != f->getHeight()
-			|| m_nChannel != f->getChannel()) {
+			|| m_nChannel != f->getChannel() || m_origin != f->getOrigin()) {
 		return;
 	}
 
+	unshareData();
 	pDstData = m_pData;
-	pDstDataMap = m_pDataMap;
-
 	pSrcData = f->getDataPointer();
 	pSrcDataMap = f->getDataMapPointer();
 
 	for (i = 0; i < m_nWidth * m_nHeight; i++) {
-		if (*pSrcDataMap) {
-			*pDstDataMap = true;
+		if (pSrcDataMap->test(i)) {
 			for (j = 0; j < m_nChannel; j++) {
 				*pDstData = *pSrcData;
 				pDstData++;
 				pSrcData++;
 			}
 		} else {
-			for (j = 0; j < m_nChannel; j++) {
-				pDstData++;
-				pSrcData++;
-			}
+			pDstData += m_nChannel;
+			pSrcData += m_nChannel;
 		}
-		pDstDataMap++;
-		pSrcDataMap++;
 	}
+	m_pDataMap->orWith(*pSrcDataMap);
 
 	calcMinMax(this->m_minMaxArea);
 	emit dataChanged();
 }
 
 template<typename vType>
-bool* TypedPixelBox<vType>::getCoverageFromData(int *i_pActivePixels)
+bool TypedPixelBox<vType>::getCoverageFromData(CoverageMap *coverage,
+		int *i_pActivePixels)
 {
-	int i, j;
-	int nActivePixels;
-	vType *pData;
-	bool *pCoverage;
-	bool *coverage = new bool[m_nWidth * m_nHeight];
-
-	pCoverage = coverage;
-	pData = m_pData;
-	nActivePixels = 0;
-
-	for (i = 0; i < m_nWidth * m_nHeight; i++) {
-		if (*pData > 0.5f) {
-			*pCoverage = true;
-			nActivePixels++;
-		} else {
-			*pCoverage = false;
-		}
-		for (j = 0; j < m_nChannel; j++) {
-			pData++;
-		}
-		pCoverage++;
-	}
+	bool changed = coverage->setFromValues(m_nWidth * m_nHeight, m_pData,
+			m_nChannel, (vType) 0.5f);
 
 	if (i_pActivePixels) {
-		*i_pActivePixels = nActivePixels;
+		*i_pActivePixels = coverage->count();
 	}
-
-	return coverage;
+	return changed;
 }
 
 template<typename vType>
@@ -445,15 +478,13 @@ QImage TypedPixelBox<vType>::getByteImage(FBMapping i_eMapping)
 {
 	int x, y, c;
 	vType *pData;
-	bool *pDataMap;
 
 	QImage image(m_nWidth, m_nHeight, QImage::Format_RGB32);
 
 	pData = m_pData;
-	pDataMap = m_pDataMap;
 	for (y = 0; y < m_nHeight; y++) {
 		for (x = 0; x < m_nWidth; x++) {
-			if (*pDataMap) {
+			if (m_pDataMap->test(y * m_nWidth + x)) {
 				/* data available */
 				QColor color;
 				if (0 < m_nChannel) {
@@ -483,7 +514,6 @@ QImage TypedPixelBox<vType>::getByteImage(FBMapping i_eMapping)
 					pData++;
 				}
 			}
-			pDataMap++;
 		}
 	}
 	return image;
@@ -512,7 +542,7 @@ void TypedPixelBox<vType>::setByteImageRedChannel(QImage *image,
 		for (x = 0; x < m_nWidth; x++) {
 			QColor c(image->pixel(x, y));
 			unsigned long idx = y * m_nWidth + x;
-			if (m_pCoverage[idx] && m_pDataMap[idx]) {
+			if (m_pCoverage->test(idx) && m_pDataMap->test(idx)) {
 				c.setRed(
 						getMappedValueI(m_pData[idx], mapping, rangeMapping,
 								minmax));
@@ -550,7 +580,7 @@ void TypedPixelBox<vType>::setByteImageGreenChannel(QImage *image,
 		for (x = 0; x < m_nWidth; x++) {
 			QColor c(image->pixel(x, y));
 			unsigned long idx = y * m_nWidth + x;
-			if (m_pCoverage[idx] && m_pDataMap[idx]) {
+			if (m_pCoverage->test(idx) && m_pDataMap->test(idx)) {
 				c.setGreen(
 						getMappedValueI(m_pData[idx], mapping, rangeMapping,
 								minmax));
@@ -588,7 +618,7 @@ void TypedPixelBox<vType>::setByteImageBlueChannel(QImage *image,
 		for (x = 0; x < m_nWidth; x++) {
 			QColor c(image->pixel(x, y));
 			unsigned long idx = y * m_nWidth + x;
-			if (m_pCoverage[idx] && m_pDataMap[idx]) {
+			if (m_pCoverage->test(idx) && m_pDataMap->test(idx)) {
 				c.setBlue(
 						getMappedValueI(m_pData[idx], mapping, rangeMapping,
 								minmax));
@@ -606,19 +636,13 @@ void TypedPixelBox<vType>::setByteImageBlueChannel(QImage *image,
 template<typename vType>
 void TypedPixelBox<vType>::invalidateData()
 {
-	int x, y, c;
-	bool *pDataMap;
+	int c;
 
 	if (!m_pDataMap) {
 		return;
 	}
 
-	pDataMap = m_pDataMap;
-	for (y = 0; y < m_nHeight; y++) {
-		for (x = 0; x < m_nWidth; x++) {
-			*pDataMap++ = false;
-		}
-	}
+	m_pDataMap->fill(false);
 	for (c = 0; c < m_nChannel; c++) {
 		m_nMinData[c] = (vType) 0;
 		m_nMaxData[c] = (vType) 0;
@@ -632,8 +656,8 @@ template<typename vType>
 bool TypedPixelBox<vType>::getDataValue(int x, int y, vType *v)
 {
 	int i;
-	if (m_pCoverage && m_pData && m_pCoverage[y * m_nWidth + x]
-			&& m_pDataMap[y * m_nWidth + x]) {
+	if (m_pCoverage && m_pData && m_pCoverage->test(y * m_nWidth + x)
+			&& m_pDataMap->test(y * m_nWidth + x)) {
 		for (i = 0; i < m_nChannel; i++) {
 			v[i] = m_pData[m_nChannel * (y * m_nWidth + x) + i];
 		}
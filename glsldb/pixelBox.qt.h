@@ -40,6 +40,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QtGui/QImage>
 
 #include "mappings.h"
+#include "sharedResult.h"
+#include "coverageMap.h"
 
 class PixelBox: public QObject {
 Q_OBJECT
@@ -48,17 +50,21 @@ public:
 	PixelBox(QObject *i_qParent = 0);
 	virtual ~PixelBox();
 
-	void setNewCoverage(bool* i_pCoverage)
+	void setNewCoverage(CoverageMap* i_pCoverage)
 	{
 		m_pCoverage = i_pCoverage;
 	}
 
-	virtual bool* getCoverageFromData(int *i_pActivePixels = NULL) = 0;
-	bool* getCoveragePointer(void)
+	/* Sets the pixels with a first channel above 0.5 in coverage, returns
+	 * whether it changed.
+	 */
+	virtual bool getCoverageFromData(CoverageMap *coverage,
+			int *i_pActivePixels = NULL) = 0;
+	CoverageMap* getCoveragePointer(void)
 	{
 		return m_pCoverage;
 	}
-	bool* getDataMapPointer(void)
+	CoverageMap* getDataMapPointer(void)
 	{
 		return m_pDataMap;
 	}
@@ -76,6 +82,18 @@ public:
 		return m_nChannel;
 	}
 
+	/* position of the top left pixel in the viewport; the boxes of a focus
+	 * region hold the region only
+	 */
+	QPoint getOrigin(void)
+	{
+		return m_origin;
+	}
+	void setOrigin(const QPoint &i_origin)
+	{
+		m_origin = i_origin;
+	}
+
 	/* get min/max data values per channel, channel == -1 means all channels */
 	virtual double getMin(int channel = -1) = 0;
 	virtual double getMax(int channel = -1) = 0;
@@ -99,6 +117,17 @@ public:
 	bool isAllDataAvailable();
 	virtual void invalidateData() = 0;
 
+	/* true for the packed readback formats of DBG_SHADER_STEP: GL_BITMAP
+	 * masks, GL_UNSIGNED_BYTE unorm and GL_HALF_FLOAT
+	 */
+	static bool isPackedFormat(int i_nFormat);
+	/* Unpacks i_nWidth x i_nHeight values of i_nChannel components in a
+	 * packed format into new[]'ed floats, masks unpack to 0.0 and 1.0. The
+	 * results stay packed until a box is made of them.
+	 */
+	static float* unpackData(int i_nFormat, int i_nWidth, int i_nHeight,
+			int i_nChannel, const void *i_pData);
+
 signals:
 	void dataChanged();
 	void dataDeleted();
@@ -111,23 +140,34 @@ protected:
 	int m_nWidth;
 	int m_nHeight;
 	int m_nChannel;
-	bool *m_pDataMap;
-	bool *m_pCoverage;
+	QPoint m_origin;
+	CoverageMap *m_pDataMap;
+	CoverageMap *m_pCoverage;
 	QRect m_minMaxArea;
 };
 
 template<typename vType> class TypedPixelBox: public PixelBox {
 public:
 	TypedPixelBox(int i_nWidth, int i_nHeight, int i_nChannel, vType *i_pData,
-			bool *i_pCoverage = 0, QObject *i_qParent = 0);
+			CoverageMap *i_pCoverage = 0, QObject *i_qParent = 0);
+	/* wraps the shared data without copying and takes over the caller's
+	 * reference to i_pShared; a result left in the arena stays there until
+	 * the box is deleted
+	 */
+	TypedPixelBox(int i_nWidth, int i_nHeight, int i_nChannel,
+			SharedResult *i_pShared, CoverageMap *i_pCoverage = 0,
+			QObject *i_qParent = 0);
 	TypedPixelBox(TypedPixelBox *src);
+	/* single channel box holding channel i_nChannel of src */
+	TypedPixelBox(TypedPixelBox *src, int i_nChannel);
 	virtual ~TypedPixelBox();
 
 	void setData(int i_nWidth, int i_nHeight, int i_nChannel, vType *i_pData,
-			bool *i_pCoverage = 0);
+			CoverageMap *i_pCoverage = 0);
 	void addPixelBox(TypedPixelBox *f);
 
-	virtual bool* getCoverageFromData(int *i_pActivePixels = NULL);
+	virtual bool getCoverageFromData(CoverageMap *coverage,
+			int *i_pActivePixels = NULL);
 	vType* getDataPointer(void)
 	{
 		return m_pData;
@@ -157,10 +197,14 @@ protected:
 	static const vType sc_minVal;
 	static const vType sc_maxVal;
 
+	void init(vType *i_pData, CoverageMap *i_pCoverage);
+	/* copy shared data somebody else still refers to before writing it */
+	void unshareData(void);
 	void calcMinMax(QRect area);
 	int mapFromValue(FBMapping i_eMapping, vType i_nF, int i_nC);
 
 	vType *m_pData;
+	SharedResult *m_pShared;
 	vType *m_nMinData;
 	vType *m_nMaxData;
 	vType *m_nAbsMinData;
@@ -86,6 +86,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "progControl.qt.h"
+#include "FunctionsMap.h"
 
 #ifdef _WIN32
 #define DEBUGLIB "\\glsldebug.dll"
@@ -97,9 +98,20 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DBG_FUNCTIONS_PATH "/../lib/plugins"
 #endif /* _WIN32 */
 
+extern "C" GLFunctionList glFunctions[];
+
+/* interval in ms to check the debuggee's health while waiting for it */
+#define DOORBELL_POLL_TIMEOUT 100
+
+/* bound the frees piggybacked on a batch, so the actual commands still fit */
+#define MAX_BATCHED_FREES (4*DBG_BATCH_MAX_SLOTS)
+
 ProgramControl::ProgramControl(const char *pname) :
-		_debuggeePID(0)
+		_debuggeePID(0), _resultShmid(-1), _resultArena(NULL), _resultArenaSize(
+				0), _traceShmid(-1), _traceRing(NULL), _tracing(false),
+				_activeSlot(-1), _batchEnd(NULL), _numBatchedFrees(0)
 {
+	memset(_threadRecords, 0, sizeof(_threadRecords));
 	buildEnvVars(pname);
 	initShmem();
 #ifdef _WIN32
@@ -136,6 +148,15 @@ bool ProgramControl::childAlive(void)
 		dbgPrint(DBGLVL_WARNING, "no such debuggee!\n");
 		return false;
 	}
+	if (pid > 0 && SHM_CONTROL(_fcalls)->doorbell) {
+		/* nobody else will pick up this state change */
+		if (evaluateChildStatus(pid, status) != PCE_NONE) {
+			return false;
+		}
+		if (WIFSTOPPED(status)) {
+			ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
+		}
+	}
 	return true;
 #else /* !_WIN32 */
 	/* TODO: check this code!! */
@@ -170,13 +191,12 @@ bool ProgramControl::childAlive(void)
 #endif /* !_WIN32 */
 }
 
-pcErrorCode ProgramControl::checkChildStatus(void)
-{
 #ifndef _WIN32
+pcErrorCode ProgramControl::waitChildStatus(void)
+{
 	int status = 15;
 	pid_t pid = -1;
 	int errorStatus = EINTR;
-	ALIGNED_DATA newPid;
 
 	while (pid == -1 && errorStatus == EINTR) {
 		dbgPrint(DBGLVL_DEBUG, "checking debuggee status...\n");
@@ -216,6 +236,74 @@ pcErrorCode ProgramControl::checkChildStatus(void)
 		dbgPrint(DBGLVL_WARNING, "no such debuggee!\n");
 		return PCE_EXIT;
 	}
+	return evaluateChildStatus(pid, status);
+}
+
+/* Takes the stop of one thread that rang the doorbell. Several threads may
+ * have rung it for one wake-up; they are taken in turn, starting behind the
+ * last one.
+ */
+bool ProgramControl::claimStoppedThread(void)
+{
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	ALIGNED_DATA numSlots = control->numThreadSlots;
+	ALIGNED_DATA i, slot;
+
+	if (numSlots > SHM_MAX_THREAD_SLOTS) {
+		numSlots = SHM_MAX_THREAD_SLOTS;
+	}
+	for (i = 0; i < numSlots; i++) {
+		slot = (_activeSlot + 1 + i) % numSlots;
+		if (control->threadSlots[slot].stopped
+				&& casIntPtr(&control->threadSlots[slot].stopped, 1, 0)) {
+			_activeSlot = (int) slot;
+			return true;
+		}
+	}
+	return false;
+}
+
+pcErrorCode ProgramControl::waitForDoorbell(void)
+{
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	pcErrorCode error;
+	int status, result;
+	pid_t pid;
+
+	while (!claimStoppedThread()) {
+		result = waitShmEvent(&control->debuggerDoorbell,
+				DOORBELL_POLL_TIMEOUT);
+		if (result == 0) {
+			continue;
+		} else if (result != ETIMEDOUT) {
+			dbgPrint(DBGLVL_ERROR,
+					"Waiting for debuggee doorbell failed: %s\n", strerror(result));
+			return PCE_UNKNOWN_ERROR;
+		}
+
+		/* debuggee still busy, check that it did not die or crash */
+		pid = waitpid(_debuggeePID, &status, WUNTRACED | WNOHANG);
+		if (pid == 0) {
+			continue;
+		} else if (pid == -1) {
+			dbgPrint(DBGLVL_WARNING, "no such debuggee!\n");
+			return PCE_EXIT;
+		}
+		error = evaluateChildStatus(pid, status);
+		if (error != PCE_NONE) {
+			return error;
+		}
+		if (WIFSTOPPED(status)) {
+			/* trace event or stray stop, not a handshake */
+			ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
+		}
+	}
+	return PCE_NONE;
+}
+
+pcErrorCode ProgramControl::evaluateChildStatus(pid_t pid, int status)
+{
+	ALIGNED_DATA newPid;
 
 	/* handle extended wait status for trace events */
 	switch (status >> 16) {
@@ -325,6 +413,16 @@ pcErrorCode ProgramControl::checkChildStatus(void)
 		dbgPrint(DBGLVL_WARNING, "debuggee terminated with unknown reason\n");
 		return PCE_EXIT;
 	}
+}
+#endif /* !_WIN32 */
+
+pcErrorCode ProgramControl::checkChildStatus(void)
+{
+#ifndef _WIN32
+	if (SHM_CONTROL(_fcalls)->doorbell) {
+		return waitForDoorbell();
+	}
+	return waitChildStatus();
 #else /* !_WIN32 */
 	DWORD exitCode = STILL_ACTIVE;
 	pcErrorCode retval = PCE_NONE;
@@ -365,17 +463,27 @@ pcErrorCode ProgramControl::checkChildStatus(void)
 #endif /* !_WIN32 */
 }
 
-pcErrorCode ProgramControl::executeDbgCommand(void)
+void ProgramControl::resumeDebuggee(void)
 {
 #ifdef _WIN32
 	if (!::SetEvent(_hEvtDebuggee)) {
 		OutputDebugStringA("Set event failed\n");
 	}
 #else /* _WIN32 */
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
+	if (SHM_CONTROL(_fcalls)->doorbell) {
+		if (_activeSlot >= 0) {
+			setShmEvent(&SHM_CONTROL(_fcalls)->threadSlots[_activeSlot].continueDoorbell);
+		}
+	} else {
+		ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
+	}
 #endif /* _WIN32 */
-	return checkChildStatus();
+}
 
+pcErrorCode ProgramControl::executeDbgCommand(void)
+{
+	resumeDebuggee();
+	return checkChildStatus();
 }
 
 void ProgramControl::setDebugEnvVars(void)
@@ -554,28 +662,79 @@ void ProgramControl::buildEnvVars(const char *pname)
 #undef PATH_SEP
 }
 
+PID_T ProgramControl::activeThread(void)
+{
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	ALIGNED_DATA tid;
+
+	if (control->doorbell) {
+		tid = _activeSlot >= 0 ? control->threadSlots[_activeSlot].threadId : 0;
+	} else {
+		tid = control->activeThread;
+	}
+
+	/* nothing stopped yet, the main thread has the process id */
+	return tid ? (PID_T) tid : _debuggeePID;
+}
+
+DbgRec* ProgramControl::getThreadRecord(PID_T tid)
+{
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	ALIGNED_DATA numSlots = control->numThreadSlots;
+	ALIGNED_DATA slot;
+
+	if (numSlots > SHM_MAX_THREAD_SLOTS) {
+		numSlots = SHM_MAX_THREAD_SLOTS;
+	}
+	for (slot = 0; slot < numSlots; slot++) {
+		if ((PID_T) control->threadSlots[slot].threadId == tid) {
+			break;
+		}
+	}
+	if (slot == numSlots) {
+		/* not registered yet; the first thread gets the first slot */
+		return &_fcalls[0];
+	}
+	if (slot < SHM_MAX_THREADS) {
+		return &_fcalls[slot];
+	}
+
 #ifndef _WIN32
-DbgRec* ProgramControl::getThreadRecord(pid_t pid)
+	if (!_threadRecords[slot]) {
+		int shmid = (int) control->threadSlots[slot].shmid;
+		void *rec = shmat(shmid, NULL, 0);
+
+		if (rec == (void*) -1) {
+			dbgPrint(DBGLVL_ERROR,
+					"Attaching to thread record %i failed: %s\n", (int)slot, strerror(errno));
+			exit(1);
+		}
+		/* the debuggee keeps it attached, so remove it as soon as both
+		 * sides are attached
+		 */
+		shmctl(shmid, IPC_RMID, 0);
+		_threadRecords[slot] = (DbgRec*) rec;
+	}
+	return _threadRecords[slot];
 #else /* _WIN32 */
-DbgRec* ProgramControl::getThreadRecord(DWORD pid)
+	dbgPrint(DBGLVL_ERROR,
+			"Error: max. number of debuggable threads exceeded!\n");
+	exit(1);
 #endif /* _WIN32 */
+}
+
+void ProgramControl::unmapThreadRecords(void)
 {
-	int i;
-	for (i = 0; i < SHM_MAX_THREADS; i++) {
+	int slot;
+
+	for (slot = 0; slot < SHM_MAX_THREAD_SLOTS; slot++) {
 #ifndef _WIN32
-		if (_fcalls[i].threadId == 0 || (pid_t) _fcalls[i].threadId == pid) {
-#else /* _WIN32 */
-			if (_fcalls[i].threadId == 0 || (DWORD)_fcalls[i].threadId == pid) {
-#endif /* _WIN32 */
-			break;
+		if (_threadRecords[slot]) {
+			shmdt(_threadRecords[slot]);
 		}
+#endif /* _WIN32 */
+		_threadRecords[slot] = NULL;
 	}
-	if (i == SHM_MAX_THREADS) {
-		dbgPrint(DBGLVL_ERROR,
-				"Error: max. number of debuggable threads exceeded!\n");
-		exit(1);
-	}
-	return &_fcalls[i];
 }
 
 unsigned int ProgramControl::getArgumentSize(int type)
@@ -744,13 +903,14 @@ char* ProgramControl::printArgument(void *addr, int type)
 void ProgramControl::printCall()
 {
 	int i;
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	if (!rec) {
 		dbgPrint(DBGLVL_ERROR, "no rec\n");
 		exit(1);
 	}
 
-	dbgPrint(DBGLVL_INFO, "call: %s(", rec->fname);
+	const char *name = FunctionsMap::instance().name(rec->function);
+	dbgPrint(DBGLVL_INFO, "call: %s(", name ? name : "<unknown>");
 
 	for (i = 0; i < (int) rec->numItems; i++) {
 		dbgPrintNoPrefix(DBGLVL_INFO,
@@ -765,7 +925,7 @@ void ProgramControl::printCall()
 /* TODO: obsolete, only for debugging */
 void ProgramControl::printResult()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 
 	if (rec->result == DBG_ERROR_CODE) {
 		/* function without return value */
@@ -782,7 +942,7 @@ void ProgramControl::printResult()
 
 pcErrorCode ProgramControl::checkError()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	if (rec->result == DBG_ERROR_CODE) {
 		switch ((unsigned int) rec->items[0]) {
 		/* TODO: keep in sync with debuglib.h and errorCodes.h */
@@ -841,87 +1001,84 @@ pcErrorCode ProgramControl::checkError()
 
 pcErrorCode ProgramControl::dbgCommandStopExecution(void)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_STOP_EXECUTION\n");
 	rec->operation = DBG_STOP_EXECUTION;
 	return PCE_NONE;
 }
 
-pcErrorCode ProgramControl::dbgCommandExecute(bool stopOnGLError)
+pcErrorCode ProgramControl::dbgCommandExecute(bool stopOnGLError, bool trace)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_EXECUTE (DBG_EXECUTE_RUN)\n");
 	rec->operation = DBG_EXECUTE;
 	rec->items[0] = DBG_EXECUTE_RUN;
 	rec->items[1] = stopOnGLError ? 1 : 0;
+	rec->items[2] = trace ? 1 : 0;
 	pcErrorCode error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
-#ifdef _WIN32
-	::SetEvent(_hEvtDebuggee);
-#else /* _WIN32 */
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
-#endif /* _WIN32 */
+	beginTrace(rec);
+	resumeDebuggee();
 	return PCE_NONE;
 }
 
-pcErrorCode ProgramControl::dbgCommandExecuteToDrawCall(bool stopOnGLError)
+pcErrorCode ProgramControl::dbgCommandExecuteToDrawCall(bool stopOnGLError,
+		bool trace)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_EXECUTE (DBG_JUMP_TO_DRAW_CALL)\n");
 	rec->operation = DBG_EXECUTE;
 	rec->items[0] = DBG_JUMP_TO_DRAW_CALL;
 	rec->items[1] = stopOnGLError ? 1 : 0;
+	rec->items[2] = trace ? 1 : 0;
 	pcErrorCode error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
-#ifdef _WIN32
-	::SetEvent(_hEvtDebuggee);
-#else /* _WIN32 */
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
-#endif /* _WIN32 */
+	beginTrace(rec);
+	resumeDebuggee();
 	return PCE_NONE;
 }
 
-pcErrorCode ProgramControl::dbgCommandExecuteToShaderSwitch(bool stopOnGLError)
+pcErrorCode ProgramControl::dbgCommandExecuteToShaderSwitch(bool stopOnGLError,
+		bool trace)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_EXECUTE (DBG_JUMP_TO_SHADER_SWITCH)\n");
 	rec->operation = DBG_EXECUTE;
 	rec->items[0] = DBG_JUMP_TO_SHADER_SWITCH;
 	rec->items[1] = stopOnGLError ? 1 : 0;
+	rec->items[2] = trace ? 1 : 0;
 	pcErrorCode error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
-#ifdef _WIN32
-	::SetEvent(_hEvtDebuggee);
-#else /* _WIN32 */
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
-#endif /* _WIN32 */
+	beginTrace(rec);
+	resumeDebuggee();
 	return PCE_NONE;
 }
 
 pcErrorCode ProgramControl::dbgCommandExecuteToUserDefined(const char *fname,
-		bool stopOnGLError)
+		bool stopOnGLError, bool trace)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_EXECUTE (DBG_JUMP_TO_USER_DEFINED)\n");
 	rec->operation = DBG_EXECUTE;
 	rec->items[0] = DBG_JUMP_TO_USER_DEFINED;
 	rec->items[1] = stopOnGLError ? 1 : 0;
-	strncpy(rec->fname, fname, SHM_MAX_FUNCNAME);
+	rec->items[2] = trace ? 1 : 0;
+	rec->items[3] = FunctionsMap::instance().id(fname);
+	if (rec->items[3] < 0) {
+		dbgPrint(DBGLVL_WARNING, "unknown function %s\n", fname);
+	}
 	pcErrorCode error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
-#ifdef _WIN32
-	::SetEvent(_hEvtDebuggee);
-#else /* _WIN32 */
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
-#endif /* _WIN32 */
+	beginTrace(rec);
+	resumeDebuggee();
 	return PCE_NONE;
 }
 
@@ -929,7 +1086,7 @@ pcErrorCode ProgramControl::dbgCommandDone()
 {
 	pcErrorCode error;
 
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "send: DBG_DONE\n");
 	rec->operation = DBG_DONE;
 	error = executeDbgCommand();
@@ -941,7 +1098,7 @@ pcErrorCode ProgramControl::dbgCommandDone()
 
 pcErrorCode ProgramControl::dbgCommandCallOrig()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_CALL_ORIGFUNCTION\n");
@@ -959,9 +1116,10 @@ pcErrorCode ProgramControl::dbgCommandCallOrig()
 
 pcErrorCode ProgramControl::dbgCommandSetDbgTarget(int target,
 		int alphaTestOption, int depthTestOption, int stencilTestOption,
-		int blendingOption)
+		int blendingOption, int focusX, int focusY, int focusWidth,
+		int focusHeight)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_SET_DBG_TARGET\n");
@@ -971,6 +1129,10 @@ pcErrorCode ProgramControl::dbgCommandSetDbgTarget(int target,
 	rec->items[2] = depthTestOption;
 	rec->items[3] = stencilTestOption;
 	rec->items[4] = blendingOption;
+	rec->items[5] = focusX;
+	rec->items[6] = focusY;
+	rec->items[7] = focusWidth;
+	rec->items[8] = focusHeight;
 	error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
@@ -980,7 +1142,7 @@ pcErrorCode ProgramControl::dbgCommandSetDbgTarget(int target,
 
 pcErrorCode ProgramControl::dbgCommandRestoreRenderTarget(int target)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_RESTORE_RENDER_TARGET\n");
@@ -995,7 +1157,7 @@ pcErrorCode ProgramControl::dbgCommandRestoreRenderTarget(int target)
 
 pcErrorCode ProgramControl::dbgCommandSaveAndInterruptQueries(void)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_SAVE_AND_INTERRUPT_QUERIES\n");
@@ -1009,7 +1171,7 @@ pcErrorCode ProgramControl::dbgCommandSaveAndInterruptQueries(void)
 
 pcErrorCode ProgramControl::dbgCommandRestartQueries(void)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_RESTART_QUERIES\n");
@@ -1023,7 +1185,7 @@ pcErrorCode ProgramControl::dbgCommandRestartQueries(void)
 
 pcErrorCode ProgramControl::dbgCommandStartRecording()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_START_RECORDING\n");
@@ -1038,7 +1200,7 @@ pcErrorCode ProgramControl::dbgCommandStartRecording()
 
 pcErrorCode ProgramControl::dbgCommandReplay(int)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_REPLAY\n");
@@ -1052,7 +1214,7 @@ pcErrorCode ProgramControl::dbgCommandReplay(int)
 
 pcErrorCode ProgramControl::dbgCommandEndReplay()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_END_REPLAY\n");
@@ -1066,7 +1228,7 @@ pcErrorCode ProgramControl::dbgCommandEndReplay()
 
 pcErrorCode ProgramControl::dbgCommandRecord()
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_RECORD_CALL\n");
@@ -1084,7 +1246,7 @@ pcErrorCode ProgramControl::dbgCommandRecord()
 
 pcErrorCode ProgramControl::dbgCommandCallOrig(const FunctionCall *fCall)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 	int i;
 
@@ -1093,8 +1255,8 @@ pcErrorCode ProgramControl::dbgCommandCallOrig(const FunctionCall *fCall)
 		exit(1);
 	}
 
-	if (strcmp(rec->fname, fCall->getName()) != 0) {
-		dbgPrint(DBGLVL_ERROR, "function name does not match record\n");
+	if (rec->function != fCall->getFunction()) {
+		dbgPrint(DBGLVL_ERROR, "function does not match record\n");
 		exit(1);
 	}
 
@@ -1124,7 +1286,7 @@ pcErrorCode ProgramControl::dbgCommandCallOrig(const FunctionCall *fCall)
 
 pcErrorCode ProgramControl::overwriteFuncArguments(const FunctionCall *fCall)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	int i;
 
 	if (!rec) {
@@ -1132,8 +1294,8 @@ pcErrorCode ProgramControl::overwriteFuncArguments(const FunctionCall *fCall)
 		exit(1);
 	}
 
-	if (strcmp(rec->fname, fCall->getName()) != 0) {
-		dbgPrint(DBGLVL_ERROR, "function name does not match record\n");
+	if (rec->function != fCall->getFunction()) {
+		dbgPrint(DBGLVL_ERROR, "function does not match record\n");
 		exit(1);
 	}
 
@@ -1150,12 +1312,18 @@ pcErrorCode ProgramControl::overwriteFuncArguments(const FunctionCall *fCall)
 pcErrorCode ProgramControl::dbgCommandCallDBGFunction(
 		const char* dbgFunctionName)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
-	if (dbgFunctionName) {
-		strcpy(rec->fname, dbgFunctionName);
+	if (!dbgFunctionName) {
+		dbgFunctionName = FunctionsMap::instance().name(rec->function);
+		if (!dbgFunctionName) {
+			dbgPrint(DBGLVL_ERROR, "no function for call ID %i\n",
+					(int)rec->function);
+			return PCE_DBG_INVALID_VALUE;
+		}
 	}
+	strncpy(rec->fname, dbgFunctionName, SHM_MAX_FUNCNAME);
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_CALL_FUNCTION\n");
 	rec->operation = DBG_CALL_FUNCTION;
@@ -1171,7 +1339,7 @@ pcErrorCode ProgramControl::dbgCommandCallDBGFunction(
 pcErrorCode ProgramControl::dbgCommandFreeMem(unsigned int numBlocks,
 		void **addresses)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	unsigned int i;
 	pcErrorCode error;
 
@@ -1209,7 +1377,7 @@ pcErrorCode ProgramControl::dbgCommandFreeMem(unsigned int numBlocks,
 pcErrorCode ProgramControl::dbgCommandAllocMem(unsigned int numBlocks,
 		unsigned int *sizes, void **addresses)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	unsigned int i;
 	pcErrorCode error;
 
@@ -1245,7 +1413,7 @@ pcErrorCode ProgramControl::dbgCommandAllocMem(unsigned int numBlocks,
 pcErrorCode ProgramControl::dbgCommandClearRenderBuffer(int mode, float r,
 		float g, float b, float a, float f, int s)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_CLEAR_RENDER_BUFFER\n");
@@ -1267,7 +1435,7 @@ pcErrorCode ProgramControl::dbgCommandClearRenderBuffer(int mode, float r,
 pcErrorCode ProgramControl::dbgCommandReadRenderBuffer(int numComponents,
 		int *width, int *height, float **image)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_READ_RENDER_BUFFER\n");
@@ -1292,97 +1460,398 @@ pcErrorCode ProgramControl::dbgCommandReadRenderBuffer(int numComponents,
 	return error;
 }
 
-pcErrorCode ProgramControl::dbgCommandShaderStepFragment(void *shaders[3],
-		int numComponents, int format, int *width, int *height, void **image)
+pcErrorCode ProgramControl::fetchResult(ALIGNED_DATA *items, size_t size,
+		void **data, SharedResult **shared)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	ALIGNED_DATA generation = items[3];
+	SharedResult *result;
+	char *arena;
+	size_t offset;
+
+	if (shared) {
+		*shared = NULL;
+	}
+
+	if (!generation) {
+		/* result in debuggee heap, free'd with the next batch */
+		void *buffer = (void*) items[0];
+		*data = malloc(size);
+		cpyFromProcess(_debuggeePID, *data, buffer, size);
+		_pendingFrees.push_back(buffer);
+		return PCE_NONE;
+	}
+
+	arena = (char*) mapResultArena();
+	offset = (size_t) items[0];
+	if (!arena || offset + size > _resultArenaSize) {
+		dbgPrint(DBGLVL_ERROR,
+				"ProgramControl::fetchResult: result %li not accessible\n", (long)generation);
+		SHM_CONTROL(_fcalls)->resultReleased = generation;
+		return PCE_DBG_INVALID_VALUE;
+	}
+
+	result = new SharedResult(arena + offset, size, SHM_CONTROL(_fcalls),
+			generation);
+	if (shared) {
+		*data = result->getDataPointer();
+		*shared = result;
+	} else {
+		*data = malloc(size);
+		memcpy(*data, result->getDataPointer(), size);
+		result->unref();
+	}
+	return PCE_NONE;
+}
+
+pcErrorCode ProgramControl::flushPendingFrees(void)
+{
+	pcErrorCode error;
+
+	if (_pendingFrees.empty()) {
+		return PCE_NONE;
+	}
+	error = dbgCommandFreeMem(_pendingFrees.size(), &_pendingFrees[0]);
+	_pendingFrees.clear();
+	return error;
+}
+
+void ProgramControl::batchBegin(void)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	DbgBatchCmd *cmd;
+	ALIGNED_DATA *items;
+	unsigned int i, n;
+
+	rec->operation = DBG_BATCH;
+	rec->items[1] = 0;
+	_batchEnd = DBG_BATCH_FIRST(rec->items);
+
+	/* piggyback the release of results that have already been read */
+	_numBatchedFrees = 0;
+	while (_numBatchedFrees < _pendingFrees.size()
+			&& _numBatchedFrees < MAX_BATCHED_FREES) {
+		n = _pendingFrees.size() - _numBatchedFrees;
+		if (n > DBG_BATCH_MAX_SLOTS) {
+			n = DBG_BATCH_MAX_SLOTS;
+		}
+		if (!(cmd = batchAdd(DBG_FREE_MEM, n))) {
+			break;
+		}
+		items = DBG_BATCH_CMD_ITEMS(cmd);
+		for (i = 0; i < n; i++) {
+			items[i] = (ALIGNED_DATA) _pendingFrees[_numBatchedFrees + i];
+		}
+		_numBatchedFrees += n;
+	}
+}
+
+DbgBatchCmd* ProgramControl::batchAdd(int operation, int numSlots,
+		size_t dataSize)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	char *end = (char*) &rec->items[SHM_MAX_ITEMS];
+	DbgBatchCmd *cmd = _batchEnd;
+	char *data = (char*) (DBG_BATCH_CMD_ITEMS(cmd) + numSlots);
+
+	dataSize = DBG_BATCH_PAD(dataSize);
+	if (numSlots > DBG_BATCH_MAX_SLOTS || data > end
+			|| dataSize > (size_t) (end - data)) {
+		return NULL;
+	}
+	cmd->operation = operation;
+	cmd->result = DBG_ERROR_CODE;
+	cmd->numSlots = numSlots;
+	cmd->numItems = 0;
+	cmd->dataSize = dataSize;
+	cmd->relocate = 0;
+	memset(DBG_BATCH_CMD_ITEMS(cmd), 0, numSlots * sizeof(ALIGNED_DATA));
+	_batchEnd = DBG_BATCH_NEXT(cmd);
+	rec->items[1]++;
+	return cmd;
+}
+
+DbgBatchCmd* ProgramControl::batchAddSources(int operation, char *shaders[3],
+		int numSlots, size_t extraSize)
+{
+	DbgBatchCmd *cmd;
+	ALIGNED_DATA *items;
+	size_t size[3], dataSize = 0, offset = 0;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		size[i] = shaders[i] ? strlen(shaders[i]) + 1 : 0;
+		dataSize += size[i];
+	}
+	if (!(cmd = batchAdd(operation, numSlots,
+			DBG_BATCH_PAD(dataSize) + extraSize))) {
+		return NULL;
+	}
+	items = DBG_BATCH_CMD_ITEMS(cmd);
+	for (i = 0; i < 3; i++) {
+		if (shaders[i]) {
+			memcpy(DBG_BATCH_CMD_DATA(cmd) + offset, shaders[i], size[i]);
+			items[i] = (ALIGNED_DATA) offset;
+			cmd->relocate |= (ALIGNED_DATA) 1 << i;
+			offset += size[i];
+		}
+	}
+	return cmd;
+}
+
+pcErrorCode ProgramControl::batchExecute(void)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	unsigned int numFreeCmds = (_numBatchedFrees + DBG_BATCH_MAX_SLOTS - 1)
+			/ DBG_BATCH_MAX_SLOTS;
 	pcErrorCode error;
 
+	dbgPrint(DBGLVL_INFO, "send: DBG_BATCH (%i commands)\n", (int)rec->items[1]);
+	error = executeDbgCommand();
+	if (error != PCE_NONE) {
+		return error;
+	}
+	if (rec->items[2] >= (ALIGNED_DATA) numFreeCmds) {
+		_pendingFrees.erase(_pendingFrees.begin(),
+				_pendingFrees.begin() + _numBatchedFrees);
+	}
+	_numBatchedFrees = 0;
+	return checkError();
+}
+
+pcErrorCode ProgramControl::fragmentStepResult(ALIGNED_DATA result,
+		ALIGNED_DATA *items, int numComponents, int format, int *width,
+		int *height, int *placement, void **image, SharedResult **shared)
+{
+	size_t size;
+	int i;
+
+	if (result != DBG_READBACK_RESULT_FRAGMENT_DATA) {
+		return PCE_DBG_INVALID_VALUE;
+	}
+	*width = (int) items[1];
+	*height = (int) items[2];
+	if ((!items[0] && !items[3]) || *width <= 0 || *height <= 0) {
+		return PCE_DBG_INVALID_VALUE;
+	}
+	if (placement) {
+		for (i = 0; i < 4; i++) {
+			placement[i] = (int) items[4 + i];
+		}
+		if (placement[0] < 0 || placement[1] < 0
+				|| placement[0] + *width > placement[2]
+				|| placement[1] + *height > placement[3]) {
+			return PCE_DBG_INVALID_VALUE;
+		}
+	}
+	size = readBackSize(format, numComponents, *width, *height);
+	if (!size) {
+		return PCE_DBG_INVALID_VALUE;
+	}
+	return fetchResult(items, size, image, shared);
+}
+
+pcErrorCode ProgramControl::fragmentStatisticsResult(ALIGNED_DATA result,
+		ALIGNED_DATA *items, int *numCovered, int *numActive, int *numPixels)
+{
+	if (result != DBG_READBACK_RESULT_FRAGMENT_STATISTICS) {
+		return PCE_DBG_INVALID_VALUE;
+	}
+	*numCovered = (int) items[0];
+	*numActive = (int) items[1];
+	*numPixels = (int) items[2];
+	return PCE_NONE;
+}
+
+pcErrorCode ProgramControl::vertexStepResult(ALIGNED_DATA result,
+		ALIGNED_DATA *items, int numFloatsPerVertex, int format,
+		int *numPrimitives, int *numVertices, void **vertexData,
+		SharedResult **shared)
+{
+	if (result != DBG_READBACK_RESULT_VERTEX_DATA) {
+		return PCE_DBG_INVALID_VALUE;
+	}
+	*numVertices = (int) items[1];
+	*numPrimitives = (int) items[2];
+	return fetchResult(items,
+			readBackSize(format, 1, *numVertices * numFloatsPerVertex, 1),
+			vertexData, shared);
+}
+
+size_t ProgramControl::readBackSize(int format, int numComponents, int width,
+		int height)
+{
+	size_t values = (size_t) numComponents * width * height;
+
+	switch (format) {
+	case GL_FLOAT:
+		return values * sizeof(float);
+	case GL_INT:
+		return values * sizeof(int);
+	case GL_UNSIGNED_INT:
+		return values * sizeof(unsigned int);
+	case GL_UNSIGNED_BYTE:
+		return values;
+	case GL_HALF_FLOAT:
+		return values * sizeof(unsigned short);
+	case GL_BITMAP:
+		return (size_t) DBG_MASK_ROW_WORDS(width) * height
+				* sizeof(unsigned int);
+	default:
+		return 0;
+	}
+}
+
+pcErrorCode ProgramControl::putShaderSources(char *shaders[3])
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	ALIGNED_DATA *item = &rec->items[DBG_INLINE_SOURCES + 1];
+	size_t size[3], total = 0;
+	unsigned int sizes[3], numBlocks = 0;
+	void *addr[3];
+	P2PBlock blocks[3];
+	pcErrorCode error;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		size[i] = shaders[i] ? strlen(shaders[i]) + 1 : 0;
+		total += sizeof(ALIGNED_DATA) + DBG_INLINE_PAD(size[i]);
+	}
+
+	if (total <= (size_t) ((char*) &rec->items[SHM_MAX_ITEMS] - (char*) item)) {
+		for (i = 0; i < 3; i++) {
+			rec->items[i] = 0;
+			*item++ = (ALIGNED_DATA) size[i];
+			memcpy(item, shaders[i], size[i]);
+			item += DBG_INLINE_PAD(size[i]) / sizeof(ALIGNED_DATA);
+		}
+		rec->items[DBG_INLINE_SOURCES] = 1;
+		return PCE_NONE;
+	}
+
+	/* overflow: allocate client side memory in one go and copy shader src */
+	for (i = 0; i < 3; i++) {
+		if (shaders[i]) {
+			sizes[numBlocks++] = size[i];
+		}
+	}
+	error = dbgCommandAllocMem(numBlocks, sizes, addr);
+	if (error != PCE_NONE) {
+		return error;
+	}
+	for (i = 0, numBlocks = 0; i < 3; i++) {
+		if (shaders[i]) {
+			blocks[numBlocks].local = shaders[i];
+			blocks[numBlocks].remote = addr[numBlocks];
+			blocks[numBlocks].size = size[i];
+			rec->items[i] = (ALIGNED_DATA) addr[numBlocks];
+			_pendingFrees.push_back(addr[numBlocks]);
+			numBlocks++;
+		} else {
+			rec->items[i] = 0;
+		}
+	}
+	cpyToProcessV(_debuggeePID, blocks, numBlocks);
+	rec->items[DBG_INLINE_SOURCES] = 0;
+	return PCE_NONE;
+}
+
+pcErrorCode ProgramControl::dbgCommandShaderStepFragment(char *shaders[3],
+		int numComponents, int format, int *width, int *height, void **image,
+		SharedResult **shared, int *placement)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	pcErrorCode error;
+
+	error = putShaderSources(shaders);
+	if (error != PCE_NONE) {
+		return error;
+	}
 	dbgPrint(DBGLVL_INFO, "send: DBG_SHADER_STEP\n");
 	rec->operation = DBG_SHADER_STEP;
-	rec->items[0] = (ALIGNED_DATA) shaders[0];
-	rec->items[1] = (ALIGNED_DATA) shaders[1];
-	rec->items[2] = (ALIGNED_DATA) shaders[2];
 	rec->items[3] = (ALIGNED_DATA) DBG_TARGET_FRAGMENT_SHADER;
 	rec->items[4] = (ALIGNED_DATA) numComponents;
 	rec->items[5] = (ALIGNED_DATA) format;
+	rec->items[6] = 0;
 	error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
 	error = checkError();
 	if (error == PCE_NONE) {
-		if (rec->result == DBG_READBACK_RESULT_FRAGMENT_DATA) {
-			void *buffer = (void*) rec->items[0];
-			*width = (int) rec->items[1];
-			*height = (int) rec->items[2];
-			if (!buffer || *width <= 0 || *height <= 0) {
-				error = PCE_DBG_INVALID_VALUE;
-			} else {
-				int formatSize;
-				switch (format) {
-				case GL_FLOAT:
-					formatSize = sizeof(float);
-					break;
-				case GL_INT:
-					formatSize = sizeof(int);
-					break;
-				case GL_UNSIGNED_INT:
-					formatSize = sizeof(unsigned int);
-					break;
-				default:
-					return PCE_DBG_INVALID_VALUE;
-				}
+		error = fragmentStepResult(rec->result, rec->items, numComponents,
+				format, width, height, placement, image, shared);
+	}
+	return error;
+}
 
-				*image = malloc(
-						numComponents * (*width) * (*height) * formatSize);
+pcErrorCode ProgramControl::dbgCommandShaderStepFragmentStatistics(
+		char *shaders[3], const unsigned int *limit, size_t limitSize,
+		int *numCovered, int *numActive, int *numPixels)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	unsigned int size = (unsigned int) limitSize;
+	void *addr = NULL;
+	pcErrorCode error;
 
-				cpyFromProcess(_debuggeePID, *image, buffer,
-						numComponents * (*width) * (*height) * formatSize);
-				error = dbgCommandFreeMem(1, &buffer);
-			}
-		} else {
-			error = PCE_DBG_INVALID_VALUE;
+	/* before the sources, they may be inline in the record */
+	if (limit) {
+		error = dbgCommandAllocMem(1, &size, &addr);
+		if (error != PCE_NONE) {
+			return error;
 		}
+		cpyToProcess(_debuggeePID, addr, (void*) limit, limitSize);
+		_pendingFrees.push_back(addr);
+	}
+	error = putShaderSources(shaders);
+	if (error != PCE_NONE) {
+		return error;
+	}
+	dbgPrint(DBGLVL_INFO, "send: DBG_SHADER_STEP (statistics)\n");
+	rec->operation = DBG_SHADER_STEP;
+	rec->items[3] = (ALIGNED_DATA) DBG_TARGET_FRAGMENT_SHADER;
+	rec->items[4] = (ALIGNED_DATA) 1;
+	rec->items[5] = (ALIGNED_DATA) GL_FLOAT;
+	rec->items[6] = (ALIGNED_DATA) 1;
+	rec->items[7] = (ALIGNED_DATA) addr;
+	error = executeDbgCommand();
+	if (error != PCE_NONE) {
+		return error;
+	}
+	error = checkError();
+	if (error == PCE_NONE) {
+		error = fragmentStatisticsResult(rec->result, rec->items, numCovered,
+				numActive, numPixels);
 	}
 	return error;
 }
 
-pcErrorCode ProgramControl::dbgCommandShaderStepVertex(void *shaders[3],
+pcErrorCode ProgramControl::dbgCommandShaderStepVertex(char *shaders[3],
 		int target, int primitiveMode, int forcePointPrimitiveMode,
-		int numFloatsPerVertex, int *numPrimitives, int *numVertices,
-		float **vertexData)
+		int numFloatsPerVertex, int format, int *numPrimitives,
+		int *numVertices, void **vertexData, SharedResult **shared)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
+	error = putShaderSources(shaders);
+	if (error != PCE_NONE) {
+		return error;
+	}
 	dbgPrint(DBGLVL_INFO, "send: DBG_SHADER_STEP\n");
 	rec->operation = DBG_SHADER_STEP;
-	rec->items[0] = (ALIGNED_DATA) shaders[0];
-	rec->items[1] = (ALIGNED_DATA) shaders[1];
-	rec->items[2] = (ALIGNED_DATA) shaders[2];
 	rec->items[3] = (ALIGNED_DATA) target;
 	rec->items[4] = (ALIGNED_DATA) primitiveMode;
 	rec->items[5] = (ALIGNED_DATA) forcePointPrimitiveMode;
 	rec->items[6] = (ALIGNED_DATA) numFloatsPerVertex;
+	rec->items[7] = (ALIGNED_DATA) format;
 	error = executeDbgCommand();
 	if (error != PCE_NONE) {
 		return error;
 	}
 	error = checkError();
 	if (error == PCE_NONE) {
-		if (rec->result == DBG_READBACK_RESULT_VERTEX_DATA) {
-			void *buffer = (void*) rec->items[0];
-			*numVertices = (int) rec->items[1];
-			*numPrimitives = (int) rec->items[2];
-			*vertexData = (float*) malloc(
-					*numVertices * numFloatsPerVertex * sizeof(float));
-			cpyFromProcess(_debuggeePID, *vertexData, buffer,
-					*numVertices * numFloatsPerVertex * sizeof(float));
-			error = dbgCommandFreeMem(1, &buffer);
-		} else {
-			error = PCE_DBG_INVALID_VALUE;
-		}
+		error = vertexStepResult(rec->result, rec->items, numFloatsPerVertex,
+				format, numPrimitives, numVertices, vertexData, shared);
 	}
 	return error;
 }
@@ -1393,7 +1862,11 @@ pcErrorCode ProgramControl::runProgram(char **debuggedProgramArgs, char *workDir
 {
 	pcErrorCode error;
 
+	/* also resets the continue doorbells of the thread slots */
 	clearShmem();
+	initShmEvent(&SHM_CONTROL(_fcalls)->debuggerDoorbell, 0);
+	SHM_CONTROL(_fcalls)->doorbell = 1;
+	_activeSlot = -1;
 
 	_debuggeePID = vfork();
 
@@ -1440,14 +1913,18 @@ pcErrorCode ProgramControl::runProgram(char **debuggedProgramArgs, char *workDir
 			);
 
 	dbgPrint(DBGLVL_INFO, "waiting for debuggee to respond...\n");
-	error = checkChildStatus();
+	error = waitChildStatus();
 	if (error != PCE_NONE) {
 		kill(_debuggeePID, SIGKILL);
 		_debuggeePID = 0;
 		return error;
 	}
+	/* leave the exec stop, from now on the debuggee stops itself */
 	dbgPrint(DBGLVL_INFO, "sending continue\n");
-	error = executeDbgCommand();
+	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
+	/* the handshake does not ptrace-stop it, a ptrace copy has to */
+	setP2PTraceeRunning(SHM_CONTROL(_fcalls)->doorbell);
+	error = checkChildStatus();
 	if (error != PCE_NONE) {
 		kill(_debuggeePID, SIGKILL);
 		_debuggeePID = 0;
@@ -1472,14 +1949,14 @@ FunctionCall* ProgramControl::getCurrentCall(void)
 {
 	FunctionCall *fCall = new FunctionCall();
 	int i;
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 
 	if (!rec) {
 		dbgPrint(DBGLVL_ERROR, "no rec\n");
 		exit(1);
 	}
 
-	fCall->setName(rec->fname);
+	fCall->setFunction(rec->function);
 
 	for (i = 0; i < (int) rec->numItems; i++) {
 		fCall->addArgument(rec->items[2 * i + 1],
@@ -1493,10 +1970,13 @@ FunctionCall* ProgramControl::getCurrentCall(void)
 pcErrorCode ProgramControl::getShaderCode(char *shaders[3],
 		TBuiltInResource *resource, char **serializedUniforms, int *numUniforms)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgBatchCmd *cmd;
+	ALIGNED_DATA *items;
 	int i;
 	pcErrorCode error;
 	void *addr[5];
+	P2PBlock blocks[5];
+	int numBlocks = 0;
 
 #ifdef _WIN32
 	::SwitchToThread();
@@ -1505,59 +1985,63 @@ pcErrorCode ProgramControl::getShaderCode(char *shaders[3],
 #endif /* _WIN32 */
 
 	dbgPrint(DBGLVL_INFO, "send: DBG_GET_SHADER_CODE\n");
-	rec->operation = DBG_GET_SHADER_CODE;
-	error = executeDbgCommand();
-	if (error != PCE_NONE) {
-		return error;
+	batchBegin();
+	if (!(cmd = batchAdd(DBG_GET_SHADER_CODE, 10))) {
+		dbgPrint(DBGLVL_ERROR, "getShaderCode: batch too small\n");
+		return PCE_UNKNOWN_ERROR;
 	}
-	error = checkError();
+	error = batchExecute();
 	if (error != PCE_NONE) {
 		return error;
 	}
+	items = DBG_BATCH_CMD_ITEMS(cmd);
 
 	for (i = 0; i < 3; i++) {
 		shaders[i] = NULL;
 	}
 
-	if (rec->result != DBG_SHADER_CODE) {
-		return checkError();
+	if (cmd->result != DBG_SHADER_CODE) {
+		return PCE_DBG_INVALID_VALUE;
 	}
 
-	if (rec->numItems > 0) {
+	if (cmd->numItems > 0) {
 
-		addr[0] = (void*) rec->items[0];
-		addr[1] = (void*) rec->items[2];
-		addr[2] = (void*) rec->items[4];
-		addr[3] = (void*) rec->items[6];
-		addr[4] = (void*) rec->items[9];
+		addr[0] = (void*) items[0];
+		addr[1] = (void*) items[2];
+		addr[2] = (void*) items[4];
+		addr[3] = (void*) items[6];
+		addr[4] = (void*) items[9];
 
 		/* copy shader sources */
 		for (i = 0; i < 3; i++) {
-			if (rec->items[2 * i] == 0) {
+			if (items[2 * i] == 0) {
 				continue;
 			}
-			if (!(shaders[i] = new char[rec->items[2 * i + 1] + 1])) {
+			if (!(shaders[i] = new char[items[2 * i + 1] + 1])) {
 				dbgPrint(DBGLVL_ERROR, "not enough memory\n");
 				for (--i; i >= 0; i--) {
 					delete[] shaders[i];
 					shaders[i] = NULL;
 				}
-				/* TODO: what about memory on client side? */
-				error = dbgCommandFreeMem(5, addr);
+				_pendingFrees.insert(_pendingFrees.end(), addr, addr + 5);
 				return PCE_MEMORY_ALLOCATION_FAILED;
 			}
-			cpyFromProcess(_debuggeePID, shaders[i], addr[i],
-					rec->items[2 * i + 1]);
-			shaders[i][rec->items[2 * i + 1]] = '\0';
+			blocks[numBlocks].local = shaders[i];
+			blocks[numBlocks].remote = addr[i];
+			blocks[numBlocks].size = items[2 * i + 1];
+			numBlocks++;
+			shaders[i][items[2 * i + 1]] = '\0';
 		}
 
 		/* copy shader resource info */
-		cpyFromProcess(_debuggeePID, resource, addr[3],
-				sizeof(TBuiltInResource));
-
-		if (rec->items[7] > 0) {
-			*numUniforms = rec->items[7];
-			if (!(*serializedUniforms = new char[rec->items[8]])) {
+		blocks[numBlocks].local = resource;
+		blocks[numBlocks].remote = addr[3];
+		blocks[numBlocks].size = sizeof(TBuiltInResource);
+		numBlocks++;
+
+		if (items[7] > 0) {
+			*numUniforms = items[7];
+			if (!(*serializedUniforms = new char[items[8]])) {
 				dbgPrint(DBGLVL_ERROR, "not enough memory\n");
 				for (i = 0; i < 3; ++i) {
 					delete[] shaders[i];
@@ -1565,30 +2049,25 @@ pcErrorCode ProgramControl::getShaderCode(char *shaders[3],
 					*serializedUniforms = NULL;
 					*numUniforms = 0;
 				}
-				/* TODO: what about memory on client side? */
-				error = dbgCommandFreeMem(5, addr);
+				_pendingFrees.insert(_pendingFrees.end(), addr, addr + 5);
 				return PCE_MEMORY_ALLOCATION_FAILED;
 			}
-			cpyFromProcess(_debuggeePID, *serializedUniforms, addr[4],
-					rec->items[8]);
+			blocks[numBlocks].local = *serializedUniforms;
+			blocks[numBlocks].remote = addr[4];
+			blocks[numBlocks].size = items[8];
+			numBlocks++;
 		} else {
 			*serializedUniforms = NULL;
 			*numUniforms = 0;
 		}
 
-		/* free memory on client side */
+		/* fetch everything in one go */
+		cpyFromProcessV(_debuggeePID, blocks, numBlocks);
+
+		/* free memory on client side with the next batch */
 		dbgPrint(DBGLVL_INFO,
 				"getShaderCode: free memory on client side [%p, %p, %p, %p, %p]\n", addr[0], addr[1], addr[2], addr[3], addr[4]);
-		error = dbgCommandFreeMem(5, addr);
-		if (error != PCE_NONE) {
-			dbgPrint(DBGLVL_WARNING,
-					"getShaderCode: free memory on client side error: %i\n", error);
-			for (i = 0; i < 3; i++) {
-				delete[] shaders[i];
-				shaders[i] = NULL;
-			}
-			return error;
-		}
+		_pendingFrees.insert(_pendingFrees.end(), addr, addr + 5);
 	}
 	dbgPrint(DBGLVL_INFO, ">>>>>>>>> Orig. Vertex Shader <<<<<<<<<<<\n%s\n"
 	">>>>>>>>>>>>>>>>>>>>>><<<<<<<<<<<<<<<<<<<\n", shaders[0]);
@@ -1601,7 +2080,7 @@ pcErrorCode ProgramControl::getShaderCode(char *shaders[3],
 
 pcErrorCode ProgramControl::saveActiveShader(void)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 #ifdef _WIN32
@@ -1621,7 +2100,7 @@ pcErrorCode ProgramControl::saveActiveShader(void)
 
 pcErrorCode ProgramControl::restoreActiveShader(void)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	pcErrorCode error;
 
 #ifdef _WIN32
@@ -1639,12 +2118,35 @@ pcErrorCode ProgramControl::restoreActiveShader(void)
 	return checkError();
 }
 
-pcErrorCode ProgramControl::setDbgShaderCode(char *shaders[3], int target)
+pcErrorCode ProgramControl::getDbgShaderCacheStats(int *hits, int *misses,
+		int *numPrograms, bool reset)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
-	int i;
+	DbgRec *rec = getThreadRecord(activeThread());
+	pcErrorCode error;
+
+	dbgPrint(DBGLVL_INFO, "send: DBG_GET_DBG_SHADER_CACHE_STATS\n");
+	rec->operation = DBG_GET_DBG_SHADER_CACHE_STATS;
+	rec->items[0] = reset ? 1 : 0;
+	error = executeDbgCommand();
+	if (error != PCE_NONE) {
+		return error;
+	}
+	error = checkError();
+	if (error != PCE_NONE) {
+		return error;
+	}
+	*hits = (int) rec->items[1];
+	*misses = (int) rec->items[2];
+	*numPrograms = (int) rec->items[3];
+	return PCE_NONE;
+}
+
+pcErrorCode ProgramControl::setDbgShaderCode(char *shaders[3], int target,
+		int forcePointPrimitiveMode)
+{
+	DbgRec *rec = getThreadRecord(activeThread());
+	DbgBatchCmd *cmd;
 	pcErrorCode error;
-	void *addr[3];
 
 #ifdef _WIN32
 	::SwitchToThread();
@@ -1655,49 +2157,28 @@ pcErrorCode ProgramControl::setDbgShaderCode(char *shaders[3], int target)
 	dbgPrint(DBGLVL_INFO,
 			"setting SH code: %p, %p, %p, %i\n", shaders[0], shaders[1], shaders[2], target);
 
-	/* allocate client side memory and copy shader src */
-	for (i = 0; i < 3; i++) {
-		if (shaders[i]) {
-			unsigned int size = strlen(shaders[i]) + 1;
-			dbgPrint(DBGLVL_ERROR,
-					"allocating memory for shader[%i]: %ibyte\n", i, size);
-			error = dbgCommandAllocMem(1, &size, &addr[i]);
-			if (error != PCE_NONE) {
-				dbgCommandFreeMem(i, addr);
-				return error;
-			}
-			cpyToProcess(_debuggeePID, addr[i], shaders[i], size);
-		} else {
-			addr[i] = NULL;
-		}
+	batchBegin();
+	if ((cmd = batchAddSources(DBG_SET_DBG_SHADER, shaders, 5))) {
+		DBG_BATCH_CMD_ITEMS(cmd)[3] = target;
+		DBG_BATCH_CMD_ITEMS(cmd)[4] = forcePointPrimitiveMode;
+		dbgPrint(DBGLVL_INFO, "send: DBG_SET_DBG_SHADER\n");
+		return batchExecute();
 	}
-	dbgPrint(DBGLVL_INFO, "send: DBG_SET_DBG_SHADER\n");
-	for (i = 0; i < 3; i++) {
-		rec->items[i] = (ALIGNED_DATA) addr[i];
+
+	/* sources too large for a batch, use the whole record */
+	error = putShaderSources(shaders);
+	if (error != PCE_NONE) {
+		return error;
 	}
+	dbgPrint(DBGLVL_INFO, "send: DBG_SET_DBG_SHADER\n");
 	rec->operation = DBG_SET_DBG_SHADER;
 	rec->items[3] = target;
+	rec->items[4] = forcePointPrimitiveMode;
 	error = executeDbgCommand();
 	if (error != PCE_NONE) {
-		dbgCommandFreeMem(3, addr);
 		return error;
 	}
-	error = checkError();
-	if (error != PCE_NONE) {
-		dbgCommandFreeMem(3, addr);
-		return error;
-	}
-
-	/* free memory on client side */
-	dbgPrint(DBGLVL_INFO,
-			"setShaderCode: free memory on client side [%p, %p, %p]\n", addr[0], addr[1], addr[2]);
-	error = dbgCommandFreeMem(3, addr);
-	if (error != PCE_NONE) {
-		dbgPrint(DBGLVL_ERROR,
-				"getShaderCode: free memory on client side error: %i\n", error);
-		return error;
-	}
-	return PCE_NONE;
+	return checkError();
 }
 
 pcErrorCode ProgramControl::initializeRenderBuffer(bool copyRGB, bool copyAlpha,
@@ -1778,7 +2259,8 @@ pcErrorCode ProgramControl::restoreRenderTarget(int target)
 }
 
 pcErrorCode ProgramControl::setDbgTarget(int target, int alphaTestOption,
-		int depthTestOption, int stencilTestOption, int blendingOption)
+		int depthTestOption, int stencilTestOption, int blendingOption,
+		int focusX, int focusY, int focusWidth, int focusHeight)
 {
 #ifdef _WIN32
 	::SwitchToThread();
@@ -1787,7 +2269,8 @@ pcErrorCode ProgramControl::setDbgTarget(int target, int alphaTestOption,
 #endif /* _WIN32 */
 
 	return dbgCommandSetDbgTarget(target, alphaTestOption, depthTestOption,
-			stencilTestOption, blendingOption);
+			stencilTestOption, blendingOption, focusX, focusY, focusWidth,
+			focusHeight);
 }
 
 pcErrorCode ProgramControl::saveAndInterruptQueries(void)
@@ -1857,10 +2340,89 @@ pcErrorCode ProgramControl::endReplay()
 }
 
 pcErrorCode ProgramControl::shaderStepFragment(char *shaders[3],
-		int numComponents, int format, int *width, int *heigh, void **image)
+		int numComponents, int format, int *width, int *heigh, void **image,
+		SharedResult **shared, int *placement)
 {
 	pcErrorCode error;
-	void *addr[3];
+	DbgBatchCmd *step;
+	ALIGNED_DATA *items;
+
+#ifdef _WIN32
+	::SwitchToThread();
+#else /* _WIN32 */
+	sched_yield();
+#endif /* _WIN32 */
+
+	batchBegin();
+	/* 8 slots for the placement of the result */
+	if ((step = batchAddSources(DBG_SHADER_STEP, shaders, 8))) {
+		items = DBG_BATCH_CMD_ITEMS(step);
+		items[3] = (ALIGNED_DATA) DBG_TARGET_FRAGMENT_SHADER;
+		items[4] = (ALIGNED_DATA) numComponents;
+		items[5] = (ALIGNED_DATA) format;
+		error = batchExecute();
+		if (error != PCE_NONE) {
+			return error;
+		}
+		return fragmentStepResult(step->result, items, numComponents, format,
+				width, heigh, placement, image, shared);
+	}
+
+	/* sources too large for a batch, use the whole record */
+	return dbgCommandShaderStepFragment(shaders, numComponents, format, width,
+			heigh, image, shared, placement);
+}
+
+pcErrorCode ProgramControl::shaderStepFragmentStatistics(char *shaders[3],
+		const unsigned int *limit, size_t limitSize, int *numCovered,
+		int *numActive, int *numPixels)
+{
+	pcErrorCode error;
+	DbgBatchCmd *step;
+	ALIGNED_DATA *items;
+
+#ifdef _WIN32
+	::SwitchToThread();
+#else /* _WIN32 */
+	sched_yield();
+#endif /* _WIN32 */
+
+	batchBegin();
+	if ((step = batchAddSources(DBG_SHADER_STEP, shaders, 8,
+			limit ? limitSize : 0))) {
+		items = DBG_BATCH_CMD_ITEMS(step);
+		items[3] = (ALIGNED_DATA) DBG_TARGET_FRAGMENT_SHADER;
+		items[4] = (ALIGNED_DATA) 1;
+		items[5] = (ALIGNED_DATA) GL_FLOAT;
+		items[6] = (ALIGNED_DATA) 1;
+		if (limit) {
+			items[7] = (ALIGNED_DATA) (step->dataSize
+					- DBG_BATCH_PAD(limitSize));
+			memcpy(DBG_BATCH_CMD_DATA(step) + items[7], limit, limitSize);
+			step->relocate |= (ALIGNED_DATA) 1 << 7;
+		}
+		error = batchExecute();
+		if (error != PCE_NONE) {
+			return error;
+		}
+		return fragmentStatisticsResult(step->result, items, numCovered,
+				numActive, numPixels);
+	}
+
+	/* sources too large for a batch, use the whole record */
+	return dbgCommandShaderStepFragmentStatistics(shaders, limit, limitSize,
+			numCovered, numActive, numPixels);
+}
+
+pcErrorCode ProgramControl::shaderStepFragments(FragmentPass *passes,
+		int numPasses, bool copyAlpha, bool copyDepth, bool copyStencil,
+		float alpha, float depth, int stencil)
+{
+	std::vector<DbgBatchCmd*> steps;
+	DbgBatchCmd *clear, *step;
+	ALIGNED_DATA *items;
+	int mode = DBG_CLEAR_RGB;
+	pcErrorCode error;
 	int i;
 
 #ifdef _WIN32
@@ -1869,44 +2431,74 @@ pcErrorCode ProgramControl::shaderStepFragment(char *shaders[3],
 	sched_yield();
 #endif /* _WIN32 */
 
-	/* allocate client side memory and copy shader src */
-	for (i = 0; i < 3; i++) {
-		if (shaders[i]) {
-			unsigned int size = strlen(shaders[i]) + 1;
-			error = dbgCommandAllocMem(1, &size, &addr[i]);
-			if (error != PCE_NONE) {
-				dbgCommandFreeMem(i, addr);
-				return error;
-			}
-			cpyToProcess(_debuggeePID, addr[i], shaders[i], size);
-		} else {
-			addr[i] = NULL;
+	if (!copyAlpha) {
+		mode |= DBG_CLEAR_ALPHA;
+	}
+	if (!copyDepth) {
+		mode |= DBG_CLEAR_DEPTH;
+	}
+	if (!copyStencil) {
+		mode |= DBG_CLEAR_STENCIL;
+	}
+
+	for (i = 0; i < numPasses; i++) {
+		passes[i].error = PCE_DBG_INVALID_VALUE;
+		passes[i].image = NULL;
+		passes[i].shared = NULL;
+	}
+
+	batchBegin();
+	for (i = 0; i < numPasses; i++) {
+		/* a clear left over at the end of a full batch does no harm */
+		if (!(clear = batchAdd(DBG_CLEAR_RENDER_BUFFER, 7))) {
+			break;
+		}
+		items = DBG_BATCH_CMD_ITEMS(clear);
+		items[0] = (ALIGNED_DATA) mode;
+		*(float*) (void*) &items[4] = alpha;
+		*(float*) (void*) &items[5] = depth;
+		items[6] = (ALIGNED_DATA) stencil;
+
+		if (!(step = batchAddSources(DBG_SHADER_STEP, passes[i].shaders, 8))) {
+			break;
 		}
+		items = DBG_BATCH_CMD_ITEMS(step);
+		items[3] = (ALIGNED_DATA) DBG_TARGET_FRAGMENT_SHADER;
+		items[4] = (ALIGNED_DATA) passes[i].numComponents;
+		items[5] = (ALIGNED_DATA) passes[i].format;
+		steps.push_back(step);
+	}
+	if (steps.empty()) {
+		return PCE_DBG_INVALID_VALUE;
 	}
 
-	error = dbgCommandShaderStepFragment(addr, numComponents, format, width,
-			heigh, image);
-	if (error) {
-		dbgCommandFreeMem(3, addr);
+	error = batchExecute();
+	if (isErrorCritical(error)) {
 		return error;
 	}
 
-	/* free memory on client side */
-	error = dbgCommandFreeMem(3, addr);
-	if (error) {
-		dbgPrint(DBGLVL_ERROR,
-				"getShaderCode: free memory on client side error: %i\n", error);
+	/* steps before a failed one still have their results */
+	for (i = 0; i < (int) steps.size(); i++) {
+		step = steps[i];
+		if (step->result == DBG_READBACK_RESULT_FRAGMENT_DATA) {
+			passes[i].error = fragmentStepResult(step->result,
+					DBG_BATCH_CMD_ITEMS(step), passes[i].numComponents,
+					passes[i].format, &passes[i].width, &passes[i].height,
+					passes[i].placement, &passes[i].image, &passes[i].shared);
+		}
 	}
 	return error;
 }
 
 pcErrorCode ProgramControl::shaderStepVertex(char *shaders[3], int target,
 		int primitiveMode, int forcePointPrimitiveMode, int numFloatsPerVertex,
-		int *numPrimitives, int *numVertices, float **vertexData)
+		int format, int *numPrimitives, int *numVertices, void **vertexData,
+		SharedResult **shared)
 {
 	pcErrorCode error;
-	void *addr[3];
-	int i, basePrimitiveMode;
+	DbgBatchCmd *step;
+	ALIGNED_DATA *items;
+	int basePrimitiveMode;
 
 #ifdef _WIN32
 	::SwitchToThread();
@@ -1914,21 +2506,6 @@ pcErrorCode ProgramControl::shaderStepVertex(char *shaders[3], int target,
 	sched_yield();
 #endif /* _WIN32 */
 
-	/* allocate client side memory and copy shader src */
-	for (i = 0; i < 3; i++) {
-		if (shaders[i]) {
-			unsigned int size = strlen(shaders[i]) + 1;
-			error = dbgCommandAllocMem(1, &size, &addr[i]);
-			if (error != PCE_NONE) {
-				dbgCommandFreeMem(i, addr);
-				return error;
-			}
-			cpyToProcess(_debuggeePID, addr[i], shaders[i], size);
-		} else {
-			addr[i] = NULL;
-		}
-	}
-
 	switch (primitiveMode) {
 	case GL_POINTS:
 		basePrimitiveMode = GL_POINTS;
@@ -1957,21 +2534,26 @@ pcErrorCode ProgramControl::shaderStepVertex(char *shaders[3], int target,
 		return PCE_DBG_INVALID_VALUE;
 	}
 
-	error = dbgCommandShaderStepVertex(addr, target, basePrimitiveMode,
-			forcePointPrimitiveMode, numFloatsPerVertex, numPrimitives,
-			numVertices, vertexData);
-	if (error) {
-		dbgCommandFreeMem(3, addr);
-		return error;
+	batchBegin();
+	if ((step = batchAddSources(DBG_SHADER_STEP, shaders, 8))) {
+		items = DBG_BATCH_CMD_ITEMS(step);
+		items[3] = (ALIGNED_DATA) target;
+		items[4] = (ALIGNED_DATA) basePrimitiveMode;
+		items[5] = (ALIGNED_DATA) forcePointPrimitiveMode;
+		items[6] = (ALIGNED_DATA) numFloatsPerVertex;
+		items[7] = (ALIGNED_DATA) format;
+		error = batchExecute();
+		if (error != PCE_NONE) {
+			return error;
+		}
+		return vertexStepResult(step->result, items, numFloatsPerVertex,
+				format, numPrimitives, numVertices, vertexData, shared);
 	}
 
-	/* free memory on client side */
-	error = dbgCommandFreeMem(3, addr);
-	if (error) {
-		dbgPrint(DBGLVL_WARNING,
-				"getShaderCode: free memory on client side error: %i\n", error);
-	}
-	return error;
+	/* sources too large for a batch, use the whole record */
+	return dbgCommandShaderStepVertex(shaders, target, basePrimitiveMode,
+			forcePointPrimitiveMode, numFloatsPerVertex, format, numPrimitives,
+			numVertices, vertexData, shared);
 }
 
 pcErrorCode ProgramControl::callDone(void)
@@ -1984,6 +2566,10 @@ pcErrorCode ProgramControl::callDone(void)
 	sched_yield();
 #endif /* _WIN32 */
 
+	error = flushPendingFrees();
+	if (error != PCE_NONE) {
+		return error;
+	}
 	error = dbgCommandDone();
 #ifdef DEBUG
 	printCall();
@@ -1991,45 +2577,46 @@ pcErrorCode ProgramControl::callDone(void)
 	return error;
 }
 
-pcErrorCode ProgramControl::execute(bool stopOnGLError)
+pcErrorCode ProgramControl::execute(bool stopOnGLError, bool trace)
 {
 #ifdef _WIN32
 	::SwitchToThread();
 #else /* _WIN32 */
 	sched_yield();
 #endif /* _WIN32 */
-	return dbgCommandExecute(stopOnGLError);
+	return dbgCommandExecute(stopOnGLError, trace);
 }
 
-pcErrorCode ProgramControl::executeToShaderSwitch(bool stopOnGLError)
+pcErrorCode ProgramControl::executeToShaderSwitch(bool stopOnGLError,
+		bool trace)
 {
 #ifdef _WIN32
 	::SwitchToThread();
 #else /* _WIN32 */
 	sched_yield();
 #endif /* _WIN32 */
-	return dbgCommandExecuteToShaderSwitch(stopOnGLError);
+	return dbgCommandExecuteToShaderSwitch(stopOnGLError, trace);
 }
 
-pcErrorCode ProgramControl::executeToDrawCall(bool stopOnGLError)
+pcErrorCode ProgramControl::executeToDrawCall(bool stopOnGLError, bool trace)
 {
 #ifdef _WIN32
 	::SwitchToThread();
 #else /* _WIN32 */
 	sched_yield();
 #endif /* _WIN32 */
-	return dbgCommandExecuteToDrawCall(stopOnGLError);
+	return dbgCommandExecuteToDrawCall(stopOnGLError, trace);
 }
 
 pcErrorCode ProgramControl::executeToUserDefined(const char *fname,
-		bool stopOnGLError)
+		bool stopOnGLError, bool trace)
 {
 #ifdef _WIN32
 	::SwitchToThread();
 #else /* _WIN32 */
 	sched_yield();
 #endif /* _WIN32 */
-	return dbgCommandExecuteToUserDefined(fname, stopOnGLError);
+	return dbgCommandExecuteToUserDefined(fname, stopOnGLError, trace);
 
 }
 
@@ -2045,7 +2632,7 @@ pcErrorCode ProgramControl::stop(void)
 
 pcErrorCode ProgramControl::checkExecuteState(int *state)
 {
-	DbgRec *rec = getThreadRecord(_debuggeePID);
+	DbgRec *rec = getThreadRecord(activeThread());
 	dbgPrint(DBGLVL_INFO, "execute state: %i\n", (int)rec->result);
 	switch (rec->result) {
 	case DBG_EXECUTE_IN_PROGRESS:
@@ -2062,15 +2649,95 @@ pcErrorCode ProgramControl::checkExecuteState(int *state)
 	}
 }
 
+bool ProgramControl::canTrace(void)
+{
+#ifdef _WIN32
+	/* the trace ring is a System V segment, see openTraceRing */
+	return false;
+#else /* _WIN32 */
+	return true;
+#endif /* _WIN32 */
+}
+
+bool ProgramControl::tracing(void)
+{
+	return _tracing;
+}
+
+void ProgramControl::beginTrace(DbgRec *rec)
+{
+	_tracing = rec->items[2] && mapTraceRing();
+	/* nobody would drain the ring otherwise */
+	rec->items[2] = _tracing ? 1 : 0;
+}
+
+FunctionCall* ProgramControl::decodeTraceRecord(const DbgTraceRecord *record)
+{
+	FunctionCall *fCall = new FunctionCall();
+	ALIGNED_DATA *args = DBG_TRACE_ARGS(record);
+	char *data = (char*) (args + 2 * record->numArgs);
+	unsigned int size;
+	void *value;
+	int i;
+
+	for (i = 0; i < (int) record->numArgs; i++) {
+		size = getArgumentSize(args[2 * i]);
+		value = malloc(size ? size : 1);
+		memcpy(value, data, size);
+		fCall->addArgument(args[2 * i], value, (void*) args[2 * i + 1]);
+		data += DBG_INLINE_PAD(size);
+	}
+	fCall->setFunction(record->function);
+	return fCall;
+}
+
+int ProgramControl::readTrace(std::vector<FunctionCall*> &calls, int maxCalls)
+{
+	DbgTraceRing *ring = _traceRing;
+	DbgTraceRecord *record;
+	ALIGNED_DATA head, tail, pos;
+	int numCalls = 0;
+
+	if (!_tracing || !ring) {
+		return 0;
+	}
+
+	head = ring->head;
+	/* do not read records before they were published */
+	memoryBarrier();
+	tail = ring->tail;
+	while (tail != head && numCalls < maxCalls) {
+		pos = tail % ring->size;
+		if (ring->size - pos < (ALIGNED_DATA) sizeof(DbgTraceRecord)) {
+			tail += ring->size - pos;
+			continue;
+		}
+		record = (DbgTraceRecord*) (DBG_TRACE_DATA(ring) + pos);
+		if (record->function != DBG_TRACE_WRAP) {
+			calls.push_back(decodeTraceRecord(record));
+			numCalls++;
+		}
+		tail += record->size;
+	}
+	/* the debuggee may overwrite the records as soon as tail moves */
+	memoryBarrier();
+	ring->tail = tail;
+	if (ring->dropped) {
+		dbgPrint(DBGLVL_WARNING, "trace ring dropped %li calls\n",
+				(long) ring->dropped);
+		ring->dropped = 0;
+	}
+	return numCalls;
+}
+
 pcErrorCode ProgramControl::executeContinueOnError(void)
 {
 #ifdef _WIN32
 	::SwitchToThread();
-	::SetEvent(_hEvtDebuggee);
 #else /* _WIN32 */
 	sched_yield();
-	ptrace(PTRACE_CONT, _debuggeePID, 0, 0);
 #endif /* _WIN32 */
+	resumeDebuggee();
 	return PCE_NONE;
 }
 
@@ -2080,13 +2747,15 @@ pcErrorCode ProgramControl::killProgram(int hard)
 	dbgPrint(DBGLVL_INFO, "killing debuggee: %s",
 			 (hard ? "forced" : "termination requested"));
 	if (_debuggeePID) {
-		if (hard) {
+		/* PTRACE_KILL needs a stopped tracee, which it is not while waiting
+		 * for the doorbell */
+		if (hard || SHM_CONTROL(_fcalls)->doorbell) {
 			kill(_debuggeePID, SIGKILL);
 		} else {
 			ptrace(PTRACE_KILL, _debuggeePID, 0, 0);
 		}
 		_debuggeePID = 0;
-		return checkChildStatus();
+		return waitChildStatus();
 	}
 	return PCE_NONE;
 }
@@ -2120,6 +2789,9 @@ void ProgramControl::initShmem(void)
 
 void ProgramControl::freeShmem(void)
 {
+	unmapResultArena();
+	unmapTraceRing();
+	unmapThreadRecords();
 	shmctl(shmid, IPC_RMID, 0);
 
 	if (shmdt(_fcalls) == -1) {
@@ -2131,9 +2803,101 @@ void ProgramControl::freeShmem(void)
 
 void ProgramControl::clearShmem(void)
 {
+	unmapResultArena();
+	unmapTraceRing();
+	unmapThreadRecords();
+	_pendingFrees.clear();
 	memset(_fcalls, 0, SHM_SIZE);
 }
 
+void* ProgramControl::mapResultArena(void)
+{
+#ifndef _WIN32
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	void *arena;
+
+	if (!control->resultSize) {
+		return NULL;
+	}
+	if (_resultArena && _resultShmid == (int) control->resultShmid) {
+		return _resultArena;
+	}
+
+	/* the debuggee only replaces the arena after all results were released */
+	unmapResultArena();
+	arena = shmat((int) control->resultShmid, NULL, 0);
+	if (arena == (void*) -1) {
+		dbgPrint(DBGLVL_ERROR,
+				"Attaching to result arena failed: %s\n", strerror(errno));
+		return NULL;
+	}
+	/* segment vanishes as soon as both sides detached */
+	shmctl((int) control->resultShmid, IPC_RMID, 0);
+
+	_resultShmid = (int) control->resultShmid;
+	_resultArena = arena;
+	_resultArenaSize = (size_t) control->resultSize;
+	return _resultArena;
+#else /* _WIN32 */
+	return NULL;
+#endif /* _WIN32 */
+}
+
+void ProgramControl::unmapResultArena(void)
+{
+#ifndef _WIN32
+	if (_resultArena) {
+		shmdt(_resultArena);
+	}
+#endif /* _WIN32 */
+	_resultShmid = -1;
+	_resultArena = NULL;
+	_resultArenaSize = 0;
+}
+
+DbgTraceRing* ProgramControl::mapTraceRing(void)
+{
+#ifndef _WIN32
+	DbgShmControl *control = SHM_CONTROL(_fcalls);
+	void *ring;
+
+	if (!control->traceSize) {
+		return NULL;
+	}
+	if (_traceRing && _traceShmid == (int) control->traceShmid) {
+		return _traceRing;
+	}
+
+	unmapTraceRing();
+	ring = shmat((int) control->traceShmid, NULL, 0);
+	if (ring == (void*) -1) {
+		dbgPrint(DBGLVL_ERROR,
+				"Attaching to trace ring failed: %s\n", strerror(errno));
+		return NULL;
+	}
+	/* segment vanishes as soon as both sides detached */
+	shmctl((int) control->traceShmid, IPC_RMID, 0);
+
+	_traceShmid = (int) control->traceShmid;
+	_traceRing = (DbgTraceRing*) ring;
+	return _traceRing;
+#else /* _WIN32 */
+	return NULL;
+#endif /* _WIN32 */
+}
+
+void ProgramControl::unmapTraceRing(void)
+{
+#ifndef _WIN32
+	if (_traceRing) {
+		shmdt(_traceRing);
+	}
+#endif /* _WIN32 */
+	_traceShmid = -1;
+	_traceRing = NULL;
+	_tracing = false;
+}
+
 
 
 
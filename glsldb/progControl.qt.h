@@ -43,6 +43,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "functionCall.h"
 #include "ResourceLimits.h"
 #include "attachToProcess.qt.h"
+#include "sharedResult.h"
+#include <vector>
 
 extern "C" {
 #include "GL/gl.h"
@@ -58,6 +60,23 @@ typedef DWORD PID_T;
 typedef pid_t PID_T;
 #endif /* _WIN32 */
 
+/* A pass of ProgramControl::shaderStepFragments: the debug sources with the
+ * components and format to read back, and what was read.
+ */
+struct FragmentPass {
+	char *shaders[3];
+	int numComponents;
+	int format;
+	/* the results are only valid if error is PCE_NONE */
+	pcErrorCode error;
+	int width;
+	int height;
+	/* see ProgramControl::shaderStepFragment */
+	int placement[4];
+	void *image;
+	SharedResult *shared;
+};
+
 class ProgramControl {
 
 public:
@@ -77,11 +96,23 @@ public:
 	pcErrorCode checkChildStatus(void);
 	FunctionCall* getCurrentCall(void);
 
-	pcErrorCode execute(bool stopOnGLError);
-	pcErrorCode executeToShaderSwitch(bool stopOnGLError);
-	pcErrorCode executeToDrawCall(bool stopOnGLError);
-	pcErrorCode executeToUserDefined(const char *fname, bool stopOnGLError);
+	/* If trace is set, the debuggee reports every call it executes through
+	 * the trace ring; tracing() tells whether it actually does.
+	 */
+	pcErrorCode execute(bool stopOnGLError, bool trace = false);
+	pcErrorCode executeToShaderSwitch(bool stopOnGLError, bool trace = false);
+	pcErrorCode executeToDrawCall(bool stopOnGLError, bool trace = false);
+	pcErrorCode executeToUserDefined(const char *fname, bool stopOnGLError,
+			bool trace = false);
 	pcErrorCode checkExecuteState(int *state);
+	/* false on platforms without a trace ring (windows) */
+	bool canTrace(void);
+	bool tracing(void);
+	/* Append up to maxCalls traced calls to calls and free their space in
+	 * the ring. Returns the number of calls read. May be called from another
+	 * thread while the debuggee executes.
+	 */
+	int readTrace(std::vector<FunctionCall*> &calls, int maxCalls);
 	pcErrorCode executeContinueOnError(void);
 	pcErrorCode stop(void);
 
@@ -90,8 +121,14 @@ public:
 	pcErrorCode overwriteFuncArguments(const FunctionCall *fCall);
 
 	pcErrorCode restoreRenderTarget(int target);
+	/* The focus region, from the top left of the viewport, limits the
+	 * fragment shader steps of the debug session to it; its width and height
+	 * are 0 to debug the whole viewport.
+	 */
 	pcErrorCode setDbgTarget(int target, int alphaTestOption,
-			int depthTestOption, int stencilTestOption, int blendingOption);
+			int depthTestOption, int stencilTestOption, int blendingOption,
+			int focusX = 0, int focusY = 0, int focusWidth = 0,
+			int focusHeight = 0);
 
 	pcErrorCode saveAndInterruptQueries(void);
 	pcErrorCode restartQueries(void);
@@ -107,15 +144,63 @@ public:
 	pcErrorCode saveActiveShader(void);
 	pcErrorCode restoreActiveShader(void);
 
+	/* hit/miss counters of the debuggee's debug program cache */
+	pcErrorCode getDbgShaderCacheStats(int *hits, int *misses,
+			int *numPrograms, bool reset = false);
+
+	/* If shared is given, the result may be returned in place from the
+	 * debuggee's result arena: *shared is then set and holds the data, which
+	 * must not be free'd; the caller owns its reference. Otherwise *shared is
+	 * NULL and the data is malloc'ed.
+	 * Shader sources are sent inline in a single DBG_BATCH if they fit.
+	 * If placement is given, it is set to x and y of the image from the top
+	 * left of the viewport followed by the viewport size; the image only
+	 * covers the focus region of setDbgTarget then.
+	 */
 	pcErrorCode shaderStepFragment(char *shaders[3], int numComponents,
-			int format, int *width, int *heigh, void **image);
+			int format, int *width, int *heigh, void **image,
+			SharedResult **shared = 0, int *placement = 0);
+	/* format is GL_FLOAT or one of the packed formats of DBG_SHADER_STEP, the
+	 * vertex data is returned in it
+	 */
 	pcErrorCode shaderStepVertex(char *shaders[3], int target,
 			int primitiveMode, int forcePointPrimitiveMode,
-			int numFloatsPerVertex, int *numPrimitives, int *numVertices,
-			float **vertexData);
-
-	/* obsolete? */
-	pcErrorCode setDbgShaderCode(char *shaders[3], int target);
+			int numFloatsPerVertex, int format, int *numPrimitives,
+			int *numVertices, void **vertexData, SharedResult **shared = 0);
+
+	/* bytes of a result of width x height values with numComponents each in
+	 * format, including the packed formats; vertex data is a single row.
+	 * 0 if the format is unknown.
+	 */
+	static size_t readBackSize(int format, int numComponents, int width,
+			int height);
+
+	/* Like shaderStepFragment for a single channel image, but the debuggee
+	 * only returns the number of pixels above 0.5 (covered, as by
+	 * PixelBox::getCoverageFromData) and above 0.75 (active loop condition),
+	 * counted on the GPU, and the number of pixels debugged. If limit is not
+	 * NULL, only the pixels set in this mask of limitSize bytes are counted,
+	 * see DBG_SHADER_STEP for its layout.
+	 */
+	pcErrorCode shaderStepFragmentStatistics(char *shaders[3],
+			const unsigned int *limit, size_t limitSize, int *numCovered,
+			int *numActive, int *numPixels);
+
+	/* Run the passes of a step in one stop of the debuggee, each on a render
+	 * buffer initialized as by initializeRenderBuffer without copying RGB. The
+	 * debuggee replays them back to back and waits for their readbacks only
+	 * at the end. Passes that do not fit into the batch are not run and keep
+	 * an error, the others return their results as shaderStepFragment does.
+	 */
+	pcErrorCode shaderStepFragments(FragmentPass *passes, int numPasses,
+			bool copyAlpha, bool copyDepth, bool copyStencil, float alpha,
+			float depth, int stencil);
+
+	/* Compile, link and activate a debug program without running it; the
+	 * debuggee keeps it in its program cache for a later shader step.
+	 */
+	pcErrorCode setDbgShaderCode(char *shaders[3], int target,
+			int forcePointPrimitiveMode = 0);
 
 	pcErrorCode initializeRenderBuffer(bool copyRGB, bool copyAlpha,
 			bool copyDepth, bool copyStencil, float red, float green,
@@ -138,11 +223,14 @@ private:
 	pcErrorCode dbgCommandExecuteToDrawCall(void);
 	pcErrorCode dbgCommandExecuteToShaderSwitch(void);
 	pcErrorCode dbgCommandExecuteToUserDefined(const char *fname);
-	pcErrorCode dbgCommandExecute(bool stopOnGLError);
-	pcErrorCode dbgCommandExecuteToDrawCall(bool stopOnGLError);
-	pcErrorCode dbgCommandExecuteToShaderSwitch(bool stopOnGLError);
+	pcErrorCode dbgCommandExecute(bool stopOnGLError, bool trace);
+	pcErrorCode dbgCommandExecuteToDrawCall(bool stopOnGLError, bool trace);
+	pcErrorCode dbgCommandExecuteToShaderSwitch(bool stopOnGLError,
+			bool trace);
 	pcErrorCode dbgCommandExecuteToUserDefined(const char *fname,
-			bool stopOnGLError);
+			bool stopOnGLError, bool trace);
+	void beginTrace(DbgRec *rec);
+	FunctionCall* decodeTraceRecord(const DbgTraceRecord *record);
 	pcErrorCode dbgCommandStopExecution(void);
 	pcErrorCode dbgCommandCallOrig(void);
 	pcErrorCode dbgCommandCallOrig(const FunctionCall *fCall);
@@ -155,20 +243,37 @@ private:
 	pcErrorCode dbgCommandReplay(int target);
 	pcErrorCode dbgCommandEndReplay(void);
 	pcErrorCode dbgCommandSetDbgTarget(int target, int alphaTestOption,
-			int depthTestOption, int stencilTestOption, int blendingOption);
+			int depthTestOption, int stencilTestOption, int blendingOption,
+			int focusX, int focusY, int focusWidth, int focusHeight);
 	pcErrorCode dbgCommandRestoreRenderTarget(int target);
 	pcErrorCode dbgCommandCopyToRenderBuffer(void);
 	pcErrorCode dbgCommandClearRenderBuffer(int mode, float r, float g, float b,
 			float a, float f, int s);
 	pcErrorCode dbgCommandSaveAndInterruptQueries(void);
 	pcErrorCode dbgCommandRestartQueries(void);
-	pcErrorCode dbgCommandShaderStepFragment(void *shaders[3],
+	pcErrorCode putShaderSources(char *shaders[3]);
+	pcErrorCode dbgCommandShaderStepFragment(char *shaders[3],
 			int numComponents, int format, int *width, int *height,
-			void **image);
-	pcErrorCode dbgCommandShaderStepVertex(void *shaders[3], int target,
+			void **image, SharedResult **shared, int *placement);
+	pcErrorCode dbgCommandShaderStepFragmentStatistics(char *shaders[3],
+			const unsigned int *limit, size_t limitSize,
+			int *numCovered, int *numActive, int *numPixels);
+	pcErrorCode dbgCommandShaderStepVertex(char *shaders[3], int target,
 			int primitiveMode, int forcePointPrimitiveMode,
-			int numFloatsPerVertex, int *numPrimitives, int *numVertices,
-			float **vertexData);
+			int numFloatsPerVertex, int format, int *numPrimitives,
+			int *numVertices, void **vertexData, SharedResult **shared);
+	pcErrorCode fragmentStepResult(ALIGNED_DATA result, ALIGNED_DATA *items,
+			int numComponents, int format, int *width, int *height,
+			int *placement, void **image, SharedResult **shared);
+	pcErrorCode fragmentStatisticsResult(ALIGNED_DATA result,
+			ALIGNED_DATA *items, int *numCovered, int *numActive,
+			int *numPixels);
+	pcErrorCode vertexStepResult(ALIGNED_DATA result, ALIGNED_DATA *items,
+			int numFloatsPerVertex, int format, int *numPrimitives,
+			int *numVertices, void **vertexData, SharedResult **shared);
+	pcErrorCode fetchResult(ALIGNED_DATA *items, size_t size, void **data,
+			SharedResult **shared);
+	pcErrorCode flushPendingFrees(void);
 	pcErrorCode dbgCommandReadRenderBuffer(int numComponents, int *width,
 			int *height, float **image);
 	pcErrorCode dbgCommandDone(void);
@@ -178,18 +283,60 @@ private:
 	void printCall(void);
 	void printResult(void);
 
+	/* DBG_BATCH assembly: batchBegin() starts a new batch with the pending
+	 * frees, batchAdd() appends a sub-command and returns NULL if it does not
+	 * fit, batchExecute() sends it. Results are read from the DbgBatchCmds.
+	 * batchAddSources() passes the shaders inline and reserves extraSize
+	 * more bytes of inline data behind them, at offset
+	 * cmd->dataSize - DBG_BATCH_PAD(extraSize).
+	 */
+	void batchBegin(void);
+	DbgBatchCmd* batchAdd(int operation, int numSlots, size_t dataSize = 0);
+	DbgBatchCmd* batchAddSources(int operation, char *shaders[3],
+			int numSlots, size_t extraSize = 0);
+	pcErrorCode batchExecute(void);
+
 	/* dbg command execution and error checking */
+	void resumeDebuggee(void);
 	pcErrorCode executeDbgCommand(void);
 	pcErrorCode checkError(void);
+#ifndef _WIN32
+	pcErrorCode waitChildStatus(void);
+	pcErrorCode waitForDoorbell(void);
+	bool claimStoppedThread(void);
+	pcErrorCode evaluateChildStatus(pid_t pid, int status);
+#endif /* _WIN32 */
 
 	/* Shared memory handling */
 	void initShmem(void);
 	void clearShmem(void);
 	void freeShmem(void);
-    DbgRec* getThreadRecord(PID_T pid);
+	/* thread of the debuggee that stopped last, with doorbells the one of
+	 * the slot claimed last */
+	PID_T activeThread(void);
+	DbgRec* getThreadRecord(PID_T tid);
+	void unmapThreadRecords(void);
+	void* mapResultArena(void);
+	void unmapResultArena(void);
+	DbgTraceRing* mapTraceRing(void);
+	void unmapTraceRing(void);
 
     int shmid;
 	DbgRec *_fcalls;
+	int _resultShmid;
+	void *_resultArena;
+	size_t _resultArenaSize;
+	int _traceShmid;
+	DbgTraceRing *_traceRing;
+	bool _tracing;
+	/* records of threads beyond SHM_MAX_THREADS, by directory slot */
+	DbgRec *_threadRecords[SHM_MAX_THREAD_SLOTS];
+	/* directory slot of the thread stopped at the doorbell, -1 if none */
+	int _activeSlot;
+	DbgBatchCmd *_batchEnd;
+	/* debuggee heap blocks to be free'd with the next batch */
+	std::vector<void*> _pendingFrees;
+	unsigned int _numBatchedFrees;
 	std::string _path_dbglib;
 	std::string _path_dbgfuncs;
 	std::string _path_libdlsym;
@@ -0,0 +1,205 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+
+#include "resultCache.h"
+#include "utils/notify.h"
+
+ResultCache::ResultCache(qint64 i_nMemoryBudget, qint64 i_nDiskBudget) :
+		m_nMemoryBudget(i_nMemoryBudget), m_nDiskBudget(i_nDiskBudget),
+		m_nMemoryUsed(0), m_nDiskUsed(0), m_pSpillDir(NULL), m_nNextFile(0),
+		m_nHits(0), m_nMisses(0)
+{
+}
+
+ResultCache::~ResultCache()
+{
+	clear();
+	delete m_pSpillDir;
+}
+
+void ResultCache::clear(void)
+{
+	while (!m_entries.isEmpty()) {
+		remove(m_entries.begin());
+	}
+}
+
+void ResultCache::remove(EntryHash::iterator it)
+{
+	Entry &entry = it.value();
+
+	if (entry.fileName.isEmpty()) {
+		entry.result.data->unref();
+		m_nMemoryUsed -= entry.size;
+	} else {
+		QFile::remove(entry.fileName);
+		m_nDiskUsed -= entry.size;
+	}
+	m_lru.erase(entry.lru);
+	m_entries.erase(it);
+}
+
+bool ResultCache::spill(Entry &entry)
+{
+	QFile file;
+
+	if (!m_pSpillDir) {
+		m_pSpillDir = new QTemporaryDir();
+	}
+	if (!m_pSpillDir->isValid()) {
+		return false;
+	}
+	file.setFileName(
+			m_pSpillDir->path() + QString("/%1.res").arg(m_nNextFile++));
+	if (!file.open(QIODevice::WriteOnly)
+			|| file.write((const char*) entry.result.extent,
+					sizeof(entry.result.extent))
+					!= (qint64) sizeof(entry.result.extent)
+			|| file.write((const char*) entry.result.data->getDataPointer(),
+					entry.result.data->getSize())
+					!= (qint64) entry.result.data->getSize()) {
+		UT_NOTIFY(LV_WARN, "Could not spill shader step result to "
+				<< file.fileName().toStdString());
+		file.remove();
+		return false;
+	}
+	entry.fileName = file.fileName();
+	entry.result.data->unref();
+	entry.result.data = NULL;
+	m_nMemoryUsed -= entry.size;
+	m_nDiskUsed += entry.size;
+	return true;
+}
+
+bool ResultCache::load(Entry &entry)
+{
+	QFile file(entry.fileName);
+	qint64 size;
+	void *data;
+
+	if (!file.open(QIODevice::ReadOnly)
+			|| file.read((char*) entry.result.extent,
+					sizeof(entry.result.extent))
+					!= (qint64) sizeof(entry.result.extent)) {
+		return false;
+	}
+	size = file.size() - (qint64) sizeof(entry.result.extent);
+	data = malloc(size);
+	if ((size && !data) || file.read((char*) data, size) != size) {
+		free(data);
+		return false;
+	}
+	entry.result.data = new SharedResult(data, size);
+	file.remove();
+	entry.fileName.clear();
+	m_nDiskUsed -= entry.size;
+	m_nMemoryUsed += entry.size;
+	return true;
+}
+
+void ResultCache::enforceBudgets(void)
+{
+	std::list<QByteArray>::iterator it = m_lru.end();
+
+	/* oldest first: spill while the memory budget is exceeded, drop what
+	 * does not fit on disk anymore
+	 */
+	while (it != m_lru.begin()
+			&& (m_nMemoryUsed > m_nMemoryBudget || m_nDiskUsed > m_nDiskBudget)) {
+		EntryHash::iterator entry = m_entries.find(*--it);
+		bool inMemory = entry.value().fileName.isEmpty();
+
+		if (inMemory && m_nMemoryUsed <= m_nMemoryBudget) {
+			continue;
+		}
+		if (!inMemory && m_nDiskUsed <= m_nDiskBudget) {
+			continue;
+		}
+		if (inMemory && entry.value().size <= m_nDiskBudget
+				&& spill(entry.value())) {
+			/* revisit it, the disk budget may be exceeded now */
+			++it;
+			continue;
+		}
+		++it;
+		remove(entry);
+	}
+}
+
+bool ResultCache::find(const QByteArray &key, CachedResult &result)
+{
+	EntryHash::iterator it = m_entries.find(key);
+
+	if (it == m_entries.end()) {
+		m_nMisses++;
+		return false;
+	}
+	Entry &entry = it.value();
+	if (!entry.fileName.isEmpty() && !load(entry)) {
+		UT_NOTIFY(LV_WARN, "Could not reload shader step result from "
+				<< entry.fileName.toStdString());
+		remove(it);
+		m_nMisses++;
+		return false;
+	}
+	m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+	result = entry.result;
+	result.data->ref();
+	m_nHits++;
+
+	enforceBudgets();
+	return true;
+}
+
+void ResultCache::insert(const QByteArray &key, const CachedResult &result)
+{
+	EntryHash::iterator it = m_entries.find(key);
+	Entry entry;
+
+	if (it != m_entries.end()) {
+		remove(it);
+	}
+	m_lru.push_front(key);
+	entry.result = result;
+	entry.result.data->ref();
+	entry.result.data->detach();
+	entry.size = key.size() + result.data->getSize();
+	entry.lru = m_lru.begin();
+	m_entries.insert(key, entry);
+	m_nMemoryUsed += entry.size;
+
+	enforceBudgets();
+}
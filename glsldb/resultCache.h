@@ -0,0 +1,123 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef _RESULT_CACHE_H_
+#define _RESULT_CACHE_H_
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <list>
+
+#include "sharedResult.h"
+
+class QTemporaryDir;
+
+/* readback of one shader step as it came from the debuggee */
+struct CachedResult {
+	/* width and height of an image, number of vertices and primitives of
+	 * vertex data
+	 */
+	int extent[2];
+	/* x and y of an image from the top left of the viewport and the
+	 * viewport size, see ProgramControl::shaderStepFragment
+	 */
+	int placement[4];
+	/* packed formats stay packed */
+	SharedResult *data;
+};
+
+/* Shader step results of the current recording, keyed by everything that
+ * determines them (see MainWindow::resultCacheKey). Entries beyond the memory
+ * budget are spilled to temporary files as long as the disk budget allows,
+ * older ones are dropped.
+ */
+class ResultCache {
+public:
+	/* budgets in bytes; no spilling if i_nDiskBudget is 0 */
+	ResultCache(qint64 i_nMemoryBudget, qint64 i_nDiskBudget);
+	~ResultCache();
+
+	/* forget all results, e.g. when a new draw call is recorded */
+	void clear(void);
+
+	/* the caller owns a reference to result.data */
+	bool find(const QByteArray &key, CachedResult &result);
+	/* like find, but neither counts nor touches the entry */
+	bool contains(const QByteArray &key) const
+	{
+		return m_entries.contains(key);
+	}
+	/* keeps a reference to result.data instead of a copy; a result in the
+	 * arena is detached first, the debuggee needs the arena back
+	 */
+	void insert(const QByteArray &key, const CachedResult &result);
+
+	int hits(void) const
+	{
+		return m_nHits;
+	}
+	int misses(void) const
+	{
+		return m_nMisses;
+	}
+
+private:
+	struct Entry {
+		CachedResult result;
+		/* non-empty if result.data was spilled, which is NULL then */
+		QString fileName;
+		qint64 size;
+		std::list<QByteArray>::iterator lru;
+	};
+	typedef QHash<QByteArray, Entry> EntryHash;
+
+	void remove(EntryHash::iterator it);
+	bool spill(Entry &entry);
+	bool load(Entry &entry);
+	void enforceBudgets(void);
+
+	EntryHash m_entries;
+	/* most recently used first */
+	std::list<QByteArray> m_lru;
+	qint64 m_nMemoryBudget;
+	qint64 m_nDiskBudget;
+	qint64 m_nMemoryUsed;
+	qint64 m_nDiskUsed;
+	QTemporaryDir *m_pSpillDir;
+	int m_nNextFile;
+	int m_nHits;
+	int m_nMisses;
+};
+
+#endif
@@ -166,7 +166,7 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 	if (vbCondition) {
 		int i;
 		float *condition = vbCondition->getDataPointer();
-		bool *coverage = vbCondition->getCoveragePointer();
+		CoverageMap *coverage = vbCondition->getCoveragePointer();
 
 		m_nTotal = vbCondition->getNumVertices();
 		if (m_nTotal == 0) {
@@ -178,7 +178,7 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 		}
 
 		for (i = 0; i < vbCondition->getNumVertices(); i++) {
-			if (*coverage) {
+			if (coverage->test(i)) {
 				m_nActive++;
 
 				if (*condition > 0.75f) {
@@ -187,7 +187,6 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 					m_nElse++;
 				}
 			}
-			coverage++;
 			condition++;
 		}
 
@@ -260,7 +259,7 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 	if (vbCondition) {
 		int i;
 		float *condition = vbCondition->getDataPointer();
-		bool *coverage = vbCondition->getCoveragePointer();
+		CoverageMap *coverage = vbCondition->getCoveragePointer();
 
 		m_nTotal = vbCondition->getNumVertices();
 		if (m_nTotal == 0) {
@@ -272,7 +271,7 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 		}
 
 		for (i = 0; i < vbCondition->getNumVertices(); i++) {
-			if (*coverage) {
+			if (coverage->test(i)) {
 				m_nActive++;
 
 				if (*condition > 0.75f) {
@@ -281,7 +280,6 @@ SelectionDialog::SelectionDialog(VertexBox *vbCondition,
 					m_nElse++;
 				}
 			}
-			coverage++;
 			condition++;
 		}
 
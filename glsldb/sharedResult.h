@@ -0,0 +1,128 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef _SHARED_RESULT_H_
+#define _SHARED_RESULT_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+#include "debuglib.h"
+}
+
+/* A readback result, either left in the result arena by the debuggee or in
+ * malloc'ed memory of its own. Arena data is read in place; the debuggee will
+ * not reuse the arena before the result was detached or its last reference
+ * dropped. Results are reference counted so the result cache and pixel boxes
+ * can hold the same data without copying it.
+ */
+class SharedResult {
+public:
+	/* a result in the arena, with one reference */
+	SharedResult(void *i_pData, size_t i_nSize, DbgShmControl *i_pControl,
+			ALIGNED_DATA i_nGeneration) :
+			m_pData(i_pData), m_nSize(i_nSize), m_pControl(i_pControl),
+			m_nGeneration(i_nGeneration), m_nRefs(1)
+	{
+	}
+	/* takes ownership of the malloc'ed i_pData, with one reference */
+	SharedResult(void *i_pData, size_t i_nSize) :
+			m_pData(i_pData), m_nSize(i_nSize), m_pControl(0),
+			m_nGeneration(0), m_nRefs(1)
+	{
+	}
+
+	void ref(void)
+	{
+		m_nRefs++;
+	}
+	/* the result is deleted with its last reference */
+	void unref(void)
+	{
+		if (--m_nRefs == 0) {
+			delete this;
+		}
+	}
+	/* whether anybody else holds a reference, too */
+	bool isShared(void) const
+	{
+		return m_nRefs > 1;
+	}
+
+	void* getDataPointer(void)
+	{
+		return m_pData;
+	}
+	size_t getSize(void) const
+	{
+		return m_nSize;
+	}
+
+	/* copies a result out of the arena into its own memory and hands the
+	 * arena back to the debuggee; the data pointer changes
+	 */
+	void detach(void)
+	{
+		void *data;
+
+		if (!m_pControl) {
+			return;
+		}
+		data = malloc(m_nSize);
+		memcpy(data, m_pData, m_nSize);
+		m_pControl->resultReleased = m_nGeneration;
+		m_pControl = 0;
+		m_pData = data;
+	}
+
+private:
+	SharedResult(const SharedResult&);
+	SharedResult& operator=(const SharedResult&);
+	~SharedResult()
+	{
+		if (m_pControl) {
+			m_pControl->resultReleased = m_nGeneration;
+		} else {
+			free(m_pData);
+		}
+	}
+
+	void *m_pData;
+	size_t m_nSize;
+	DbgShmControl *m_pControl;
+	ALIGNED_DATA m_nGeneration;
+	int m_nRefs;
+};
+
+#endif
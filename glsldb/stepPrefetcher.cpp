@@ -0,0 +1,303 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include <QtCore/QCryptographicHash>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stepPrefetcher.h"
+#include "progControl.qt.h"
+#include "errorCodes.h"
+#include "utils/dbgprint.h"
+
+/* programs submitted ahead at most, half of the debuggee's program cache */
+#define PREFETCH_MAX_PROGRAMS 8
+
+static QByteArray programHash(const char *code)
+{
+	return QCryptographicHash::hash(QByteArray::fromRawData(code,
+			strlen(code)), QCryptographicHash::Sha1);
+}
+
+StepPrefetcher::StepPrefetcher(ProgramControl *i_pPc, int i_nMaxAhead) :
+		m_pPc(i_pPc), m_nMaxAhead(i_nMaxAhead), m_hCompiler(0), m_nTarget(0),
+		m_bInSync(false), m_bFinished(true), m_nPrefetched(0), m_nHits(0),
+		m_nMisses(0), m_nWasted(0)
+{
+	m_variables.numVariables = 0;
+	m_variables.variables = NULL;
+	m_pShaders[0] = m_pShaders[1] = m_pShaders[2] = NULL;
+}
+
+StepPrefetcher::~StepPrefetcher()
+{
+	stop();
+}
+
+bool StepPrefetcher::start(EShLanguage language, const char *source,
+		const TBuiltInResource *resources, char *shaders[3], int target)
+{
+	int debugOptions = EDebugOpIntermediate;
+
+	stop();
+	if (m_nMaxAhead <= 0) {
+		return false;
+	}
+
+	m_hCompiler = ShConstructCompiler(language, debugOptions);
+	if (!m_hCompiler) {
+		return false;
+	}
+	if (!ShCompile(m_hCompiler, &source, 1, EShOptNone, resources,
+			debugOptions, &m_variables)) {
+		dbgPrint(DBGLVL_WARNING, "StepPrefetcher: shader does not compile\n");
+		stop();
+		return false;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		m_pShaders[i] = shaders[i];
+	}
+	m_nTarget = target;
+	m_bInSync = true;
+	m_bFinished = false;
+	m_nPrefetched = 0;
+	m_nHits = 0;
+	m_nMisses = 0;
+	m_nWasted = 0;
+	return true;
+}
+
+void StepPrefetcher::stop(void)
+{
+	if (!m_hCompiler) {
+		return;
+	}
+	discardAhead();
+	discard(m_current);
+	dbgPrint(DBGLVL_INFO, "StepPrefetcher: %i programs prefetched, "
+			"%i hits, %i misses, %i wasted\n", m_nPrefetched, m_nHits,
+			m_nMisses, m_nWasted);
+
+	freeShVariableList(&m_variables);
+	ShDestruct(m_hCompiler);
+	m_hCompiler = 0;
+	m_history.clear();
+	m_bFinished = true;
+}
+
+void StepPrefetcher::discard(QList<QByteArray> &programs)
+{
+	m_nWasted += programs.count();
+	programs.clear();
+}
+
+void StepPrefetcher::discardAhead(void)
+{
+	while (!m_ahead.isEmpty()) {
+		discard(m_ahead.first());
+		m_ahead.removeFirst();
+	}
+}
+
+void StepPrefetcher::stepped(int action)
+{
+	if (!m_hCompiler) {
+		return;
+	}
+
+	/* whatever was left for the previous step is not used anymore */
+	discard(m_current);
+
+	if (action == DBG_BH_RESET) {
+		m_history.clear();
+	} else {
+		m_history.append(action);
+	}
+
+	if (action == DBG_BH_JUMP_INTO && m_bInSync) {
+		if (!m_ahead.isEmpty()) {
+			/* the prediction was right */
+			m_current = m_ahead.takeFirst();
+			return;
+		}
+		/* not ahead yet, keep up with the debugged compiler */
+		DbgResult *dr = ShDebugJumpToNext(m_hCompiler, EDebugOpIntermediate,
+				action);
+		if (!dr || dr->status != DBG_RS_STATUS_OK) {
+			m_bFinished = true;
+		}
+		return;
+	}
+
+	/* any other action leaves the predicted path */
+	discardAhead();
+	m_bInSync = false;
+	m_bFinished = false;
+}
+
+void StepPrefetcher::used(const char *debugCode)
+{
+	if (!m_hCompiler || !debugCode) {
+		return;
+	}
+	if (m_current.removeOne(programHash(debugCode))) {
+		m_nHits++;
+	} else {
+		m_nMisses++;
+	}
+}
+
+/* bring the prefetching compiler to the position of the debugged one */
+bool StepPrefetcher::resync(void)
+{
+	DbgResult *dr;
+
+	dr = ShDebugJumpToNext(m_hCompiler, EDebugOpIntermediate, DBG_BH_RESET);
+	for (int i = 0; dr && i < m_history.count(); i++) {
+		dr = ShDebugJumpToNext(m_hCompiler, EDebugOpIntermediate, m_history[i]);
+	}
+	m_bInSync = true;
+	m_bFinished = !dr || dr->status != DBG_RS_STATUS_OK;
+	return !m_bFinished;
+}
+
+bool StepPrefetcher::prefetch(DbgCgOptions option, ShChangeableList *cl,
+		QList<QByteArray> &programs)
+{
+	char *shaders[3] = { m_pShaders[0], m_pShaders[1], m_pShaders[2] };
+	int forcePointPrimitiveMode = 0;
+	char *debugCode;
+	pcErrorCode error;
+
+	debugCode = ShDebugGetProg(m_hCompiler, cl, &m_variables, option);
+	if (!debugCode) {
+		return true;
+	}
+
+	/* as in MainWindow::getDebugImage and getDebugVertexData */
+	switch (m_nTarget) {
+	case DBG_TARGET_VERTEX_SHADER:
+		shaders[0] = debugCode;
+		shaders[1] = NULL;
+		break;
+	case DBG_TARGET_GEOMETRY_SHADER:
+		shaders[1] = debugCode;
+		forcePointPrimitiveMode = 1;
+		break;
+	default:
+		shaders[2] = debugCode;
+		break;
+	}
+
+	/* a speculative program may well not compile, e.g. for a watch item
+	 * that is out of scope there
+	 */
+	error = m_pPc->setDbgShaderCode(shaders, m_nTarget,
+			forcePointPrimitiveMode);
+	if (error == PCE_NONE) {
+		programs.append(programHash(debugCode));
+		m_nPrefetched++;
+	}
+	free(debugCode);
+	return !isErrorCritical(error);
+}
+
+DbgResult* StepPrefetcher::advance(int numWatchPrograms, bool *more)
+{
+	QList<QByteArray> programs;
+	DbgResult *dr;
+	int numPrograms, i;
+	bool ok;
+
+	*more = false;
+	if (!m_hCompiler) {
+		return NULL;
+	}
+	if (!m_bInSync) {
+		/* one piece of work on its own, it replays the whole history */
+		*more = resync();
+		return NULL;
+	}
+
+	numPrograms = m_current.count();
+	for (i = 0; i < m_ahead.count(); i++) {
+		numPrograms += m_ahead[i].count();
+	}
+	if (m_bFinished || m_ahead.count() >= m_nMaxAhead
+			|| numPrograms + 1 + numWatchPrograms > PREFETCH_MAX_PROGRAMS) {
+		return NULL;
+	}
+
+	dr = ShDebugJumpToNext(m_hCompiler, EDebugOpIntermediate,
+			DBG_BH_JUMP_INTO);
+	if (!dr || dr->status != DBG_RS_STATUS_OK) {
+		m_bFinished = true;
+		return NULL;
+	}
+
+	/* what MainWindow::ShaderStep reads back at that position */
+	ok = prefetch(DBG_CG_COVERAGE, NULL, programs);
+	switch (dr->position) {
+	case DBG_RS_POSITION_SELECTION_IF_CHOOSE:
+	case DBG_RS_POSITION_SELECTION_IF_ELSE_CHOOSE:
+		ok = ok && prefetch(DBG_CG_SELECTION_CONDITIONAL, NULL, programs);
+		break;
+	case DBG_RS_POSITION_LOOP_CHOOSE:
+		ok = ok && prefetch(DBG_CG_LOOP_CONDITIONAL, NULL, programs);
+		break;
+	default:
+		break;
+	}
+	m_ahead.append(programs);
+
+	if (!ok) {
+		/* the debuggee is in trouble, leave it alone */
+		stop();
+		return NULL;
+	}
+	*more = true;
+	return dr;
+}
+
+bool StepPrefetcher::prefetchChangeables(ShChangeableList *cl)
+{
+	if (!m_hCompiler || m_ahead.isEmpty()) {
+		return false;
+	}
+	if (!prefetch(DBG_CG_CHANGEABLE, cl, m_ahead.last())) {
+		stop();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef _STEP_PREFETCHER_H_
+#define _STEP_PREFETCHER_H_
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+#include "ShaderLang.h"
+
+class ProgramControl;
+
+/* Speculatively walks a second compiler of the debugged shader ahead of the
+ * user by DBG_BH_JUMP_INTO steps. For every position it generates the debug
+ * programs the next step is likely to need and submits them to the
+ * debuggee, so that they are already linked in its program cache when the
+ * user gets there. The compilers step independently, each handle keeps its
+ * own position. All work happens in small pieces on the GUI thread: the
+ * code generator is neither reentrant nor thread-safe.
+ */
+class StepPrefetcher {
+public:
+	/* i_nMaxAhead positions are prefetched at most, 0 disables prefetching */
+	StepPrefetcher(ProgramControl *i_pPc, int i_nMaxAhead);
+	~StepPrefetcher();
+
+	/* Start on the shader that is compiled from source for the debug target;
+	 * shaders are the sources of the whole program and must stay valid until
+	 * stop().
+	 */
+	bool start(EShLanguage language, const char *source,
+			const TBuiltInResource *resources, char *shaders[3], int target);
+	void stop(void);
+
+	/* the debugged compiler was advanced with action */
+	void stepped(int action);
+
+	/* the debugger generated debugCode for the current step */
+	void used(const char *debugCode);
+
+	/* Do one piece of speculative work: move one position ahead and prefetch
+	 * its coverage and condition programs. Returns that position if the
+	 * programs of its watch items are to be prefetched next, at most
+	 * numWatchPrograms of them. *more is false if there is nothing left to
+	 * do. The position stays valid until the next call.
+	 */
+	DbgResult* advance(int numWatchPrograms, bool *more);
+
+	/* Prefetch the program reading the packed watch items cl at the position
+	 * advance() returned. Returns false if there is nothing left to do.
+	 */
+	bool prefetchChangeables(ShChangeableList *cl);
+
+	int numPrefetched(void) const
+	{
+		return m_nPrefetched;
+	}
+	int numHits(void) const
+	{
+		return m_nHits;
+	}
+	int numMisses(void) const
+	{
+		return m_nMisses;
+	}
+	int numWasted(void) const
+	{
+		return m_nWasted;
+	}
+
+private:
+	void discard(QList<QByteArray> &programs);
+	void discardAhead(void);
+	bool resync(void);
+	bool prefetch(DbgCgOptions option, ShChangeableList *cl,
+			QList<QByteArray> &programs);
+
+	ProgramControl *m_pPc;
+	int m_nMaxAhead;
+
+	ShHandle m_hCompiler;
+	ShVariableList m_variables;
+	char *m_pShaders[3];
+	int m_nTarget;
+
+	/* actions of the debugged compiler since the last reset */
+	QList<int> m_history;
+	/* the prefetching compiler is m_ahead.count() JUMP_INTOs ahead */
+	bool m_bInSync;
+	bool m_bFinished;
+	/* hashes of the programs submitted per position ahead */
+	QList<QList<QByteArray> > m_ahead;
+	/* submitted for the current step and not used yet */
+	QList<QByteArray> m_current;
+
+	int m_nPrefetched;
+	int m_nHits;
+	int m_nMisses;
+	int m_nWasted;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "glstate.h"
+#include "glenumerants.h"
+#include "debugLibStubs.h"
+
+static struct {
+	EGLDisplay display;
+	EGLConfig config;
+	EGLContext context;
+	EGLContext second;
+	int major;
+	int minor;
+	DbgRec record;
+	DbgShmControl control;
+} stub;
+
+int createStubContext(void)
+{
+	static const EGLint configAttribs[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_SURFACE_TYPE, 0,
+		EGL_NONE
+	};
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay;
+	EGLint numConfigs;
+
+	/* no window system needed where Mesa offers its surfaceless platform */
+	getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress(
+			"eglGetPlatformDisplayEXT");
+	stub.display = EGL_NO_DISPLAY;
+	if (getPlatformDisplay) {
+		stub.display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+				EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (stub.display == EGL_NO_DISPLAY) {
+		stub.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if (stub.display == EGL_NO_DISPLAY
+			|| !eglInitialize(stub.display, NULL, NULL)) {
+		return 0;
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)
+			|| !eglChooseConfig(stub.display, configAttribs, &stub.config, 1,
+					&numConfigs) || numConfigs == 0) {
+		eglTerminate(stub.display);
+		return 0;
+	}
+	/* the default context is a compatibility one, readbacks use its pixel
+	 * transfer state */
+	stub.context = eglCreateContext(stub.display, stub.config, EGL_NO_CONTEXT,
+			NULL);
+	if (stub.context == EGL_NO_CONTEXT
+			|| !eglMakeCurrent(stub.display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+					stub.context)) {
+		eglTerminate(stub.display);
+		return 0;
+	}
+
+	/* the debugger always holds the previous result, so results go to the
+	 * heap instead of a shared memory arena */
+	stub.control.resultGeneration = 1;
+	stub.control.resultReleased = 0;
+	return 1;
+}
+
+void destroyStubContext(void)
+{
+	eglMakeCurrent(stub.display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+			EGL_NO_CONTEXT);
+	if (stub.second != EGL_NO_CONTEXT) {
+		eglDestroyContext(stub.display, stub.second);
+	}
+	eglDestroyContext(stub.display, stub.context);
+	eglTerminate(stub.display);
+}
+
+int createSecondStubContext(void)
+{
+	stub.second = eglCreateContext(stub.display, stub.config, EGL_NO_CONTEXT,
+			NULL);
+	return stub.second != EGL_NO_CONTEXT;
+}
+
+void useStubContext(int second)
+{
+	eglMakeCurrent(stub.display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+			second ? stub.second : stub.context);
+}
+
+void setStubGLVersion(int major, int minor)
+{
+	stub.major = major;
+	stub.minor = minor;
+}
+
+void (*getOrigFunc(const char *fname))(void)
+{
+	/* the debug program cache tells the contexts apart with it */
+	if (!strcmp(fname, "glXGetCurrentContext")) {
+		return (void (*)(void)) eglGetCurrentContext;
+	}
+	return eglGetProcAddress(fname);
+}
+
+DbgRec *getThreadRecord(void)
+{
+	return &stub.record;
+}
+
+DbgShmControl *getShmControl(void)
+{
+	return &stub.control;
+}
+
+int glError(void)
+{
+	return ORIG_GL(glGetError)();
+}
+
+void setErrorCode(int error)
+{
+	stub.record.result = DBG_ERROR_CODE;
+	stub.record.items[0] = (ALIGNED_DATA) error;
+}
+
+int setGLErrorCode(void)
+{
+	int error;
+
+	if ((error = glError())) {
+		setErrorCode(error);
+		return 1;
+	}
+	return 0;
+}
+
+int checkGLVersionSupported(int majorVersion, int minorVersion)
+{
+	GLint major = stub.major, minor = stub.minor;
+
+	if (!major) {
+		ORIG_GL(glGetIntegerv)(GL_MAJOR_VERSION, &major);
+		ORIG_GL(glGetIntegerv)(GL_MINOR_VERSION, &minor);
+	}
+	return majorVersion < major
+			|| (majorVersion == major && minorVersion <= minor);
+}
+
+int checkGLExtensionSupported(const char *extension)
+{
+	GLint i, n;
+
+	if (stub.major) {
+		return 0;
+	}
+	ORIG_GL(glGetIntegerv)(GL_NUM_EXTENSIONS, &n);
+	for (i = 0; i < n; i++) {
+		if (!strcmp((const char*) ORIG_GL(glGetStringi)(GL_EXTENSIONS, i),
+				extension)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* not reached by the readbacks */
+
+TFBVersion getTFBVersion()
+{
+	return TFBVersion_None;
+}
+
+int saveGLState(void)
+{
+	abort();
+}
+
+int restoreGLState(void)
+{
+	abort();
+}
+
+const char *lookupEnum(GLenum e)
+{
+	UNUSED_ARG(e)
+	return "";
+}
+
+char *dissectBitfield(GLbitfield b)
+{
+	UNUSED_ARG(b)
+	return NULL;
+}
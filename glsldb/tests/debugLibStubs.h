@@ -0,0 +1,68 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+/* Stand-ins for the parts of libglsldebug the readback code calls, so that it
+ * can run in a test against an offscreen context instead of in a debuggee.
+ */
+
+#ifndef DEBUG_LIB_STUBS_H
+#define DEBUG_LIB_STUBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Makes a surfaceless desktop GL context current, returns 0 if there is no
+ * EGL display or GL driver to do so.
+ */
+int createStubContext(void);
+void destroyStubContext(void);
+
+/* Creates a second context that shares no objects with the first one, returns
+ * 0 if it cannot. useStubContext makes the first (0) or second (1) current.
+ */
+int createSecondStubContext(void);
+void useStubContext(int second);
+
+/* Claims GL version major.minor and no extensions at all towards the debug
+ * library, to take its paths for old GL versions; 0, 0 reports the context's
+ * own version and extensions again.
+ */
+void setStubGLVersion(int major, int minor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+#ifndef COVERAGE_MAP_TEST_H
+#define COVERAGE_MAP_TEST_H
+
+#include "coverageMap.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestAssert.h>
+#include <string.h>
+
+/* Maps of sizes that are no multiple of the word size, so the tail bits of
+ * the last word are involved in every operation.
+ */
+class CoverageMapTest: public CppUnit::TestFixture {
+public:
+	static CppUnit::TestSuite *suite()
+	{
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite;
+		suiteOfTests->addTest(new CppUnit::TestCaller<CoverageMapTest>(
+				"testTailBits", &CoverageMapTest::testTailBits));
+		suiteOfTests->addTest(new CppUnit::TestCaller<CoverageMapTest>(
+				"testSetFromValues", &CoverageMapTest::testSetFromValues));
+		suiteOfTests->addTest(new CppUnit::TestCaller<CoverageMapTest>(
+				"testSizes", &CoverageMapTest::testSizes));
+		suiteOfTests->addTest(new CppUnit::TestCaller<CoverageMapTest>(
+				"testAssign", &CoverageMapTest::testAssign));
+		suiteOfTests->addTest(new CppUnit::TestCaller<CoverageMapTest>(
+				"testPackRows", &CoverageMapTest::testPackRows));
+		return suiteOfTests;
+	}
+
+	void testTailBits()
+	{
+		CoverageMap m(70, true);
+		CPPUNIT_ASSERT_EQUAL(70, m.count());
+
+		/* refilling a smaller size must not keep the old bits */
+		m.fill(true, 33);
+		CPPUNIT_ASSERT_EQUAL(33, m.count());
+		m.fill(false, 64);
+		m.fill(true);
+		CPPUNIT_ASSERT_EQUAL(64, m.count());
+		m.fill(true, 40);
+		CPPUNIT_ASSERT_EQUAL(40, m.count());
+
+		/* the tail stays clear when combining with a larger map */
+		CoverageMap full(96, true);
+		m.orWith(full);
+		CPPUNIT_ASSERT_EQUAL(40, m.count());
+		CPPUNIT_ASSERT(m == CoverageMap(40, true));
+
+		m.set(39, false);
+		CPPUNIT_ASSERT(!m.test(39));
+		CPPUNIT_ASSERT(m.test(38));
+		CPPUNIT_ASSERT_EQUAL(39, m.count());
+	}
+
+	void testSetFromValues()
+	{
+		float values[3 * 70];
+		CoverageMap m;
+		int i;
+
+		/* only the first of every three values counts */
+		for (i = 0; i < 3 * 70; i++) {
+			values[i] = i % 3 ? 1.0f : (i / 3) % 2 ? 0.8f : 0.2f;
+		}
+		CPPUNIT_ASSERT(m.setFromValues(70, values, 3, 0.5f));
+		CPPUNIT_ASSERT_EQUAL(70, m.getSize());
+		CPPUNIT_ASSERT_EQUAL(35, m.count());
+		for (i = 0; i < 70; i++) {
+			CPPUNIT_ASSERT_EQUAL(i % 2 == 1, m.test(i));
+		}
+
+		/* same values, nothing changed */
+		CPPUNIT_ASSERT(!m.setFromValues(70, values, 3, 0.5f));
+		values[3 * 69] = 0.0f;
+		CPPUNIT_ASSERT(m.setFromValues(70, values, 3, 0.5f));
+		CPPUNIT_ASSERT_EQUAL(34, m.count());
+
+		/* a new size is a change even with the same leading bits */
+		CPPUNIT_ASSERT(m.setFromValues(65, values, 3, 0.5f));
+		CPPUNIT_ASSERT_EQUAL(65, m.getSize());
+		CPPUNIT_ASSERT_EQUAL(32, m.count());
+	}
+
+	void testSizes()
+	{
+		CoverageMap small(33, true), large(70, true);
+
+		/* bits past the size of the other map count as clear there */
+		CPPUNIT_ASSERT_EQUAL(37, large.countAndNot(small));
+		CPPUNIT_ASSERT_EQUAL(0, small.countAndNot(large));
+		CPPUNIT_ASSERT_EQUAL(33, small.countAnd(large));
+		CPPUNIT_ASSERT(large.contains(small));
+		CPPUNIT_ASSERT(!small.contains(large));
+
+		large.andNotWith(small);
+		CPPUNIT_ASSERT_EQUAL(37, large.count());
+		CPPUNIT_ASSERT(!large.test(32));
+		CPPUNIT_ASSERT(large.test(33));
+
+		large.andWith(small);
+		CPPUNIT_ASSERT_EQUAL(0, large.count());
+		CPPUNIT_ASSERT(small.contains(large));
+
+		CoverageMap empty;
+		CPPUNIT_ASSERT(small.contains(empty));
+		CPPUNIT_ASSERT_EQUAL(33, small.countAndNot(empty));
+	}
+
+	void testAssign()
+	{
+		CoverageMap a(70), b(33, true), c(200, true);
+
+		a.set(3);
+		a.set(69);
+		b = a;
+		CPPUNIT_ASSERT(b == a);
+		CPPUNIT_ASSERT_EQUAL(70, b.getSize());
+		CPPUNIT_ASSERT_EQUAL(2, b.count());
+
+		/* shrinking keeps no bits of the larger map */
+		c = CoverageMap(33);
+		CPPUNIT_ASSERT_EQUAL(0, c.count());
+		c.fill(true);
+		CPPUNIT_ASSERT_EQUAL(33, c.count());
+
+		b = b;
+		CPPUNIT_ASSERT(b == a);
+		b.set(4);
+		CPPUNIT_ASSERT(b != a);
+	}
+
+	void testPackRows()
+	{
+		const int width = 37, height = 3, rowWords = 4;
+		unsigned int rows[height * rowWords];
+		CoverageMap m(width * height);
+		int x, y;
+
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < width; x++) {
+				m.set(y * width + x, (x + y) % 3 == 0);
+			}
+		}
+		memset(rows, 0xff, sizeof(rows));
+		m.packRows(width, rowWords, rows);
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < 32 * rowWords; x++) {
+				bool bit = (rows[y * rowWords + x / 32] >> (x % 32)) & 1;
+				CPPUNIT_ASSERT_EQUAL(x < width && (x + y) % 3 == 0, bit);
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,241 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+
+
+#ifndef DBG_SHADER_CACHE_TEST_H
+#define DBG_SHADER_CACHE_TEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestAssert.h>
+#include <stdio.h>
+#include <vector>
+
+extern "C" {
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "shader.h"
+}
+#include "debugLibStubs.h"
+
+/* Fills the debug program cache of loadDbgShader and checks what happens to
+ * the programs it evicts: those of the current context are deleted, those of
+ * another context are only dropped, since their handles may name objects of
+ * the current one. Needs two contexts, see createSecondStubContext.
+ */
+class DbgShaderCacheTest: public CppUnit::TestFixture {
+public:
+	static CppUnit::TestSuite *suite()
+	{
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite;
+		suiteOfTests->addTest(new CppUnit::TestCaller<DbgShaderCacheTest>(
+				"testEvictOwn", &DbgShaderCacheTest::testEvictOwn));
+		suiteOfTests->addTest(new CppUnit::TestCaller<DbgShaderCacheTest>(
+				"testDropOther", &DbgShaderCacheTest::testDropOther));
+		return suiteOfTests;
+	}
+
+	void setUp()
+	{
+		useStubContext(0);
+	}
+
+	void tearDown()
+	{
+		useStubContext(0);
+		ORIG_GL(glUseProgram)(0);
+		freeDbgShaderCache();
+		glError();
+	}
+
+	void testEvictOwn()
+	{
+		std::vector<GLuint> names;
+		GLuint first;
+		int i;
+
+		storeProgram(&names);
+		first = loadProgram(0);
+		for (i = 1; i <= cacheSize; i++) {
+			loadProgram(i);
+		}
+		CPPUNIT_ASSERT_EQUAL((int) cacheSize, getStats(NULL));
+		CPPUNIT_ASSERT(!ORIG_GL(glIsProgram)(first));
+
+		getStats(NULL);
+		loadProgram(1);
+		CPPUNIT_ASSERT_EQUAL((int) cacheSize, getStats(&i));
+		CPPUNIT_ASSERT_EQUAL(1, i);
+
+		restoreProgram(&names);
+	}
+
+	void testDropOther()
+	{
+		std::vector<GLuint> names, otherNames;
+		GLuint handle, maxHandle = 0;
+		GLint deleted;
+		int i, hits;
+
+		/* fill the cache in the first context */
+		storeProgram(&names);
+		for (i = 0; i < cacheSize; i++) {
+			handle = loadProgram(i);
+			maxHandle = handle > maxHandle ? handle : maxHandle;
+		}
+		restoreActiveShader();
+
+		/* every handle of the cache names an object of the second one */
+		useStubContext(1);
+		storeProgram(&otherNames);
+		while (otherNames.back() < maxHandle) {
+			otherNames.push_back(ORIG_GL(glCreateProgram)());
+		}
+		handle = loadProgram(cacheSize);
+		CPPUNIT_ASSERT_EQUAL((int) cacheSize, getStats(NULL));
+		ORIG_GL(glGetProgramiv)(handle, GL_DELETE_STATUS, &deleted);
+		CPPUNIT_ASSERT_EQUAL(GL_FALSE, deleted);
+		for (i = 0; i < (int) otherNames.size(); i++) {
+			CPPUNIT_ASSERT(ORIG_GL(glIsProgram)(otherNames[i])
+					|| ORIG_GL(glIsShader)(otherNames[i]));
+		}
+		restoreProgram(&otherNames);
+		for (i = 0; i < (int) otherNames.size(); i++) {
+			ORIG_GL(glDeleteProgram)(otherNames[i]);
+		}
+		glError();
+
+		/* only the least recently used program was dropped */
+		useStubContext(0);
+		ORIG_GL(glUseProgram)(names.back());
+		storeActiveShader();
+		getStats(NULL);
+		loadProgram(1);
+		getStats(&hits);
+		CPPUNIT_ASSERT_EQUAL(1, hits);
+		loadProgram(0);
+		getStats(&hits);
+		CPPUNIT_ASSERT_EQUAL(0, hits);
+
+		restoreProgram(&names);
+	}
+
+private:
+	/* DBG_PROGRAM_CACHE_SIZE of shader.c */
+	static const int cacheSize = 16;
+
+	static GLuint compileShader(GLenum type, const char *source)
+	{
+		GLuint shader = ORIG_GL(glCreateShader)(type);
+		GLint status;
+
+		ORIG_GL(glShaderSource)(shader, 1, &source, NULL);
+		ORIG_GL(glCompileShader)(shader);
+		ORIG_GL(glGetShaderiv)(shader, GL_COMPILE_STATUS, &status);
+		CPPUNIT_ASSERT(status);
+		return shader;
+	}
+
+	/* makes a program current and stores it as the debugged one; its
+	 * objects are appended to names, the program last
+	 */
+	static void storeProgram(std::vector<GLuint> *names)
+	{
+		GLuint program = ORIG_GL(glCreateProgram)();
+		GLuint vs = compileShader(GL_VERTEX_SHADER, vertexShader);
+		GLuint fs = compileShader(GL_FRAGMENT_SHADER,
+				"#version 120\nvoid main() { gl_FragColor = vec4(1.0); }\n");
+		GLint status;
+
+		ORIG_GL(glAttachShader)(program, vs);
+		ORIG_GL(glAttachShader)(program, fs);
+		ORIG_GL(glLinkProgram)(program);
+		ORIG_GL(glGetProgramiv)(program, GL_LINK_STATUS, &status);
+		CPPUNIT_ASSERT(status);
+		ORIG_GL(glUseProgram)(program);
+		storeActiveShader();
+		CPPUNIT_ASSERT_EQUAL((ALIGNED_DATA) DBG_NO_ERROR,
+				getThreadRecord()->items[0]);
+		names->push_back(vs);
+		names->push_back(fs);
+		names->push_back(program);
+	}
+
+	static void restoreProgram(std::vector<GLuint> *names)
+	{
+		restoreActiveShader();
+		ORIG_GL(glUseProgram)(0);
+		ORIG_GL(glDeleteShader)((*names)[0]);
+		ORIG_GL(glDeleteShader)((*names)[1]);
+		ORIG_GL(glDeleteProgram)((*names)[2]);
+		names->erase(names->begin(), names->begin() + 3);
+		CPPUNIT_ASSERT_EQUAL(0, glError());
+	}
+
+	/* loads the debug program with fragment shader number i, returns it */
+	static GLuint loadProgram(int i)
+	{
+		char fragmentShader[80];
+		GLint program;
+
+		snprintf(fragmentShader, sizeof(fragmentShader),
+				"#version 120\nvoid main() { gl_FragColor = vec4(%i.0); }\n", i);
+		CPPUNIT_ASSERT_EQUAL((int) DBG_NO_ERROR, loadDbgShader(vertexShader,
+				NULL, fragmentShader, DBG_TARGET_FRAGMENT_SHADER, 0));
+		ORIG_GL(glGetIntegerv)(GL_CURRENT_PROGRAM, &program);
+		return (GLuint) program;
+	}
+
+	/* number of cached programs; resets the hit counter */
+	static int getStats(int *hits)
+	{
+		DbgRec *rec = getThreadRecord();
+
+		rec->items[0] = 1;
+		getDbgShaderCacheStats();
+		if (hits) {
+			*hits = (int) rec->items[1];
+		}
+		return (int) rec->items[3];
+	}
+
+	static const char *vertexShader;
+};
+
+const char *DbgShaderCacheTest::vertexShader =
+		"#version 120\nvoid main() { gl_Position = ftransform(); }\n";
+
+#endif
@@ -0,0 +1,257 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+
+
+#ifndef READ_BACK_TEST_H
+#define READ_BACK_TEST_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestAssert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "debuglib.h"
+#include "debuglibInternal.h"
+#include "readback.h"
+}
+#include "debugLibStubs.h"
+
+/* Reads a known float image with every readback path of a fragment shader
+ * step: the pixel pack buffer read of readBackRenderBuffer, its plain
+ * glReadPixels fallback for old GL versions and the fenced reads of a
+ * readback queue. All of them have to deliver the same bytes. Needs a
+ * current context, see createStubContext.
+ */
+class ReadBackTest: public CppUnit::TestFixture {
+public:
+	static CppUnit::TestSuite *suite()
+	{
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite;
+		suiteOfTests->addTest(new CppUnit::TestCaller<ReadBackTest>(
+				"testFlipped", &ReadBackTest::testFlipped));
+		suiteOfTests->addTest(new CppUnit::TestCaller<ReadBackTest>(
+				"testFallback", &ReadBackTest::testFallback));
+		suiteOfTests->addTest(new CppUnit::TestCaller<ReadBackTest>(
+				"testQueue", &ReadBackTest::testQueue));
+		return suiteOfTests;
+	}
+
+	void setUp()
+	{
+		int x, y;
+
+		/* sizes that are no multiple of the mask words or the alignment */
+		image.resize(4 * width * height);
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < width; x++) {
+				float *pixel = &image[4 * (y * width + x)];
+				pixel[0] = (float) x / width;
+				pixel[1] = (float) y / height;
+				pixel[2] = (float) ((7 * x + 3 * y) % 11) / 10.0f;
+				pixel[3] = (float) ((x + y) % 5) - 1.0f;
+			}
+		}
+
+		ORIG_GL(glGenTextures)(1, &texture);
+		ORIG_GL(glBindTexture)(GL_TEXTURE_2D, texture);
+		ORIG_GL(glTexImage2D)(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0,
+				GL_RGBA, GL_FLOAT, &image[0]);
+		ORIG_GL(glGenFramebuffers)(1, &fbo);
+		ORIG_GL(glBindFramebuffer)(GL_FRAMEBUFFER, fbo);
+		ORIG_GL(glFramebufferTexture2D)(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+				GL_TEXTURE_2D, texture, 0);
+		ORIG_GL(glReadBuffer)(GL_COLOR_ATTACHMENT0);
+		ORIG_GL(glViewport)(0, 0, width, height);
+		CPPUNIT_ASSERT_EQUAL((GLenum) GL_FRAMEBUFFER_COMPLETE,
+				ORIG_GL(glCheckFramebufferStatus)(GL_FRAMEBUFFER));
+		CPPUNIT_ASSERT_EQUAL(0, glError());
+	}
+
+	void tearDown()
+	{
+		setStubGLVersion(0, 0);
+		ORIG_GL(glBindFramebuffer)(GL_FRAMEBUFFER, 0);
+		ORIG_GL(glDeleteFramebuffers)(1, &fbo);
+		ORIG_GL(glDeleteTextures)(1, &texture);
+	}
+
+	void testFlipped()
+	{
+		int x, y, w, h;
+		void *buffer;
+		float *rows;
+
+		CPPUNIT_ASSERT_EQUAL(0, readBackRenderBuffer(4, GL_FLOAT, NULL, &w,
+				&h, &buffer, NULL));
+		CPPUNIT_ASSERT_EQUAL(width, w);
+		CPPUNIT_ASSERT_EQUAL(height, h);
+
+		/* the first row of a result is the top one */
+		rows = (float*) buffer;
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < 4 * width; x++) {
+				CPPUNIT_ASSERT_EQUAL(image[(height - 1 - y) * 4 * width + x],
+						rows[y * 4 * width + x]);
+			}
+		}
+		free(buffer);
+	}
+
+	void testFallback()
+	{
+		int i, numCases;
+		const ReadBack *cases = getCases(&numCases);
+
+		for (i = 0; i < numCases; i++) {
+			/* half floats need GL 3.0 and masks are packed with it */
+			if (cases[i].format == GL_HALF_FLOAT) {
+				continue;
+			}
+			ReadBack packBuffer = cases[i], plain = cases[i];
+			readBack(&packBuffer);
+			setStubGLVersion(2, 0);
+			readBack(&plain);
+			setStubGLVersion(0, 0);
+			assertSame(&packBuffer, &plain);
+		}
+	}
+
+	void testQueue()
+	{
+		int i, numCases;
+		const ReadBack *cases = getCases(&numCases);
+		std::vector<ReadBack> queued(cases, cases + numCases);
+		std::vector<ALIGNED_DATA> results(numCases);
+		std::vector<ALIGNED_DATA> items(8 * numCases);
+
+		/* more steps than the queue starts with */
+		beginReadBackQueue();
+		for (i = 0; i < numCases; i++) {
+			setReadBackQueueTarget(&results[i], &items[8 * i]);
+			CPPUNIT_ASSERT(isReadBackQueued());
+			CPPUNIT_ASSERT_EQUAL(0, queueReadBackRenderBuffer(
+					queued[i].numComponents, queued[i].format, queued[i].region,
+					&queued[i].width, &queued[i].height));
+		}
+		CPPUNIT_ASSERT_EQUAL(0, endReadBackQueue());
+
+		for (i = 0; i < numCases; i++) {
+			ReadBack direct = cases[i];
+			/* the stub keeps results out of the arena */
+			CPPUNIT_ASSERT_EQUAL((ALIGNED_DATA) 0, items[8 * i + 3]);
+			queued[i].data = (void*) items[8 * i];
+			readBack(&direct);
+			assertSame(&direct, &queued[i]);
+		}
+	}
+
+private:
+	static const int width = 37;
+	static const int height = 23;
+
+	struct ReadBack {
+		int numComponents;
+		int format;
+		const int *region;
+		int width;
+		int height;
+		void *data;
+	};
+
+	static const ReadBack *getCases(int *numCases)
+	{
+		static const int region[4] = { 5, 3, 17, 11 };
+		static const ReadBack cases[] = {
+			{ 4, GL_FLOAT, NULL, 0, 0, NULL },
+			{ 3, GL_FLOAT, region, 0, 0, NULL },
+			{ 1, GL_FLOAT, NULL, 0, 0, NULL },
+			{ 4, GL_UNSIGNED_BYTE, region, 0, 0, NULL },
+			{ 3, GL_UNSIGNED_BYTE, NULL, 0, 0, NULL },
+			{ 1, GL_UNSIGNED_BYTE, region, 0, 0, NULL },
+			{ 4, GL_HALF_FLOAT, NULL, 0, 0, NULL },
+			{ 1, GL_HALF_FLOAT, region, 0, 0, NULL },
+			{ 1, GL_BITMAP, NULL, 0, 0, NULL },
+			{ 1, GL_BITMAP, region, 0, 0, NULL }
+		};
+		*numCases = sizeof(cases) / sizeof(cases[0]);
+		return cases;
+	}
+
+	static int getSize(const ReadBack *rb)
+	{
+		switch (rb->format) {
+		case GL_BITMAP:
+			return DBG_MASK_ROW_WORDS(rb->width) * sizeof(GLuint) * rb->height;
+		case GL_UNSIGNED_BYTE:
+			return rb->numComponents * rb->width * rb->height;
+		case GL_HALF_FLOAT:
+			return rb->numComponents * rb->width * rb->height * sizeof(GLhalf);
+		default:
+			return rb->numComponents * rb->width * rb->height * sizeof(GLfloat);
+		}
+	}
+
+	void readBack(ReadBack *rb)
+	{
+		CPPUNIT_ASSERT_EQUAL(0, readBackRenderBuffer(rb->numComponents,
+				rb->format, rb->region, &rb->width, &rb->height, &rb->data,
+				NULL));
+	}
+
+	/* frees the data of both */
+	void assertSame(ReadBack *expected, ReadBack *actual)
+	{
+		CPPUNIT_ASSERT_EQUAL(expected->region ? expected->region[2] : width,
+				expected->width);
+		CPPUNIT_ASSERT_EQUAL(expected->region ? expected->region[3] : height,
+				expected->height);
+		CPPUNIT_ASSERT_EQUAL(expected->width, actual->width);
+		CPPUNIT_ASSERT_EQUAL(expected->height, actual->height);
+		CPPUNIT_ASSERT(actual->data != NULL);
+		CPPUNIT_ASSERT(!memcmp(expected->data, actual->data,
+				getSize(expected)));
+		free(expected->data);
+		free(actual->data);
+	}
+
+	std::vector<float> image;
+	GLuint texture;
+	GLuint fbo;
+};
+
+#endif
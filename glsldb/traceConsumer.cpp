@@ -0,0 +1,98 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#include "traceConsumer.h"
+#include "progControl.qt.h"
+
+/* calls decoded per lock of the queue */
+#define TRACE_CHUNK 1024
+/* stop draining while the GUI lags this far behind, the debuggee waits then */
+#define MAX_QUEUED_CALLS (64*1024)
+
+TraceConsumer::TraceConsumer(ProgramControl *i_pPc) :
+		m_pPc(i_pPc), m_bFinish(false)
+{
+}
+
+TraceConsumer::~TraceConsumer()
+{
+	finish();
+	wait();
+	for (size_t i = 0; i < m_calls.size(); i++) {
+		delete m_calls[i];
+	}
+}
+
+void TraceConsumer::finish(void)
+{
+	m_bFinish = true;
+}
+
+void TraceConsumer::takeCalls(std::vector<FunctionCall*> &calls)
+{
+	QMutexLocker locker(&m_qMutex);
+	calls.insert(calls.end(), m_calls.begin(), m_calls.end());
+	m_calls.clear();
+}
+
+void TraceConsumer::run(void)
+{
+	std::vector<FunctionCall*> chunk;
+	size_t numQueued;
+	int numCalls;
+
+	for (;;) {
+		/* read the finish flag first, the last records are in the ring then */
+		bool finishing = m_bFinish;
+
+		m_qMutex.lock();
+		numQueued = m_calls.size();
+		m_qMutex.unlock();
+
+		numCalls = 0;
+		if (finishing || numQueued < MAX_QUEUED_CALLS) {
+			chunk.clear();
+			numCalls = m_pPc->readTrace(chunk, TRACE_CHUNK);
+			if (numCalls) {
+				QMutexLocker locker(&m_qMutex);
+				m_calls.insert(m_calls.end(), chunk.begin(), chunk.end());
+			}
+		}
+		if (!numCalls) {
+			if (finishing) {
+				break;
+			}
+			msleep(1);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+
+Copyright (C) 2006-2009 Institute for Visualization and Interactive Systems
+(VIS), Universität Stuttgart.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+
+  * Redistributions in binary form must reproduce the above copyright notice, this
+	list of conditions and the following disclaimer in the documentation and/or
+	other materials provided with the distribution.
+
+  * Neither the name of the name of VIS, Universität Stuttgart nor the names
+	of its contributors may be used to endorse or promote products derived from
+	this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*******************************************************************************/
+
+#ifndef _TRACE_CONSUMER_H_
+#define _TRACE_CONSUMER_H_
+
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <vector>
+
+#include "functionCall.h"
+
+class ProgramControl;
+
+/* Drains the trace ring of a traced execution in the background, so the
+ * debuggee never waits for the GUI. The decoded calls are queued until the
+ * GUI fetches them with takeCalls().
+ */
+class TraceConsumer: public QThread {
+public:
+	TraceConsumer(ProgramControl *i_pPc);
+	~TraceConsumer();
+
+	/* Stop after the ring was drained completely; the debuggee must not
+	 * execute anymore. Wait for the thread before the last takeCalls().
+	 */
+	void finish(void);
+
+	/* Append all queued calls to calls; the caller owns them afterwards */
+	void takeCalls(std::vector<FunctionCall*> &calls);
+
+protected:
+	void run(void);
+
+private:
+	ProgramControl *m_pPc;
+	QMutex m_qMutex;
+	std::vector<FunctionCall*> m_calls;
+	volatile bool m_bFinish;
+};
+
+#endif
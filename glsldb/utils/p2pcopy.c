@@ -40,7 +40,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osx_ptrace_defs.h"
 #endif /* __APPLE __ */
 #include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <signal.h>
 #include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#ifdef GLSLDB_LINUX
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#endif /* GLSLDB_LINUX */
 #else /* _WIN32 */
 #include <windows.h>
 #endif /* _WIN32 */
@@ -57,31 +65,248 @@ typedef INT_PTR ALIGNED_DATA;
 #endif /* _WIN32 */
 
 #ifdef _WIN32
-void cpyFromProcess(DWORD pid, void *dst, void *src, size_t size) {
-	SIZE_T numBytesRead;
-	HANDLE procHandle = OpenProcess(PROCESS_VM_READ, FALSE, pid);
+static void transferBlocks(DWORD pid, const P2PBlock *blocks, size_t numBlocks,
+		int toProcess)
+{
+	SIZE_T numBytes;
+	size_t i;
+	HANDLE procHandle = OpenProcess(toProcess ?
+			(PROCESS_VM_WRITE | PROCESS_VM_OPERATION) : PROCESS_VM_READ,
+			FALSE, pid);
 	if (procHandle == NULL) {
-		dbgPrint(DBGLVL_ERROR, "cpyFromProcess: could not open process %u\n", procHandle);
-		exit(1);
-	}
-	if (ReadProcessMemory(procHandle, src, dst, size, &numBytesRead) == 0) {
-		dbgPrint(DBGLVL_ERROR, "cpyFromProcess: copying failed: %u\n", GetLastError());
-		CloseHandle(procHandle);
+		dbgPrint(DBGLVL_ERROR, "transferBlocks: could not open process %u\n", procHandle);
 		exit(1);
 	}
-	if (numBytesRead != size) {
-		dbgPrint(DBGLVL_ERROR, "cpyFromProcess: could copy only %u out of %u bytes.\n", numBytesRead, size);
-		CloseHandle(procHandle);
-		exit(1);
+	for (i = 0; i < numBlocks; i++) {
+		BOOL success = toProcess ?
+				WriteProcessMemory(procHandle, blocks[i].remote,
+						blocks[i].local, blocks[i].size, &numBytes) :
+				ReadProcessMemory(procHandle, blocks[i].remote,
+						blocks[i].local, blocks[i].size, &numBytes);
+		if (!success) {
+			dbgPrint(DBGLVL_ERROR, "transferBlocks: copying failed: %u\n", GetLastError());
+			CloseHandle(procHandle);
+			exit(1);
+		}
+		if (numBytes != blocks[i].size) {
+			dbgPrint(DBGLVL_ERROR, "transferBlocks: could copy only %u out of %u bytes.\n", numBytes, blocks[i].size);
+			CloseHandle(procHandle);
+			exit(1);
+		}
 	}
 	CloseHandle(procHandle);
 }
+
+void cpyFromProcess(DWORD pid, void *dst, void *src, size_t size)
+{
+	P2PBlock block;
+	block.local = dst;
+	block.remote = src;
+	block.size = size;
+	transferBlocks(pid, &block, 1, 0);
+}
+
+void cpyToProcess(DWORD pid, void *dst, void *src, size_t size)
+{
+	P2PBlock block;
+	block.local = src;
+	block.remote = dst;
+	block.size = size;
+	transferBlocks(pid, &block, 1, 1);
+}
+
+void cpyFromProcessV(DWORD pid, const P2PBlock *blocks, size_t numBlocks)
+{
+	transferBlocks(pid, blocks, numBlocks, 0);
+}
+
+void cpyToProcessV(DWORD pid, const P2PBlock *blocks, size_t numBlocks)
+{
+	transferBlocks(pid, blocks, numBlocks, 1);
+}
+
+int setP2PCopyMode(int mode)
+{
+	return mode == P2P_COPY_AUTO ? 0 : -1;
+}
+
+void setP2PTraceeRunning(int running)
+{
+	/* no ptrace on windows, the debuggee is always accessible */
+	(void) running;
+}
+
+int getP2PCopyMode(void)
+{
+	return P2P_COPY_AUTO;
+}
 #else /* _WIN32 */
-void cpyFromProcess(pid_t pid, void *dst, void *src, size_t size)
+
+/* Maximum number of bytes handed to the kernel in a single call. Large
+ * transfers are split so that a single request never pins an excessive
+ * amount of memory in the kernel.
+ */
+#define P2P_CHUNK_SIZE (16*1024*1024)
+
+/* Maximum number of iovecs per process_vm_readv/process_vm_writev call */
+#ifdef IOV_MAX
+#  define P2P_MAX_IOV IOV_MAX
+#else
+#  define P2P_MAX_IOV 1024
+#endif
+
+static int copyMode = P2P_COPY_AUTO;
+
+/* cleared once a method failed in a way that will not go away (e.g. missing
+ * kernel support), so that P2P_COPY_AUTO does not retry it on every copy
+ */
+static int vmUsable = 1;
+static int procMemUsable = 1;
+
+/* set while the tracee is not held in a ptrace stop between handshakes */
+static int traceeRunning = 0;
+
+int setP2PCopyMode(int mode)
+{
+#ifndef GLSLDB_LINUX
+	if (mode == P2P_COPY_VM) {
+		return -1;
+	}
+#endif /* !GLSLDB_LINUX */
+	copyMode = mode;
+	return 0;
+}
+
+int getP2PCopyMode(void)
+{
+	return copyMode;
+}
+
+void setP2PTraceeRunning(int running)
+{
+	traceeRunning = running;
+}
+
+#ifdef GLSLDB_LINUX
+/* returns 0 on success, -1 and errno on failure */
+static int vmTransfer(pid_t pid, const P2PBlock *blocks, size_t numBlocks,
+		int toProcess)
+{
+	struct iovec local[P2P_MAX_IOV];
+	struct iovec remote[P2P_MAX_IOV];
+	size_t block = 0, offset = 0;
+
+	while (block < numBlocks) {
+		size_t b = block, o = offset, bytes = 0;
+		int n = 0;
+		ssize_t done;
+
+		/* gather as many (partial) blocks as fit into one call */
+		while (b < numBlocks && n < P2P_MAX_IOV && bytes < P2P_CHUNK_SIZE) {
+			size_t len = blocks[b].size - o;
+			if (len > P2P_CHUNK_SIZE - bytes) {
+				len = P2P_CHUNK_SIZE - bytes;
+			}
+			if (len > 0) {
+				local[n].iov_base = (char*) blocks[b].local + o;
+				local[n].iov_len = len;
+				remote[n].iov_base = (char*) blocks[b].remote + o;
+				remote[n].iov_len = len;
+				n++;
+				bytes += len;
+			}
+			o += len;
+			if (o == blocks[b].size) {
+				b++;
+				o = 0;
+			}
+		}
+		if (n == 0) {
+			break;
+		}
+
+		if (toProcess) {
+			done = process_vm_writev(pid, local, n, remote, n, 0);
+		} else {
+			done = process_vm_readv(pid, local, n, remote, n, 0);
+		}
+		if (done <= 0) {
+			if (done == 0) {
+				errno = EFAULT;
+			}
+			return -1;
+		}
+
+		/* advance by the number of bytes actually transferred */
+		while (done > 0) {
+			size_t len = blocks[block].size - offset;
+			if ((size_t) done < len) {
+				offset += done;
+				done = 0;
+			} else {
+				done -= len;
+				block++;
+				offset = 0;
+			}
+		}
+		while (block < numBlocks && blocks[block].size == 0) {
+			block++;
+		}
+	}
+	return 0;
+}
+#endif /* GLSLDB_LINUX */
+
+/* returns 0 on success, -1 and errno on failure */
+static int procMemTransfer(pid_t pid, const P2PBlock *blocks, size_t numBlocks,
+		int toProcess)
+{
+	char path[64];
+	size_t i;
+	int fd;
+
+	snprintf(path, sizeof(path), "/proc/%i/mem", (int) pid);
+	if ((fd = open(path, toProcess ? O_RDWR : O_RDONLY)) == -1) {
+		return -1;
+	}
+
+	for (i = 0; i < numBlocks; i++) {
+		size_t offset = 0;
+		while (offset < blocks[i].size) {
+			size_t len = blocks[i].size - offset;
+			off_t addr = (off_t) ((uintptr_t) blocks[i].remote + offset);
+			ssize_t done;
+
+			if (len > P2P_CHUNK_SIZE) {
+				len = P2P_CHUNK_SIZE;
+			}
+			if (toProcess) {
+				done = pwrite(fd, (char*) blocks[i].local + offset, len, addr);
+			} else {
+				done = pread(fd, (char*) blocks[i].local + offset, len, addr);
+			}
+			if (done <= 0) {
+				if (done == -1 && errno == EINTR) {
+					continue;
+				}
+				if (done == 0) {
+					errno = EFAULT;
+				}
+				close(fd);
+				return -1;
+			}
+			offset += done;
+		}
+	}
+	close(fd);
+	return 0;
+}
+
+static void ptraceFromProcess(pid_t pid, void *dst, void *src, size_t size)
 {
 	ALIGNED_DATA start, *buffer;
 	size_t count;
-	int i;
+	size_t i;
 
 	/* Round starting address down to word boundary */
 	start = (ALIGNED_DATA) src & -(ALIGNED_DATA) sizeof(ALIGNED_DATA);
@@ -108,34 +333,12 @@ void cpyFromProcess(pid_t pid, void *dst, void *src, size_t size)
 
 	free(buffer);
 }
-#endif /* _WIN32 */
 
-#ifdef _WIN32
-void cpyToProcess(DWORD pid, void *dst, void *src, size_t size) {
-	SIZE_T numBytesWritten;
-	HANDLE procHandle = OpenProcess(PROCESS_VM_WRITE | PROCESS_VM_OPERATION, FALSE, pid);
-	if (procHandle == NULL) {
-		dbgPrint(DBGLVL_ERROR, "cpyToProcess: could not open process %u\n", procHandle);
-		exit(1);
-	}
-	if (WriteProcessMemory(procHandle, dst, src, size, &numBytesWritten) == 0) {
-		dbgPrint(DBGLVL_ERROR, "cpyToProcess: copying failed: %u\n", GetLastError());
-		CloseHandle(procHandle);
-		exit(1);
-	}
-	if (numBytesWritten != size) {
-		dbgPrint(DBGLVL_ERROR, "cpyToProcess: could copy only %u out of %u bytes.\n", numBytesWritten, size);
-		CloseHandle(procHandle);
-		exit(1);
-	}
-	CloseHandle(procHandle);
-}
-#else /* _WIN32 */
-void cpyToProcess(pid_t pid, void *dst, void *src, size_t size)
+static void ptraceToProcess(pid_t pid, void *dst, void *src, size_t size)
 {
 	ALIGNED_DATA start, *buffer;
 	size_t count;
-	int i;
+	size_t i;
 
 	/* Round starting address down to word boundary */
 	start = (ALIGNED_DATA) dst & -(ALIGNED_DATA) sizeof(ALIGNED_DATA);
@@ -146,7 +349,7 @@ void cpyToProcess(pid_t pid, void *dst, void *src, size_t size)
 
 	buffer = (ALIGNED_DATA*) malloc(count * sizeof(ALIGNED_DATA));
 	if (!buffer) {
-		dbgPrint(DBGLVL_ERROR, "cpyFromProcess: Could not allocate buffer\n");
+		dbgPrint(DBGLVL_ERROR, "cpyToProcess: Could not allocate buffer\n");
 		exit(1);
 	}
 
@@ -168,5 +371,149 @@ void cpyToProcess(pid_t pid, void *dst, void *src, size_t size)
 	}
 	free(buffer);
 }
-#endif /* _WIN32 */
 
+/* PTRACE_PEEKTEXT/PTRACE_POKETEXT fail with ESRCH unless the tracee is in a
+ * ptrace stop. Stops only the traced thread itself, a process-wide SIGSTOP
+ * would put the other (untraced) threads into a group stop that a
+ * PTRACE_CONT does not end. Returns the signal to hand back on continuing.
+ */
+static int stopTracee(pid_t pid)
+{
+	int status;
+	pid_t result;
+
+#ifdef GLSLDB_LINUX
+	result = (pid_t) syscall(SYS_tgkill, pid, pid, SIGSTOP);
+#else /* GLSLDB_LINUX */
+	result = kill(pid, SIGSTOP);
+#endif /* GLSLDB_LINUX */
+	if (result == -1) {
+		dbgPrint(DBGLVL_ERROR, "stopping tracee %i failed: %s\n", (int) pid,
+				strerror(errno));
+		exit(1);
+	}
+	do {
+		result = waitpid(pid, &status, WUNTRACED);
+	} while (result == -1 && errno == EINTR);
+	if (result == -1 || !WIFSTOPPED(status)) {
+		dbgPrint(DBGLVL_ERROR, "tracee %i did not stop for a ptrace transfer\n",
+				(int) pid);
+		exit(1);
+	}
+	/* A stop for some other reason came first. That one is just as good for
+	 * the transfer, our SIGSTOP stays pending and is taken as a stray stop by
+	 * the next status check.
+	 */
+	if ((status >> 16) != 0 || WSTOPSIG(status) == SIGSTOP) {
+		return 0;
+	}
+	return WSTOPSIG(status);
+}
+
+static void continueTracee(pid_t pid, int sig)
+{
+	ptrace(PTRACE_CONT, pid, 0, (void*) (intptr_t) sig);
+}
+
+/* errors that are a property of the system rather than of this transfer */
+static int isPermanentFailure(int error)
+{
+	return error == ENOSYS || error == EPERM || error == EACCES
+			|| error == ENOENT;
+}
+
+static void transferBlocks(pid_t pid, const P2PBlock *blocks, size_t numBlocks,
+		int toProcess)
+{
+	size_t i;
+	int sig = 0;
+
+	if (numBlocks == 0) {
+		return;
+	}
+
+#ifdef GLSLDB_LINUX
+	if ((copyMode == P2P_COPY_AUTO && vmUsable) || copyMode == P2P_COPY_VM) {
+		if (vmTransfer(pid, blocks, numBlocks, toProcess) == 0) {
+			return;
+		}
+		if (copyMode == P2P_COPY_VM) {
+			dbgPrint(DBGLVL_ERROR, "%s failed: %s\n",
+					toProcess ? "process_vm_writev" : "process_vm_readv",
+					strerror(errno));
+			exit(1);
+		}
+		dbgPrint(DBGLVL_WARNING, "%s failed: %s, falling back\n",
+				toProcess ? "process_vm_writev" : "process_vm_readv",
+				strerror(errno));
+		if (isPermanentFailure(errno)) {
+			vmUsable = 0;
+		}
+	}
+#endif /* GLSLDB_LINUX */
+
+	if ((copyMode == P2P_COPY_AUTO && procMemUsable)
+			|| copyMode == P2P_COPY_PROCMEM) {
+		if (procMemTransfer(pid, blocks, numBlocks, toProcess) == 0) {
+			return;
+		}
+		if (copyMode == P2P_COPY_PROCMEM) {
+			dbgPrint(DBGLVL_ERROR, "/proc/%i/mem transfer failed: %s\n",
+					(int) pid, strerror(errno));
+			exit(1);
+		}
+		dbgPrint(DBGLVL_WARNING, "/proc/%i/mem transfer failed: %s, "
+				"falling back to ptrace\n", (int) pid, strerror(errno));
+		if (isPermanentFailure(errno)) {
+			procMemUsable = 0;
+		}
+	}
+
+	if (traceeRunning) {
+		sig = stopTracee(pid);
+	}
+	for (i = 0; i < numBlocks; i++) {
+		if (blocks[i].size == 0) {
+			continue;
+		}
+		if (toProcess) {
+			ptraceToProcess(pid, blocks[i].remote, blocks[i].local,
+					blocks[i].size);
+		} else {
+			ptraceFromProcess(pid, blocks[i].local, blocks[i].remote,
+					blocks[i].size);
+		}
+	}
+	if (traceeRunning) {
+		continueTracee(pid, sig);
+	}
+}
+
+void cpyFromProcess(pid_t pid, void *dst, void *src, size_t size)
+{
+	P2PBlock block;
+	block.local = dst;
+	block.remote = src;
+	block.size = size;
+	transferBlocks(pid, &block, 1, 0);
+}
+
+void cpyToProcess(pid_t pid, void *dst, void *src, size_t size)
+{
+	P2PBlock block;
+	block.local = src;
+	block.remote = dst;
+	block.size = size;
+	transferBlocks(pid, &block, 1, 1);
+}
+
+void cpyFromProcessV(pid_t pid, const P2PBlock *blocks, size_t numBlocks)
+{
+	transferBlocks(pid, blocks, numBlocks, 0);
+}
+
+void cpyToProcessV(pid_t pid, const P2PBlock *blocks, size_t numBlocks)
+{
+	transferBlocks(pid, blocks, numBlocks, 1);
+}
+#endif /* _WIN32 */
@@ -62,4 +62,56 @@ void cpyToProcess(DWORD pid, void *dst, void *src, size_t size);
 UTILSLOCAL void cpyToProcess(pid_t pid, void *dst, void *src, size_t size);
 #endif /* _WIN32 */
 
+/* a single block of a scatter/gather transfer: <size> bytes at local address
+ * <local> correspond to <size> bytes at address <remote> in the other process
+ */
+typedef struct {
+	void *local;
+	void *remote;
+	size_t size;
+} P2PBlock;
+
+/* copy <numBlocks> blocks from process <pid> to local memory, i.e. from
+ * blocks[i].remote to blocks[i].local
+ */
+#ifdef _WIN32
+void cpyFromProcessV(DWORD pid, const P2PBlock *blocks, size_t numBlocks);
+#else /* _WIN32 */
+UTILSLOCAL void cpyFromProcessV(pid_t pid, const P2PBlock *blocks,
+		size_t numBlocks);
+#endif /* _WIN32 */
+
+/* copy <numBlocks> blocks from local memory to process <pid>, i.e. from
+ * blocks[i].local to blocks[i].remote
+ */
+#ifdef _WIN32
+void cpyToProcessV(DWORD pid, const P2PBlock *blocks, size_t numBlocks);
+#else /* _WIN32 */
+UTILSLOCAL void cpyToProcessV(pid_t pid, const P2PBlock *blocks,
+		size_t numBlocks);
+#endif /* _WIN32 */
+
+/* transfer methods used on unix; P2P_COPY_AUTO picks the fastest one that
+ * works and falls back to the next one on failure
+ */
+enum P2P_COPY_MODES {
+	P2P_COPY_AUTO = 0,
+	P2P_COPY_VM,      /* process_vm_readv/process_vm_writev */
+	P2P_COPY_PROCMEM, /* pread/pwrite on /proc/<pid>/mem */
+	P2P_COPY_PTRACE   /* PTRACE_PEEKTEXT/PTRACE_POKETEXT, word by word */
+};
+
+/* force a transfer method (e.g. for benchmarking); returns -1 if the method
+ * is not available on this platform. A forced method does not fall back, a
+ * failing transfer is fatal as with any other copy error.
+ */
+UTILSLOCAL int setP2PCopyMode(int mode);
+UTILSLOCAL int getP2PCopyMode(void);
+
+/* tell the ptrace transfer whether the debuggee may be running while it is
+ * accessed, i.e. whether it waits in a doorbell handshake instead of a ptrace
+ * stop. If so, each ptrace transfer stops the traced thread for its duration.
+ */
+UTILSLOCAL void setP2PTraceeRunning(int running);
+
 #endif
@@ -39,6 +39,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <errno.h>
 #include <fcntl.h>
 #include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#ifdef GLSLDB_LINUX
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif /* GLSLDB_LINUX */
 
 #ifdef __MACH__
 #include <mach/clock.h>
@@ -190,3 +196,132 @@ int deleteIpcEvent(IpcEvent evt)
 	return ((sem_close(evt) == -1) ? errno : 0);
 #endif /* _WIN32 */
 }
+
+/* number of polls before a waiter goes to sleep */
+#define SHM_EVENT_SPIN_COUNT 4000
+/* sleep interval of the polling fallback in microseconds */
+#ifdef _WIN32
+#define SHM_EVENT_POLL_INTERVAL 1000
+#else /* _WIN32 */
+#define SHM_EVENT_POLL_INTERVAL 100
+#endif /* _WIN32 */
+
+#ifdef _WIN32
+#define SHM_EVENT_CAS(p, o, n) \
+	(InterlockedCompareExchange((volatile LONG*)(p), (n), (o)) == (o))
+#define SHM_EVENT_XCHG(p, n) InterlockedExchange((volatile LONG*)(p), (n))
+#define SHM_EVENT_ADD(p, n) InterlockedExchangeAdd((volatile LONG*)(p), (n))
+#else /* _WIN32 */
+#define SHM_EVENT_CAS(p, o, n) __sync_bool_compare_and_swap((p), (o), (n))
+#define SHM_EVENT_XCHG(p, n) __sync_lock_test_and_set((p), (n))
+#define SHM_EVENT_ADD(p, n) __sync_fetch_and_add((p), (n))
+#endif /* _WIN32 */
+
+static int tryResetShmEvent(ShmEvent *evt)
+{
+	return SHM_EVENT_CAS(&evt->state, 1, 0);
+}
+
+/* spinning only pays off if the other side can run meanwhile */
+static int getShmEventSpinCount(void)
+{
+	static int spinCount = -1;
+
+	if (spinCount < 0) {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		spinCount = info.dwNumberOfProcessors > 1 ? SHM_EVENT_SPIN_COUNT : 0;
+#else /* _WIN32 */
+		spinCount = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_EVENT_SPIN_COUNT : 0;
+#endif /* _WIN32 */
+	}
+	return spinCount;
+}
+
+/*
+ * ::initShmEvent
+ */
+void initShmEvent(ShmEvent *evt, const int isInitiallySet)
+{
+	evt->state = isInitiallySet ? 1 : 0;
+	evt->waiters = 0;
+}
+
+/*
+ * ::setShmEvent
+ */
+int setShmEvent(ShmEvent *evt)
+{
+	SHM_EVENT_XCHG(&evt->state, 1);
+#ifdef GLSLDB_LINUX
+	/* the exchange is a full barrier, so a waiter either sees the new state
+	 * or is already registered here */
+	if (evt->waiters
+			&& syscall(SYS_futex, &evt->state, FUTEX_WAKE, 1, NULL, NULL, 0)
+					== -1) {
+		return errno;
+	}
+#endif /* GLSLDB_LINUX */
+	return 0;
+}
+
+/*
+ * ::waitShmEvent
+ */
+int waitShmEvent(ShmEvent *evt, int timeout)
+{
+	int i;
+#ifdef GLSLDB_LINUX
+	struct timespec ts, *pts = NULL;
+	int retval = 0;
+#else /* GLSLDB_LINUX */
+	long polls;
+#endif /* GLSLDB_LINUX */
+
+	for (i = getShmEventSpinCount(); i > 0; i--) {
+		if (evt->state && tryResetShmEvent(evt)) {
+			return 0;
+		}
+	}
+
+#ifdef GLSLDB_LINUX
+	if (timeout != TIMEOUT_INFINITE) {
+		ts.tv_sec = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000;
+		pts = &ts;
+	}
+
+	SHM_EVENT_ADD(&evt->waiters, 1);
+	while (!tryResetShmEvent(evt)) {
+		/* relative timeout, restarted on spurious wake-ups */
+		if (syscall(SYS_futex, &evt->state, FUTEX_WAIT, 0, pts, NULL, 0) == -1
+				&& errno != EAGAIN && errno != EINTR) {
+			retval = errno;
+			break;
+		}
+	}
+	SHM_EVENT_ADD(&evt->waiters, -1);
+	return retval;
+#else /* GLSLDB_LINUX */
+	polls = (long) timeout * 1000 / SHM_EVENT_POLL_INTERVAL;
+	while (!tryResetShmEvent(evt)) {
+		if (timeout != TIMEOUT_INFINITE && polls-- <= 0) {
+#ifdef _WIN32
+			return ERROR_TIMEOUT;
+#else /* _WIN32 */
+			return ETIMEDOUT;
+#endif /* _WIN32 */
+		}
+#ifdef _WIN32
+		Sleep(SHM_EVENT_POLL_INTERVAL / 1000);
+#else /* _WIN32 */
+		{
+			struct timespec ts = { 0, SHM_EVENT_POLL_INTERVAL * 1000 };
+			nanosleep(&ts, NULL);
+		}
+#endif /* _WIN32 */
+	}
+	return 0;
+#endif /* GLSLDB_LINUX */
+}
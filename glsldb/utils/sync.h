@@ -107,6 +107,43 @@ typedef pthread_mutex_t ThdLock;
 #define deleteThdLock(lock) pthread_mutex_destroy(lock)
 #endif /* _WIN32 */
 
+/**
+ * Atomically replace the pointer sized integer at 'ptr' by 'newval' if it
+ * equals 'oldval'. Works across processes on shared memory.
+ *
+ * @return non-zero if the value has been replaced.
+ */
+#ifdef _WIN32
+#define casIntPtr(ptr, oldval, newval) \
+	(InterlockedCompareExchangePointer((PVOID volatile *)(ptr), \
+		(PVOID)(newval), (PVOID)(oldval)) == (PVOID)(oldval))
+#else /* _WIN32 */
+#define casIntPtr(ptr, oldval, newval) \
+	__sync_bool_compare_and_swap(ptr, oldval, newval)
+#endif /* _WIN32 */
+
+/**
+ * Atomically add 'value' to the pointer sized integer at 'ptr'.
+ *
+ * @return the previous value.
+ */
+#ifdef _WIN64
+#define fetchAddIntPtr(ptr, value) \
+	InterlockedExchangeAdd64((LONGLONG volatile *)(ptr), (LONGLONG)(value))
+#elif defined(_WIN32)
+#define fetchAddIntPtr(ptr, value) \
+	InterlockedExchangeAdd((LONG volatile *)(ptr), (LONG)(value))
+#else /* _WIN64 */
+#define fetchAddIntPtr(ptr, value) __sync_fetch_and_add(ptr, value)
+#endif /* _WIN64 */
+
+/** Full memory barrier, e.g. before publishing data to another process. */
+#ifdef _WIN32
+#define memoryBarrier() MemoryBarrier()
+#else /* _WIN32 */
+#define memoryBarrier() __sync_synchronize()
+#endif /* _WIN32 */
+
 /** An event object for interprocess synchronisation. */
 #ifdef _WIN32
 typedef HANDLE IpcEvent;
@@ -170,6 +207,46 @@ int waitIpcEvent(IpcEvent evt, int timeout);
  */
 int deleteIpcEvent(IpcEvent evt);
 
+/**
+ * An event object for synchronising processes that lives in memory shared by
+ * them, e.g. a shared memory segment. It needs no kernel object: waiting spins
+ * for a short while and then sleeps on a futex (Linux) or polls.
+ */
+typedef struct {
+	volatile int state;
+	volatile int waiters;
+} ShmEvent;
+
+/**
+ * Initialise an event in shared memory. Must be called by exactly one of the
+ * processes before any other operation on the event.
+ *
+ * @param evt            The event to be initialised.
+ * @param isInitiallySet If TRUE, the event is initially set.
+ */
+void initShmEvent(ShmEvent *evt, const int isInitiallySet);
+
+/**
+ * Signal the event.
+ *
+ * Only a single waiting thread is released if the event enters signaled state.
+ *
+ * @param evt The event to be signaled.
+ *
+ * @return 0 in case of success, a system error code otherwise.
+ */
+int setShmEvent(ShmEvent *evt);
+
+/**
+ * Wait for the event to enter signaled state and reset it.
+ *
+ * @param evt     The event to wait for.
+ * @param timeout Timeout in milliseconds or TIMEOUT_INFINITE.
+ *
+ * @return 0 in case of success, a system error code otherwise.
+ */
+int waitShmEvent(ShmEvent *evt, int timeout);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
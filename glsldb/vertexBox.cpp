@@ -53,7 +53,7 @@ VertexBox::VertexBox(QObject *i_qParent) :
 }
 
 VertexBox::VertexBox(float *i_pData, int i_numElementsPerVertex,
-		int i_numVertices, int i_numPrimitives, bool *i_pCoverage,
+		int i_numVertices, int i_numPrimitives, CoverageMap *i_pCoverage,
 		QObject *i_qParent)
 {
 	UNUSED_ARG(i_qParent)
@@ -65,7 +65,7 @@ VertexBox::~VertexBox()
 {
 	emit dataDeleted();
 	delete[] m_pData;
-	delete[] m_pDataMap;
+	delete m_pDataMap;
 	delete[] m_nMinData;
 	delete[] m_nMaxData;
 	delete[] m_nAbsMinData;
@@ -75,7 +75,7 @@ VertexBox::~VertexBox()
 void VertexBox::copyFrom(VertexBox *src)
 {
 	delete[] m_pData;
-	delete[] m_pDataMap;
+	delete m_pDataMap;
 	delete[] m_nMinData;
 	delete[] m_nMaxData;
 	delete[] m_nAbsMinData;
@@ -86,11 +86,10 @@ void VertexBox::copyFrom(VertexBox *src)
 	m_numPrimitives = src->m_numPrimitives;
 
 	m_pData = new float[m_numVertices * m_numElementsPerVertex];
-	m_pDataMap = new bool[m_numVertices];
+	m_pDataMap = src->m_pDataMap ? new CoverageMap(*src->m_pDataMap) : NULL;
 
 	memcpy(m_pData, src->m_pData,
 			m_numVertices * m_numElementsPerVertex * sizeof(float));
-	memcpy(m_pDataMap, src->m_pDataMap, m_numVertices * sizeof(bool));
 
 	m_pCoverage = src->m_pCoverage;
 
@@ -108,14 +107,25 @@ void VertexBox::copyFrom(VertexBox *src)
 
 }
 
-void VertexBox::setData(float *i_pData, int i_numElementsPerVertex,
-		int i_numVertices, int i_numPrimitives, bool *i_pCoverage)
+void VertexBox::copyElementFrom(VertexBox *src, int numElement)
 {
+	float *data = new float[src->m_numVertices];
 	int i;
 
+	for (i = 0; i < src->m_numVertices; i++) {
+		data[i] = src->m_pData[i * src->m_numElementsPerVertex + numElement];
+	}
+	setData(data, 1, src->m_numVertices, src->m_numPrimitives,
+			src->m_pCoverage);
+	delete[] data;
+}
+
+void VertexBox::setData(float *i_pData, int i_numElementsPerVertex,
+		int i_numVertices, int i_numPrimitives, CoverageMap *i_pCoverage)
+{
 	if (m_numVertices > 0) {
 		delete[] m_pData;
-		delete[] m_pDataMap;
+		delete m_pDataMap;
 		delete[] m_nMinData;
 		delete[] m_nMaxData;
 		delete[] m_nAbsMinData;
@@ -125,19 +135,15 @@ void VertexBox::setData(float *i_pData, int i_numElementsPerVertex,
 	}
 	if (i_numVertices > 0 && i_pData) {
 		m_pData = new float[i_numVertices * i_numElementsPerVertex];
-		m_pDataMap = new bool[i_numVertices];
 		memcpy(m_pData, i_pData,
 				i_numVertices * i_numElementsPerVertex * sizeof(float));
 		m_numElementsPerVertex = i_numElementsPerVertex;
 		m_numVertices = i_numVertices;
 		m_numPrimitives = i_numPrimitives;
 		/* Initially use all given data */
+		m_pDataMap = new CoverageMap(m_numVertices, true);
 		if (i_pCoverage) {
-			memcpy(m_pDataMap, i_pCoverage, m_numVertices * sizeof(bool));
-		} else {
-			for (i = 0; i < m_numVertices; i++) {
-				m_pDataMap[i] = true;
-			}
+			m_pDataMap->andWith(*i_pCoverage);
 		}
 		m_pCoverage = i_pCoverage;
 
@@ -165,44 +171,17 @@ void VertexBox::setData(float *i_pData, int i_numElementsPerVertex,
 	emit dataChanged();
 }
 
-bool* VertexBox::getCoverageFromData(bool *oldCoverage, bool *coverageChanged)
+bool VertexBox::getCoverageFromData(CoverageMap *coverage)
 {
-	int i;
-	float *pData;
-	bool *pCoverage, *pOldCoverage;
-	bool *coverage = new bool[m_numVertices];
-
-	if (oldCoverage) {
-		*coverageChanged = false;
-	} else {
-		*coverageChanged = true;
-	}
-
-	pCoverage = coverage;
-	pOldCoverage = oldCoverage;
-	pData = m_pData;
-
-	for (i = 0; i < m_numVertices; i++) {
-		if (*pData > 0.5f) {
-			*pCoverage = true;
-		} else {
-			*pCoverage = false;
-		}
-		if (oldCoverage && *pCoverage != *pOldCoverage) {
-			*coverageChanged = true;
-		}
-		pOldCoverage++;
-		pCoverage++;
-		pData += m_numElementsPerVertex;
-	}
-	return coverage;
+	return coverage->setFromValues(m_numVertices, m_pData,
+			m_numElementsPerVertex, 0.5f);
 }
 
 void VertexBox::addVertexBox(VertexBox *f)
 {
 	int i, j;
 	float *pDstData, *pSrcData;
-	bool *pDstDataMap, *pSrcDataMap;
+	CoverageMap *pSrcDataMap;
 
 	if (m_numVertices != f->getNumVertices()
 			|| m_numPrimitives != f->getNumPrimitives()
@@ -211,25 +190,20 @@ void VertexBox::addVertexBox(VertexBox *f)
 	}
 
 	pDstData = m_pData;
-	pDstDataMap = m_pDataMap;
-
 	pSrcData = f->getDataPointer();
 	pSrcDataMap = f->getDataMapPointer();
 
 	for (i = 0; i < m_numVertices; i++) {
 		for (j = 0; j < m_numElementsPerVertex; j++) {
-			if (*pSrcDataMap) {
-				*pDstDataMap = true;
+			if (pSrcDataMap->test(i)) {
 				*pDstData = *pSrcData;
-				pDstData++;
-				pSrcData++;
-			} else {
-				pDstData++;
-				pSrcData++;
 			}
+			pDstData++;
+			pSrcData++;
 		}
-		pDstDataMap++;
-		pSrcDataMap++;
+	}
+	if (m_pDataMap) {
+		m_pDataMap->orWith(*pSrcDataMap);
 	}
 	calcMinMax();
 
@@ -240,7 +214,7 @@ void VertexBox::calcMinMax()
 {
 	int v, c;
 	float *pData;
-	bool *pCoverage;
+	CoverageMap *pCoverage;
 
 	for (c = 0; c < m_numElementsPerVertex; c++) {
 		m_nMinData[c] = FLT_MAX;
@@ -259,7 +233,7 @@ void VertexBox::calcMinMax()
 
 	for (v = 0; v < m_numVertices; v++) {
 		for (c = 0; c < m_numElementsPerVertex; c++) {
-			if (*pCoverage) {
+			if (pCoverage->test(v)) {
 				if (*pData < m_nMinData[c]) {
 					m_nMinData[c] = *pData;
 				}
@@ -275,7 +249,6 @@ void VertexBox::calcMinMax()
 			}
 			pData++;
 		}
-		pCoverage++;
 	}
 }
 
@@ -361,17 +334,13 @@ float VertexBox::getAbsMax(int element)
 
 void VertexBox::invalidateData()
 {
-	int i, c;
-	bool *pDataMap;
+	int c;
 
 	if (!m_pDataMap) {
 		return;
 	}
 	dbgPrint(DBGLVL_DEBUG, "VertexBox::invalidateData()\n");
-	pDataMap = m_pDataMap;
-	for (i = 0; i < m_numVertices; i++) {
-		*pDataMap++ = false;
-	}
+	m_pDataMap->fill(false);
 	for (c = 0; c < m_numElementsPerVertex; c++) {
 		m_nMinData[c] = 0.f;
 		m_nMaxData[c] = 0.f;
@@ -384,14 +353,14 @@ void VertexBox::invalidateData()
 bool VertexBox::getDataValue(int numVertex, float *v)
 {
 	int i;
-	bool *pCoverage;
+	CoverageMap *pCoverage;
 
 	if (m_pCoverage) {
 		pCoverage = m_pCoverage;
 	} else {
 		pCoverage = m_pDataMap;
 	}
-	if (pCoverage && m_pData && pCoverage[numVertex * m_numElementsPerVertex]) {
+	if (pCoverage && m_pData && pCoverage->test(numVertex)) {
 		for (i = 0; i < m_numElementsPerVertex; i++) {
 			v[i] = m_pData[m_numElementsPerVertex * numVertex + i];
 		}
@@ -404,14 +373,14 @@ bool VertexBox::getDataValue(int numVertex, float *v)
 bool VertexBox::getDataValue(int numVertex, QVariant *v)
 {
 	int i;
-	bool *pCoverage;
+	CoverageMap *pCoverage;
 
 	if (m_pCoverage) {
 		pCoverage = m_pCoverage;
 	} else {
 		pCoverage = m_pDataMap;
 	}
-	if (pCoverage && m_pData && pCoverage[numVertex * m_numElementsPerVertex]) {
+	if (pCoverage && m_pData && pCoverage->test(numVertex)) {
 		for (i = 0; i < m_numElementsPerVertex; i++) {
 			v[i] = m_pData[m_numElementsPerVertex * numVertex + i];
 		}
@@ -37,33 +37,40 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QtCore/QObject>
 #include <QtCore/QVariant>
 
+#include "coverageMap.h"
+
 class VertexBox: public QObject {
 Q_OBJECT
 
 public:
 	VertexBox(QObject *i_qParent = 0);
 	VertexBox(float *i_pData, int numElementsPerVertex, int numVertices,
-			int numPrimitives, bool *i_pCoverage, QObject *i_qParent = 0);
+			int numPrimitives, CoverageMap *i_pCoverage, QObject *i_qParent = 0);
 	~VertexBox();
 
 	void copyFrom(VertexBox* src);
+	/* take element numElement of every vertex of src as the only element */
+	void copyElementFrom(VertexBox* src, int numElement);
 
 	void setData(float *i_pData, int numElementsPerVertex, int numVertices,
-			int numPrimitives, bool *i_pCoverage = 0);
+			int numPrimitives, CoverageMap *i_pCoverage = 0);
 
 	void addVertexBox(VertexBox *f);
 
-	void setNewCoverage(bool* i_pCoverage)
+	void setNewCoverage(CoverageMap* i_pCoverage)
 	{
 		m_pCoverage = i_pCoverage;
 	}
 
-	bool* getCoverageFromData(bool *oldCoverage, bool *coverageChanged);
-	bool* getCoveragePointer(void)
+	/* Sets the vertices with a first element above 0.5 in coverage, returns
+	 * whether it changed.
+	 */
+	bool getCoverageFromData(CoverageMap *coverage);
+	CoverageMap* getCoveragePointer(void)
 	{
 		return m_pCoverage;
 	}
-	bool* getDataMapPointer(void)
+	CoverageMap* getDataMapPointer(void)
 	{
 		return m_pDataMap;
 	}
@@ -104,8 +111,8 @@ private:
 	void calcMinMax();
 
 	float *m_pData;
-	bool *m_pDataMap;
-	bool *m_pCoverage;
+	CoverageMap *m_pDataMap;
+	CoverageMap *m_pCoverage;
 	int m_numElementsPerVertex;
 	int m_numVertices;
 	int m_numPrimitives;
@@ -63,7 +63,8 @@ bool VertexTableModel::addVertexBox(VertexBox *vb, QString &name)
 	return true;
 }
 
-void VertexTableModel::setCondition(VertexBox *condition, bool *initialCoverage)
+void VertexTableModel::setCondition(VertexBox *condition,
+		CoverageMap *initialCoverage)
 {
 	m_condition = condition;
 	m_pInitialCoverage = initialCoverage;
@@ -100,8 +101,8 @@ QVariant VertexTableModel::data(const QModelIndex &index, int role) const
 		switch (role) {
 		case Qt::DisplayRole:
 			if (m_pInitialCoverage && index.column() == 0) {
-				if (m_pInitialCoverage[index.row()]) {
-					if (m_condition->getCoveragePointer()[index.row()]
+				if (m_pInitialCoverage->test(index.row())) {
+					if (m_condition->getCoveragePointer()->test(index.row())
 							== true) {
 						if (m_condition->getDataPointer()[index.row()]
 								> 0.75f) {
@@ -115,7 +116,7 @@ QVariant VertexTableModel::data(const QModelIndex &index, int role) const
 				} else {
 					return QVariant("%");
 				}
-			} else if (m_condition->getCoveragePointer()[index.row()]) {
+			} else if (m_condition->getCoveragePointer()->test(index.row())) {
 				if (index.column() == 0) {
 					if (m_condition->getDataPointer()[index.row()] > 0.75f) {
 						return QString("true");
@@ -126,7 +127,7 @@ QVariant VertexTableModel::data(const QModelIndex &index, int role) const
 						return QVariant("false");
 					}
 				} else {
-					if (!m_pData[index.column() - 1]->getDataMapPointer()[index.row()]) {
+					if (!m_pData[index.column() - 1]->getDataMapPointer()->test(index.row())) {
 						return QString("-");
 					} else {
 						return m_pData[index.column() - 1]->getDataPointer()[index.row()];
@@ -137,8 +138,8 @@ QVariant VertexTableModel::data(const QModelIndex &index, int role) const
 			}
 		case Qt::TextColorRole:
 			if (m_pInitialCoverage) {
-				if (m_pInitialCoverage[index.row()]) {
-					if (m_condition->getCoveragePointer()[index.row()]
+				if (m_pInitialCoverage->test(index.row())) {
+					if (m_condition->getCoveragePointer()->test(index.row())
 							== true) {
 						if (m_condition->getDataPointer()[index.row()]
 								> 0.75f) {
@@ -173,9 +174,9 @@ QVariant VertexTableModel::data(const QModelIndex &index, int role) const
 
 		switch (role) {
 		case Qt::DisplayRole:
-			if (!m_pData[index.column()]->getCoveragePointer()[index.row()]) {
+			if (!m_pData[index.column()]->getCoveragePointer()->test(index.row())) {
 				return QString("%");
-			} else if (!m_pData[index.column()]->getDataMapPointer()[index.row()]) {
+			} else if (!m_pData[index.column()]->getDataMapPointer()->test(index.row())) {
 				return QString("-");
 			} else {
 				return m_pData[index.column()]->getDataPointer()[index.row()];
@@ -193,7 +194,7 @@ Qt::ItemFlags VertexTableModel::flags(const QModelIndex &index) const
 				|| index.row() >= m_condition->getNumVertices()) {
 			return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
 		}
-		if (m_condition->getCoveragePointer()[index.row()] == false) {
+		if (m_condition->getCoveragePointer()->test(index.row()) == false) {
 			return 0;
 		} else {
 			return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
@@ -206,7 +207,7 @@ Qt::ItemFlags VertexTableModel::flags(const QModelIndex &index) const
 		}
 
 		if (!m_pData.empty()
-				&& m_pData[0]->getCoveragePointer()[index.row()] == false) {
+				&& m_pData[0]->getCoveragePointer()->test(index.row()) == false) {
 			return 0;
 		} else {
 			return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
@@ -69,7 +69,8 @@ public:
 
 	bool addVertexBox(VertexBox *vb, QString &name);
 
-	void setCondition(VertexBox *condition, bool *initialCoverage = NULL);
+	void setCondition(VertexBox *condition,
+			CoverageMap *initialCoverage = NULL);
 
 	int rowCount(const QModelIndex &parent = QModelIndex()) const;
 	int columnCount(const QModelIndex &parent = QModelIndex()) const;
@@ -99,7 +100,7 @@ private:
 	QList<VertexBox*> m_pData;
 	QList<QString> m_Names;
 	VertexBox *m_condition;
-	bool *m_pInitialCoverage;
+	CoverageMap *m_pInitialCoverage;
 };
 
 #endif
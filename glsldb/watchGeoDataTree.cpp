@@ -341,24 +341,20 @@ void WatchGeoDataTree::updateDataCurrent(float *data, int *count,
 		fabs(max - min) > FLT_EPSILON ? max : 1.0f + min };
 	float *dd = data;
 	float *ds = srcData->getDataPointer();
-	bool *dc = srcData->getCoveragePointer();
-	bool *dm = srcData->getDataMapPointer();
+	CoverageMap *dc = srcData->getCoveragePointer();
+	CoverageMap *dm = srcData->getDataMapPointer();
 
 	clearData(data, srcData->getNumVertices(), dataStride, 0.0f);
 
 	*count = 0;
 	for (int i = 0; i < srcData->getNumVertices(); i++) {
-		if ((dc && !*dc) || (dm && !*dm)) {
+		if ((dc && !dc->test(i)) || (dm && !dm->test(i))) {
 		} else {
 			*dd = getMappedValueF(*ds, mapping, rangeMapping, minmax);
 			dd += dataStride;
 			(*count)++;
 		}
 		ds++;
-		if (dm)
-			dm++;
-		if (dc)
-			dc++;
 	}
 	if (*count > 0) {
 		m_scatterDataElements = *count;
@@ -379,21 +375,19 @@ void WatchGeoDataTree::updateDataVertex(float *data, int *count, int dataStride,
 		fabs(max - min) > FLT_EPSILON ? max : 1.0f + min };
 	float *dd = data;
 	float *ds = srcData->getDataPointer();
-	bool *dm = srcData->getDataMapPointer();
+	CoverageMap *dm = srcData->getDataMapPointer();
 
 	clearData(data, srcData->getNumVertices(), dataStride, 0.0f);
 
 	*count = 0;
 	for (int i = 0; i < srcData->getNumVertices(); i++) {
-		if (dm && !*dm) {
+		if (dm && !dm->test(i)) {
 		} else if (ds[1] > 0.0f) {
 			*dd = getMappedValueF(*ds, mapping, rangeMapping, minmax);
 			dd += dataStride;
 			(*count)++;
 		}
 		ds += 2;
-		if (dm)
-			dm++;
 	}
 
 	if (*count > 0) {
@@ -908,14 +902,13 @@ float WatchGeoDataTree::getDataMin(int column)
 		float min = FLT_MAX;
 		VertexBox *vb = m_dataModel->getDataColumnVertexData(column);
 		float *pData = vb->getDataPointer();
-		bool *pDataMap = vb->getDataMapPointer();
+		CoverageMap *pDataMap = vb->getDataMapPointer();
 
 		for (int i = 0; i < vb->getNumVertices(); i++) {
-			if (*pDataMap && pData[1] > 0.0f && min > pData[0]) {
+			if (pDataMap->test(i) && pData[1] > 0.0f && min > pData[0]) {
 				min = pData[0];
 			}
 			pData += 2;
-			pDataMap += 1;
 		}
 		return min;
 	}
@@ -933,14 +926,13 @@ float WatchGeoDataTree::getDataMax(int column)
 		VertexBox *vb = m_dataModel->getDataColumnVertexData(column);
 
 		float *pData = vb->getDataPointer();
-		bool *pDataMap = vb->getDataMapPointer();
+		CoverageMap *pDataMap = vb->getDataMapPointer();
 
 		for (int i = 0; i < vb->getNumVertices(); i++) {
-			if (*pDataMap && pData[1] > 0.0f && max < pData[0]) {
+			if (pDataMap->test(i) && pData[1] > 0.0f && max < pData[0]) {
 				max = pData[0];
 			}
 			pData += 2;
-			pDataMap += 1;
 		}
 		return max;
 	}
@@ -958,14 +950,13 @@ float WatchGeoDataTree::getDataAbsMin(int column)
 		float min = FLT_MAX;
 		VertexBox *vb = m_dataModel->getDataColumnVertexData(column);
 		float *pData = vb->getDataPointer();
-		bool *pDataMap = vb->getDataMapPointer();
+		CoverageMap *pDataMap = vb->getDataMapPointer();
 
 		for (int i = 0; i < vb->getNumVertices(); i++) {
-			if (*pDataMap && pData[1] > 0.0f && min > fabs(pData[0])) {
+			if (pDataMap->test(i) && pData[1] > 0.0f && min > fabs(pData[0])) {
 				min = fabs(pData[0]);
 			}
 			pData += 2;
-			pDataMap += 1;
 		}
 		return min;
 	}
@@ -983,14 +974,13 @@ float WatchGeoDataTree::getDataAbsMax(int column)
 		float max = 0.0;
 		VertexBox *vb = m_dataModel->getDataColumnVertexData(column);
 		float *pData = vb->getDataPointer();
-		bool *pDataMap = vb->getDataMapPointer();
+		CoverageMap *pDataMap = vb->getDataMapPointer();
 
 		for (int i = 0; i < vb->getNumVertices(); i++) {
-			if (*pDataMap && pData[1] > 0.0f && max < fabs(pData[0])) {
+			if (pDataMap->test(i) && pData[1] > 0.0f && max < fabs(pData[0])) {
 				max = fabs(pData[0]);
 			}
 			pData += 2;
-			pDataMap += 1;
 		}
 		return max;
 	}
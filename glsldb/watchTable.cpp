@@ -288,24 +288,20 @@ void WatchTable::updateDataCurrent(float *data, int *count, int dataStride,
 		fabs(max - min) > FLT_EPSILON ? max : 1.0f + min };
 	float *dd = data;
 	float *ds = srcData->getDataPointer();
-	bool *dc = srcData->getCoveragePointer();
-	bool *dm = srcData->getDataMapPointer();
+	CoverageMap *dc = srcData->getCoveragePointer();
+	CoverageMap *dm = srcData->getDataMapPointer();
 
 	clearData(data, srcData->getNumVertices(), dataStride, 0.0f);
 
 	*count = 0;
 	for (int i = 0; i < srcData->getNumVertices(); i++) {
-		if ((dc && !*dc) || (dm && !*dm)) {
+		if ((dc && !dc->test(i)) || (dm && !dm->test(i))) {
 		} else {
 			*dd = getMappedValueF(*ds, mapping, rangeMapping, minmax);
 			dd += dataStride;
 			(*count)++;
 		}
 		ds++;
-		if (dm)
-			dm++;
-		if (dc)
-			dc++;
 	}
 	if (*count > 0) {
 		m_scatterDataElements = *count;
@@ -170,6 +170,8 @@ WatchVector::WatchVector(QWidget *parent) :
 			SLOT(newSelection(int, int)));
 	connect(m_pImageView, SIGNAL(viewCenterChanged(int, int)), this,
 			SLOT(newViewCenter(int, int)));
+	connect(m_pImageView, SIGNAL(focusRegionChanged(const QRect &)), this,
+			SLOT(newFocusRegion(const QRect &)));
 
 	m_pImageView->setFocusPolicy(Qt::StrongFocus);
 	m_pImageView->setFocus();
@@ -883,12 +885,13 @@ void WatchVector::on_tbSaveImage_clicked()
 	}
 }
 
-static void setImageRedChannel(QImage *image, bool *pCover, int value)
+static void setImageRedChannel(QImage *image, CoverageMap *pCover,
+		int value)
 {
 	for (int y = 0; y < image->height(); y++) {
 		for (int x = 0; x < image->width(); x++) {
 			QColor c(image->pixel(x, y));
-			if (pCover[y * image->width() + x]) {
+			if (pCover->test(y * image->width() + x)) {
 				c.setRed(value);
 			} else {
 				c.setRed(((x / 8) % 2) == ((y / 8) % 2) ? 255 : 204);
@@ -897,12 +900,13 @@ static void setImageRedChannel(QImage *image, bool *pCover, int value)
 		}
 	}
 }
-static void setImageGreenChannel(QImage *image, bool *pCover, int value)
+static void setImageGreenChannel(QImage *image, CoverageMap *pCover,
+		int value)
 {
 	for (int y = 0; y < image->height(); y++) {
 		for (int x = 0; x < image->width(); x++) {
 			QColor c(image->pixel(x, y));
-			if (pCover[y * image->width() + x]) {
+			if (pCover->test(y * image->width() + x)) {
 				c.setGreen(value);
 			} else {
 				c.setGreen(((x / 8) % 2) == ((y / 8) % 2) ? 255 : 204);
@@ -912,12 +916,13 @@ static void setImageGreenChannel(QImage *image, bool *pCover, int value)
 	}
 }
 
-static void setImageBlueChannel(QImage *image, bool *pCover, int value)
+static void setImageBlueChannel(QImage *image, CoverageMap *pCover,
+		int value)
 {
 	for (int y = 0; y < image->height(); y++) {
 		for (int x = 0; x < image->width(); x++) {
 			QColor c(image->pixel(x, y));
-			if (pCover[y * image->width() + x]) {
+			if (pCover->test(y * image->width() + x)) {
 				c.setBlue(value);
 			} else {
 				c.setBlue(((x / 8) % 2) == ((y / 8) % 2) ? 255 : 204);
@@ -933,7 +938,7 @@ QImage* WatchVector::drawNewImage(bool useAlpha)
 	RangeMapping rangemappings[3];
 	float minmax[3][2];
 	int width, height;
-	bool *pCover = NULL;
+	CoverageMap *pCover = NULL;
 	//bool  *pValid[3] = {NULL, NULL, NULL};
 	//float *pData[3] = {NULL, NULL, NULL};
 
@@ -1210,6 +1215,26 @@ void WatchVector::setMinMaxMode()
 	m_pImageView->setMouseMode(ImageView::MM_MINMAX);
 }
 
+void WatchVector::setFocusMode()
+{
+	m_pImageView->setMouseMode(ImageView::MM_FOCUS);
+}
+
+/* The view shows the boxes of the current focus region only */
+void WatchVector::newFocusRegion(const QRect &region)
+{
+	int i;
+
+	for (i = 0; i < MAX_ATTACHMENTS; i++) {
+		if (m_pData[i]) {
+			emit focusRegionChanged(
+					region.isEmpty() ?
+							QRect() : region.translated(m_pData[i]->getOrigin()));
+			return;
+		}
+	}
+}
+
 void WatchVector::updateAllMinMax()
 {
 	on_tbMinRed_clicked();
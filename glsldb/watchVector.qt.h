@@ -90,17 +90,21 @@ public slots:
 	void setZoomMode();
 	void setPickMode();
 	void setMinMaxMode();
+	void setFocusMode();
 	void updateAllMinMax();
 
 signals:
 	void mouseOverValuesChanged(int x, int y, const bool *active,
 			const QVariant *values);
 	void selectionChanged(int x, int y);
+	/* focus region picked in the view, in viewport coordinates */
+	void focusRegionChanged(const QRect &region);
 
 private slots:
 	void setMousePos(int x, int y);
 	void newSelection(int x, int y);
 	void newViewCenter(int x, int y);
+	void newFocusRegion(const QRect &region);
 	void onMinMaxAreaChanged(void);
 
 private:
@@ -0,0 +1,143 @@
+/*
+ * codegenBench.cpp
+ *
+ *  Created on: 16.10.2026
+ *
+ * Generation of debug programs for synthetic fragment shaders of growing
+ * size. Also emits the same token stream into a StringBuffer and, for
+ * comparison, with ralloc_asprintf_append like the output visitor did.
+ *
+ * Usage: codegenBench [number of lines ...]
+ */
+
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "glsldb/utils/benchtime.h"
+#include "interface/StringBuffer.h"
+#include "mesa/util/ralloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define ROUNDS 3
+
+/* A main function with one statement per line, using few variables so that
+ * the compiler does not spend its time in the symbol table.
+ */
+static std::string makeShader(int lines)
+{
+	std::string source = "#version 130\n"
+			"uniform float u;\n"
+			"void main()\n"
+			"{\n"
+			"  float a = u;\n"
+			"  float b = 1.0;\n";
+	char line[128];
+
+	for (int i = 0; i < lines; ++i) {
+		if (i % 2)
+			snprintf(line, sizeof(line), "  b = b * 0.5 + a - %d.25;\n", i % 100);
+		else
+			snprintf(line, sizeof(line), "  a = (a + b) * %d.5;\n", i % 100);
+		source += line;
+	}
+	source += "  gl_FragColor = vec4(a, b, 0.0, 1.0);\n}\n";
+	return source;
+}
+
+/* seconds per debug program of the first statement, -1 on failure */
+static double benchDebugProgram(const std::string& source, size_t* length)
+{
+	TBuiltInResource resources;
+	ShVariableList vl;
+	const char* text = source.c_str();
+	double best = -1.0;
+
+	setTestResources(&resources);
+	ShHandle compiler = ShConstructCompiler(EShLangFragment, EDebugOpIntermediate);
+	if (!compiler)
+		return -1.0;
+
+	if (ShCompile(compiler, &text, 1, EShOptNone, &resources,
+			EDebugOpIntermediate, &vl)) {
+		DbgResult* dr = ShDebugJumpToNext(compiler, EDebugOpIntermediate,
+				DBG_BH_JUMP_INTO);
+		if (dr && dr->status == DBG_RS_STATUS_OK) {
+			for (int round = 0; round < ROUNDS; ++round) {
+				double start = now();
+				char* prog = ShDebugGetProg(compiler, NULL, &vl, DBG_CG_COVERAGE);
+				double elapsed = now() - start;
+				if (!prog)
+					break;
+				*length = strlen(prog);
+				free(prog);
+				if (best < 0.0 || elapsed < best)
+					best = elapsed;
+			}
+		}
+		freeShVariableList(&vl);
+	}
+
+	ShDestruct(compiler);
+	return best;
+}
+
+/* tokens of a statement like the output visitor emits them */
+static const char* tokens[] = { "  ", "a_12", " ", "=", " ", "(", "a_12", " ",
+		"+", " ", "b_13", ")", " ", "*", " ", "1.500000", ";", "\n" };
+#define NUM_TOKENS (sizeof(tokens) / sizeof(tokens[0]))
+
+static double benchStringBuffer(int lines)
+{
+	double start = now();
+	StringBuffer buffer;
+	for (int i = 0; i < lines; ++i)
+		for (size_t t = 0; t < NUM_TOKENS; ++t)
+			buffer.append(tokens[t]);
+	return buffer.length() ? now() - start : -1.0;
+}
+
+static double benchRallocAppend(int lines)
+{
+	double start = now();
+	char* buffer = NULL;
+	for (int i = 0; i < lines; ++i)
+		for (size_t t = 0; t < NUM_TOKENS; ++t)
+			ralloc_asprintf_append(&buffer, "%s", tokens[t]);
+	double elapsed = now() - start;
+	ralloc_free(buffer);
+	return elapsed;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> sizes;
+	for (int i = 1; i < argc; ++i)
+		sizes.push_back(atoi(argv[i]));
+	if (sizes.empty()) {
+		sizes.push_back(1000);
+		sizes.push_back(10000);
+		sizes.push_back(50000);
+	}
+
+	ShInitialize();
+	printf("%8s %12s %14s %14s %14s\n", "lines", "prog bytes", "debug prog ms",
+			"buffer ms", "ralloc ms");
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		size_t length = 0;
+		double prog = benchDebugProgram(makeShader(sizes[i]), &length);
+		double buffer = benchStringBuffer(sizes[i]);
+		double ralloc = benchRallocAppend(sizes[i]);
+		if (prog < 0.0)
+			printf("%8d %12s %14s", sizes[i], "-", "failed");
+		else
+			printf("%8d %12lu %14.2f", sizes[i], (unsigned long) length, prog * 1e3);
+		printf(" %14.2f %14.2f\n", buffer * 1e3, ralloc * 1e3);
+	}
+	ShFinalize();
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * compileBench.cpp
+ *
+ *  Created on: 16.10.2026
+ *
+ * Cold and warm compile times of small shaders. The first compile of a stage
+ * builds the compile session and the built-in variables for it, the later
+ * ones reuse them. For comparison, the time to generate the built-in
+ * variables into a parser state is printed next to the time to add the
+ * cached ones. Last, the time to build mesa's built-in functions, which all
+ * compiles share until ShFinalize, is printed next to the time a compile
+ * spends on them once they are built.
+ *
+ * Usage: compileBench [number of compiles]
+ */
+
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "glsldb/utils/benchtime.h"
+#include "interface/CompileSession.h"
+#include "mesa/glsl/glsl_parser_extras.h"
+#include "mesa/glsl/ir.h"
+#include "mesa/util/ralloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct {
+	const char* name;
+	EShLanguage language;
+	gl_shader_stage stage;
+	const char* source;
+} shaders[] = {
+	{ "vertex", EShLangVertex, MESA_SHADER_VERTEX,
+		"#version 120\n"
+		"uniform float u;\n"
+		"void main()\n"
+		"{\n"
+		"  gl_TexCoord[0] = gl_MultiTexCoord0 * u;\n"
+		"  gl_Position = ftransform();\n"
+		"}\n" },
+	{ "geometry", EShLangGeometry, MESA_SHADER_GEOMETRY,
+		"#version 120\n"
+		"#extension GL_EXT_geometry_shader4 : enable\n"
+		"void main()\n"
+		"{\n"
+		"  for (int i = 0; i < gl_VerticesIn; ++i) {\n"
+		"    gl_Position = gl_PositionIn[i];\n"
+		"    EmitVertex();\n"
+		"  }\n"
+		"  EndPrimitive();\n"
+		"}\n" },
+	{ "fragment", EShLangFragment, MESA_SHADER_FRAGMENT,
+		"#version 120\n"
+		"uniform sampler2D tex;\n"
+		"void main()\n"
+		"{\n"
+		"  gl_FragColor = texture2D(tex, gl_TexCoord[0].xy);\n"
+		"}\n" }
+};
+#define NUM_SHADERS (sizeof(shaders) / sizeof(shaders[0]))
+
+/* seconds for one compile, -1 on failure */
+static double compile(EShLanguage language, const char* source,
+		const TBuiltInResource* resources)
+{
+	ShVariableList vl;
+	double start = now();
+
+	ShHandle compiler = ShConstructCompiler(language, EDebugOpIntermediate);
+	if (!compiler)
+		return -1.0;
+	int success = ShCompile(compiler, &source, 1, EShOptNone, resources,
+			EDebugOpIntermediate, &vl);
+	if (success)
+		freeShVariableList(&vl);
+	ShDestruct(compiler);
+
+	return success ? now() - start : -1.0;
+}
+
+/* seconds to generate and to add the cached built-in variables */
+static void benchBuiltIns(CompileSession* session, gl_shader_stage stage,
+		int rounds, double* generate, double* cached)
+{
+	*generate = *cached = 0.0;
+	for (int i = 0; i < rounds; ++i) {
+		void* mem_ctx = ralloc_context(NULL);
+
+		_mesa_glsl_parse_state* state = new(mem_ctx) _mesa_glsl_parse_state(
+				session->ctx, stage, mem_ctx);
+		state->language_version = 120;
+		exec_list instructions;
+		double start = now();
+		_mesa_glsl_initialize_variables(&instructions, state);
+		*generate += now() - start;
+
+		state = new(mem_ctx) _mesa_glsl_parse_state(session->ctx, stage, mem_ctx);
+		state->language_version = 120;
+		start = now();
+		session->addBuiltInVariables(state);
+		*cached += now() - start;
+
+		ralloc_free(mem_ctx);
+	}
+	*generate /= rounds;
+	*cached /= rounds;
+}
+
+/* seconds to build the built-in functions and to find them already built */
+static void benchBuiltInFunctions(int rounds, double* build, double* kept)
+{
+	*build = *kept = 0.0;
+	for (int i = 0; i < rounds; ++i) {
+		/* no compile is running, so they can be dropped in between */
+		_mesa_glsl_release_builtin_functions();
+		double start = now();
+		_mesa_glsl_initialize_builtin_functions();
+		*build += now() - start;
+
+		start = now();
+		_mesa_glsl_initialize_builtin_functions();
+		*kept += now() - start;
+	}
+	*build /= rounds;
+	*kept /= rounds;
+}
+
+int main(int argc, char** argv)
+{
+	int compiles = argc > 1 ? atoi(argv[1]) : 100;
+	if (compiles < 1)
+		compiles = 1;
+
+	TBuiltInResource resources;
+	setTestResources(&resources);
+
+	ShInitialize();
+	printf("%10s %12s %12s %14s %14s\n", "shader", "cold ms", "warm ms",
+			"generate us", "cached us");
+	for (size_t s = 0; s < NUM_SHADERS; ++s) {
+		double cold = compile(shaders[s].language, shaders[s].source, &resources);
+		double warm = 0.0;
+		for (int i = 0; i < compiles && warm >= 0.0; ++i) {
+			double elapsed = compile(shaders[s].language, shaders[s].source,
+					&resources);
+			warm = elapsed < 0.0 ? -1.0 : warm + elapsed;
+		}
+
+		double generate, cached;
+		benchBuiltIns(CompileSession::get(&resources), shaders[s].stage,
+				compiles, &generate, &cached);
+
+		if (cold < 0.0 || warm < 0.0)
+			printf("%10s %12s %12s", shaders[s].name, "failed", "-");
+		else
+			printf("%10s %12.3f %12.3f", shaders[s].name, cold * 1e3,
+					warm / compiles * 1e3);
+		printf(" %14.1f %14.1f\n", generate * 1e6, cached * 1e6);
+	}
+
+	/* building them is slow, a few rounds are enough */
+	double build, kept;
+	benchBuiltInFunctions(compiles < 10 ? compiles : 10, &build, &kept);
+	printf("built-in functions: %.3f ms to build, %.3f us once built\n",
+			build * 1e3, kept * 1e6);
+	ShFinalize();
+
+	return 0;
+}
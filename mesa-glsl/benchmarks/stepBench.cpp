@@ -0,0 +1,120 @@
+/*
+ * stepBench.cpp
+ *
+ *  Created on: 16.10.2026
+ *
+ * Cost of a debugger step in synthetic fragment shaders of growing size.
+ * The shaders grow by functions main does not call, as in uber-shaders,
+ * so a step has the same work to do in all of them. For comparison, the
+ * time of one traverse over the whole tree is printed; the debug path used
+ * to take two of them per step.
+ *
+ * Usage: stepBench [number of lines ...]
+ */
+
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "glsldb/utils/benchtime.h"
+#include "ShaderHolder.h"
+#include "visitors/debugpath.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define STEPS 64
+#define LINES_PER_FUNCTION 10
+
+static std::string makeShader(int lines)
+{
+	std::string source = "#version 130\nuniform float u;\n";
+	char line[128];
+
+	for (int f = 0; f < lines / LINES_PER_FUNCTION; ++f) {
+		snprintf(line, sizeof(line), "float f%d(float x)\n{\n", f);
+		source += line;
+		for (int i = 0; i < LINES_PER_FUNCTION - 4; ++i)
+			source += "  x = x * 0.5 + 1.0;\n";
+		source += "  return x;\n}\n";
+	}
+
+	source += "void main()\n{\n  float a = u;\n";
+	for (int i = 0; i < STEPS; ++i) {
+		if (i % 8 == 0 && lines >= LINES_PER_FUNCTION)
+			source += "  a = f0(a);\n";
+		else
+			source += "  a = a * 1.5 - 0.25;\n";
+	}
+	source += "  gl_FragColor = vec4(a);\n}\n";
+	return source;
+}
+
+/* seconds per step and per whole tree traverse, false on failure */
+static bool benchSteps(const std::string& source, double* step, double* traverse,
+		int* steps)
+{
+	TBuiltInResource resources;
+	ShVariableList vl;
+	const char* text = source.c_str();
+	bool success = false;
+
+	setTestResources(&resources);
+	ShHandle compiler = ShConstructCompiler(EShLangFragment, EDebugOpIntermediate);
+	if (!compiler)
+		return false;
+
+	if (ShCompile(compiler, &text, 1, EShOptNone, &resources,
+			EDebugOpIntermediate, &vl)) {
+		double start = now();
+		*steps = 0;
+		for (int i = 0; i < STEPS; ++i) {
+			DbgResult* dr = ShDebugJumpToNext(compiler, EDebugOpIntermediate,
+					DBG_BH_JUMP_INTO);
+			if (!dr || dr->status != DBG_RS_STATUS_OK)
+				break;
+			++*steps;
+		}
+		*step = *steps ? (now() - start) / *steps : 0.0;
+
+		ShaderHolder* holder = reinterpret_cast<ShaderHolder*>(compiler);
+		ast_debugpath_traverser_visitor dbgpath;
+		start = now();
+		dbgpath.run(holder->shaders[0]->head, DPOpReset);
+		*traverse = now() - start;
+
+		success = *steps > 0;
+		freeShVariableList(&vl);
+	}
+
+	ShDestruct(compiler);
+	return success;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> sizes;
+	for (int i = 1; i < argc; ++i)
+		sizes.push_back(atoi(argv[i]));
+	if (sizes.empty()) {
+		sizes.push_back(1000);
+		sizes.push_back(10000);
+		sizes.push_back(50000);
+	}
+
+	ShInitialize();
+	printf("%8s %8s %14s %14s\n", "lines", "steps", "us/step", "traverse us");
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		double step = 0.0, traverse = 0.0;
+		int steps = 0;
+		if (benchSteps(makeShader(sizes[i]), &step, &traverse, &steps))
+			printf("%8d %8d %14.1f %14.1f\n", sizes[i], steps, step * 1e6,
+					traverse * 1e6);
+		else
+			printf("%8d %8s %14s %14s\n", sizes[i], "-", "failed", "-");
+	}
+	ShFinalize();
+
+	return 0;
+}
@@ -6,6 +6,8 @@
 
 #include "AstScope.h"
 #include "glsldb/utils/dbgprint.h"
+#include <string.h>
+#include <set>
 
 
 extern ShChangeable * copyShChangeableCtx(ShChangeable *c, void* mem_ctx);
@@ -48,6 +50,26 @@ void addScopeToScopeStack(DbgRsScope& stack, exec_list *scope, void* mem_ctx)
  		addToScope(stack, sc_item, mem_ctx);
 }
 
+void addScopesToScopeStack(DbgRsScope& stack, std::vector<exec_list*>& scopes,
+		void* mem_ctx)
+{
+	std::set<int> ids(stack.ids, stack.ids + stack.numIds);
+	std::vector<int> added;
+
+	for (unsigned i = 0; i < scopes.size(); ++i)
+		foreach_in_list(scope_item, sc_item, scopes[i])
+			if (ids.insert(sc_item->id).second)
+				added.push_back(sc_item->id);
+
+	if (added.empty())
+		return;
+
+	stack.ids = (int*) reralloc_array_size(mem_ctx, stack.ids, sizeof(int),
+			stack.numIds + added.size());
+	memcpy(stack.ids + stack.numIds, &added[0], added.size() * sizeof(int));
+	stack.numIds += added.size();
+}
+
 void setDbgScope(DbgRsScope& scope, exec_list *s, void* mem_ctx)
 {
 	assert(s || !"no scopeList");
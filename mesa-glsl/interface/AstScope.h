@@ -9,6 +9,7 @@
 
 #include "ShaderLang.h"
 #include "mesa/glsl/list.h"
+#include <vector>
 
 
 class scope_item: public exec_node {
@@ -31,6 +32,9 @@ public:
 
 
 void addScopeToScopeStack(DbgRsScope& stack, exec_list *s, void* mem_ctx);
+/* Same for several scopes in order, but with a single allocation */
+void addScopesToScopeStack(DbgRsScope& stack, std::vector<exec_list*>& scopes,
+		void* mem_ctx);
 void setDbgScope(DbgRsScope& target, exec_list *s, void* mem_ctx);
 
 #endif /* AST_SCOPE_H_ */
@@ -196,21 +196,11 @@ bool compileDbgShaderCode(AstShader* shader, ShChangeableList *cgbl, ShVariableL
 	ast_output_traverser_visitor it(cg, shader, vl, cgbl, language, dbgCgOptions);
 	it.append_header();
 
-	/* I have some problems with locale-dependent %f interpretation in printf
-	 * Not sure, whose fault it is, qt or some line of code in debugger initialization.
-	 * I added this crutch to resolve it, but it must be eventually rewritten.
-	 * Well... fuck you, something.
-	 * P.S. You cannot have Gujarati comments in generated shaders now.
-	 */
-	char* old_locale = setlocale(LC_NUMERIC, NULL);
-	setlocale(LC_NUMERIC, "POSIX");
-
 	/* 2. Pass:
-	 * - do the actual code generation
+	 * - do the actual code generation, floats are printed with StringBuffer::appendFloat
+	 *   which does not depend on the locale of the application
 	 */
 	it.visit(list);
-	/* restore locale */
-	setlocale(LC_NUMERIC, old_locale);
 
 	it.dump();
 	it.get_code(code);
@@ -21,23 +21,6 @@
 #define CG_RANDOMIZED_POSTFIX_SIZE 3
 
 
-struct ltstr {
-	bool operator()(const char* s1, const char* s2) const
-	{
-		return strcmp(s1, s2) < 0;
-	}
-};
-
-typedef std::map<const char*, const char*, ltstr> strMap;
-typedef std::list<const char*> strList;
-
-static struct {
-	strMap nameMap;
-	strList loopIters;
-	int numLoopIters;
-} g;
-
-
 CodeGen::CodeGen(AstShader* _sh, ShVariableList* _vl, ShChangeableList* _cgbls)
 {
 	shader = _sh;
@@ -46,10 +29,7 @@ CodeGen::CodeGen(AstShader* _sh, ShVariableList* _vl, ShChangeableList* _cgbls)
 	result = condition = parameter = NULL;
 	defined_constructions = 0;
 	mem = ralloc_context(NULL);
-
-	g.nameMap.clear();
-	g.numLoopIters = 0;
-	g.loopIters.clear();
+	numLoopIters = 0;
 }
 
 
@@ -95,9 +75,21 @@ static ShVariable* createDefault(cgTypes type, EShLanguage l, void* mem_ctx)
 	return ret;
 }
 
+/* Write the n-th postfix (AAA, AAB, ...) instead of a random one, so that every
+ * compiler handle generates the same code without sharing rand() state. */
+static void setNamePostfix(char* dst, unsigned int n)
+{
+	for (int i = CG_RANDOMIZED_POSTFIX_SIZE - 1; i >= 0; i--) {
+		dst[i] = (char) ('A' + n % ('Z' - 'A' + 1));
+		n /= 'Z' - 'A' + 1;
+	}
+	dst[CG_RANDOMIZED_POSTFIX_SIZE] = '\0';
+}
+
 static char* getUnusedNameByPrefix(ShVariableList *vl, const char *prefix, void* mem_ctx)
 {
 	char* new_name = NULL;
+	unsigned int postfix = 0;
 
 	new_name = (char*) rzalloc_size(mem_ctx, strlen(prefix) + 1 + CG_RANDOMIZED_POSTFIX_SIZE);
 	assert(new_name || !"CodeInsertion - not enough memory for result name\n");
@@ -105,11 +97,7 @@ static char* getUnusedNameByPrefix(ShVariableList *vl, const char *prefix, void*
 
 	if (findFirstShVariableFromName(vl, prefix)) {
 		while (findFirstShVariableFromName(vl, new_name)) {
-			new_name[strlen(prefix)] = '\0';
-			for (int i = 0; i < CG_RANDOMIZED_POSTFIX_SIZE; i++) {
-				char ran = (char) ((rand() / (float) RAND_MAX) * ('Z' - 'A') + 'A');
-				strncat(new_name, &ran, 1);
-			}
+			setNamePostfix(new_name + strlen(prefix), postfix++);
 		}
 	}
 
@@ -201,7 +189,7 @@ void CodeGen::initTarget(ast_function_expression* node, EShLanguage l, DbgCgOpti
 	if (lastInParameter >= 0) {
 		ast_node* t = getSideEffectsDebugParameter(node, lastInParameter);
 		assert((t && t->debug_id >= 0) || !"CodeGen - side effects returned type is invalid");
-		ShVariable* var = findShVariable(t->debug_id);
+		ShVariable* var = findShVariable(shader->context, t->debug_id);
 		init(CG_TYPE_PARAMETER, var, l);
 	}
 }
@@ -254,13 +242,16 @@ void CodeGen::allocateResult(ast_node* target, EShLanguage language, DbgCgOption
 	dbgPrint(DBGLVL_COMPILERINFO, "initialize CG_TYPE_RESULT for %i\n", language);
 	int size = (options == DBG_CG_GEOMETRY_MAP || options == DBG_CG_VERTEX_COUNT) ? 3 :
 				(options == DBG_CG_GEOMETRY_CHANGEABLE) ? 2 : 0;
+	/* several watch items packed into one result, one component each */
+	if (options == DBG_CG_CHANGEABLE && cgbls && cgbls->numChangeables > 1)
+		size = cgbls->numChangeables;
 	ShVariable* ret = NULL;
 	if (size) {
 		ret = (ShVariable*)rzalloc(shader, ShVariable);
 		ret->uniqueId = -1;
 		ret->size = size;
 		ret->type = SH_FLOAT;
-		ret->qualifier = SH_VARYING_OUT;
+		ret->qualifier = (language == EShLangFragment) ? SH_TEMPORARY : SH_VARYING_OUT;
 	}
 
 	init(CG_TYPE_RESULT, ret, language);
@@ -332,31 +323,31 @@ static std::string getTypeCode(ShVariable *v, bool reduceToScalar = false)
 	}
 }
 
-void CodeGen::addDeclaration(cgTypes type, char** prog, EShLanguage l)
+void CodeGen::addDeclaration(cgTypes type, StringBuffer* prog, EShLanguage l)
 {
 	switch (type) {
 	case CG_TYPE_RESULT:
 		if (result)
-			ralloc_asprintf_append(prog, "%s%s %s;\n", getQualifierCode(result, l, shader->version),
+			prog->printf("%s%s %s;\n", getQualifierCode(result, l, shader->version),
 					getTypeCode(result).c_str(), result->name);
 		break;
 	case CG_TYPE_CONDITION:
 		if (condition)
-			ralloc_asprintf_append(prog, "%s%s %s;\n", getQualifierCode(condition, l, shader->version),
+			prog->printf("%s%s %s;\n", getQualifierCode(condition, l, shader->version),
 					getTypeCode(condition).c_str(), condition->name);
 		break;
 	case CG_TYPE_PARAMETER:
 		if (parameter) {
-			ralloc_asprintf_append(prog, "%s%s %s", getQualifierCode(parameter, l, shader->version),
+			prog->printf("%s%s %s", getQualifierCode(parameter, l, shader->version),
 					getTypeCode(parameter).c_str(), parameter->name);
 			if (parameter->isArray)
-				ralloc_asprintf_append(prog, "[%i]", parameter->arraySize[0]);
-			ralloc_asprintf_append(prog, ";\n");
+				prog->printf("[%i]", parameter->arraySize[0]);
+			prog->append(";\n");
 		}
 		break;
 	case CG_TYPE_LOOP_ITERS:
-		for (strList::iterator it = g.loopIters.begin(); it != g.loopIters.end(); it++)
-			ralloc_asprintf_append(prog, "int %s;\n", *it);
+		for (strList::iterator it = loopIters.begin(); it != loopIters.end(); it++)
+			prog->printf("int %s;\n", *it);
 		break;
 	case CG_TYPE_ALL:
 		addDeclaration(CG_TYPE_RESULT, prog, l);
@@ -390,7 +381,7 @@ static const char* getInitializationCode(cgInitialization init)
 	return "";
 }
 
-void CodeGen::addInitialization(cgTypes type, cgInitialization init, char** prog)
+void CodeGen::addInitialization(cgTypes type, cgInitialization init, StringBuffer* prog)
 {
 	ShVariable* tgt = NULL;
 	switch (type) {
@@ -407,11 +398,27 @@ void CodeGen::addInitialization(cgTypes type, cgInitialization init, char** prog
 		break;
 	}
 	if (tgt)
-		ralloc_asprintf_append(prog, "%s = %s", tgt->name, getTypeCode(tgt).c_str());
-	ralloc_asprintf_append(prog, "(%s)", getInitializationCode(init));
+		prog->printf("%s = %s", tgt->name, getTypeCode(tgt).c_str());
+	prog->printf("(%s)", getInitializationCode(init));
+}
+
+/* components of the fragment output written by the result; packed watch
+ * items use more than the red channel */
+static const char* get_output_swizzle(ShVariable* v)
+{
+	switch (v->size) {
+	case 2:
+		return "xy";
+	case 3:
+		return "xyz";
+	case 4:
+		return "xyzw";
+	default:
+		return "x";
+	}
 }
 
-static void put_fragment_output(char** prog, char* name, exec_list* instructions)
+static void put_fragment_output(StringBuffer* prog, ShVariable* result, exec_list* instructions)
 {
 	const char* output_name = NULL;
 
@@ -437,10 +444,11 @@ static void put_fragment_output(char** prog, char* name, exec_list* instructions
 		output_name = "gl_FragData[0]";
 	}
 
-	ralloc_asprintf_append(prog, "%s.x = %s;\n", output_name, name);
+	prog->printf("%s.%s = %s;\n", output_name, get_output_swizzle(result),
+			result->name);
 }
 
-void CodeGen::addOutput(cgTypes type, char** prog, EShLanguage l)
+void CodeGen::addOutput(cgTypes type, StringBuffer* prog, EShLanguage l)
 {
 	/* TODO: fill out other possibilities */
 	switch (l) {
@@ -450,15 +458,15 @@ void CodeGen::addOutput(cgTypes type, char** prog, EShLanguage l)
 		if (type == CG_TYPE_RESULT)
 			if (!defined(GS_EMIT_VERTEX | GS_END_PRIMITIVE)) {
 				if (!defined(GS_EMIT_VERTEX))
-					ralloc_asprintf_append(prog, "EmitVertex();");
+					prog->append("EmitVertex();");
 				if (!defined(GS_END_PRIMITIVE))
-					ralloc_asprintf_append(prog, "EndPrimitive();");
-				ralloc_asprintf_append(prog, "\n");
+					prog->append("EndPrimitive();");
+				prog->append('\n');
 			}
 		break;
 	case EShLangFragment:
 		if (type == CG_TYPE_RESULT)
-			put_fragment_output(prog, result->name, shader->head);
+			put_fragment_output(prog, result, shader->head);
 		break;
 	default:
 		break;
@@ -520,7 +528,7 @@ char* itoMultiSwizzle(int i)
 	return swizzle;
 }
 
-static void addVariableCode(char** prog, ShChangeable *cgb, ShVariableList *vl)
+static void addVariableCode(StringBuffer* prog, ShChangeable *cgb, ShVariableList *vl)
 {
 	ShVariable *var;
 
@@ -528,11 +536,11 @@ static void addVariableCode(char** prog, ShChangeable *cgb, ShVariableList *vl)
 
 	var = findShVariableFromId(vl, cgb->id);
 	assert(var || !"CodeInsertion - called getVariableType without valid parameter\n");
-	ralloc_asprintf_append(prog, "%s", var->name);
+	prog->append(var->name);
 
 	if (!var->builtin && var->qualifier != SH_VARYING_IN && var->qualifier != SH_VARYING_OUT
 			&& var->qualifier != SH_UNIFORM && var->qualifier != SH_ATTRIBUTE)
-		ralloc_asprintf_append(prog, "_%i", var->uniqueId);
+		prog->printf("_%i", var->uniqueId);
 
 	int i;
 	for (i = 0; i < cgb->numIndices; i++) {
@@ -540,20 +548,20 @@ static void addVariableCode(char** prog, ShChangeable *cgb, ShVariableList *vl)
 
 		switch (idx->type) {
 		case SH_CGB_ARRAY_INDIRECT:
-			ralloc_asprintf_append(prog, "[%i]", idx->index);
+			prog->printf("[%i]", idx->index);
 			break;
 		case SH_CGB_ARRAY_DIRECT:
 			// FIXME: Leak ahead
-			ralloc_asprintf_append(prog, ".%s", itoSwizzle(idx->index));
+			prog->printf(".%s", itoSwizzle(idx->index));
 			break;
 		case SH_CGB_STRUCT:
 			assert(idx->index < var->structSize || !"CodeInsertion - struct and changeable do not match\n");
 			var = var->structSpec[idx->index];
-			ralloc_asprintf_append(prog, ".%s", var->name);
+			prog->printf(".%s", var->name);
 			break;
 		case SH_CGB_SWIZZLE:
 			// FIXME: Leak ahead
-			ralloc_asprintf_append(prog, ".%s", itoMultiSwizzle(idx->index));
+			prog->printf(".%s", itoMultiSwizzle(idx->index));
 			break;
 		}
 	}
@@ -655,7 +663,7 @@ static int getShChangeableSize(ShChangeable *cgb, ShVariableList *vl)
 	return size;
 }
 
-static void addVariableCodeFromList(char** prog, ShChangeableList* cgbl, ShVariableList *vl,
+static void addVariableCodeFromList(StringBuffer* prog, ShChangeableList* cgbl, ShVariableList *vl,
 		int targetSize)
 {
 	int id;
@@ -672,7 +680,7 @@ static void addVariableCodeFromList(char** prog, ShChangeableList* cgbl, ShVaria
 
 		/* Only add seperator if not last item */
 		if (id < (cgbl->numChangeables - 1))
-			ralloc_asprintf_append(prog, ", ");
+			prog->append(", ");
 	}
 
 	if (size > 4) {
@@ -682,7 +690,7 @@ static void addVariableCodeFromList(char** prog, ShChangeableList* cgbl, ShVaria
 	}
 
 	for (id = size; id < targetSize; id++)
-		ralloc_asprintf_append(prog, ", 0.0");
+		prog->append(", 0.0");
 }
 
 static bool hasLoop(AstStack* stack)
@@ -695,12 +703,12 @@ static bool hasLoop(AstStack* stack)
 	return false;
 }
 
-static void addLoopHeader(char** prog, AstStack* stack)
+static void addLoopHeader(StringBuffer* prog, AstStack* stack)
 {
 	if (!hasLoop(stack))
 		return;
 
-	ralloc_asprintf_append(prog, "(");
+	prog->append('(');
 
 	/* for each loop node inside stack, e.g. dbgPath add condition */
 	foreach_stack(node, stack) {
@@ -708,24 +716,24 @@ static void addLoopHeader(char** prog, AstStack* stack)
 		if (loop && loop->need_dbgiter()) {
 			if (loop->debug_iter_name == NULL)
 				dbgPrint(DBGLVL_ERROR, "No iter name, crash ahead");
-			ralloc_asprintf_append(prog, "%s == %i && ", loop->debug_iter_name, loop->debug_iter);
+			prog->printf("%s == %i && ", loop->debug_iter_name, loop->debug_iter);
 		}
 	}
 
-	ralloc_asprintf_append(prog, "(");
+	prog->append('(');
 }
 
-static void addLoopFooter(char** prog, AstStack* stack)
+static void addLoopFooter(StringBuffer* prog, AstStack* stack)
 {
 	if (hasLoop(stack))
-		ralloc_asprintf_append(prog, ", true))");
+		prog->append(", true))");
 }
 
 /* 'option' semantics:
  *     DBG_CG_SELECTION_CONDITIONAL: branch (true or false)
  *     DBG_CG_GEOMETRY_MAP:          EmitVertex or EndPrimitive
  */
-void CodeGen::addDbgCode(cgTypes type, char** prog, DbgCgOptions cgOptions, int option, GLenum outPrimType)
+void CodeGen::addDbgCode(cgTypes type, StringBuffer* prog, DbgCgOptions cgOptions, int option, GLenum outPrimType)
 {
 	/* TODO: fill out other possibilities */
 	switch (type) {
@@ -740,47 +748,50 @@ void CodeGen::addDbgCode(cgTypes type, char** prog, DbgCgOptions cgOptions, int
 		const char* type_code = stype.c_str();
 		switch (cgOptions) {
 		case DBG_CG_COVERAGE:
-			ralloc_asprintf_append(prog, "%s = %s(1.0)", result->name, type_code);
+			prog->printf("%s = %s(1.0)", result->name, type_code);
 			break;
 		case DBG_CG_SELECTION_CONDITIONAL:
-			ralloc_asprintf_append(prog, "%s = %s(%f)", result->name, type_code,
-					option ? 1.0 : 0.5);
+			prog->printf("%s = %s(", result->name, type_code);
+			prog->appendFloat(option ? 1.0 : 0.5);
+			prog->append(')');
 			break;
 		case DBG_CG_SWITCH_CONDITIONAL: {
 			float optf = (float)option / (float)DBG_BH_SWITCH_BRANCH_LAST;
-			ralloc_asprintf_append(prog, "%s = %s(%f)", result->name, type_code, optf);
+			prog->printf("%s = %s(", result->name, type_code);
+			prog->appendFloat(optf);
+			prog->append(')');
 			break;
 		}
 		case DBG_CG_LOOP_CONDITIONAL:
-			ralloc_asprintf_append(prog, "%s = %s(%s)", result->name, type_code, condition->name);
+			prog->printf("%s = %s(%s)", result->name, type_code, condition->name);
 			break;
 		case DBG_CG_CHANGEABLE:
-			ralloc_asprintf_append(prog, "%s = %s(", result->name, type_code);
+			prog->printf("%s = %s(", result->name, type_code);
 			addVariableCodeFromList(prog, cgbls, vl, getVariableSizeByArrayIndices(result, 0));
-			ralloc_asprintf_append(prog, ")");
+			prog->append(')');
 			break;
 		case DBG_CG_GEOMETRY_MAP:
 			/* option: '0' EmitVertex
 			 *         '1' EndPrimitive */
-			ralloc_asprintf_append(prog, "%s = %s", result->name, type_code);
+			prog->printf("%s = %s", result->name, type_code);
 			if (option)
-				ralloc_asprintf_append(prog, "(dbgResult.x + 1, 0.0, gl_PrimitiveIDIn)");
+				prog->append("(dbgResult.x + 1, 0.0, gl_PrimitiveIDIn)");
 			else
-				ralloc_asprintf_append(prog,
+				prog->append(
 						"(dbgResult.x, dbgResult.y + 1, gl_PrimitiveIDIn)");
 			break;
 		case DBG_CG_GEOMETRY_CHANGEABLE:
 			switch (option) {
 			case CG_GEOM_CHANGEABLE_AT_TARGET:
-				ralloc_asprintf_append(prog, "%s = %s(0.0)", result->name, type_code);
+				prog->printf("%s = %s(0.0)", result->name, type_code);
 				break;
 			case CG_GEOM_CHANGEABLE_IN_SCOPE:
-				ralloc_asprintf_append(prog, "%s = %s(", result->name, type_code);
+				prog->printf("%s = %s(", result->name, type_code);
 				addVariableCodeFromList(prog, cgbls, vl, 0);
-				ralloc_asprintf_append(prog, ", abs(%s.y))", result->name);
+				prog->printf(", abs(%s.y))", result->name);
 				break;
 			case CG_GEOM_CHANGEABLE_NO_SCOPE:
-				ralloc_asprintf_append(prog, "%s = %s(0.0, -abs(%s.y))", result->name,
+				prog->printf("%s = %s(0.0, -abs(%s.y))", result->name,
 						type_code, result->name);
 				break;
 			}
@@ -788,24 +799,24 @@ void CodeGen::addDbgCode(cgTypes type, char** prog, DbgCgOptions cgOptions, int
 		case DBG_CG_VERTEX_COUNT:
 			/* option: '0' EmitVertex
 			 *         '1' EndPrimitive */
-			ralloc_asprintf_append(prog, "%s = %s", result->name, type_code);
+			prog->printf("%s = %s", result->name, type_code);
 			if (option) {
 				switch (outPrimType) {
 				case GL_POINTS:
-					ralloc_asprintf_append(prog,
+					prog->append(
 							"(dbgResult.y > 0 ? dbgResult.x + 1 : dbgResult.x, 0.0, gl_PrimitiveIDIn)");
 					break;
 				case GL_LINE_STRIP:
-					ralloc_asprintf_append(prog,
+					prog->append(
 							"(dbgResult.y > 1 ? dbgResult.x + dbgResult.y : dbgResult.x, 0.0, gl_PrimitiveIDIn)");
 					break;
 				case GL_TRIANGLE_STRIP:
-					ralloc_asprintf_append(prog,
+					prog->append(
 							"(dbgResult.y > 2 ? dbgResult.x + dbgResult.y : dbgResult.x, 0.0, gl_PrimitiveIDIn)");
 					break;
 				}
 			} else
-				ralloc_asprintf_append(prog,
+				prog->append(
 						"(dbgResult.x, dbgResult.y + 1, gl_PrimitiveIDIn)");
 			break;
 		default:
@@ -820,10 +831,10 @@ void CodeGen::addDbgCode(cgTypes type, char** prog, DbgCgOptions cgOptions, int
 		break;
 	}
 	case CG_TYPE_PARAMETER:
-		ralloc_asprintf_append(prog, "%s", parameter->name);
+		prog->append(parameter->name);
 		break;
 	case CG_TYPE_CONDITION:
-		ralloc_asprintf_append(prog, "%s", condition->name);
+		prog->append(condition->name);
 		break;
 	default:
 		break;
@@ -859,7 +870,7 @@ static const char* getNewUnusedFunctionName(const char *input, AstShader* shader
 {
 	char *output;
 	size_t baseLen;
-	int i;
+	unsigned int postfix = 0;
 	char* func_name = getFunctionName(input);
 	size_t fn_len = strlen(func_name);
 
@@ -872,13 +883,8 @@ static const char* getNewUnusedFunctionName(const char *input, AstShader* shader
 	baseLen = strlen(output);
 	free(func_name);
 
-    while (shader->symbols->get_function(output)) {
-        output[baseLen] = '\0';
-        for (i=0; i<CG_RANDOMIZED_POSTFIX_SIZE; i++) {
-            output[baseLen+i] = (char)((rand()/(float)RAND_MAX)*('Z'-'A')+'A');
-        }
-        output[baseLen+i] = '\0';
-    }
+	while (shader->symbols->get_function(output))
+		setNamePostfix(output + baseLen, postfix++);
 
 	return output;
 }
@@ -886,26 +892,26 @@ static const char* getNewUnusedFunctionName(const char *input, AstShader* shader
 
 const char* CodeGen::getDebugName(const char *input)
 {
-	strMap::iterator it = g.nameMap.find(input);
-	if (it != g.nameMap.end()) {
+	strMap::iterator it = nameMap.find(input);
+	if (it != nameMap.end()) {
 		/* Object already found */
 		return it->second;
 	} else {
 		/* New object: 1. generate new name
 		 *             2. add to map */
 		char *name = ralloc_strdup(mem, input);
-		g.nameMap[name] = getNewUnusedFunctionName(name, shader);
-		return g.nameMap[name];
+		nameMap[name] = getNewUnusedFunctionName(name, shader);
+		return nameMap[name];
 	}
 }
 
-static void setLoopIterName(char **name, ShVariableList *vl, void* mem_ctx)
+void CodeGen::setLoopIterName(char **name)
 {
 	char prefix[200];
-	sprintf(prefix, "%s%i", CG_LOOP_ITER_PREFIX, g.numLoopIters);
-	*name = getUnusedNameByPrefix(vl, prefix, mem_ctx);
-	g.loopIters.push_back(*name);
-	g.numLoopIters++;
+	sprintf(prefix, "%s%i", CG_LOOP_ITER_PREFIX, numLoopIters);
+	*name = getUnusedNameByPrefix(vl, prefix, shader);
+	loopIters.push_back(*name);
+	numLoopIters++;
 }
 
 void CodeGen::setIterNames()
@@ -925,7 +931,7 @@ void CodeGen::setIterNames()
 			if (loop->debug_state_internal == ast_dbg_loop_qyr_test
 					|| loop->debug_state_internal == ast_dbg_loop_select_flow
 					|| loop->debug_state_internal == ast_dbg_loop_qyr_terminal)
-				setLoopIterName(&loop->debug_iter_name, vl, shader);
+				setLoopIterName(&loop->debug_iter_name);
 			else
 				assert(!"CodeGen - loop target has invalid internal state");
 		} else if (loop->debug_state == ast_dbg_state_path) {
@@ -933,7 +939,7 @@ void CodeGen::setIterNames()
 					|| loop->debug_state_internal == ast_dbg_loop_wrk_test
 					|| loop->debug_state_internal == ast_dbg_loop_wrk_body
 					|| loop->debug_state_internal == ast_dbg_loop_wrk_terminal)
-				setLoopIterName(&loop->debug_iter_name, vl, shader);
+				setLoopIterName(&loop->debug_iter_name);
 			else
 				assert(!"CodeGen - loop path has invalid internal state");
 		}
@@ -943,7 +949,7 @@ void CodeGen::setIterNames()
 
 void CodeGen::resetLoopIterNames(void)
 {
-	g.numLoopIters = 0;
-	g.loopIters.clear();
+	numLoopIters = 0;
+	loopIters.clear();
 }
 
@@ -3,6 +3,11 @@
 
 #include "ShaderLang.h"
 #include "ShaderHolder.h"
+#include "StringBuffer.h"
+
+#include <map>
+#include <list>
+#include <string.h>
 
 enum cgTypes {
 	CG_TYPE_NONE,
@@ -27,6 +32,17 @@ enum cgGeomChangeable {
 };
 
 
+struct ltstr {
+	bool operator()(const char* s1, const char* s2) const
+	{
+		return strcmp(s1, s2) < 0;
+	}
+};
+
+typedef std::map<const char*, const char*, ltstr> strMap;
+typedef std::list<const char*> strList;
+
+
 class ast_function_expression;
 class ast_selection_statement;
 class ast_switch_statement;
@@ -61,11 +77,11 @@ public:
 	void allocateResult(ast_node*, EShLanguage, DbgCgOptions);
 	/* code generation */
 	void getNewName(char **name, const char *prefix);
-	void addDeclaration(cgTypes type, char** prog, EShLanguage l);
-	void addDbgCode(cgTypes type, char** prog, DbgCgOptions cgOptions,
+	void addDeclaration(cgTypes type, StringBuffer* prog, EShLanguage l);
+	void addDbgCode(cgTypes type, StringBuffer* prog, DbgCgOptions cgOptions,
 	                  int option, GLenum outPrimType = 0x0000);
-	void addOutput(cgTypes type, char** prog, EShLanguage l);
-	void addInitialization(cgTypes type, cgInitialization init, char** prog);
+	void addOutput(cgTypes type, StringBuffer* prog, EShLanguage l);
+	void addInitialization(cgTypes type, cgInitialization init, StringBuffer* prog);
 	//void addAssignment(cgTypes type, ShVariable *src);
 	void destruct(cgTypes type);
 
@@ -80,6 +96,7 @@ protected:
 	void initTarget(ast_selection_statement*, EShLanguage, DbgCgOptions);
 	void initTarget(ast_switch_statement*, EShLanguage, DbgCgOptions);
 	void initTarget(ast_iteration_statement*, EShLanguage, DbgCgOptions);
+	void setLoopIterName(char **name);
 
 
 private:
@@ -91,6 +108,11 @@ private:
 	ShVariable* condition;
 	ShVariable* parameter;
 	void *mem;
+
+	/* debug names of the functions and loop counters of the path */
+	strMap nameMap;
+	strList loopIters;
+	int numLoopIters;
 };
 
 
@@ -6,6 +6,7 @@
 #include "mesa/glsl/list.h"
 #include "glsldb/utils/dbgprint.h"
 #include <map>
+#include <stdio.h>
 
 #define X 1
 #define R 5
@@ -0,0 +1,163 @@
+/*
+ * CompileSession.cpp
+ *
+ *  Created on: 16.10.2026
+ */
+
+#include "CompileSession.h"
+
+// Mesa includes
+#include "mesa/glsl/standalone_scaffolding.h"
+#include "mesa/glsl/glsl_parser_extras.h"
+#include "mesa/glsl/glsl_symbol_table.h"
+#include "mesa/glsl/ir.h"
+#include "mesa/glsl/list.h"
+#include "main/mtypes.h"
+
+#include <string.h>
+#include <vector>
+
+// Variables
+int glsl_es = 0;
+int glsl_version = 330;
+
+
+struct CompileSession::BuiltInVariables {
+	/* stage, version and extensions the variables were generated for */
+	struct _mesa_glsl_parse_state* state;
+	exec_list* variables;
+	BuiltInVariables* next;
+};
+
+static std::vector<CompileSession*> sessions;
+static mtx_t sessions_lock = _MTX_INITIALIZER_NP;
+
+
+static void initialize_context(struct gl_context *ctx, const TBuiltInResource* resources)
+{
+	// FIXME: right api
+	initialize_context_to_defaults(ctx, API_OPENGL_COMPAT);
+	/* The standalone compiler needs to claim support for almost
+	 * everything in order to compile the built-in functions.
+	 */
+	ctx->Const.GLSLVersion = glsl_version;
+	ctx->Extensions.ARB_ES3_compatibility = true;
+
+	/* 1.20 minimums. */
+	ctx->Const.MaxLights = resources->maxLights;
+	ctx->Const.MaxClipPlanes = resources->maxClipPlanes;
+	ctx->Const.MaxTextureUnits = resources->maxTextureUnits;
+
+	/* allow high amount */
+	ctx->Const.MaxTextureCoordUnits = resources->maxTextureCoords;
+
+	ctx->Const.Program[MESA_SHADER_VERTEX].MaxAttribs = resources->maxVertexAttribs;
+	ctx->Const.Program[MESA_SHADER_VERTEX].MaxUniformComponents = resources->maxVertexUniformComponents;
+	ctx->Const.Program[MESA_SHADER_FRAGMENT].MaxUniformComponents = resources->maxFragmentUniformComponents;
+	ctx->Const.MaxVarying = resources->maxVaryingFloats;
+	ctx->Const.MaxCombinedTextureImageUnits = resources->maxCombinedTextureImageUnits;
+	ctx->Const.Program[MESA_SHADER_VERTEX].MaxTextureImageUnits = resources->maxVertexTextureImageUnits;
+//	ctx->Const.FragmentProgram.MaxTextureImageUnits = 16;
+//	ctx->Const.GeometryProgram.MaxTextureImageUnits = 16;
+
+	ctx->Const.MaxDrawBuffers = resources->maxDrawBuffers;
+	ctx->Const.MaxGeometryOutputVertices = resources->geoVerticesOut;
+	// I saw it in mailing list in the latest mesa git, I think. Or not.
+	// But anyway I cannot find anything in current headers and we using only stable mesa now.
+	//	int geoVerticesIn;
+	//	int geoInputType;
+	//	int geoOutputType;
+
+	ctx->Driver.NewShader = _mesa_new_shader;
+
+	// Enable required extensions
+	ctx->Extensions.ARB_framebuffer_object = (GLboolean)resources->framebufferObjectsSupported;
+	ctx->Extensions.EXT_transform_feedback = (GLboolean)resources->transformFeedbackSupported;
+	ctx->Extensions.ARB_geometry_shader4 = (GLboolean)resources->geoShaderSupported;
+}
+
+CompileSession::CompileSession(struct gl_context* _ctx) :
+		ctx(_ctx),
+		builtins(NULL)
+{
+	memset(&resources, 0, sizeof(resources));
+	mtx_init(&lock, mtx_plain);
+}
+
+CompileSession::~CompileSession()
+{
+	// The built-in variables belong to the session memory
+	mtx_destroy(&lock);
+}
+
+CompileSession* CompileSession::get(const TBuiltInResource* resources)
+{
+	CompileSession* session = NULL;
+
+	mtx_lock(&sessions_lock);
+	for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+		if (!memcmp(&(*it)->resources, resources, sizeof(TBuiltInResource))) {
+			session = *it;
+			break;
+		}
+	}
+
+	if (!session) {
+		struct gl_context* ctx = rzalloc(NULL, struct gl_context);
+		initialize_context(ctx, resources);
+		session = new(ctx) CompileSession(ctx);
+		memcpy(&session->resources, resources, sizeof(TBuiltInResource));
+		sessions.push_back(session);
+	}
+	mtx_unlock(&sessions_lock);
+
+	return session;
+}
+
+void CompileSession::releaseAll()
+{
+	mtx_lock(&sessions_lock);
+	// The sessions are part of their context memory
+	for (auto it = sessions.begin(); it != sessions.end(); ++it)
+		ralloc_free((*it)->ctx);
+	sessions.clear();
+	mtx_unlock(&sessions_lock);
+	/* built once by the first compile, kept for all later ones */
+	_mesa_glsl_release_builtin_functions();
+}
+
+void CompileSession::addBuiltInVariables(struct _mesa_glsl_parse_state* state)
+{
+	BuiltInVariables* found = NULL;
+
+	mtx_lock(&lock);
+	for (BuiltInVariables* b = builtins; b; b = b->next) {
+		if (b->state->stage == state->stage
+				&& b->state->language_version == state->language_version
+				&& b->state->es_shader == state->es_shader
+				&& _mesa_glsl_extension_flags_equal(b->state, state)) {
+			found = b;
+			break;
+		}
+	}
+
+	if (!found) {
+		found = rzalloc(this, BuiltInVariables);
+		found->state = new(this) _mesa_glsl_parse_state(ctx, state->stage, this);
+		found->state->language_version = state->language_version;
+		found->state->es_shader = state->es_shader;
+		_mesa_glsl_copy_extension_flags(found->state, state);
+		found->variables = new(this) exec_list;
+		_mesa_glsl_initialize_variables(found->variables, found->state);
+		found->next = builtins;
+		builtins = found;
+	}
+	mtx_unlock(&lock);
+
+	/* The compile writes to its variables, e.g. max_array_access and
+	 * data.used, so it gets copies. Cloning is still far cheaper than
+	 * generating them.
+	 */
+	foreach_in_list(ir_variable, var, found->variables)
+		state->symbols->add_variable(var->clone(state, NULL));
+}
@@ -0,0 +1,76 @@
+/*
+ * CompileSession.h
+ *
+ *  Created on: 16.10.2026
+ */
+
+#ifndef COMPILE_SESSION_H_
+#define COMPILE_SESSION_H_
+
+#include "ShaderLang.h"
+#include "mesa/util/ralloc.h"
+#include "c11/threads.h"
+#include <assert.h>
+
+struct gl_context;
+struct _mesa_glsl_parse_state;
+
+/*
+ * The mesa context and built-in variables for compiles with one set of
+ * resource limits. Both are built once, so all shaders of all handles with
+ * the same limits share them. The context is only read by the compiles, the
+ * variables are cloned into each one. The built-in functions are global in
+ * mesa, the first compile builds them and they live until releaseAll.
+ */
+struct CompileSession {
+	/* Callers of this ralloc-based new need not call delete. */
+	static void* operator new(size_t size, void *ctx)
+	{
+		void *session = ralloc_size(ctx, size);
+		assert(session != NULL);
+		ralloc_set_destructor(session, _destructor);
+		return session;
+	}
+
+	static void operator delete(void *session)
+	{
+		ralloc_set_destructor(session, NULL);
+		ralloc_free(session);
+	}
+
+	/* Session for an already initialized context, the caller keeps it. */
+	CompileSession(struct gl_context* ctx);
+	~CompileSession();
+
+	/* Shared session for these limits, created on first use */
+	static CompileSession* get(const TBuiltInResource* resources);
+	/* Frees the shared sessions and the built-in functions, all handles must
+	 * be destructed before.
+	 */
+	static void releaseAll();
+
+	/* Adds copies of the built-in variables for the stage, version and
+	 * extensions of state to its symbol table, generating them on first use.
+	 * The copies belong to state.
+	 */
+	void addBuiltInVariables(struct _mesa_glsl_parse_state* state);
+
+	struct gl_context* ctx;
+
+private:
+	struct BuiltInVariables;
+
+	static void _destructor(void *session)
+	{
+		static_cast<CompileSession*>(session)->~CompileSession();
+	}
+
+	CompileSession(const CompileSession&);
+	CompileSession& operator=(const CompileSession&);
+
+	BuiltInVariables* builtins;
+	TBuiltInResource resources;
+	mtx_t lock;
+};
+
+#endif /* COMPILE_SESSION_H_ */
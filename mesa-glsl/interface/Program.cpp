@@ -7,20 +7,18 @@
 #include "glsldb/utils/dbgprint.h"
 #include <string.h>
 
-static struct {
-	ast_debugjump_traverser_visitor* it;
-    DbgResult result;
-} g;
 
 
 //
 // Some helper functions for easier scope handling
 //
 
-void clearTraverseDebugJump(void)
+void clearTraverseDebugJump(ShaderContext* context)
 {
-    delete g.it;
-    g.it = NULL;
+	delete context->debugjump;
+	context->debugjump = NULL;
+	delete context->debugpath;
+	context->debugpath = NULL;
 }
 
 void resetDbgResult(DbgResult& r)
@@ -30,69 +28,93 @@ void resetDbgResult(DbgResult& r)
 	memset(&r, '\0', sizeof(DbgResult));
 }
 
-static void resetGlobals()
+static void resetContext(ShaderContext* context)
 {
-	resetDbgResult(g.result);
+	resetDbgResult(context->result);
 
-	if (!g.it)
-		g.it = new ast_debugjump_traverser_visitor(g.result);
+	if (!context->debugjump)
+		context->debugjump = new ast_debugjump_traverser_visitor(context->result);
 }
 
-static DbgResult* endTraverse(enum DbgRsStatuses status)
+static ast_debugpath_traverser_visitor* getDebugPath(ShaderContext* context,
+		exec_list* list)
 {
-	g.result.status = status;
-	return &g.result;
+	/* Links the nodes of the tree, the path is kept up to date from then on */
+	if (!context->debugpath) {
+		context->debugpath = new ast_debugpath_traverser_visitor;
+		context->debugpath->reset(list);
+	}
+	return context->debugpath;
+}
+
+static DbgResult* endTraverse(ShaderContext* context, enum DbgRsStatuses status)
+{
+	context->result.status = status;
+	return &context->result;
 }
 
 //
 //  Generate code from the given parse tree
 //
-DbgResult* ShaderTraverse(AstShader* shader, int debugOptions, int dbgBehaviour)
+DbgResult* ShaderTraverse(ShaderContext* context, AstShader* shader, int debugOptions,
+		int dbgBehaviour)
 {
 	UNUSED_ARG(debugOptions)
 
-	resetGlobals();
+	resetContext(context);
 
 	/* Check for empty parse tree */
 	if (!shader)
-		return endTraverse(DBG_RS_STATUS_ERROR);
+		return endTraverse(context, DBG_RS_STATUS_ERROR);
 
-	g.it->setUp(shader, dbgBehaviour);
+	context->debugjump->setUp(shader, dbgBehaviour);
 	exec_list* list = shader->head;
 	ast_node* root = exec_node_data(ast_node, shader->head, link);
 
 	/* Check for finished parsing */
 	if (dbgBehaviour != DBG_BH_RESET && root->debug_state == ast_dbg_state_end) {
 		VPRINT(1, "!!! debugging already finished !!!\n");
-		return endTraverse(DBG_RS_STATUS_FINISHED);
+		return endTraverse(context, DBG_RS_STATUS_FINISHED);
 	}
 
-	ast_debugpath_traverser_visitor dbgpath;
+	ast_debugpath_traverser_visitor* dbgpath = getDebugPath(context, list);
 
 	/* In case of a reset clear DbgStates and empty stack */
 	if (dbgBehaviour == DBG_BH_RESET) {
-		g.it->parseStack.clear();
-		dbgpath.run(list, DPOpReset);
+		context->debugjump->parseStack.clear();
+		dbgpath->reset(list);
 		return NULL;
 	}
 
-	/* Clear debug path, i.e remove all DbgStPath */
-	dbgpath.run(list, DPOpPathClear);
+	/* Clear debug path, i.e remove all DbgStPath of the last step */
+	dbgpath->clearPath();
 
-	if (!g.it->step(MAIN_FUNC_SIGNATURE))
-		return endTraverse(DBG_RS_STATUS_ERROR);
+	if (!context->debugjump->step(MAIN_FUNC_SIGNATURE))
+		return endTraverse(context, DBG_RS_STATUS_ERROR);
 
-	if (g.it->finished()) {
+	if (context->debugjump->finished()) {
 		/* Debugging finished at the end of the code */
 		root->debug_state = ast_dbg_state_end;
-		return endTraverse(DBG_RS_STATUS_FINISHED);
+		return endTraverse(context, DBG_RS_STATUS_FINISHED);
 	}
 
-	/* Build up new debug path; all DbgStPath */
-	dbgpath.run(list, DPOpPathBuild);
+	/* Build up new debug path from the nodes the step changed */
+	dbgpath->buildPath(&context->debugjump->changed);
 	VPRINT(1, "********* Copy scope **********\n");
-	dbgpath.getPath(g.result.scopeStack, shader);
+	dbgpath->getPath(context->result.scopeStack, shader);
+
+	return endTraverse(context, DBG_RS_STATUS_OK);
+}
+
 
-	return endTraverse(DBG_RS_STATUS_OK);
+ShaderContext::ShaderContext() :
+		num_variables(0), debugjump(NULL), debugpath(NULL)
+{
+	resetDbgResult(result);
 }
 
+ShaderContext::~ShaderContext()
+{
+	delete debugjump;
+	delete debugpath;
+}
@@ -10,16 +10,18 @@
 #include "ShaderLang.h"
 
 struct AstShader;
-struct gl_context;
+struct ShaderContext;
+struct CompileSession;
 
-void clearTraverseDebugJump(void);
+void clearTraverseDebugJump(ShaderContext* context);
 void resetDbgResult(DbgResult& r);
-DbgResult* ShaderTraverse(AstShader* shader, int debugOptions, int dbgBh);
+DbgResult* ShaderTraverse(ShaderContext* context, AstShader* shader, int debugOptions,
+		int dbgBh);
 bool ShaderVarTraverse(AstShader* shader, ShVariableList *vl);
 bool compileShaderCode(AstShader* shader);
 bool compileDbgShaderCode(AstShader* shader, ShChangeableList *cgbl, ShVariableList *vl,
 		DbgCgOptions dbgCgOptions, char** code);
 
-void compile_shader_to_ast(struct gl_context *ctx, struct AstShader *shader, int debug);
+void compile_shader_to_ast(CompileSession* session, struct AstShader *shader, int debug);
 
 #endif /* PROGRAM_INTERFACE_TO_MESA */
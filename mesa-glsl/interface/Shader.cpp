@@ -7,6 +7,7 @@
 #include "Shader.h"
 #include "ShaderHolder.h"
 #include "Program.h"
+#include "CompileSession.h"
 #include "SymbolTable.h"
 #include "visitors/postprocess.h"
 
@@ -25,54 +26,6 @@
 #define UNUSED_ARG(x) (void) x;
 #endif
 
-// Variables
-int glsl_es = 0;
-int glsl_version = 330;
-
-
-static void initialize_context(struct gl_context *ctx, const TBuiltInResource* resources)
-{
-	// FIXME: right api
-	initialize_context_to_defaults(ctx, API_OPENGL_COMPAT);
-	/* The standalone compiler needs to claim support for almost
-	 * everything in order to compile the built-in functions.
-	 */
-	ctx->Const.GLSLVersion = glsl_version;
-	ctx->Extensions.ARB_ES3_compatibility = true;
-
-	/* 1.20 minimums. */
-	ctx->Const.MaxLights = resources->maxLights;
-	ctx->Const.MaxClipPlanes = resources->maxClipPlanes;
-	ctx->Const.MaxTextureUnits = resources->maxTextureUnits;
-
-	/* allow high amount */
-	ctx->Const.MaxTextureCoordUnits = resources->maxTextureCoords;
-
-	ctx->Const.Program[MESA_SHADER_VERTEX].MaxAttribs = resources->maxVertexAttribs;
-	ctx->Const.Program[MESA_SHADER_VERTEX].MaxUniformComponents = resources->maxVertexUniformComponents;
-	ctx->Const.Program[MESA_SHADER_FRAGMENT].MaxUniformComponents = resources->maxFragmentUniformComponents;
-	ctx->Const.MaxVarying = resources->maxVaryingFloats;
-	ctx->Const.MaxCombinedTextureImageUnits = resources->maxCombinedTextureImageUnits;
-	ctx->Const.Program[MESA_SHADER_VERTEX].MaxTextureImageUnits = resources->maxVertexTextureImageUnits;
-//	ctx->Const.FragmentProgram.MaxTextureImageUnits = 16;
-//	ctx->Const.GeometryProgram.MaxTextureImageUnits = 16;
-
-	ctx->Const.MaxDrawBuffers = resources->maxDrawBuffers;
-	ctx->Const.MaxGeometryOutputVertices = resources->geoVerticesOut;
-	// I saw it in mailing list in the latest mesa git, I think. Or not.
-	// But anyway I cannot find anything in current headers and we using only stable mesa now.
-	//	int geoVerticesIn;
-	//	int geoInputType;
-	//	int geoOutputType;
-
-	ctx->Driver.NewShader = _mesa_new_shader;
-
-	// Enable required extensions
-	ctx->Extensions.ARB_framebuffer_object = (GLboolean)resources->framebufferObjectsSupported;
-	ctx->Extensions.EXT_transform_feedback = (GLboolean)resources->transformFeedbackSupported;
-	ctx->Extensions.ARB_geometry_shader4 = (GLboolean)resources->geoShaderSupported;
-}
-
 int addShVariableList(ShVariableList *vl, AstShader* shader)
 {
 	int count = 0;
@@ -82,7 +35,7 @@ int addShVariableList(ShVariableList *vl, AstShader* shader)
 		if (!dlist)
 			continue;
 		foreach_list_typed (ast_declaration, decl, link, &dlist->declarations){
-			ShVariable* var = findShVariable(decl->debug_id);
+			ShVariable* var = findShVariable(shader->context, decl->debug_id);
 			addShVariableCtx(vl, var, var->builtin, shader);
 			count++;
 		}
@@ -91,8 +44,9 @@ int addShVariableList(ShVariableList *vl, AstShader* shader)
 	return count;
 }
 
-void compile_shader_to_ast(struct gl_context *ctx, struct AstShader *shader, int)
+void compile_shader_to_ast(CompileSession* session, struct AstShader *shader, int)
 {
+	struct gl_context *ctx = session->ctx;
 	struct _mesa_glsl_parse_state *state = new (shader) _mesa_glsl_parse_state(
 			ctx, shader->stage, shader);
 	const char *source = shader->source;
@@ -105,9 +59,8 @@ void compile_shader_to_ast(struct gl_context *ctx, struct AstShader *shader, int
 	}
 
 	if (!state->error) {
-		exec_list instructions;
 		/* We need global variables later */
-		_mesa_glsl_initialize_variables(&instructions, state);
+		session->addBuiltInVariables(state);
 		state->symbols->push_scope();
 		shader->head = &state->translation_unit;
 	}
@@ -171,9 +124,7 @@ ShHandle ShConstructCompiler(const EShLanguage language, int debugOptions)
 	ShaderHolder* holder = rzalloc(NULL, struct ShaderHolder);
 	holder->language = language;
 	holder->debug_options = debugOptions;
-	holder->ctx = rzalloc(holder, struct gl_context);
-	initialize_context_to_defaults( holder->ctx,
-					( glsl_es ) ? API_OPENGLES2 : API_OPENGL_COMPAT );
+	holder->context = new(holder) ShaderContext;
 	return reinterpret_cast< void* >( holder );
 }
 
@@ -198,10 +149,6 @@ void ShDestruct(ShHandle handle)
 		return;
 
 	ShaderHolder* holder = reinterpret_cast< ShaderHolder* >( handle );
-
-	if( holder->ctx )
-		ralloc_free(holder->ctx);
-
 	ralloc_free(holder);
 	holder = NULL;
 }
@@ -211,6 +158,7 @@ void ShDestruct(ShHandle handle)
 //
 int __fastcall ShFinalize( )
 {
+	CompileSession::releaseAll();
 	_mesa_glsl_release_types();
 	// Lol, mesa just lost it.
 	//_mesa_glsl_release_functions();
@@ -235,13 +183,14 @@ int ShCompile(const ShHandle handle, const char* const shaderStrings[],
 	if (handle == NULL)
 		return 0;
 
-	clearTraverseDebugJump();
+	ShaderHolder* holder = reinterpret_cast<ShaderHolder*>(handle);
+	clearTraverseDebugJump(holder->context);
 
 	vl->numVariables = 0;
 	vl->variables = NULL;
 
-	ShaderHolder* holder = reinterpret_cast<ShaderHolder*>(handle);
-	initialize_context(holder->ctx, resources);
+	holder->session = CompileSession::get(resources);
+	holder->ctx = holder->session->ctx;
 
 	bool success = true;
 	for (int shnum = 0; numStrings > shnum; shnum++) {
@@ -249,6 +198,7 @@ int ShCompile(const ShHandle handle, const char* const shaderStrings[],
 						struct AstShader*, holder->num_shaders + 1);
 		AstShader* shader = rzalloc(holder, struct AstShader);
 		shader->symbols = new(holder) sh_symbol_table;
+		shader->context = holder->context;
 		holder->shaders[holder->num_shaders] = shader;
 		holder->num_shaders++;
 
@@ -268,10 +218,7 @@ int ShCompile(const ShHandle handle, const char* const shaderStrings[],
 			break;
 		}
 
-		char* old_locale = setlocale(LC_NUMERIC, NULL);
-		setlocale(LC_NUMERIC, "POSIX");
-		compile_shader_to_ast(holder->ctx, shader, debugOptions);
-		setlocale(LC_NUMERIC, old_locale);
+		compile_shader_to_ast(holder->session, shader, debugOptions);
 
 		// TODO: informative names
 		if (!shader->compile_status) {
@@ -301,7 +248,7 @@ DbgResult* ShDebugJumpToNext(const ShHandle handle, int debugOptions, int dbgBh)
 
 	ShaderHolder* holder = reinterpret_cast< ShaderHolder* >( handle );
 	AstShader* shader = holder->shaders[0];
-	result = ShaderTraverse(shader, debugOptions, dbgBh);
+	result = ShaderTraverse(holder->context, shader, debugOptions, dbgBh);
 	return result;
 
 }
@@ -13,6 +13,8 @@ class exec_list;
 class ast_node;
 class ast_type_qualifier;
 class ir_variable;
+struct AstShader;
+struct ShaderContext;
 
 // Changeagles
 ShChangeable* createShChangeableCtx(int id, void* mem_ctx);
@@ -25,16 +27,16 @@ void copyShChangeableToListCtx(ShChangeableList *cl, ShChangeable *c, void* mem_
 void copyShChangeableListCtx(ShChangeableList *clout, exec_list *clin, void* mem_ctx);
 
 // Variables
-ShVariable* findShVariable(int id);
+ShVariable* findShVariable(ShaderContext* context, int id);
 ShVariable* findShVariableFromId(ShVariableList *vl, int id);
 ShVariable* findFirstShVariableFromName(ShVariableList *vl, const char *name);
 
 ShVariable* copyShVariableCtx(ShVariable *src, void* mem_ctx);
 void addShVariableCtx(ShVariableList *vl, ShVariable *v, int builtin, void *mem_ctx);
-void addAstShVariable(ast_node*, ShVariable*);
+void addAstShVariable(ShaderContext*, ast_node*, ShVariable*);
 ShVariable* astToShVariable(ast_node* decl, variableQualifier qualifier,
 		variableVaryingModifier modifier, const struct glsl_type* decl_type,
-		void* mem_ctx);
+		AstShader* shader);
 
 variableQualifier qualifierFromAst(const ast_type_qualifier* qualifier, bool is_parameter);
 variableQualifier qualifierFromIr(ir_variable* var);
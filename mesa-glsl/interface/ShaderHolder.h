@@ -10,12 +10,58 @@
 #include "ShaderLang.h"
 #include "AstStack.h"
 #include "main/mtypes.h"
+#include "mesa/util/ralloc.h"
+#include <map>
+#include <assert.h>
 
 
 struct sh_symbol_table;
 struct ast_type_qualifier;
 struct sh_extension;
 struct exec_list;
+class ast_debugjump_traverser_visitor;
+class ast_debugpath_traverser_visitor;
+struct CompileSession;
+
+/*
+ * Everything of a compiler handle that is not part of its shaders. Handles
+ * share nothing, so different handles can compile shaders and generate debug
+ * code in different threads at the same time.
+ */
+struct ShaderContext {
+	/* Callers of this ralloc-based new need not call delete. */
+	static void* operator new(size_t size, void *ctx)
+	{
+		void *context = ralloc_size(ctx, size);
+		assert(context != NULL);
+		ralloc_set_destructor(context, _destructor);
+		return context;
+	}
+
+	static void operator delete(void *context)
+	{
+		ralloc_set_destructor(context, NULL);
+		ralloc_free(context);
+	}
+
+	ShaderContext();
+	~ShaderContext();
+
+	/* ShVariables of the declarations by uniqueId, they belong to the shaders */
+	std::map<int, ShVariable*> variables;
+	int num_variables;
+
+	/* state of ShDebugJumpToNext */
+	ast_debugjump_traverser_visitor* debugjump;
+	ast_debugpath_traverser_visitor* debugpath;
+	DbgResult result;
+
+private:
+	static void _destructor(void *context)
+	{
+		static_cast<ShaderContext*>(context)->~ShaderContext();
+	}
+};
 
 
 typedef enum {
@@ -40,6 +86,7 @@ struct AstShader {
 	AstStack path;
 	bool gs_input_prim_type_specified;
 	ast_type_qualifier* qualifiers[SQ_LAST];
+	ShaderContext* context;
 };
 
 struct ShaderHolder {
@@ -47,7 +94,10 @@ struct ShaderHolder {
 	EShLanguage language;
 	AstShader** shaders;
 	unsigned num_shaders;
+	/* context of the session, the handle does not own them */
 	struct gl_context* ctx;
+	CompileSession* session;
+	ShaderContext* context;
 };
 
 
@@ -0,0 +1,119 @@
+/*
+ * StringBuffer.cpp
+ *
+ *  Created on: 16.10.2026
+ */
+
+#include "StringBuffer.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+
+StringBuffer::StringBuffer(size_t _capacity)
+{
+	capacity = _capacity > 0 ? _capacity : 1;
+	data = (char*) malloc(capacity);
+	assert(data || !"StringBuffer - not enough memory");
+	data[0] = '\0';
+	len = 0;
+}
+
+StringBuffer::~StringBuffer()
+{
+	free(data);
+}
+
+void StringBuffer::grow(size_t min_capacity)
+{
+	size_t new_capacity = capacity;
+	while (new_capacity < min_capacity)
+		new_capacity *= 2;
+
+	data = (char*) realloc(data, new_capacity);
+	assert(data || !"StringBuffer - not enough memory");
+	capacity = new_capacity;
+}
+
+void StringBuffer::appendUInt(unsigned int value)
+{
+	char digits[16];
+	int n = sizeof(digits);
+
+	do {
+		digits[--n] = (char) ('0' + value % 10);
+		value /= 10;
+	} while (value);
+	append(digits + n, sizeof(digits) - n);
+}
+
+void StringBuffer::appendInt(int value)
+{
+	if (value < 0) {
+		append('-');
+		appendUInt(0u - (unsigned int) value);
+	} else {
+		appendUInt((unsigned int) value);
+	}
+}
+
+void StringBuffer::appendFloat(float value)
+{
+	char text[64];
+	int n;
+
+#ifdef _MSC_VER
+	static _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+	n = _snprintf_l(text, sizeof(text), "%f", c_locale, value);
+#else
+	/* uselocale only changes the locale of the calling thread */
+	static locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0);
+	locale_t old_locale = uselocale(c_locale);
+	n = snprintf(text, sizeof(text), "%f", value);
+	uselocale(old_locale);
+#endif
+	if (n < 0 || n >= (int) sizeof(text))
+		n = strlen(text);
+	append(text, n);
+}
+
+void StringBuffer::printf(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void StringBuffer::vprintf(const char* fmt, va_list args)
+{
+	va_list args_copy;
+
+	/* Print in place, the tail usually has enough room */
+	va_copy(args_copy, args);
+	int n = vsnprintf(data + len, capacity - len, fmt, args_copy);
+	va_end(args_copy);
+	assert(n >= 0 || !"StringBuffer - bad format string");
+	if (n < 0) {
+		data[len] = '\0';
+		return;
+	}
+
+	if (len + n >= capacity) {
+		grow(len + n + 1);
+		va_copy(args_copy, args);
+		vsnprintf(data + len, capacity - len, fmt, args_copy);
+		va_end(args_copy);
+	}
+	len += n;
+}
+
+void StringBuffer::clear()
+{
+	len = 0;
+	data[0] = '\0';
+}
@@ -0,0 +1,88 @@
+/*
+ * StringBuffer.h
+ *
+ *  Created on: 16.10.2026
+ */
+
+#ifndef STRING_BUFFER_H_
+#define STRING_BUFFER_H_
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+
+#if defined(__GNUC__)
+#define STRING_BUFFER_PRINTFLIKE(f, a) __attribute__ ((format(__printf__, f, a)))
+#else
+#define STRING_BUFFER_PRINTFLIKE(f, a)
+#endif
+
+/*
+ * Output buffer for the generated debug shaders. Keeps track of its length
+ * and grows geometrically, so appending does not rescan or copy the code
+ * emitted so far like ralloc_asprintf_append does.
+ */
+class StringBuffer {
+public:
+	StringBuffer(size_t capacity = 4096);
+	~StringBuffer();
+
+	/* identifiers, keywords and operators */
+	inline void append(const char* str)
+	{
+		append(str, strlen(str));
+	}
+
+	inline void append(const char* str, size_t n)
+	{
+		reserve(n);
+		memcpy(data + len, str, n);
+		len += n;
+		data[len] = '\0';
+	}
+
+	inline void append(char c)
+	{
+		reserve(1);
+		data[len++] = c;
+		data[len] = '\0';
+	}
+
+	/* numbers, always printed like in the "C" locale */
+	void appendInt(int value);
+	void appendUInt(unsigned int value);
+	void appendFloat(float value);
+
+	void printf(const char* fmt, ...) STRING_BUFFER_PRINTFLIKE(2, 3);
+	void vprintf(const char* fmt, va_list args);
+
+	inline const char* c_str() const
+	{
+		return data;
+	}
+
+	inline size_t length() const
+	{
+		return len;
+	}
+
+	void clear();
+
+private:
+	/* make room for n more characters and the terminating zero */
+	inline void reserve(size_t n)
+	{
+		if (len + n >= capacity)
+			grow(len + n + 1);
+	}
+	void grow(size_t min_capacity);
+
+	StringBuffer(const StringBuffer&);
+	StringBuffer& operator=(const StringBuffer&);
+
+	char* data;
+	size_t len;
+	size_t capacity;
+};
+
+#endif /* STRING_BUFFER_H_ */
@@ -6,6 +6,7 @@
 
 #include "ShaderLang.h"
 #include "AstScope.h"
+#include "ShaderHolder.h"
 #include "mesa/glsl/ast.h"
 #include "glsldb/utils/dbgprint.h"
 #include <map>
@@ -33,9 +34,6 @@ namespace {
 		else
 			return NULL;
 	}
-
-	std::map<int, ShVariable*> VariablesById;
-	unsigned int VariablesCount = 0;
 }
 
 
@@ -293,11 +291,11 @@ void addShVariableCtx(ShVariableList *vl, ShVariable *v, int builtin, void* mem_
 	vl->variables[vl->numVariables - 1] = v;
 }
 
-ShVariable* findShVariable(int id)
+ShVariable* findShVariable(ShaderContext* context, int id)
 {
 	if (id >= 0) {
-		std::map<int, ShVariable*>::iterator it = VariablesById.find(id);
-		if (it != VariablesById.end())
+		std::map<int, ShVariable*>::iterator it = context->variables.find(id);
+		if (it != context->variables.end())
 			return it->second;
 	}
 	return NULL;
@@ -475,11 +473,8 @@ void freeShVariable(ShVariable **var)
 	if (!var || *var == NULL)
 		return;
 
-	// Remove variable from storages if it is not copy
-	auto iit = VariablesById.find((*var)->uniqueId);
-	if (iit != VariablesById.end() && iit->second == *var)
-		VariablesById.erase(iit);
-
+	// Registered variables stay in the ShaderContext of their compiler
+	// until it is destructed, do not debug with it afterwards
 	ralloc_free(*var);
 	*var = NULL;
 }
@@ -559,17 +554,17 @@ static void glsltypeToShVariable(ShVariable* var, const struct glsl_type* vtype,
 	}
 }
 
-void addAstShVariable(ast_node* decl, ShVariable* var)
+void addAstShVariable(ShaderContext* context, ast_node* decl, ShVariable* var)
 {
-	var->uniqueId = VariablesCount++;
-	VariablesById[var->uniqueId] = var;
+	var->uniqueId = context->num_variables++;
+	context->variables[var->uniqueId] = var;
 	decl->debug_id = var->uniqueId;
 }
 
 
 ShVariable* astToShVariable(ast_node* decl, variableQualifier qualifier,
 		variableVaryingModifier modifier, const struct glsl_type* decl_type,
-		void* mem_ctx)
+		AstShader* shader)
 {
 	if (!decl)
 		return NULL;
@@ -578,14 +573,14 @@ ShVariable* astToShVariable(ast_node* decl, variableQualifier qualifier,
 	if (!identifier)
 		return NULL;
 
-	ShVariable* var = findShVariable(decl->debug_id);
+	ShVariable* var = findShVariable(shader->context, decl->debug_id);
 	if (!var) {
-		var = (ShVariable*)rzalloc(mem_ctx, ShVariable);
+		var = (ShVariable*)rzalloc(shader, ShVariable);
 		var->uniqueId = -1;
 		var->builtin = qualifier & SH_BUILTIN;
 		var->name = ralloc_strdup(var, identifier);
 		glsltypeToShVariable(var, decl_type, qualifier, modifier);
-		addAstShVariable(decl, var);
+		addAstShVariable(shader->context, decl, var);
 	}
 
 	return var;
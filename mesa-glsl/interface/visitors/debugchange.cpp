@@ -267,7 +267,7 @@ bool ast_debugchange_traverser_visitor::enter(class ast_function_expression* nod
 		ast_node* dast = exec_node_data(ast_node, pD, link);
 		if (dast->debug_id < 0)
 			continue;
-		ShVariable* dvar = findShVariable(dast->debug_id);
+		ShVariable* dvar = findShVariable(shader->context, dast->debug_id);
 		ast_node* cast = exec_node_data(ast_node, pC, link);
 		if (dvar->qualifier & SH_OUT)
 			this->activate();
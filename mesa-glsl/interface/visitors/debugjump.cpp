@@ -25,6 +25,7 @@ bool ast_debugjump_traverser_visitor::step(const char* name)
 {
 	/* Initialize parse tree for debugging if necessary */
 	operation = OTOpTargetUnset;
+	changed.clear();
 	if (parseStack.empty()) {
 		ast_function_definition* func = shader->symbols->get_function(name);
 		if (!func)
@@ -77,7 +78,7 @@ void ast_debugjump_traverser_visitor::processDebugable(ast_node *node)
 	if (operation == OTOpTargetUnset) {
 		if (node->debug_state == ast_dbg_state_target
 				|| node->debug_state == ast_dbg_state_call) {
-			node->debug_state = ast_dbg_state_unset;
+			setDebugState(node, ast_dbg_state_unset);
 			operation = OTOpTargetSet;
 			VPRINT( 3, "\t ------- unset target --------\n");
 			result.position = DBG_RS_POSITION_UNSET;
@@ -85,7 +86,7 @@ void ast_debugjump_traverser_visitor::processDebugable(ast_node *node)
 	} else if (operation == OTOpTargetSet) {
 		assert(node->debug_state != ast_dbg_state_target || !"ERROR! found target with DbgStTarget\n");
 		if (node->debug_state == ast_dbg_state_unset) {
-			node->debug_state = ast_dbg_state_target;
+			setDebugState(node, ast_dbg_state_target);
 			operation = OTOpDone;
 			VPRINT(3, "\t -------- set target ---------\n");
 			if (node->as_expression())
@@ -469,7 +470,7 @@ void ast_debugjump_traverser_visitor::leave(class ast_function_expression* node)
 			VPRINT(2, "\t ---- push %p on stack ----\n", funcDef);
 			this->parseStack.push(funcDef);
 			this->operation = OTOpTargetSet;
-			node->debug_state = ast_dbg_state_call;
+			setDebugState(node, ast_dbg_state_call);
 
 			// add local parameters of called function first
 			copyShChangeableListCtx(&result.cgbls, &funcDef->prototype->changeables, shader);
@@ -503,7 +504,7 @@ void ast_debugjump_traverser_visitor::leave(class ast_function_expression* node)
 			assert(!"ERROR! found target with DbgStTarget\n");
 
 		if (node->debug_state == ast_dbg_state_unset) {
-			node->debug_state = ast_dbg_state_target;
+			setDebugState(node, ast_dbg_state_target);
 			VPRINT( 3, "\t -------- set target ---------\n");
 			result.position = DBG_RS_POSITION_FUNCTION_CALL;
 			setDbgResultRange(result.range, node->get_location());
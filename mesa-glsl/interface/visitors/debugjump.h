@@ -49,6 +49,13 @@ public:
 	}
 
 	bool step(const char* name);
+
+	/* Records the node, so the debug path only needs to look at these */
+	inline void setDebugState(ast_node* node, enum ast_dbg_state state)
+	{
+		node->debug_state = state;
+		changed.push(node);
+	}
 	void setGobalScope(exec_list*);
 	void addShChangeables(ast_node* node);
 	void checkReturns(ast_node*);
@@ -82,6 +89,8 @@ public:
 
 	OTOperation operation;
     AstStack parseStack;
+    /* nodes with a new debug state since the last step */
+    AstStack changed;
     int dbgBehaviour;
     bool finishedDbgFunction;
     AstShader* shader;
@@ -34,7 +34,7 @@ static inline DbgRsTargetPosition loop_position(ast_iteration_statement::ast_ite
 
 #define SET_OPERATION_INTERNAL(internal, op, ds, dsi, pos) \
 	this->operation = op;				\
-	node->debug_state = ds;				\
+	setDebugState(node, ds);			\
 	internal = dsi;						\
 	result.position = pos;
 
@@ -86,7 +86,7 @@ bool ast_debugjump_traverser_visitor::selection(class ast_node* node,
 		}
 		case ast_dbg_if_condition_passed: {
 			VPRINT(3, "\t ------- unset target again --------\n");
-			node->debug_state = ast_dbg_state_unset;
+			setDebugState(node, ast_dbg_state_unset);
 			this->operation = OTOpTargetSet;
 			result.position = DBG_RS_POSITION_UNSET;
 
@@ -206,7 +206,7 @@ bool ast_debugjump_traverser_visitor::enter(class ast_switch_statement* node)
 		}
 		case ast_dbg_switch_condition_passed: {
 			VPRINT( 3, "\t ------- unset target again --------\n");
-			node->debug_state = ast_dbg_state_unset;
+			setDebugState(node, ast_dbg_state_unset);
 			this->operation = OTOpTargetSet;
 			result.position = DBG_RS_POSITION_UNSET;
 
@@ -381,7 +381,7 @@ bool ast_debugjump_traverser_visitor::enter(class ast_iteration_statement* node)
 					 */
 
 					/* Reset target */
-					node->debug_state = ast_dbg_state_target;
+					setDebugState(node, ast_dbg_state_target);
 					node->debug_state_internal = ast_dbg_loop_select_flow;
 
 					/* Increase iteration */
@@ -441,7 +441,7 @@ bool ast_debugjump_traverser_visitor::enter(class ast_iteration_statement* node)
 				|| (node->debug_state_internal >= ast_dbg_loop_wrk_init
 						&& node->debug_state_internal <= ast_dbg_loop_wrk_terminal)) {
 			VPRINT(3, "\t -------- set target ---------\n");
-			node->debug_state = ast_dbg_state_target;
+			setDebugState(node, ast_dbg_state_target);
 			this->operation = OTOpDone;
 			YYLTYPE loc;
 
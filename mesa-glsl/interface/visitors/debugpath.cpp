@@ -10,189 +10,199 @@
 #include "mesa/glsl/ast.h"
 #include "mesa/glsl/list.h"
 #include "glsldb/utils/dbgprint.h"
-
-static inline void childPath(ast_node* node, ast_node* child)
-{
-	if (node->debug_state == ast_dbg_state_unset)
-		if (child && child->debug_state != ast_dbg_state_unset)
-			node->debug_state = ast_dbg_state_path;
-}
+#include <algorithm>
+#include <set>
 
 void ast_debugpath_traverser_visitor::getPath(DbgRsScope& scope, AstShader* shader)
 {
+	std::vector<exec_list*> scopes;
+
 	shader->path.clear();
-	path.copy(&shader->path);
-	while(!path.empty()) {
-		ast_node* top = path.top();
-		addScopeToScopeStack(scope, &top->scope, shader);
-		path.pop();
-	}
+	for (unsigned i = 0; i < path.size(); ++i)
+		shader->path.push(path[i]);
+
+	for (unsigned i = path.size(); i > 0; --i)
+		scopes.push_back(&path[i - 1]->scope);
+	addScopesToScopeStack(scope, scopes, shader);
 }
 
 void ast_debugpath_traverser_visitor::run(exec_list* node, enum DPOperation op)
 {
-	if (op == DPOpPathClear) {
-		VPRINT(1, "********* clear path traverse **********\n");
-	} else if (op == DPOpPathBuild) {
-		VPRINT(1, "********* create path traverse **********\n");
-	} else if (op == DPOpReset) {
+	if (op == DPOpReset) {
 		VPRINT(1, "********* reset traverse **********\n");
 	} else {
 		assert(!"Wrong operation type");
 	}
 
 	this->action = op;
+	this->order = 0;
 	this->visit(node);
 }
 
+void ast_debugpath_traverser_visitor::reset(exec_list* list)
+{
+	run(list, DPOpReset);
+	path.clear();
+	marked.clear();
+}
+
+void ast_debugpath_traverser_visitor::clearPath()
+{
+	VPRINT(1, "********* clear path **********\n");
+	for (unsigned i = 0; i < path.size(); ++i)
+		if (path[i]->debug_state == ast_dbg_state_path)
+			path[i]->debug_state = ast_dbg_state_unset;
+	path.clear();
+}
+
+static bool byOrder(const ast_node* a, const ast_node* b)
+{
+	return a->debug_order < b->debug_order;
+}
+
+static inline bool isMarked(ast_node* node)
+{
+	/* Nodes the reset traverse did not reach cannot be on the path */
+	return node->debug_order
+			&& (node->debug_state == ast_dbg_state_target
+					|| node->debug_state == ast_dbg_state_call);
+}
+
+void ast_debugpath_traverser_visitor::buildPath(AstStack* changed)
+{
+	VPRINT(1, "********* create path **********\n");
+
+	/* Targets and calls either stayed from the last step or were just set */
+	std::set<ast_node*> candidates(marked.begin(), marked.end());
+	for (ast_node* node = changed->back(); node != NULL; node = changed->next())
+		candidates.insert(node);
+
+	marked.clear();
+	for (std::set<ast_node*>::iterator it = candidates.begin(); it != candidates.end(); ++it)
+		if (isMarked(*it))
+			marked.push_back(*it);
+
+	/* Everything above a marked node is path, each node is added once */
+	std::set<ast_node*> visited;
+	for (unsigned i = 0; i < marked.size(); ++i) {
+		for (ast_node* node = marked[i]; node; node = node->debug_parent) {
+			if (!visited.insert(node).second)
+				break;
+			if (node->debug_state == ast_dbg_state_unset)
+				node->debug_state = ast_dbg_state_path;
+			path.push_back(node);
+		}
+	}
+
+	/* Same order a post-order traverse of the whole tree would push them */
+	std::sort(path.begin(), path.end(), byOrder);
+}
+
 void ast_debugpath_traverser_visitor::processDebugable(ast_node* node)
 {
 	VPRINT(3, "path Debugable L:%s Op:%i DbgSt:%i\n",
 			FormatSourceRange(node->get_location()).c_str(), action, node->debug_state);
 
-	if (action == DPOpPathClear) {
-		if (node->debug_state == ast_dbg_state_path)
-			node->debug_state = ast_dbg_state_unset;
-	} else if (action == DPOpReset) {
+	if (action == DPOpReset)
 		node->debug_state = ast_dbg_state_unset;
-	}
 }
 
-void ast_debugpath_traverser_visitor::leave(class ast_expression* node)
+void ast_debugpath_traverser_visitor::link(ast_node* node, ast_node* child)
 {
-	processDebugable(node);
+	if (child)
+		child->debug_parent = node;
+}
 
-	if (action != DPOpPathBuild)
-		return;
+void ast_debugpath_traverser_visitor::linked(ast_node* node)
+{
+	node->debug_order = ++order;
+}
 
-	if (action == DPOpReset)
-		node->debug_state_internal = ast_dbg_if_unset;
+void ast_debugpath_traverser_visitor::leave(class ast_expression* node)
+{
+	processDebugable(node);
 
-	if (node->oper == ast_conditional) {
-		childPath(node, node->subexpressions[1]);
-		childPath(node, node->subexpressions[2]);
-		childPath(node, node->subexpressions[0]);
-	} else {
-		for (int i = 0; i < 3; ++i)
-			childPath(node, node->subexpressions[i]);
-	}
+	node->debug_state_internal = ast_dbg_if_unset;
 
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	for (int i = 0; i < 3; ++i)
+		link(node, node->subexpressions[i]);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_expression_bin* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
 	for (int i = 0; i < 2; ++i)
-		childPath(node, node->subexpressions[i]);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+		link(node, node->subexpressions[i]);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_function_expression* node)
 {
 	processDebugable(node);
-	if (action == DPOpPathBuild && node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_expression_statement* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->expression);
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->expression);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_compound_statement* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
 	foreach_list_typed(ast_node, ast, link, &node->statements)
-		childPath(node, ast);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+		link(node, ast);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_declaration* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->initializer);
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->initializer);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_declarator_list* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
 	foreach_list_typed(ast_node, ast, link, &node->declarations)
-		childPath(node, ast);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+		link(node, ast);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_case_statement* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->labels);
-
+	link(node, node->labels);
 	foreach_list_typed(ast_node, ast, link, &node->stmts)
-		childPath(node, ast);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+		link(node, ast);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_case_statement_list* node)
 {
 	processDebugable(node);
 
-	if (action != DPOpPathBuild)
-		return;
-
 	foreach_list_typed(ast_node, ast, link, &node->cases)
-		childPath(node, ast);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+		link(node, ast);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_switch_body* node)
 {
 	processDebugable(node);
-	if (action != DPOpPathBuild)
-		return;
 
-	childPath(node, node->stmts);
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->stmts);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_switch_statement* node)
@@ -201,18 +211,11 @@ void ast_debugpath_traverser_visitor::leave(class ast_switch_statement* node)
 			node->debug_state);
 
 	processDebugable(node);
+	node->debug_state_internal = ast_dbg_switch_unset;
 
-	if (action == DPOpReset)
-		node->debug_state_internal = ast_dbg_switch_unset;
-
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->test_expression);
-	childPath(node, node->body);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->test_expression);
+	link(node, node->body);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_selection_statement* node)
@@ -221,20 +224,12 @@ void ast_debugpath_traverser_visitor::leave(class ast_selection_statement* node)
 			node->debug_state);
 
 	processDebugable(node);
+	node->debug_state_internal = ast_dbg_if_unset;
 
-	if (action == DPOpReset)
-		node->debug_state_internal = ast_dbg_if_unset;
-
-
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->then_statement);
-	childPath(node, node->else_statement);
-	childPath(node, node->condition);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->then_statement);
+	link(node, node->else_statement);
+	link(node, node->condition);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_iteration_statement* node)
@@ -243,23 +238,15 @@ void ast_debugpath_traverser_visitor::leave(class ast_iteration_statement* node)
 			node->debug_state);
 
 	processDebugable(node);
-
-	if (action == DPOpReset) {
-		node->debug_state_internal = ast_dbg_loop_unset;
-		node->debug_iter = 0;
-	}
-
-	/* Check init, test, terminal, and body */
-	if (action != DPOpPathBuild)
-		return;
-
-	childPath(node, node->init_statement);
-	childPath(node, node->condition);
-	childPath(node, node->rest_expression);
-	childPath(node, node->body);
-
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	node->debug_state_internal = ast_dbg_loop_unset;
+	node->debug_iter = 0;
+
+	/* Link init, test, terminal, and body */
+	link(node, node->init_statement);
+	link(node, node->condition);
+	link(node, node->rest_expression);
+	link(node, node->body);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_function_definition* node)
@@ -269,22 +256,15 @@ void ast_debugpath_traverser_visitor::leave(class ast_function_definition* node)
 			action, node->debug_state);
 
 	processDebugable(node);
-	if (action != DPOpPathBuild)
-		return;
 
-	VPRINT(6, "getDebugState: %i\n", node->body->debug_state);
-	childPath(node, node->body);
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->body);
+	linked(node);
 }
 
 void ast_debugpath_traverser_visitor::leave(class ast_jump_statement* node)
 {
 	processDebugable(node);
-	if (action != DPOpPathBuild)
-		return;
 
-	childPath(node, node->opt_return_value);
-	if (node->debug_state != ast_dbg_state_unset)
-		path.push(node);
+	link(node, node->opt_return_value);
+	linked(node);
 }
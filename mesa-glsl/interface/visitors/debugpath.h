@@ -11,21 +11,27 @@
 #include "ShaderHolder.h"
 #include "AstStack.h"
 #include "mesa/glsl/ast_visitor.h"
+#include <vector>
 
 
 enum DPOperation {
-    DPOpPathClear,           // Clear all path nodes, but not targets
-    DPOpPathBuild,           // Construct path from root to targets
-    DPOpReset,               // Reconstruct initial debug state
+    DPOpReset,               // Reconstruct initial debug state, link nodes
 };
 
 
+/*
+ * Maintains the debug path, i.e. the nodes from the function definitions
+ * down to the target and the calls. The tree is traversed only on reset,
+ * which links every node to the one the path continues with. A step then
+ * only walks up from the nodes the jump traverser marked.
+ */
 class ast_debugpath_traverser_visitor : public ast_traverse_visitor {
 public:
 	ast_debugpath_traverser_visitor()
 	{
 		passedTarget = false;
 		action = DPOpReset;
+		order = 0;
 	}
 
 	virtual ~ast_debugpath_traverser_visitor()
@@ -36,6 +42,14 @@ public:
 	void run(exec_list*, enum DPOperation);
 	void processDebugable(ast_node*);
 
+	/* Reset all debug states of the tree and forget the path */
+	void reset(exec_list*);
+	/* Unset the path nodes of the last step, but not targets */
+	void clearPath();
+	/* Construct path from the function definitions to targets and calls;
+	 * changed are the nodes the jump traverser set since clearPath. */
+	void buildPath(AstStack* changed);
+
 	virtual void leave(class ast_expression *);
 	virtual void leave(class ast_expression_bin *);
 	virtual void leave(class ast_function_expression *);
@@ -53,9 +67,16 @@ public:
 	virtual void leave(class ast_jump_statement*);
 
 protected:
-	AstStack path;
+	void link(ast_node*, ast_node*);
+	void linked(ast_node*);
+
+	/* sorted like a post-order traverse would push them */
+	std::vector<ast_node*> path;
+	/* targets and calls the last path was built from */
+	std::vector<ast_node*> marked;
 	bool passedTarget;
 	enum DPOperation action;
+	int order;
 };
 
 
@@ -85,7 +85,7 @@ bool ast_debugvar_traverser_visitor::enter(class ast_compound_statement* node)
 
 bool ast_debugvar_traverser_visitor::enter(class ast_declaration* node)
 {
-	ShVariable* var = findShVariable(node->debug_id);
+	ShVariable* var = findShVariable(shader->context, node->debug_id);
 	assert(var);
 
 	VPRINT(3, "%c%sdeclaration of %s <%i>%c%s\n", ESC_CHAR, ESC_BOLD,
@@ -125,7 +125,7 @@ bool ast_debugvar_traverser_visitor::enter(class ast_parameter_declarator* node)
 	if (node->is_void)
 		return false;
 
-	ShVariable* var = findShVariable(node->debug_id);
+	ShVariable* var = findShVariable(shader->context, node->debug_id);
 	assert(var);
 
 	VPRINT(3, "%c%sparameter %s <%i> %c%s\n", ESC_CHAR, ESC_BOLD,
@@ -13,22 +13,22 @@
 
 #include <assert.h>
 
-static void print_variable(char **buffer, ast_node* node, const char* name, ShVariableList* vl)
+static void print_variable(StringBuffer* buffer, ast_node* node, const char* name, ShVariableList* vl)
 {
-	ralloc_asprintf_append(buffer, "%s", name);
+	buffer->append(name);
 	int postfix = node->debug_id;
 	ShVariable* var = findShVariableFromId(vl, postfix);
 	/* Add postfix to all non-builtin symbols due to !@$#^$% scope hiding */
 	if (var && !var->builtin && var->qualifier != SH_VARYING_IN
 				&& var->qualifier != SH_VARYING_OUT && var->qualifier != SH_UNIFORM
-				&& var->qualifier != SH_ATTRIBUTE)
-		ralloc_asprintf_append(buffer, "_%i", postfix);
+				&& var->qualifier != SH_ATTRIBUTE) {
+		buffer->append('_');
+		buffer->appendInt(postfix);
+	}
 }
 
 ast_output_traverser_visitor::~ast_output_traverser_visitor()
 {
-	if (buffer)
-		ralloc_free(buffer);
 }
 
 void ast_output_traverser_visitor::dump()
@@ -36,7 +36,7 @@ void ast_output_traverser_visitor::dump()
 	dbgPrint(DBGLVL_COMPILERINFO, "\n"
 			"XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n"
 			"%s\n"
-			"XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n", buffer);
+			"XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n", buffer.c_str());
 }
 
 bool has_comma(ast_node* n)
@@ -46,7 +46,7 @@ bool has_comma(ast_node* n)
 
 void ast_output_traverser_visitor::get_code(char** dst)
 {
-	*dst = strdup(buffer);
+	*dst = strdup(buffer.c_str());
 }
 
 void ast_output_traverser_visitor::append_header()
@@ -54,31 +54,31 @@ void ast_output_traverser_visitor::append_header()
 	assert(shader);
 
 	if(shader->version)
-		ralloc_asprintf_append(&buffer, "#version %i\n", shader->version);
+		buffer.printf("#version %i\n", shader->version);
 	output_extensions(shader->extensions);
-	ralloc_asprintf_append(&buffer, "\n");
+	buffer.append('\n');
 
 	if (shader->stage == MESA_SHADER_GEOMETRY){
 		if (shader->gs_input_prim_type_specified) {
 			output_qualifier(shader->qualifiers[SQ_GS_IN]);
-			ralloc_asprintf_append(&buffer, "in;\n");
+			buffer.append("in;\n");
 		}
 		output_qualifier(shader->qualifiers[SQ_GS_OUT]);
-		ralloc_asprintf_append(&buffer, "out;\n\n");
+		buffer.append("out;\n\n");
 	}
 
 	/* Add declaration of all neccessary types */
 	if (cgOptions != DBG_CG_ORIGINAL_SRC)
 		cg.addDeclaration(CG_TYPE_ALL, &buffer, mode);
 
-	ralloc_asprintf_append(&buffer, "\n");
+	buffer.append('\n');
 }
 
 
 void ast_output_traverser_visitor::indent(void)
 {
    for (int i = 0; i < depth; i++)
-      ralloc_asprintf_append (&buffer, "  ");
+      buffer.append("  ");
 }
 
 void ast_output_traverser_visitor::visit(exec_list* list)
@@ -88,7 +88,7 @@ void ast_output_traverser_visitor::visit(exec_list* list)
 
 void ast_output_traverser_visitor::visit(class ast_node*)
 {
-	ralloc_asprintf_append(&buffer, "unhandled node ");
+	buffer.append("unhandled node ");
 }
 
 void ast_output_traverser_visitor::visit(class ast_expression* node)
@@ -96,7 +96,7 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 	if (node->debug_target() && cgOptions != DBG_CG_ORIGINAL_SRC) {
 		dbgTargetProcessed = true;
 		cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-		ralloc_asprintf_append(&buffer, ", ");
+		buffer.append(", ");
 	}
 
 	switch (node->oper) {
@@ -112,17 +112,19 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 	case ast_xor_assign:
 	case ast_or_assign:
 		node->subexpressions[0]->accept(this);
-		ralloc_asprintf_append(&buffer, " %s ", node->operator_string(node->oper));
+		buffer.append(' ');
+		buffer.append(node->operator_string(node->oper));
+		buffer.append(' ');
 		node->subexpressions[1]->accept(this);
 		break;
 
 	case ast_field_selection:
 		node->subexpressions[0]->accept(this);
-		ralloc_asprintf_append(&buffer, ".");
+		buffer.append('.');
 		if (node->debug_selection_type == ast_fst_method)
 			node->subexpressions[1]->accept(this);
 		else
-			ralloc_asprintf_append(&buffer, "%s", node->primary_expression.identifier);
+			buffer.append(node->primary_expression.identifier);
 		break;
 
 	case ast_plus:
@@ -131,14 +133,15 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 	case ast_logic_not:
 	case ast_pre_inc:
 	case ast_pre_dec:
-		ralloc_asprintf_append(&buffer, "%s ", node->operator_string(node->oper));
+		buffer.append(node->operator_string(node->oper));
+		buffer.append(' ');
 		node->subexpressions[0]->accept(this);
 		break;
 
 	case ast_post_inc:
 	case ast_post_dec:
 		node->subexpressions[0]->accept(this);
-		ralloc_asprintf_append(&buffer, "%s", node->operator_string(node->oper));
+		buffer.append(node->operator_string(node->oper));
 		break;
 
 	case ast_conditional: {
@@ -148,7 +151,7 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 		/* Add debug code */
 		if (node->debug_target()) {
 			this->dbgTargetProcessed = true;
-			ralloc_asprintf_append(&buffer, "(");
+			buffer.append('(');
 			if (cgOptions == DBG_CG_COVERAGE || cgOptions == DBG_CG_CHANGEABLE
 					|| cgOptions == DBG_CG_GEOMETRY_CHANGEABLE) {
 				switch (node->debug_state_internal) {
@@ -159,7 +162,7 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 				case ast_dbg_if_condition:
 					/* Add debug code prior to selection */
 					cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-					ralloc_asprintf_append(&buffer, ", ");
+					buffer.append(", ");
 					break;
 				case ast_dbg_if_condition_passed:
 				case ast_dbg_if_then:
@@ -173,17 +176,17 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 			}
 		}
 
-		ralloc_asprintf_append(&buffer, "(");
+		buffer.append('(');
 		/* Add condition */
 		if (copyCondition) {
 			cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, " = (");
+			buffer.append(" = (");
 			node->subexpressions[0]->accept(this);
-			ralloc_asprintf_append(&buffer, "), ");
+			buffer.append("), ");
 
 			/* Add debug code */
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, ", ");
+			buffer.append(", ");
 			cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
 		} else if (node->subexpressions[0])
 			node->subexpressions[0]->accept(this);
@@ -191,22 +194,22 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 		bool colorize = node->debug_target()
 				&& node->debug_state_internal == ast_dbg_if_condition_passed;
 
-		ralloc_asprintf_append(&buffer, ") ? (\n");
+		buffer.append(") ? (\n");
 		selection_body(node->subexpressions[1], colorize, true, true);
-		ralloc_asprintf_append(&buffer, ") : (\n");
+		buffer.append(") : (\n");
 		selection_body(node->subexpressions[2], colorize, false, true);
-		ralloc_asprintf_append(&buffer, ")");
+		buffer.append(')');
 		if (node->debug_target())
-			ralloc_asprintf_append(&buffer, ")");
+			buffer.append(')');
 
 		break;
 	}
 
 	case ast_array_index:
 		node->subexpressions[0]->accept(this);
-		ralloc_asprintf_append(&buffer, "[");
+		buffer.append('[');
 		node->subexpressions[1]->accept(this);
-		ralloc_asprintf_append(&buffer, "]");
+		buffer.append(']');
 		break;
 
 	case ast_function_call:
@@ -218,17 +221,16 @@ void ast_output_traverser_visitor::visit(class ast_expression* node)
 		break;
 
 	case ast_int_constant:
-		ralloc_asprintf_append(&buffer, "%d", node->primary_expression.int_constant);
+		buffer.appendInt(node->primary_expression.int_constant);
 		break;
 	case ast_uint_constant:
-		ralloc_asprintf_append(&buffer, "%u", node->primary_expression.uint_constant);
+		buffer.appendUInt(node->primary_expression.uint_constant);
 		break;
 	case ast_float_constant:
-		ralloc_asprintf_append(&buffer, "%f", node->primary_expression.float_constant);
+		buffer.appendFloat(node->primary_expression.float_constant);
 		break;
 	case ast_bool_constant:
-		ralloc_asprintf_append(&buffer, "%s",
-				node->primary_expression.bool_constant ? "true" : "false");
+		buffer.append(node->primary_expression.bool_constant ? "true" : "false");
 		break;
 
 	case ast_sequence:
@@ -250,11 +252,13 @@ void ast_output_traverser_visitor::visit(class ast_expression_bin* node)
 		dbgTargetProcessed = true;
 		cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
 		// FIXME: WAT?
-		ralloc_asprintf_append(&buffer, ", ");
+		buffer.append(", ");
 	}
 
 	node->subexpressions[0]->accept(this);
-	ralloc_asprintf_append(&buffer, " %s ", node->operator_string(node->oper));
+	buffer.append(' ');
+	buffer.append(node->operator_string(node->oper));
+	buffer.append(' ');
 	node->subexpressions[1]->accept(this);
 }
 
@@ -270,11 +274,14 @@ void ast_output_traverser_visitor::visit(class ast_function_expression* node)
 void ast_output_traverser_visitor::visit(class ast_array_specifier* node)
 {
 	if (node->is_unsized_array)
-		ralloc_asprintf_append(&buffer, "[]");
+		buffer.append("[]");
 
 	foreach_list_typed(ast_expression, expr, link, &node->array_dimensions)
-		if (expr->oper == ast_int_constant)
-			ralloc_asprintf_append(&buffer, "[%i]", expr->primary_expression.int_constant);
+		if (expr->oper == ast_int_constant) {
+			buffer.append('[');
+			buffer.appendInt(expr->primary_expression.int_constant);
+			buffer.append(']');
+		}
 }
 
 void ast_output_traverser_visitor::visit(class ast_aggregate_initializer* node)
@@ -290,7 +297,7 @@ void ast_output_traverser_visitor::visit(class ast_compound_statement *node)
 	no_brakets = false;
 
 	if (!skip_brakets)
-		ralloc_asprintf_append(&buffer, "{\n");
+		buffer.append("{\n");
 
 	/* If in debug mode add initialization to main function */
 	if (cgOptions != DBG_CG_ORIGINAL_SRC && main_child) {
@@ -313,7 +320,7 @@ void ast_output_traverser_visitor::visit(class ast_compound_statement *node)
 		default:
 			break;
 		}
-		ralloc_asprintf_append(&buffer, ";\n");
+		buffer.append(";\n");
 		depth--;
 	}
 
@@ -341,7 +348,7 @@ void ast_output_traverser_visitor::visit(class ast_compound_statement *node)
 	}
 
 	if (!skip_brakets)
-		ralloc_asprintf_append(&buffer, "}\n");
+		buffer.append("}\n");
 
 }
 
@@ -353,14 +360,14 @@ void ast_output_traverser_visitor::visit(class ast_declaration* node)
 		node->array_specifier->accept(this);
 
 	if (node->initializer) {
-		ralloc_asprintf_append(&buffer, " = ");
+		buffer.append(" = ");
 		node->initializer->accept(this);
 	}
 }
 
 void ast_output_traverser_visitor::visit(class ast_struct_specifier* node)
 {
-	ralloc_asprintf_append(&buffer, "struct %s ", node->name);
+	buffer.printf("struct %s ", node->name);
 	output_sequence(&node->declarations, "{\n", "\n", "\n}", true);
 }
 
@@ -369,7 +376,7 @@ void ast_output_traverser_visitor::visit(class ast_type_specifier* node)
 	if (node->structure)
 		node->structure->accept(this);
 	else
-		ralloc_asprintf_append(&buffer, "%s", node->type_name);
+		buffer.append(node->type_name);
 
 	if (node->array_specifier)
 		node->array_specifier->accept(this);
@@ -388,7 +395,7 @@ void ast_output_traverser_visitor::visit(class ast_declarator_list* node)
 		if (decl->debug_target() || (decl->initializer && decl->initializer->debug_target())) {
 			dbgTargetProcessed = true;
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, ";\n");
+			buffer.append(";\n");
 			indent();
 		}
 	}
@@ -399,7 +406,7 @@ void ast_output_traverser_visitor::visit(class ast_declarator_list* node)
 		output_sequence(&node->declarations, " ", ", ", "");
 		depth--;
 	}
-	ralloc_asprintf_append(&buffer, ";");
+	buffer.append(';');
 }
 
 void ast_output_traverser_visitor::visit(class ast_parameter_declarator* node)
@@ -408,7 +415,7 @@ void ast_output_traverser_visitor::visit(class ast_parameter_declarator* node)
 	if (node->is_void)
 		return;
 
-	ralloc_asprintf_append(&buffer, " ");
+	buffer.append(' ');
 	print_variable(&buffer, node, node->identifier, vl);
 	if (node->array_specifier)
 		node->array_specifier->accept(this);
@@ -418,17 +425,17 @@ void ast_output_traverser_visitor::visit(class ast_expression_statement* node)
 {
 	if (node->expression)
 		node->expression->accept(this);
-	ralloc_asprintf_append(&buffer, ";");
+	buffer.append(';');
 }
 
 void ast_output_traverser_visitor::visit(class ast_case_label* node)
 {
 	if (node->test_value) {
-		ralloc_asprintf_append(&buffer, "case ");
+		buffer.append("case ");
 		node->test_value->accept(this);
-		ralloc_asprintf_append(&buffer, ":");
+		buffer.append(':');
 	} else {
-		ralloc_asprintf_append(&buffer, "default:");
+		buffer.append("default:");
 	}
 }
 
@@ -442,7 +449,7 @@ void ast_output_traverser_visitor::visit(class ast_case_label_list* node)
 void ast_output_traverser_visitor::visit(class ast_case_statement* node)
 {
 	node->labels->accept(this);
-	ralloc_asprintf_append(&buffer, " {\n");
+	buffer.append(" {\n");
 
 	if (cgOptions == DBG_CG_SWITCH_CONDITIONAL) {
 		ast_switch_statement* current_switch = NULL;
@@ -455,14 +462,14 @@ void ast_output_traverser_visitor::visit(class ast_case_statement* node)
 			indent();
 			/* Add code to colorize branch */
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, node->debug_branch_index);
-			ralloc_asprintf_append(&buffer, ";\n");
+			buffer.append(";\n");
 			depth--;
 		}
 	}
 
 	output_sequence(&node->stmts, "", "\n", "\n", true);
 	indent();
-	ralloc_asprintf_append(&buffer, "}\n");
+	buffer.append("}\n");
 }
 
 void ast_output_traverser_visitor::visit(class ast_case_statement_list* node)
@@ -472,11 +479,11 @@ void ast_output_traverser_visitor::visit(class ast_case_statement_list* node)
 
 void ast_output_traverser_visitor::visit(class ast_switch_body* node)
 {
-	ralloc_asprintf_append(&buffer, " {\n");
+	buffer.append(" {\n");
 	if (node->stmts)
 		node->stmts->accept(this);
 	indent();
-	ralloc_asprintf_append(&buffer, "}\n");
+	buffer.append("}\n");
 }
 
 void ast_output_traverser_visitor::visit(class ast_selection_statement* node)
@@ -495,7 +502,7 @@ void ast_output_traverser_visitor::visit(class ast_selection_statement* node)
 			case ast_dbg_if_condition:
 				/* Add debug code prior to selection */
 				cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-				ralloc_asprintf_append(&buffer, ";\n");
+				buffer.append(";\n");
 				indent();
 				break;
 			case ast_dbg_if_condition_passed:
@@ -519,18 +526,18 @@ void ast_output_traverser_visitor::visit(class ast_selection_statement* node)
 		}
 	}
 
-	ralloc_asprintf_append(&buffer, "if (");
+	buffer.append("if (");
 
 	/* Add condition */
 	if (copyCondition) {
 		cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
-		ralloc_asprintf_append(&buffer, " = (");
+		buffer.append(" = (");
 		node->condition->accept(this);
-		ralloc_asprintf_append(&buffer, "), ");
+		buffer.append("), ");
 
 		/* Add debug code */
 		cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-		ralloc_asprintf_append(&buffer, ", ");
+		buffer.append(", ");
 		cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
 	} else
 		if (node->condition)
@@ -539,14 +546,14 @@ void ast_output_traverser_visitor::visit(class ast_selection_statement* node)
 	bool colorize = node->debug_target()
 			&& node->debug_state_internal == ast_dbg_if_condition_passed;
 
-	ralloc_asprintf_append(&buffer, ") {\n");
+	buffer.append(") {\n");
 	selection_body(node->then_statement, colorize, true);
-	ralloc_asprintf_append(&buffer, "}");
+	buffer.append('}');
 
 	if (node->else_statement) {
-		ralloc_asprintf_append(&buffer, " else {\n");
+		buffer.append(" else {\n");
 		selection_body(node->else_statement, colorize, false);
-		ralloc_asprintf_append(&buffer, "}");
+		buffer.append('}');
 	}
 }
 
@@ -566,7 +573,7 @@ void ast_output_traverser_visitor::visit(class ast_switch_statement* node)
 			case ast_dbg_switch_condition:
 				/* Add debug code prior to selection */
 				cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-				ralloc_asprintf_append(&buffer, ";\n");
+				buffer.append(";\n");
 				indent();
 				break;
 			case ast_dbg_switch_condition_passed:
@@ -579,25 +586,25 @@ void ast_output_traverser_visitor::visit(class ast_switch_statement* node)
 		}
 	}
 
-	ralloc_asprintf_append(&buffer, "switch (");
+	buffer.append("switch (");
 
 	/* Add condition */
 	if (node->test_expression) {
 		if (copyExpression) {
 			cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, " = (");
+			buffer.append(" = (");
 			node->test_expression->accept(this);
-			ralloc_asprintf_append(&buffer, "), ");
+			buffer.append("), ");
 			/* Add debug code */
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, ", ");
+			buffer.append(", ");
 			cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
 		} else {
 			node->test_expression->accept(this);
 		}
 	}
 
-	ralloc_asprintf_append(&buffer, ")");
+	buffer.append(')');
 
 	switches.push(node);
 	node->body->accept(this);
@@ -612,41 +619,41 @@ void ast_output_traverser_visitor::visit(class ast_iteration_statement* node)
 	loop_debug_prepare(node);
 
 	if (node->mode == ast_iteration_statement::ast_for) {
-		ralloc_asprintf_append(&buffer, "for (");
+		buffer.append("for (");
 		if (node->init_statement && node->debug_state_internal != ast_dbg_loop_wrk_init)
 			node->init_statement->accept(this);
 		if (node->debug_state_internal == ast_dbg_loop_wrk_init || !node->init_statement
 				|| !has_comma(node->init_statement))
-			ralloc_asprintf_append(&buffer, ";");
-		ralloc_asprintf_append(&buffer, " ");
+			buffer.append(';');
+		buffer.append(' ');
 		loop_debug_condition(node);
-		ralloc_asprintf_append(&buffer, "; ");
+		buffer.append("; ");
 		loop_debug_terminal(node);
-		ralloc_asprintf_append(&buffer, ") ");
+		buffer.append(") ");
 	} else if (node->mode == ast_iteration_statement::ast_while) {
-		ralloc_asprintf_append(&buffer, "while (");
+		buffer.append("while (");
 		loop_debug_condition(node);
-		ralloc_asprintf_append(&buffer, ") ");
+		buffer.append(") ");
 	} else {
-		ralloc_asprintf_append(&buffer, "do ");
+		buffer.append("do ");
 	}
 
 	// Add one more depth level to insert debug iteration
 	if (cgOptions != DBG_CG_ORIGINAL_SRC){
-		ralloc_asprintf_append(&buffer, "{\n");
+		buffer.append("{\n");
 		no_brakets = true;
 	}
 	node->body->accept(this);
 	loop_debug_end(node);
 	if (cgOptions != DBG_CG_ORIGINAL_SRC) {
 		indent();
-		ralloc_asprintf_append(&buffer, "} ");
+		buffer.append("} ");
 	}
 
 	if (node->mode == ast_iteration_statement::ast_do_while) {
-		ralloc_asprintf_append(&buffer, "while (");
+		buffer.append("while (");
 		loop_debug_condition(node);
-		ralloc_asprintf_append(&buffer, ")");
+		buffer.append(')');
 	}
 }
 
@@ -657,7 +664,7 @@ void ast_output_traverser_visitor::visit(class ast_jump_statement* node)
 			node->debug_target() && cgOptions != DBG_CG_ORIGINAL_SRC) {
 		dbgTargetProcessed = true;
 		cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-		ralloc_asprintf_append (&buffer, ";\n");
+		buffer.append(";\n");
 		indent();
 	}
 
@@ -672,14 +679,14 @@ void ast_output_traverser_visitor::visit(class ast_jump_statement* node)
 		 * for this function may be after it.
 		 */
 		if (dbgTargetProcessed && cgOptions != DBG_CG_ORIGINAL_SRC)
-			ralloc_asprintf_append (&buffer, "// ");
-		ralloc_asprintf_append (&buffer, "discard;");
+			buffer.append("// ");
+		buffer.append("discard;");
 		break;
 	case ast_jump_statement::ast_jump_modes::ast_break:
-		ralloc_asprintf_append (&buffer, "break;");
+		buffer.append("break;");
 		break;
 	case ast_jump_statement::ast_jump_modes::ast_continue:
-		ralloc_asprintf_append (&buffer, "continue;");
+		buffer.append("continue;");
 		break;
 	case ast_jump_statement::ast_jump_modes::ast_return:
 		char *tmpRegister = NULL;
@@ -694,14 +701,14 @@ void ast_output_traverser_visitor::visit(class ast_jump_statement* node)
 
 				cg.getNewName(&tmpRegister, "dbgBranch");
 				type->accept(this);
-				ralloc_asprintf_append (&buffer, " %s = ", tmpRegister);
+				buffer.printf(" %s = ", tmpRegister);
 				node->opt_return_value->accept(this);
-				ralloc_asprintf_append (&buffer, ";\n");
+				buffer.append(";\n");
 				indent();
 			}
 
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append (&buffer, "; ");
+			buffer.append("; ");
 		}
 
 		/* If control flow ends program execution append code
@@ -724,17 +731,17 @@ void ast_output_traverser_visitor::visit(class ast_jump_statement* node)
 			}
 		}
 
-		ralloc_asprintf_append (&buffer, "return");
+		buffer.append("return");
 
 		if (node->opt_return_value) {
-			ralloc_asprintf_append (&buffer, " ");
+			buffer.append(' ');
 			if (node->debug_target() && cgOptions != DBG_CG_ORIGINAL_SRC)
-				ralloc_asprintf_append (&buffer, "%s", tmpRegister);
+				buffer.append(tmpRegister);
 			else
 				node->opt_return_value->accept(this);
 		}
 
-		ralloc_asprintf_append (&buffer, ";");
+		buffer.append(';');
 		break;
 	}
 }
@@ -763,14 +770,14 @@ void ast_output_traverser_visitor::visit(class ast_function_definition* node)
 
 	return_types.push(node->prototype->return_type);
 	node->prototype->return_type->accept(this);
-	ralloc_asprintf_append(&buffer, " %s", fname);
+	buffer.printf(" %s", fname);
 	output_sequence(&node->prototype->parameters, "(", ", ", ")");
 	if (!node->body || node->body->statements.is_empty()) {
-		ralloc_asprintf_append(&buffer, ";\n");
+		buffer.append(";\n");
 		return;
 	}
 
-	ralloc_asprintf_append(&buffer, "\n");
+	buffer.append('\n');
 	node->body->accept(this);
 	return_types.pop();
 }
@@ -779,13 +786,13 @@ void ast_output_traverser_visitor::visit(class ast_interface_block* node)
 {
 	indent();
 	output_qualifier(&node->layout);
-	ralloc_asprintf_append(&buffer, "%s ", node->block_name);
+	buffer.printf("%s ", node->block_name);
 	output_sequence(&node->declarations, "{", "\n", "}", true);
 
 	if (node->instance_name)
-		ralloc_asprintf_append(&buffer, " %s", node->instance_name);
+		buffer.printf(" %s", node->instance_name);
 	if (node->array_specifier)
 		node->array_specifier->accept(this);
 
-	ralloc_asprintf_append(&buffer, ";\n");
+	buffer.append(";\n");
 }
@@ -9,6 +9,7 @@
 
 #include "ShaderLang.h"
 #include "interface/CodeInsertion.h"
+#include "interface/StringBuffer.h"
 #include "mesa/glsl/ast_visitor.h"
 
 
@@ -19,7 +20,6 @@ public:
 			ShChangeableList* _cgbls, EShLanguage _mode, DbgCgOptions _dbgopts) :
 			cg(_cg), shader(_shader), vl(_vl), cgbls(_cgbls), mode(_mode), cgOptions(_dbgopts)
 	{
-		buffer = NULL;
 		no_brakets = false;
 		dbgTargetProcessed = false;
 	}
@@ -72,7 +72,7 @@ protected:
 	void loop_debug_terminal(ast_iteration_statement *);
 	void loop_debug_end(ast_iteration_statement *);
 
-	char* buffer;
+	StringBuffer buffer;
 	CodeGen& cg;
 	AstShader* shader;
 	ShVariableList *vl;
@@ -111,23 +111,23 @@ void ast_output_traverser_visitor::output_qualifier(const struct ast_type_qualif
 	if (has_layout || q->flags.q.prim_type
 			|| q->flags.q.local_size
 			|| q->flags.q.explicit_image_format) {
-		ralloc_asprintf_append(&buffer, "layout(");
+		buffer.append("layout(");
 		bool defined = false;
 		for (int i = 0; i < LAYOUTS_COUNT; ++i) {
 			if (layouts[i]) {
 				if (defined)
-					ralloc_asprintf_append(&buffer, ", ");
+					buffer.append(", ");
 				defined = true;
-				ralloc_asprintf_append(&buffer, "%s", layouts_names[i]);
+				buffer.append(layouts_names[i]);
 				if (i > LAYOUTS_FIRST_EXPLICIT)
-					ralloc_asprintf_append(&buffer, " = %i",
+					buffer.printf(" = %i",
 							explicit_layouts[i - LAYOUTS_FIRST_EXPLICIT]);
 			}
 		}
 		// GLSL 1.5 primitive
 		if (q->flags.q.prim_type) {
 			if (defined)
-				ralloc_asprintf_append(&buffer, ", ");
+				buffer.append(", ");
 			defined = true;
 			int ptype;
 			switch (q->prim_type) {
@@ -139,7 +139,7 @@ void ast_output_traverser_visitor::output_qualifier(const struct ast_type_qualif
 			case GL_TRIANGLE_STRIP: ptype = 6; break;
 			default: ptype = 0; break;
 			}
-			ralloc_asprintf_append(&buffer, "%s", prim_types[ptype]);
+			buffer.append(prim_types[ptype]);
 		}
 
 		// Local size
@@ -148,9 +148,9 @@ void ast_output_traverser_visitor::output_qualifier(const struct ast_type_qualif
 				if (!(q->flags.q.local_size & (1 << i)))
 					continue;
 				if (defined)
-					ralloc_asprintf_append(&buffer, ", ");
+					buffer.append(", ");
 				defined = true;
-				ralloc_asprintf_append(&buffer, "%s = %i",
+				buffer.printf("%s = %i",
 						local_size_qualifiers[i], q->local_size[i]);
 			}
 		}
@@ -160,51 +160,51 @@ void ast_output_traverser_visitor::output_qualifier(const struct ast_type_qualif
 			while (images[iter].name != NULL) {
 				if (images[iter].format == q->image_format) {
 					if (defined)
-						ralloc_asprintf_append(&buffer, ", ");
-					ralloc_asprintf_append(&buffer, "%s", images[iter].name);
+						buffer.append(", ");
+					buffer.append(images[iter].name);
 					break;
 				}
 				iter++;
 			}
 		}
 
-		ralloc_asprintf_append(&buffer, ") ");
+		buffer.append(") ");
 	}
 
 	if (q->flags.q.constant)
-		ralloc_asprintf_append(&buffer, "const ");
+		buffer.append("const ");
 
 	if (q->flags.q.invariant)
-		ralloc_asprintf_append(&buffer, "invariant ");
+		buffer.append("invariant ");
 
 	if (q->flags.q.attribute)
-		ralloc_asprintf_append(&buffer, "attribute ");
+		buffer.append("attribute ");
 
 	if (q->flags.q.varying)
-		ralloc_asprintf_append(&buffer, "varying ");
+		buffer.append("varying ");
 
 	if (q->flags.q.in && q->flags.q.out) {
-		ralloc_asprintf_append(&buffer, "inout ");
+		buffer.append("inout ");
 	} else {
 		if (q->flags.q.in)
-			ralloc_asprintf_append(&buffer, "in ");
+			buffer.append("in ");
 
 		if (q->flags.q.out)
-			ralloc_asprintf_append(&buffer, "out ");
+			buffer.append("out ");
 	}
 
 	if (q->flags.q.centroid)
-		ralloc_asprintf_append(&buffer, "centroid ");
+		buffer.append("centroid ");
 	if (q->flags.q.sample)
-		ralloc_asprintf_append(&buffer, "sample ");
+		buffer.append("sample ");
 	if (q->flags.q.uniform)
-		ralloc_asprintf_append(&buffer, "uniform ");
+		buffer.append("uniform ");
 	if (q->flags.q.smooth)
-		ralloc_asprintf_append(&buffer, "smooth ");
+		buffer.append("smooth ");
 	if (q->flags.q.flat)
-		ralloc_asprintf_append(&buffer, "flat ");
+		buffer.append("flat ");
 	if (q->flags.q.noperspective)
-		ralloc_asprintf_append(&buffer, "noperspective ");
+		buffer.append("noperspective ");
 }
 
 typedef struct {
@@ -216,7 +216,7 @@ void ast_output_traverser_visitor::output_extensions(const struct sh_extension*
 {
 	const sh_extension* ext = extensions;
 	while (ext) {
-		ralloc_asprintf_append(&buffer, "#extension %s : %s\n", ext->name,
+		buffer.printf("#extension %s : %s\n", ext->name,
 				ext->behavior == sh_ext_warn ? "warn" :
 				ext->behavior == sh_ext_enable ? "enable" :
 				ext->behavior == sh_ext_require ? "require" : "disable");
@@ -227,13 +227,13 @@ void ast_output_traverser_visitor::output_extensions(const struct sh_extension*
 void ast_output_traverser_visitor::output_sequence(exec_list* list, const char* s,
 		const char* j, const char* e, bool do_indent)
 {
-	ralloc_asprintf_append(&buffer, s);
+	buffer.append(s);
 	if (do_indent)
 		depth++;
 	bool first = true;
 	foreach_list_typed(ast_node, node, link, list) {
 		if (!first)
-			ralloc_asprintf_append(&buffer, j);
+			buffer.append(j);
 		if (do_indent)
 			indent();
 		node->accept(this);
@@ -241,7 +241,7 @@ void ast_output_traverser_visitor::output_sequence(exec_list* list, const char*
 	}
 	if (do_indent)
 		depth--;
-	ralloc_asprintf_append(&buffer, e);
+	buffer.append(e);
 }
 
 bool ast_output_traverser_visitor::enter(ast_function_expression* node)
@@ -268,53 +268,53 @@ bool ast_output_traverser_visitor::enter(ast_function_expression* node)
 		if (lastInParameter >= 0) {
 			/* we found a usable parameter */
 			node->subexpressions[0]->accept(this);
-			ralloc_asprintf_append(&buffer, "(");
+			buffer.append('(');
 
 			int iter = 0;
 			foreach_list_typed(ast_node, param, link, &node->expressions) {
 				if (iter)
-					ralloc_asprintf_append(&buffer, ", ");
+					buffer.append(", ");
 
 				if (iter == lastInParameter) {
-					ralloc_asprintf_append(&buffer, "(");
+					buffer.append('(');
 					if (!getSideEffectsDebugParameter(node, lastInParameter)) {
 						/* No special care necessary, just add it before */
 						cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-						ralloc_asprintf_append(&buffer, ", ");
+						buffer.append(", ");
 						param->accept(this);
 					} else {
 						/* Copy to temporary, debug, and copy back */
 						cg.addDbgCode(CG_TYPE_PARAMETER, &buffer, cgOptions, 0);
-						ralloc_asprintf_append(&buffer, " = (");
+						buffer.append(" = (");
 						param->accept(this);
-						ralloc_asprintf_append(&buffer, "), ");
+						buffer.append("), ");
 						cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-						ralloc_asprintf_append(&buffer, ", ");
+						buffer.append(", ");
 						cg.addDbgCode(CG_TYPE_PARAMETER, &buffer, cgOptions, 0);
 					}
-					ralloc_asprintf_append(&buffer, ")");
+					buffer.append(')');
 				} else
 					param->accept(this);
 				++iter;
 			}
-			ralloc_asprintf_append(&buffer, ")");
+			buffer.append(')');
 		} else {
 			/* no usable parameter, so debug before function call */
-			ralloc_asprintf_append(&buffer, "(");
+			buffer.append('(');
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, ", ");
+			buffer.append(", ");
 			node->subexpressions[0]->accept(this);
 			output_sequence(&node->expressions, "(", ", ", ")");
 			if (return_void)
-				ralloc_asprintf_append(&buffer, ", true");
-			ralloc_asprintf_append(&buffer, ")");
+				buffer.append(", true");
+			buffer.append(')');
 		}
 		return false;
 	} else if (cgOptions != DBG_CG_ORIGINAL_SRC && node->debug_state == ast_dbg_state_call
 			&& node->debug_overwrite != ast_dbg_ow_original) {
 		/* This call leads to the actual prosition of debugging */
 		const char* name = node->subexpressions[0]->primary_expression.identifier;
-		ralloc_asprintf_append(&buffer, "%s", cg.getDebugName(name));
+		buffer.append(cg.getDebugName(name));
 		output_sequence(&node->expressions, "(", ", ", ")");
 		return false;
 	} else if (mode == EShLangGeometry && !node->is_constructor() && node->debug_builtin) {
@@ -380,7 +380,7 @@ bool ast_output_traverser_visitor::geom_call(ast_function_expression *node)
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions,
 					allInScope ? CG_GEOM_CHANGEABLE_IN_SCOPE : CG_GEOM_CHANGEABLE_NO_SCOPE);
 
-			ralloc_asprintf_append(&buffer, "\n");
+			buffer.append('\n');
 			indent();
 		}
 
@@ -420,16 +420,16 @@ void ast_output_traverser_visitor::selection_body(ast_node* instructions,
       //DBG_CG_COVERAGE
       cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, debug_option);
       if (conditional)
-    	  ralloc_asprintf_append(&buffer, ",\n");
+    	  buffer.append(",\n");
       else
-    	  ralloc_asprintf_append(&buffer, ";\n");
+    	  buffer.append(";\n");
       depth--;
    }
 
    depth++;
    indent();
    instructions->accept(this);
-   ralloc_asprintf_append(&buffer, "\n");
+   buffer.append('\n');
    depth--;
    indent();
 }
@@ -439,7 +439,7 @@ void ast_output_traverser_visitor::loop_debug_prepare(ast_iteration_statement *n
 {
 	/* Add loop counter */
 	if (node->need_dbgiter()){
-		ralloc_asprintf_append(&buffer, "%s = 0;\n", node->debug_iter_name);
+		buffer.printf("%s = 0;\n", node->debug_iter_name);
 		indent();
 	}
 
@@ -452,7 +452,7 @@ void ast_output_traverser_visitor::loop_debug_prepare(ast_iteration_statement *n
 				case DBG_CG_CHANGEABLE:
 				case DBG_CG_GEOMETRY_CHANGEABLE:
 					cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-					ralloc_asprintf_append(&buffer, ";\n");
+					buffer.append(";\n");
 					indent();
 					break;
 				default:
@@ -462,13 +462,13 @@ void ast_output_traverser_visitor::loop_debug_prepare(ast_iteration_statement *n
 		} else {
 			if (node->debug_state_internal == ast_dbg_loop_wrk_init) {
 				depth++;
-				ralloc_asprintf_append(&buffer, "{\n");
+				buffer.append("{\n");
 				indent();
 				if (node->init_statement) {
 					node->init_statement->accept(this);
 					if (!has_comma(node->init_statement))
-						ralloc_asprintf_append(&buffer, ";");
-					ralloc_asprintf_append(&buffer, "\n");
+						buffer.append(';');
+					buffer.append('\n');
 					indent();
 				}
 			}
@@ -481,11 +481,11 @@ void ast_output_traverser_visitor::loop_debug_condition(ast_iteration_statement*
 	if (cgOptions != DBG_CG_ORIGINAL_SRC && node->debug_target()) {
 		if (node->debug_state_internal == ast_dbg_loop_qyr_test) {
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, ", ");
+			buffer.append(", ");
 		} else if (node->debug_state_internal == ast_dbg_loop_select_flow) {
 			/* Copy test */
 			cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
-			ralloc_asprintf_append(&buffer, " = (");
+			buffer.append(" = (");
 		}
 	}
 
@@ -495,15 +495,15 @@ void ast_output_traverser_visitor::loop_debug_condition(ast_iteration_statement*
 	if (node->condition)
 		node->condition->accept(this);
 	else
-		ralloc_asprintf_append(&buffer, "true");
+		buffer.append("true");
 	cgOptions = opts;
 
 	if (cgOptions != DBG_CG_ORIGINAL_SRC && node->debug_target()
 			&& node->debug_state_internal == ast_dbg_loop_select_flow) {
-		ralloc_asprintf_append(&buffer, "), ");
+		buffer.append("), ");
 		/* Add debug code */
 		cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
-		ralloc_asprintf_append(&buffer, ", ");
+		buffer.append(", ");
 		cg.addDbgCode(CG_TYPE_CONDITION, &buffer, cgOptions, 0);
 	}
 }
@@ -515,7 +515,7 @@ void ast_output_traverser_visitor::loop_debug_terminal(ast_iteration_statement*
 				&& node->debug_state_internal == ast_dbg_loop_qyr_terminal) {
 			cg.addDbgCode(CG_TYPE_RESULT, &buffer, cgOptions, 0);
 			if (node->rest_expression)
-				ralloc_asprintf_append(&buffer, ", ");
+				buffer.append(", ");
 		}
 	}
 
@@ -531,14 +531,14 @@ void ast_output_traverser_visitor::loop_debug_end(ast_iteration_statement* node)
 	depth++;
 	if (node->need_dbgiter()) {
 		indent();
-		ralloc_asprintf_append(&buffer, "%s++;\n", node->debug_iter_name);
+		buffer.printf("%s++;\n", node->debug_iter_name);
 	}
 
 	if (node->mode == ast_iteration_statement::ast_for && !node->debug_target()
 			&& node->debug_state_internal == ast_dbg_loop_wrk_init) {
 		depth--;
 		indent();
-		ralloc_asprintf_append(&buffer, "}\n");
+		buffer.append("}\n");
 	}
 	depth--;
 }
@@ -233,6 +233,11 @@ public:
    enum ast_dbg_overwrite debug_overwrite;
    int debug_sideeffects;
    int debug_id;
+   /* Set by ast_debugpath_traverser_visitor: the node the debug path
+    * continues with and the post-order position in the translation unit.
+    */
+   ast_node *debug_parent;
+   int debug_order;
 #endif
 
 protected:
@@ -685,6 +685,40 @@ _mesa_glsl_process_extension(const char *name, YYLTYPE *name_locp,
 }
 
 
+/**
+ * Compare the enable and warn flags of all supported extensions.
+ */
+bool
+_mesa_glsl_extension_flags_equal(const _mesa_glsl_parse_state *a,
+                                 const _mesa_glsl_parse_state *b)
+{
+   for (unsigned i = 0; i < Elements(_mesa_glsl_supported_extensions); ++i) {
+      const _mesa_glsl_extension *extension =
+         &_mesa_glsl_supported_extensions[i];
+      if (a->*(extension->enable_flag) != b->*(extension->enable_flag) ||
+          a->*(extension->warn_flag) != b->*(extension->warn_flag))
+         return false;
+   }
+   return true;
+}
+
+
+/**
+ * Copy the enable and warn flags of all supported extensions.
+ */
+void
+_mesa_glsl_copy_extension_flags(_mesa_glsl_parse_state *dst,
+                                const _mesa_glsl_parse_state *src)
+{
+   for (unsigned i = 0; i < Elements(_mesa_glsl_supported_extensions); ++i) {
+      const _mesa_glsl_extension *extension =
+         &_mesa_glsl_supported_extensions[i];
+      dst->*(extension->enable_flag) = src->*(extension->enable_flag);
+      dst->*(extension->warn_flag) = src->*(extension->warn_flag);
+   }
+}
+
+
 /**
  * Recurses through <type> and <expr> if <expr> is an aggregate initializer
  * and sets <expr>'s <constructor_type> field to <type>. Gives later functions
@@ -840,6 +874,8 @@ ast_node::ast_node(void)
    this->location.last_column = 0;
 #ifdef AST_DEBUG_STATE
    this->debug_id = -1;
+   this->debug_parent = NULL;
+   this->debug_order = 0;
 #endif
 }
 
@@ -1366,9 +1402,12 @@ ast_struct_specifier::ast_struct_specifier(const char *identifier,
 					   ast_declarator_list *declarator_list)
 {
    if (identifier == NULL) {
+      static mtx_t anon_lock = _MTX_INITIALIZER_NP;
       static unsigned anon_count = 1;
-      identifier = ralloc_asprintf(this, "#anon_struct_%04x", anon_count);
-      anon_count++;
+      mtx_lock(&anon_lock);
+      unsigned count = anon_count++;
+      mtx_unlock(&anon_lock);
+      identifier = ralloc_asprintf(this, "#anon_struct_%04x", count);
    }
    name = identifier;
    this->declarations.push_degenerate_list_at_head(&declarator_list->link);
@@ -557,6 +557,15 @@ extern bool _mesa_glsl_process_extension(const char *name, YYLTYPE *name_locp,
 					 YYLTYPE *behavior_locp,
 					 _mesa_glsl_parse_state *state);
 
+/**
+ * Compare or copy the extension enable and warn flags of two parser states,
+ * e.g. to tell whether they get the same built-in variables.
+ */
+extern bool _mesa_glsl_extension_flags_equal(const _mesa_glsl_parse_state *a,
+                                             const _mesa_glsl_parse_state *b);
+extern void _mesa_glsl_copy_extension_flags(_mesa_glsl_parse_state *dst,
+                                            const _mesa_glsl_parse_state *src);
+
 #endif /* __cplusplus */
 
 
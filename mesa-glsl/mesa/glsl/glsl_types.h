@@ -122,6 +122,8 @@ struct glsl_type {
     * easier to just ralloc_free 'mem_ctx' (or any of its ancestors). */
    static void* operator new(size_t size)
    {
+      mtx_lock(&glsl_type::mutex);
+
       if (glsl_type::mem_ctx == NULL) {
 	 glsl_type::mem_ctx = ralloc_context(NULL);
 	 assert(glsl_type::mem_ctx != NULL);
@@ -132,6 +134,8 @@ struct glsl_type {
       type = ralloc_size(glsl_type::mem_ctx, size);
       assert(type != NULL);
 
+      mtx_unlock(&glsl_type::mutex);
+
       return type;
    }
 
@@ -139,7 +143,9 @@ struct glsl_type {
     * ralloc_free in that case. */
    static void operator delete(void *type)
    {
+      mtx_lock(&glsl_type::mutex);
       ralloc_free(type);
+      mtx_unlock(&glsl_type::mutex);
    }
 
    /**
@@ -607,6 +613,12 @@ struct glsl_type {
    bool record_compare(const glsl_type *b) const;
 
 private:
+   /**
+    * Protects mem_ctx and the type caches below, so that shaders can be
+    * compiled in several threads at once.
+    */
+   static mtx_t mutex;
+
    /**
     * ralloc context for all glsl_type allocations
     *
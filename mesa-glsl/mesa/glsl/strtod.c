@@ -31,6 +31,8 @@
 #ifdef __APPLE__
 #include <xlocale.h>
 #endif
+#elif defined(_MSC_VER)
+#include <locale.h>
 #endif
 
 #include "strtod.h"
@@ -51,6 +53,12 @@ glsl_strtod(const char *s, char **end)
       loc = newlocale(LC_CTYPE_MASK, "C", NULL);
    }
    return strtod_l(s, end, loc);
+#elif defined(_MSC_VER)
+   static _locale_t loc = NULL;
+   if (!loc) {
+      loc = _create_locale(LC_NUMERIC, "C");
+   }
+   return _strtod_l(s, end, loc);
 #else
    return strtod(s, end);
 #endif
@@ -71,6 +79,8 @@ glsl_strtof(const char *s, char **end)
       loc = newlocale(LC_CTYPE_MASK, "C", NULL);
    }
    return strtof_l(s, end, loc);
+#elif defined(_MSC_VER)
+   return (float) glsl_strtod(s, end);
 #elif _XOPEN_SOURCE >= 600 || _ISOC99_SOURCE
    return strtof(s, end);
 #else
@@ -46,10 +46,10 @@ std::string formatChangeable(ShChangeable *cgb)
 	return ss.str();
 }
 
-std::string formatVariable(int id, ShVariable* var = NULL)
+std::string formatVariable(ShaderContext* context, int id, ShVariable* var = NULL)
 {
 	if (!var)
-		var = findShVariable(id);
+		var = findShVariable(context, id);
 	const char* name = var ? var->name : "undefined";
 	std::stringstream ss;
 	ss << "<" << id << "," << name << ">";
@@ -8,9 +8,9 @@
 #include "misc.h"
 #include "ShaderInput.h"
 #include "interface/Program.h"
+#include "interface/CompileSession.h"
 #include "interface/SymbolTable.h"
 #include "glsldb/utils/dbgprint.h"
-#include <locale.h>
 #include <sys/stat.h>
 
 static const std::string shExtensions[SHADERS_PER_PROGRAM] = {
@@ -44,6 +44,8 @@ ShaderHolder* ShaderInput::load(std::string name)
 
 	ShaderHolder* holder = rzalloc(ctx, struct ShaderHolder);
 	holder->ctx = ctx;
+	holder->session = new(holder) CompileSession(ctx);
+	holder->context = new(holder) ShaderContext;
 
 	for (int shnum = 0; shnum < SHADERS_PER_PROGRAM; ++shnum) {
 		std::string fname = path + name + shExtensions[shnum];
@@ -60,16 +62,14 @@ ShaderHolder* ShaderInput::load(std::string name)
 
 		AstShader* shader = rzalloc(holder, struct AstShader);
 		shader->symbols = new(holder) sh_symbol_table;
+		shader->context = holder->context;
 		holder->shaders[shnum] = shader;
 		shader->stage = shTypes[shnum];
 		shader->source = source;
 		shader->name = (char*) rzalloc_array(holder, char, fname.length()+1);
 		strcpy(shader->name, fname.c_str());
 
-		char* old_locale = setlocale(LC_NUMERIC, NULL);
-		setlocale(LC_NUMERIC, "POSIX");
-		compile_shader_to_ast(holder->ctx, shader, 0);
-		setlocale(LC_NUMERIC, old_locale);
+		compile_shader_to_ast(holder->session, shader, 0);
 
 		if (!shader->compile_status) {
 			dbgPrint(DBGLVL_ERROR,
@@ -0,0 +1,38 @@
+/*
+ * TestResources.h
+ *
+ *  Created on: 16.10.2026
+ *
+ * Resource limits the tests and benchmarks compile their shaders with. Only
+ * needs ResourceLimits.h, so the glslang benchmarks use it as well.
+ */
+
+#ifndef TESTRESOURCES_H_
+#define TESTRESOURCES_H_
+
+#include "ResourceLimits.h"
+#include <string.h>
+
+static inline void setTestResources(TBuiltInResource* resources,
+		int maxDrawBuffers = 8)
+{
+	memset(resources, 0, sizeof(*resources));
+	resources->maxLights = 8;
+	resources->maxClipPlanes = 6;
+	resources->maxTextureUnits = 8;
+	resources->maxTextureCoords = 8;
+	resources->maxVertexAttribs = 16;
+	resources->maxVertexUniformComponents = 4096;
+	resources->maxVaryingFloats = 64;
+	resources->maxVertexTextureImageUnits = 16;
+	resources->maxCombinedTextureImageUnits = 32;
+	resources->maxTextureImageUnits = 16;
+	resources->maxFragmentUniformComponents = 4096;
+	resources->maxDrawBuffers = maxDrawBuffers;
+	resources->framebufferObjectsSupported = 1;
+	resources->transformFeedbackSupported = 1;
+	resources->geoShaderSupported = 1;
+	resources->geoVerticesOut = 256;
+}
+
+#endif /* TESTRESOURCES_H_ */
@@ -9,6 +9,8 @@
 #include "units/DebugChangeTest.h"
 #include "units/DebugJumpTest.h"
 #include "units/DebugOutputTest.h"
+#include "units/ConcurrencyTest.h"
+#include "units/CompileSessionTest.h"
 #include "glsldb/utils/dbgprint.h"
 #include <cppunit/TextTestRunner.h>
 
@@ -28,6 +30,8 @@ int main(int argc, char **argv)
 	runner.addTest(DebugChangeTest::suite());
 	runner.addTest(DebugJumpTest::suite());
 	runner.addTest(DebugOutputTest::suite());
+	runner.addTest(ConcurrencyTest::suite());
+	runner.addTest(CompileSessionTest::suite());
 	int status = !runner.run();
 	ShaderInput::free();
 	return status;
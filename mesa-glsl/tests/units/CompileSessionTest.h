@@ -0,0 +1,117 @@
+/*
+ * CompileSessionTest.h
+ *
+ *  Created on: 16.10.2026
+ */
+
+#ifndef COMPILESESSIONTEST_H_
+#define COMPILESESSIONTEST_H_
+
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "interface/ShaderHolder.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <string.h>
+
+/*
+ * Compiles share the built-in variables of their resource limits. A shader
+ * that redeclares or accesses one must not change it for the shaders
+ * compiled later.
+ */
+class CompileSessionTest: public CppUnit::TestFixture {
+public:
+	static CppUnit::TestSuite *suite()
+	{
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite;
+		suiteOfTests->addTest(new CppUnit::TestCaller<CompileSessionTest>(
+				"testRedeclaredBuiltIn", &CompileSessionTest::testRedeclaredBuiltIn));
+		suiteOfTests->addTest(new CppUnit::TestCaller<CompileSessionTest>(
+				"testAccessedBuiltIn", &CompileSessionTest::testAccessedBuiltIn));
+		return suiteOfTests;
+	}
+
+	void testRedeclaredBuiltIn()
+	{
+		static const char* redeclaring = "#version 120\n"
+				"varying vec4 gl_TexCoord[2];\n"
+				"void main()\n"
+				"{\n"
+				"  gl_FragColor = gl_TexCoord[1];\n"
+				"}\n";
+		static const char* using_builtin = "#version 120\n"
+				"void main()\n"
+				"{\n"
+				"  gl_FragColor = gl_TexCoord[5];\n"
+				"}\n";
+		int before = -1, after = -1, redeclared = -1;
+
+		CPPUNIT_ASSERT_MESSAGE("Cannot compile shader",
+				texCoordSize(using_builtin, &before));
+		CPPUNIT_ASSERT_MESSAGE("Cannot compile redeclaring shader",
+				texCoordSize(redeclaring, &redeclared));
+		CPPUNIT_ASSERT_MESSAGE("Cannot compile shader again",
+				texCoordSize(using_builtin, &after));
+		CPPUNIT_ASSERT_EQUAL_MESSAGE("gl_TexCoord changed by an earlier compile",
+				before, after);
+	}
+
+	/* The field selection makes the postprocessor build HIR for the indexed
+	 * gl_TexCoord, which raises its max_array_access. A later shader must
+	 * still be able to redeclare it smaller.
+	 */
+	void testAccessedBuiltIn()
+	{
+		static const char* accessing = "#version 120\n"
+				"void main()\n"
+				"{\n"
+				"  gl_FragColor = vec4(gl_TexCoord[5].x);\n"
+				"}\n";
+		static const char* redeclaring = "#version 120\n"
+				"varying vec4 gl_TexCoord[2];\n"
+				"void main()\n"
+				"{\n"
+				"  gl_FragColor = gl_TexCoord[1];\n"
+				"}\n";
+		int accessed = -1, redeclared = -1;
+
+		CPPUNIT_ASSERT_MESSAGE("Cannot compile accessing shader",
+				texCoordSize(accessing, &accessed));
+		CPPUNIT_ASSERT_MESSAGE("Cannot compile redeclaring shader",
+				texCoordSize(redeclaring, &redeclared));
+		CPPUNIT_ASSERT_EQUAL_MESSAGE("Redeclared gl_TexCoord has wrong size",
+				2, redeclared);
+	}
+
+private:
+	/* Array size of gl_TexCoord as the shader sees it */
+	static bool texCoordSize(const char* source, int* size)
+	{
+		TBuiltInResource resources;
+		ShVariableList vl;
+
+		setTestResources(&resources);
+
+		ShHandle compiler = ShConstructCompiler(EShLangFragment, EDebugOpIntermediate);
+		if (!compiler)
+			return false;
+
+		bool success = ShCompile(compiler, &source, 1, EShOptNone, &resources,
+				EDebugOpIntermediate, &vl);
+		if (success) {
+			AstShader* shader = reinterpret_cast<ShaderHolder*>(compiler)->shaders[0];
+			ShVariableList* lists[2] = { &vl, &shader->globals };
+			for (int l = 0; l < 2; ++l)
+				for (int i = 0; i < lists[l]->numVariables; ++i)
+					if (!strcmp(lists[l]->variables[i]->name, "gl_TexCoord"))
+						*size = lists[l]->variables[i]->arraySize[0];
+			freeShVariableList(&vl);
+		}
+
+		ShDestruct(compiler);
+		return success && *size >= 0;
+	}
+};
+
+#endif /* COMPILESESSIONTEST_H_ */
@@ -0,0 +1,143 @@
+/*
+ * ConcurrencyTest.h
+ *
+ *  Created on: 16.10.2026
+ */
+
+#ifndef CONCURRENCYTEST_H_
+#define CONCURRENCYTEST_H_
+
+#include "ShaderInput.h"
+#include "ShaderLang.h"
+#include "TestResources.h"
+#include "misc.h"
+#include "mesa/util/ralloc.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#define CONCURRENCY_THREADS 8
+#define CONCURRENCY_ROUNDS 4
+#define CONCURRENCY_MAX_STEPS 256
+
+typedef std::vector<std::string> ProgramsList;
+
+/*
+ * Compiles and steps through the test shaders in several threads at once.
+ * Every thread must generate the same debug programs as a single thread
+ * does, also when the application uses a locale with a decimal comma.
+ */
+class ConcurrencyTest: public Resource, public CppUnit::TestFixture {
+public:
+	static CppUnit::TestSuite *suite()
+	{
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite;
+		suiteOfTests->addTest(new CppUnit::TestCaller<ConcurrencyTest>(
+				"testParallelDebug", &ConcurrencyTest::testParallelDebug));
+		return suiteOfTests;
+	}
+
+	void setUp()
+	{
+		static const char* extensions[2] = { ".frag", ".geom" };
+		for (int i = 0; i < 2; ++i) {
+			std::string fname = path + "shaders/test" + extensions[i];
+			sources[i] = test_load_text_file(NULL, fname.c_str());
+		}
+	}
+
+	void tearDown()
+	{
+		for (int i = 0; i < 2; ++i)
+			ralloc_free(sources[i]);
+	}
+
+	void testParallelDebug()
+	{
+		static const EShLanguage languages[2] = { EShLangFragment, EShLangGeometry };
+		ProgramsList expected[2];
+
+		for (int i = 0; i < 2; ++i) {
+			CPPUNIT_ASSERT_MESSAGE("Test shader not found", sources[i]);
+			CPPUNIT_ASSERT_MESSAGE("Cannot debug shader",
+					debugShader(languages[i], sources[i], expected[i]));
+			CPPUNIT_ASSERT_MESSAGE("No debug programs", !expected[i].empty());
+		}
+
+		/* What a Qt application may have done, the generated code must not
+		 * care. The locale is not available everywhere, the test runs anyway.
+		 */
+		std::string old_locale = setlocale(LC_NUMERIC, NULL);
+		if (!setlocale(LC_NUMERIC, "de_DE.UTF-8"))
+			setlocale(LC_NUMERIC, "de_DE");
+
+		std::vector<std::thread> threads;
+		std::vector<int> failures(CONCURRENCY_THREADS, 0);
+		for (int t = 0; t < CONCURRENCY_THREADS; ++t) {
+			threads.push_back(std::thread([&, t]() {
+				for (int round = 0; round < CONCURRENCY_ROUNDS; ++round) {
+					int i = (t + round) % 2;
+					ProgramsList programs;
+					if (!debugShader(languages[i], sources[i], programs)
+							|| programs != expected[i])
+						failures[t]++;
+				}
+			}));
+		}
+		for (auto it = threads.begin(); it != threads.end(); ++it)
+			it->join();
+
+		setlocale(LC_NUMERIC, old_locale.c_str());
+
+		for (int t = 0; t < CONCURRENCY_THREADS; ++t) {
+			std::stringstream ss;
+			ss << "Thread " << t << " generated different debug programs in "
+			   << failures[t] << " of " << CONCURRENCY_ROUNDS << " rounds";
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), !failures[t]);
+		}
+	}
+
+private:
+	/* Steps into the shader until it is finished and collects the coverage
+	 * program of every step.
+	 */
+	static bool debugShader(EShLanguage language, const char* source,
+			ProgramsList& programs)
+	{
+		TBuiltInResource resources;
+		ShVariableList vl;
+
+		setTestResources(&resources);
+
+		ShHandle compiler = ShConstructCompiler(language, EDebugOpIntermediate);
+		if (!compiler)
+			return false;
+
+		bool success = ShCompile(compiler, &source, 1, EShOptNone, &resources,
+				EDebugOpIntermediate, &vl);
+		for (int step = 0; success && step < CONCURRENCY_MAX_STEPS; ++step) {
+			DbgResult* dr = ShDebugJumpToNext(compiler, EDebugOpIntermediate,
+					DBG_BH_JUMP_INTO);
+			if (!dr || dr->status != DBG_RS_STATUS_OK)
+				break;
+			char* prog = ShDebugGetProg(compiler, NULL, &vl, DBG_CG_COVERAGE);
+			programs.push_back(std::string(prog ? prog : ""));
+			free(prog);
+		}
+
+		freeShVariableList(&vl);
+		ShDestruct(compiler);
+		return success;
+	}
+
+	char* sources[2];
+};
+
+#endif /* CONCURRENCYTEST_H_ */
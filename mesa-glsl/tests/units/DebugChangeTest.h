@@ -38,7 +38,7 @@ public:
 		if (!node->changeables.is_empty()) {
 			printIndent(length, depth);
 			foreach_in_list(changeable_item, sc, &node->changeables) {
-				ShVariable* var = findShVariable(sc->id);
+				ShVariable* var = findShVariable(holder->context, sc->id);
 				const char* name = var ? var->name : "undefined";
 				results << " <" << sc->id << "," << name << ">";
 			}
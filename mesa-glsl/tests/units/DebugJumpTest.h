@@ -35,17 +35,15 @@ public:
 	{
 		TestRepeater<DebugJumpTest, DebugJump>::RepeatedTestCase::runTest();
 
-		exec_list* list = shader->head;
-		ast_debugpath_traverser_visitor dbgpath;
-		dbgpath.run(list, DPOpPathClear);
+		base->dpv->clearPath();
 		base->results << "================== Clear path ==================\n";
 		base->doComparison(shader, false);
 		CPPUNIT_ASSERT_MESSAGE("Cannot step into shader", base->djv->step(MAIN_FUNC_SIGNATURE));
 		base->results << "===================== Step =====================\n";
 		if (!base->djv->finished()) {
 			base->doComparison(shader, false);
-			dbgpath.run(list, DPOpPathBuild);
-			dbgpath.getPath(base->dbg_result.scopeStack, shader);
+			base->dpv->buildPath(&base->djv->changed);
+			base->dpv->getPath(base->dbg_result.scopeStack, shader);
 			base->results << "================== Build path ==================\n";
 		}
 
@@ -87,7 +85,7 @@ public:
 		   << "\nScope:\n";
 		for (int i = 0; i < dbg_result.scope.numIds; ++i) {
 			int id = dbg_result.scope.ids[i];
-			dr << " " << formatVariable(id);
+			dr << " " << formatVariable(holder->context, id);
 		}
 		dr << "\nChangeables:\n";
 		for (int i = 0; i < dbg_result.cgbls.numChangeables; ++i) {
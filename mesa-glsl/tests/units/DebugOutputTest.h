@@ -29,13 +29,11 @@ public:
 	{
 		TestRepeater<DebugOutputTest, DebugOutput>::RepeatedTestCase::runTest();
 
-		exec_list* list = shader->head;
-		ast_debugpath_traverser_visitor dbgpath;
-		dbgpath.run(list, DPOpPathClear);
+		base->dpv->clearPath();
 		CPPUNIT_ASSERT_MESSAGE("Cannot step into shader", base->djv->step(MAIN_FUNC_SIGNATURE));
 		if (!base->djv->finished()) {
-			dbgpath.run(list, DPOpPathBuild);
-			dbgpath.getPath(base->dbg_result.scopeStack, shader);
+			base->dpv->buildPath(&base->djv->changed);
+			base->dpv->getPath(base->dbg_result.scopeStack, shader);
 		}
 
 		char* src = NULL;
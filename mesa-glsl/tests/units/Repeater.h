@@ -28,11 +28,13 @@ public:
 		behaviour = DBG_BH_JUMP_INTO;
 		resetDbgResult(dbg_result);
 		djv = new ast_debugjump_traverser_visitor(dbg_result);
+		dpv = new ast_debugpath_traverser_visitor;
 	}
 
 	virtual ~TestRepeater()
 	{
 		delete djv;
+		delete dpv;
 
 		// Due to cppunit strange behavior it expected test runner
 		// to exist after test finished, so we just collect all test
@@ -58,8 +60,7 @@ public:
 			base->reset();
 			base->djv->parseStack.clear();
 			resetDbgResult(base->dbg_result);
-			ast_debugpath_traverser_visitor dbgpath;
-			dbgpath.run(shader->head, DPOpReset);
+			base->dpv->reset(shader->head);
 		}
 
 		virtual void runTest()
@@ -109,6 +110,7 @@ protected:
 
 	// cppunit makes new instance for each test, lol.
 	ast_debugjump_traverser_visitor* djv;
+	ast_debugpath_traverser_visitor* dpv;
 };
 
 #endif /* TEST_REPEATOR_H_ */